@@ -0,0 +1,236 @@
+#include "CctCrowd.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Engine { namespace Collision {
+
+CctCrowd::CctCrowd(CollisionWorldLegacy* world)
+    : m_world(world)
+{
+    SetWorkerCount(1);
+}
+
+CctCrowd::~CctCrowd()
+{
+    StopWorkers();
+}
+
+uint32_t CctCrowd::Add(const CctCapsule& geom, const CctConfig& cfg, const CctState& state)
+{
+    const uint32_t idx = Size();
+    m_controllers.emplace_back(m_world, geom, cfg);
+    m_controllers.back().setState(state);
+
+    const CctState& s = m_controllers.back().getState();
+    m_walkMove.push_back({0.0f, 0.0f, 0.0f});
+    m_jump.push_back(0);
+    m_posFeet.push_back(s.posFeet);
+    m_vel.push_back(s.vel);
+    m_verticalVelocity.push_back(s.verticalVelocity);
+    m_onGround.push_back(s.onGround ? 1 : 0);
+    m_moveMode.push_back(s.moveMode);
+    m_geom.push_back(geom);
+    m_up.push_back(cfg.up);
+    m_maxCharacterRadius = (std::max)(m_maxCharacterRadius, geom.radius);
+    return idx;
+}
+
+void CctCrowd::SetWorkerCount(uint32_t workers)
+{
+    if (workers == 0)
+        workers = 1;
+    StopWorkers();
+
+    m_contexts.clear();
+    for (uint32_t w = 0; w < workers; ++w)
+        m_contexts.push_back(std::make_unique<CollisionQueryContext>());
+
+    m_shutdown = false;
+    for (uint32_t w = 1; w < workers; ++w)
+        m_threads.emplace_back(&CctCrowd::WorkerMain, this, w, m_generation);
+}
+
+void CctCrowd::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads)
+        t.join();
+    m_threads.clear();
+}
+
+void CctCrowd::Step(float dt)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto& ctx : m_contexts)
+        m_world->ResetSceneQueryFrameMetrics(ctx.get());
+
+    BuildCharacterSet();
+
+    m_stepDt = dt;
+    m_nextChunk.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busyWorkers = static_cast<uint32_t>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    TickChunks(0);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+    }
+
+    m_lastStep = CctCrowdStepStats{};
+    m_lastStep.characters = Size();
+    m_lastStep.workers = GetWorkerCount();
+    for (const KinematicCharacterControllerLegacy& cct : m_controllers)
+        m_lastStep.asleep += cct.isSleeping() ? 1u : 0u;
+    for (auto& ctx : m_contexts)
+        sq::AccumulateFrameMetrics(m_lastStep.metrics, m_world->GetSceneQueryFrameMetrics(ctx.get()));
+
+    const auto end = std::chrono::steady_clock::now();
+    m_lastStep.elapsedNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Cell edge = largest capsule diameter: a capsule touches at most 2 cells
+// per lateral axis, so Build and Gather stay O(1) per character.
+void CctCrowd::BuildCharacterSet()
+{
+    const uint32_t count = Size();
+    const sq::DynamicCapsuleHash* set = nullptr;
+    if (m_characterCollision && count > 1) {
+        m_capsules.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            sq::DynamicCapsule& c = m_capsules[i];
+            c.p = m_posFeet[i] + m_up[i] * m_geom[i].radius;
+            c.q = m_posFeet[i] + m_up[i] * (m_geom[i].radius + 2.0f * m_geom[i].halfHeight);
+            c.radius = m_geom[i].radius;
+        }
+        m_characterSet.Build(m_capsules.data(), count, 2.0f * m_maxCharacterRadius);
+        set = &m_characterSet;
+    } else {
+        m_characterSet.Clear();
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+        m_controllers[i].setCharacterSet(set, i);
+}
+
+void CctCrowd::TickChunks(uint32_t worker)
+{
+    CollisionQueryContext* ctx = m_contexts[worker].get();
+    const uint32_t count = Size();
+    const float dt = m_stepDt;
+
+    for (;;) {
+        const uint32_t chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed);
+        const uint32_t begin = chunk * kChunkSize;
+        if (begin >= count)
+            break;
+        const uint32_t end = (begin + kChunkSize < count) ? begin + kChunkSize : count;
+
+        for (uint32_t i = begin; i < end; ++i)
+            m_controllers[i].setQueryContext(ctx);
+
+        if (m_laneMode) {
+            // Sleeping controllers drop out before lanes are packed.
+            uint32_t awake[kChunkSize];
+            uint32_t awakeCount = 0;
+            for (uint32_t i = begin; i < end; ++i) {
+                CctInput input;
+                input.walkMove = m_walkMove[i];
+                input.jump = m_jump[i] != 0;
+                if (!m_controllers[i].TrySleepTick(input, dt))
+                    awake[awakeCount++] = i;
+            }
+            for (uint32_t i = 0; i < awakeCount; i += kCctLaneWidth)
+                TickLaneBlock(awake + i, std::min(kCctLaneWidth, awakeCount - i), dt);
+            continue;
+        }
+
+        for (uint32_t i = begin; i < end; ++i) {
+            CctInput input;
+            input.walkMove = m_walkMove[i];
+            input.jump = m_jump[i] != 0;
+            m_controllers[i].Tick(input, dt);
+            StoreControllerState(i);
+        }
+    }
+}
+
+void CctCrowd::TickLaneBlock(const uint32_t* indices, uint32_t count, float dt)
+{
+    CctLaneBlock block;
+    block.count = count;
+    CctInput inputs[kCctLaneWidth];
+
+    for (uint32_t lane = 0; lane < count; ++lane) {
+        KinematicCharacterControllerLegacy& cct = m_controllers[indices[lane]];
+        inputs[lane].walkMove = m_walkMove[indices[lane]];
+        inputs[lane].jump = m_jump[indices[lane]] != 0;
+        cct.BeginLaneTick(inputs[lane]);
+        cct.ExportVerticalLane(inputs[lane], block, lane);
+    }
+
+    IntegrateVerticalLanes(block, dt);
+
+    for (uint32_t lane = 0; lane < count; ++lane) {
+        KinematicCharacterControllerLegacy& cct = m_controllers[indices[lane]];
+        cct.ImportVerticalLane(block, lane);
+        cct.SimulateLaneTick(inputs[lane], dt);
+        cct.ExportWritebackLane(block, lane);
+    }
+
+    WritebackLanes(block, dt);
+
+    for (uint32_t lane = 0; lane < count; ++lane) {
+        KinematicCharacterControllerLegacy& cct = m_controllers[indices[lane]];
+        cct.ImportWritebackLane(block, lane);
+        cct.EndLaneTick();
+        StoreControllerState(indices[lane]);
+    }
+}
+
+void CctCrowd::StoreControllerState(uint32_t i)
+{
+    const CctState& s = m_controllers[i].getState();
+    m_posFeet[i] = s.posFeet;
+    m_vel[i] = s.vel;
+    m_verticalVelocity[i] = s.verticalVelocity;
+    m_onGround[i] = s.onGround ? 1 : 0;
+    m_moveMode[i] = s.moveMode;
+}
+
+void CctCrowd::WorkerMain(uint32_t worker, uint64_t seen)
+{
+    // 'seen' is captured at spawn so a Step() issued before this thread first
+    // runs is still observed as a new generation.
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_shutdown || m_generation != seen; });
+            if (m_shutdown)
+                return;
+            seen = m_generation;
+        }
+
+        TickChunks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busyWorkers;
+        }
+        m_done.notify_one();
+    }
+}
+
+}} // namespace Engine::Collision
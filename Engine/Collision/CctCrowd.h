@@ -0,0 +1,145 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/kcc/16-parallel-crowd.md
+//
+// TERMINOLOGY:
+//   CctCrowd     - owns N KCC instances plus SoA input/state mirrors
+//   Worker       - thread index in [0, workerCount); worker 0 is the caller
+//   Chunk        - contiguous controller range claimed by one worker
+//
+// POLICY:
+//   - Controllers never read each other's live state: a tick depends only on
+//     its own state, its input, the static CollisionWorld and the character
+//     set. Chunk-to-worker assignment therefore cannot change results; thread
+//     count only changes wall time.
+//   - Character collision (default on) rebuilds a DynamicCapsuleHash from
+//     PosFeet at the start of Step, before any controller ticks. Every
+//     controller sees the same tick-start snapshot (Jacobi, not Gauss-Seidel).
+//   - Each worker owns one CollisionQueryContext. The world BVH/registry is
+//     shared read-only.
+//   - SoA state is written by controller index after its tick.
+//   - Lane mode (default on) runs IntegrateVertical/Writeback for
+//     kCctLaneWidth controllers at a time (CctLanes.h). Bit-identical to
+//     per-controller Tick; queries stay per controller.
+//   - Sleeping controllers (CctConfig::useSleep) are filtered out per chunk
+//     before lane packing; lanes only carry awake controllers.
+//
+// CONTRACT:
+//   - CollisionWorld::BuildStatic must not run concurrently with Step().
+//   - Add() and SetWorkerCount() are not allowed during Step().
+//
+// PROOF POINTS:
+//   - RunCctCrowdBenchmark: position hash identical for 1 and N workers.
+// =========================================================================
+
+#include "CctLanes.h"
+#include "KinematicCharacterControllerLegacy.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine { namespace Collision {
+
+struct CctCrowdStepStats {
+    uint32_t characters = 0;
+    uint32_t workers = 0;
+    uint32_t asleep = 0;       // controllers asleep after the step
+    uint64_t elapsedNs = 0;
+    sq::SceneQueryFrameMetrics metrics{};  // summed over worker contexts
+};
+
+class CctCrowd {
+public:
+    explicit CctCrowd(CollisionWorldLegacy* world);
+    ~CctCrowd();
+
+    CctCrowd(const CctCrowd&) = delete;
+    CctCrowd& operator=(const CctCrowd&) = delete;
+
+    // Returns the controller index (dense, stable).
+    uint32_t Add(const CctCapsule& geom, const CctConfig& cfg, const CctState& state);
+    uint32_t Size() const { return static_cast<uint32_t>(m_controllers.size()); }
+
+    // 0 or 1 = caller thread only.
+    void SetWorkerCount(uint32_t workers);
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_contexts.size()); }
+
+    void SetLaneMode(bool enabled) { m_laneMode = enabled; }
+    bool GetLaneMode() const { return m_laneMode; }
+
+    void SetCharacterCollision(bool enabled) { m_characterCollision = enabled; }
+    bool GetCharacterCollision() const { return m_characterCollision; }
+
+    // ---- SoA input (consumed by the next Step) ----
+    void SetInput(uint32_t i, const CctInput& input)
+    {
+        m_walkMove[i] = input.walkMove;
+        m_jump[i] = input.jump ? 1 : 0;
+    }
+
+    void Step(float dt);
+
+    // ---- SoA state (valid after Step / Add) ----
+    const std::vector<sq::Vec3>& PosFeet() const { return m_posFeet; }
+    const std::vector<sq::Vec3>& Velocity() const { return m_vel; }
+    const std::vector<float>& VerticalVelocity() const { return m_verticalVelocity; }
+    const std::vector<uint8_t>& OnGround() const { return m_onGround; }
+    const std::vector<CctMoveMode>& MoveMode() const { return m_moveMode; }
+
+    const KinematicCharacterControllerLegacy& Controller(uint32_t i) const { return m_controllers[i]; }
+    const CctCrowdStepStats& GetLastStepStats() const { return m_lastStep; }
+
+private:
+    static constexpr uint32_t kChunkSize = 32;  // multiple of kCctLaneWidth
+    static_assert(kChunkSize % kCctLaneWidth == 0, "chunks must hold whole lane blocks");
+
+    void TickChunks(uint32_t worker);
+    void TickLaneBlock(const uint32_t* indices, uint32_t count, float dt);
+    void StoreControllerState(uint32_t i);
+    void BuildCharacterSet();
+    void WorkerMain(uint32_t worker, uint64_t seen);
+    void StopWorkers();
+
+    CollisionWorldLegacy* m_world;
+    std::vector<KinematicCharacterControllerLegacy> m_controllers;
+
+    // SoA mirrors, index = controller index
+    std::vector<sq::Vec3>    m_walkMove;
+    std::vector<uint8_t>     m_jump;
+    std::vector<sq::Vec3>    m_posFeet;
+    std::vector<sq::Vec3>    m_vel;
+    std::vector<float>       m_verticalVelocity;
+    std::vector<uint8_t>     m_onGround;
+    std::vector<CctMoveMode> m_moveMode;
+    std::vector<CctCapsule>  m_geom;
+    std::vector<sq::Vec3>    m_up;
+
+    // Tick-start character snapshot shared read-only by all workers.
+    std::vector<sq::DynamicCapsule> m_capsules;
+    sq::DynamicCapsuleHash m_characterSet;
+    float m_maxCharacterRadius = 0.0f;
+    bool m_characterCollision = true;
+
+    // One query context per worker; index 0 belongs to the calling thread.
+    std::vector<std::unique_ptr<CollisionQueryContext>> m_contexts;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    uint32_t m_busyWorkers = 0;
+    bool m_shutdown = false;
+    float m_stepDt = 0.0f;
+    bool m_laneMode = true;
+    std::atomic<uint32_t> m_nextChunk{0};
+
+    CctCrowdStepStats m_lastStep{};
+};
+
+}} // namespace Engine::Collision
@@ -0,0 +1,225 @@
+#include "CctCrowdBenchmark.h"
+#include "CctCrowd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace Engine { namespace Collision {
+
+namespace {
+
+// Mirrors WorldConfig defaults / WorldState::BuildCollisionWorld.
+constexpr uint32_t kGridSize   = 100;
+constexpr float    kCubeHalfXZ = 0.9f;
+constexpr float    kCubeMinY   = 0.0f;
+constexpr float    kCubeMaxY   = 3.0f;
+constexpr float    kFloorExtent = 200.0f;
+constexpr float    kFloorThickness = 1.0f;
+constexpr float    kWalkSpeed  = 30.0f;
+
+void BuildDefaultMap(CollisionWorldLegacy& world)
+{
+    std::vector<ColliderDesc> descs;
+    descs.reserve(kGridSize * kGridSize + 1);
+
+    for (uint32_t i = 0; i < kGridSize * kGridSize; ++i) {
+        const float cx = 2.0f * static_cast<float>(i % kGridSize) - 99.0f;
+        const float cz = 2.0f * static_cast<float>(i / kGridSize) - 99.0f;
+        ColliderDesc d;
+        d.bounds  = {cx - kCubeHalfXZ, kCubeMinY, cz - kCubeHalfXZ,
+                     cx + kCubeHalfXZ, kCubeMaxY, cz + kCubeHalfXZ};
+        d.shape   = ColliderShape::AABB;
+        d.userTag = i;
+        descs.push_back(d);
+    }
+
+    // Floor as a bounded plane, like WorldState's map.
+    const float f = kFloorExtent;
+    ColliderDesc floor;
+    floor.shape   = ColliderShape::Plane;
+    floor.userTag = 0xFFFFFFFE;
+    floor.plane   = sq::MakeBoundedPlane({0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+                                         {1.0f, 0.0f, 0.0f}, f, f, kFloorThickness);
+    floor.bounds  = sq::PlaneFootprintBounds(floor.plane);
+    descs.push_back(floor);
+
+    world.BuildStatic(descs);
+}
+
+uint32_t HashU32(uint32_t x)
+{
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Deterministic per-character script: heading changes every 40 ticks,
+// occasional jumps; idlePercent of the characters stand still. Independent of
+// worker count by construction.
+CctInput ScriptInput(uint32_t character, uint32_t tick, float dt, uint32_t idlePercent)
+{
+    if (HashU32(character ^ 0x5bd1e995U) % 100 < idlePercent)
+        return CctInput{};
+    const uint32_t h = HashU32(character * 0x9E3779B9U + (tick / 40));
+    const float angle = static_cast<float>(h & 0xFFFF) * (6.2831853f / 65536.0f);
+    CctInput in;
+    in.walkMove = {std::cos(angle) * kWalkSpeed * dt, 0.0f, std::sin(angle) * kWalkSpeed * dt};
+    in.jump = ((tick + character) % 90) == 0;
+    return in;
+}
+
+uint64_t HashCrowdState(const CctCrowd& crowd)
+{
+    uint64_t h = 1469598103934665603ULL;  // FNV-1a
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= b[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    for (uint32_t i = 0; i < crowd.Size(); ++i) {
+        mix(&crowd.PosFeet()[i], sizeof(sq::Vec3));
+        mix(&crowd.VerticalVelocity()[i], sizeof(float));
+        mix(&crowd.MoveMode()[i], sizeof(CctMoveMode));
+    }
+    return h;
+}
+
+CctCrowdBenchmarkRow RunCrowd(CollisionWorldLegacy& world, uint32_t characters,
+                              uint32_t workers, bool lanes,
+                              const CctCrowdBenchmarkConfig& config)
+{
+    CctCapsule geom;
+    geom.radius = 1.5f;
+    geom.halfHeight = 1.5f;
+
+    CctConfig cfg;
+    cfg.gravity = 30.0f;
+    cfg.jumpSpeed = 15.0f;
+    cfg.stepHeight = 0.3f;
+    cfg.fallSpeed = 55.0f;
+    cfg.contactOffset = 0.02f;
+    cfg.useSleep = config.sleep;
+
+    CctCrowd crowd(&world);
+    crowd.SetWorkerCount(workers);
+    crowd.SetLaneMode(lanes);
+    crowd.SetCharacterCollision(config.characterCollision);
+    // Every other cube: 4 m spacing keeps the 3 m capsules apart at spawn.
+    constexpr uint32_t kSpawnRow = kGridSize / 2;
+    constexpr uint32_t kSpawnLayer = kSpawnRow * kSpawnRow;
+    for (uint32_t i = 0; i < characters; ++i) {
+        const uint32_t cell = i % kSpawnLayer;
+        CctState s;
+        s.posFeet = {4.0f * static_cast<float>(cell % kSpawnRow) - 99.0f,
+                     kCubeMaxY + 7.0f * static_cast<float>(i / kSpawnLayer),
+                     4.0f * static_cast<float>(cell / kSpawnRow) - 99.0f};
+        crowd.Add(geom, cfg, s);
+    }
+
+    CctCrowdBenchmarkRow row;
+    row.characters = characters;
+    row.workers = crowd.GetWorkerCount();
+    row.lanes = lanes;
+    row.ticks = config.ticks;
+    for (uint32_t t = 0; t < config.ticks; ++t) {
+        for (uint32_t i = 0; i < characters; ++i)
+            crowd.SetInput(i, ScriptInput(i, t, config.dt, config.idlePercent));
+        crowd.Step(config.dt);
+
+        const CctCrowdStepStats& step = crowd.GetLastStepStats();
+        row.elapsedNs += step.elapsedNs;
+        row.sweepQueries += step.metrics.sweepQueries;
+        row.overlapQueries += step.metrics.overlapQueries;
+        row.asleep = step.asleep;
+    }
+    row.stateHash = HashCrowdState(crowd);
+    return row;
+}
+
+template <typename... Args>
+void AppendReportLine(char* out, size_t outSize, size_t& used,
+                      const char* format, Args... args)
+{
+    if (used >= outSize)
+        return;
+    const int written = std::snprintf(out + used, outSize - used, format, args...);
+    if (written > 0)
+        used = std::min(outSize - 1, used + static_cast<size_t>(written));
+}
+
+} // namespace
+
+CctCrowdBenchmarkReport RunCctCrowdBenchmark(const CctCrowdBenchmarkConfig& config)
+{
+    CctCrowdBenchmarkReport report;
+    report.config = config;
+
+    std::vector<uint32_t> workerCounts = config.workerCounts;
+    if (workerCounts.empty()) {
+        const uint32_t hw = std::max(1u, std::thread::hardware_concurrency());
+        for (uint32_t w = 1; w < hw; w *= 2)
+            workerCounts.push_back(w);
+        workerCounts.push_back(hw);
+    }
+
+    CollisionWorldLegacy world;
+    BuildDefaultMap(world);
+
+    for (uint32_t characters : config.characterCounts) {
+        std::vector<CctCrowdBenchmarkRow> rows;
+        if (config.scalarReference)
+            rows.push_back(RunCrowd(world, characters, 1, false, config));
+        for (uint32_t workers : workerCounts)
+            rows.push_back(RunCrowd(world, characters, workers, true, config));
+
+        for (CctCrowdBenchmarkRow& row : rows) {
+            row.matchesSerial = (row.stateHash == rows.front().stateHash);
+            report.deterministic = report.deterministic && row.matchesSerial;
+            report.rows.push_back(row);
+        }
+    }
+    return report;
+}
+
+void FormatCctCrowdBenchmarkReport(
+    const CctCrowdBenchmarkReport& report,
+    char* out,
+    size_t outSize)
+{
+    if (!out || outSize == 0)
+        return;
+
+    size_t used = 0;
+    AppendReportLine(out, outSize, used,
+        "CctCrowd benchmark\n"
+        "deterministic=%s map=%ux%u ticks=%u characterCollision=%s sleep=%s idle=%u%%\n",
+        report.deterministic ? "yes" : "no",
+        kGridSize, kGridSize,
+        report.config.ticks,
+        report.config.characterCollision ? "on" : "off",
+        report.config.sleep ? "on" : "off",
+        report.config.idlePercent);
+
+    for (const CctCrowdBenchmarkRow& row : report.rows) {
+        AppendReportLine(out, outSize, used,
+            "chars=%u workers=%u lanes=%s: ticks/s=%.1f charTicks/s=%.0f sweeps=%llu overlaps=%llu asleep=%u hash=%016llx%s\n",
+            row.characters,
+            row.workers,
+            row.lanes ? "on" : "off",
+            row.TicksPerSecond(),
+            row.TicksPerSecond() * static_cast<double>(row.characters),
+            static_cast<unsigned long long>(row.sweepQueries),
+            static_cast<unsigned long long>(row.overlapQueries),
+            row.asleep,
+            static_cast<unsigned long long>(row.stateHash),
+            row.matchesSerial ? "" : " MISMATCH");
+    }
+}
+
+}} // namespace Engine::Collision
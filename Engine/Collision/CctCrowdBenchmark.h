@@ -0,0 +1,59 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/kcc/16-parallel-crowd.md
+//
+// CctCrowd throughput benchmark on the default 100x100 cube map
+// (WorldConfig defaults: cubes +-0.9 XZ, Y [0,3], floor +-200).
+// Reports ticks/second per (characters, workers, lane mode) and checks that
+// the final crowd state hash is identical for every row of a crowd size.
+// =========================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision {
+
+struct CctCrowdBenchmarkConfig {
+    std::vector<uint32_t> characterCounts{1000, 10000};
+    std::vector<uint32_t> workerCounts{};  // empty = 1, 2, 4 .. hardware_concurrency
+    uint32_t ticks = 60;
+    bool scalarReference = true;           // extra 1-worker row without lanes
+    bool characterCollision = true;        // CctCrowd::SetCharacterCollision
+    bool sleep = true;                     // CctConfig::useSleep
+    uint32_t idlePercent = 0;              // characters with zero input (sleep candidates)
+    float dt = 1.0f / 60.0f;
+};
+
+struct CctCrowdBenchmarkRow {
+    uint32_t characters = 0;
+    uint32_t workers = 0;
+    bool lanes = true;
+    uint32_t ticks = 0;
+    uint64_t elapsedNs = 0;
+    uint64_t sweepQueries = 0;
+    uint64_t overlapQueries = 0;
+    uint32_t asleep = 0;                   // after the last tick
+    uint64_t stateHash = 0;
+    bool matchesSerial = true;
+
+    double TicksPerSecond() const {
+        return elapsedNs ? static_cast<double>(ticks) * 1e9 / static_cast<double>(elapsedNs) : 0.0;
+    }
+};
+
+struct CctCrowdBenchmarkReport {
+    CctCrowdBenchmarkConfig config{};
+    std::vector<CctCrowdBenchmarkRow> rows;
+    bool deterministic = true;
+};
+
+CctCrowdBenchmarkReport RunCctCrowdBenchmark(
+    const CctCrowdBenchmarkConfig& config = {});
+
+void FormatCctCrowdBenchmarkReport(
+    const CctCrowdBenchmarkReport& report,
+    char* out,
+    size_t outSize);
+
+}} // namespace Engine::Collision
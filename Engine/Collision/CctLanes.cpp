@@ -0,0 +1,77 @@
+#include "CctLanes.h"
+
+namespace Engine { namespace Collision {
+
+namespace simd = Math::simd;
+
+// =========================================================================
+// IntegrateVerticalLanes
+// =========================================================================
+// PRODUCES: verticalVelocity, verticalOffset per lane, jumpStartedBits
+// CONSUMES: walkingMask, jumpMask, gravity, jumpSpeed, fallSpeed, verticalVelocity
+//
+// MASKS:
+//   hold   = walking & ~jump   -> v = 0, offset = 0
+//   launch = walking &  jump   -> v = jumpSpeed, then integrate
+//   other lanes (Falling)      -> integrate
+// INVARIANT: same clamp order as scalar (min jumpSpeed, then max -fallSpeed).
+
+void IntegrateVerticalLanes(CctLaneBlock& block, float dt)
+{
+    const simd::MaskLanes walking = simd::LoadMaskLanes(block.walkingMask);
+    const simd::MaskLanes jump    = simd::LoadMaskLanes(block.jumpMask);
+    const simd::MaskLanes hold    = simd::AndNot(walking, jump);
+    const simd::MaskLanes launch  = simd::And(walking, jump);
+
+    const simd::FloatLanes zero      = simd::SplatLanes(0.0f);
+    const simd::FloatLanes dtL       = simd::SplatLanes(dt);
+    const simd::FloatLanes gravity   = simd::LoadLanes(block.gravity);
+    const simd::FloatLanes jumpSpeed = simd::LoadLanes(block.jumpSpeed);
+    const simd::FloatLanes fallSpeed = simd::LoadLanes(block.fallSpeed);
+
+    simd::FloatLanes v = simd::LoadLanes(block.verticalVelocity);
+    v = simd::Select(launch, jumpSpeed, v);
+    v = simd::Sub(v, simd::Mul(gravity, dtL));
+    v = simd::Min(v, jumpSpeed);
+    v = simd::Max(v, simd::Neg(fallSpeed));
+    simd::FloatLanes offset = simd::Mul(v, dtL);
+
+    v      = simd::Select(hold, zero, v);
+    offset = simd::Select(hold, zero, offset);
+
+    simd::StoreLanes(v, block.verticalVelocity);
+    simd::StoreLanes(offset, block.verticalOffset);
+    block.jumpStartedBits = simd::MaskBits(launch);
+}
+
+// =========================================================================
+// WritebackLanes
+// =========================================================================
+// PRODUCES: vel, dxIntent, dxCorr and their debug magnitudes per lane
+// CONSUMES: xOld, xSweep, xFinalPre, up
+//
+// §3A: v_next = (x_final - x_sweep) / dt; recovery displacement excluded.
+
+void WritebackLanes(CctLaneBlock& block, float dt)
+{
+    const simd::Vec3Lanes xOld      = simd::LoadLanes3(block.xOld);
+    const simd::Vec3Lanes xSweep    = simd::LoadLanes3(block.xSweep);
+    const simd::Vec3Lanes xFinalPre = simd::LoadLanes3(block.xFinalPre);
+    const simd::Vec3Lanes up        = simd::LoadLanes3(block.up);
+
+    const simd::Vec3Lanes dxIntent = simd::Sub(xFinalPre, xSweep);
+    const simd::Vec3Lanes dxCorr   = simd::Sub(xSweep, xOld);
+    const simd::Vec3Lanes vel = (dt > 0.0f)
+        ? simd::Scale(dxIntent, simd::SplatLanes(1.0f / dt))
+        : simd::SplatLanes3({0.0f, 0.0f, 0.0f});
+
+    simd::StoreLanes3(vel, block.vel);
+    simd::StoreLanes3(dxIntent, block.dxIntent);
+    simd::StoreLanes3(dxCorr, block.dxCorr);
+    simd::StoreLanes(simd::Length3(dxIntent), block.dxIntentMag);
+    simd::StoreLanes(simd::Length3(dxCorr), block.dxCorrMag);
+    simd::StoreLanes(simd::Length3(vel), block.vNextMag);
+    simd::StoreLanes(simd::Dot3(vel, up), block.vNextDotUp);
+}
+
+}} // namespace Engine::Collision
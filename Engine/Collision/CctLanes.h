@@ -0,0 +1,79 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/kcc/17-controller-lanes.md
+//
+// TERMINOLOGY:
+//   Lane       - one controller slot in a CctLaneBlock (kLaneWidth per block)
+//   Lane block - SoA staging for the pure-math KCC phases of kLaneWidth
+//                controllers
+//
+// POLICY:
+//   - Only query-free phases run on lanes: IntegrateVertical and Writeback.
+//     Movement phases issue data-dependent query sequences and stay per
+//     controller, and with them slide projection and walkable checks: each
+//     consumes one sweep hit inside that sequence.
+//   - Walking/Falling and jump divergence is handled with lane masks; every
+//     lane computes both paths and Select keeps the right one.
+//   - Lane kernels evaluate the scalar expressions in the same order, so a
+//     lane tick is bit-identical to KinematicCharacterControllerLegacy::Tick.
+//
+// CONTRACT:
+//   - Lanes >= count are padding. Kernels compute them; callers ignore them.
+// =========================================================================
+
+#include "../Math/LaneSimd.h"
+#include "SceneQuery/SqTypes.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Engine { namespace Collision {
+
+static constexpr uint32_t kCctLaneWidth = Math::simd::kLaneWidth;
+
+struct CctLaneBlock {
+    uint32_t count = 0;
+
+    // ---- IntegrateVertical ----
+    // Mode/jump flags are stored as float bit masks (all-ones = set) so the
+    // kernel loads them like any other lane.
+    float    walkingMask[kCctLaneWidth]{};
+    float    jumpMask[kCctLaneWidth]{};
+    float    gravity[kCctLaneWidth]{};
+    float    jumpSpeed[kCctLaneWidth]{};
+    float    fallSpeed[kCctLaneWidth]{};
+    float    verticalVelocity[kCctLaneWidth]{};   // in/out
+    float    verticalOffset[kCctLaneWidth]{};     // out
+    uint32_t jumpStartedBits = 0;                 // out: bit i = lane i Walking -> Falling
+
+    // ---- Writeback (§3A) ----
+    Math::simd::Vec3LaneStore xOld{};
+    Math::simd::Vec3LaneStore xSweep{};
+    Math::simd::Vec3LaneStore xFinalPre{};
+    Math::simd::Vec3LaneStore up{};
+    Math::simd::Vec3LaneStore vel{};              // out
+    Math::simd::Vec3LaneStore dxIntent{};         // out
+    Math::simd::Vec3LaneStore dxCorr{};           // out
+    float    dxIntentMag[kCctLaneWidth]{};        // out
+    float    dxCorrMag[kCctLaneWidth]{};          // out
+    float    vNextMag[kCctLaneWidth]{};           // out
+    float    vNextDotUp[kCctLaneWidth]{};         // out
+
+    static float MaskValue(bool set);
+};
+
+inline float CctLaneBlock::MaskValue(bool set)
+{
+    const uint32_t bits = set ? 0xFFFFFFFFu : 0u;
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+// Lane equivalent of KinematicCharacterControllerLegacy::IntegrateVertical.
+void IntegrateVerticalLanes(CctLaneBlock& block, float dt);
+
+// Lane equivalent of KinematicCharacterControllerLegacy::Writeback.
+void WritebackLanes(CctLaneBlock& block, float dt);
+
+}} // namespace Engine::Collision
@@ -37,6 +37,16 @@ struct CctCapsule {
 
 // ---- Solver configuration ---------------------------------------------------
 
+// Lateral/air contact response after a blocking sweep.
+//   SinglePlane - slide along the last hit normal, re-sweep (Bullet-style)
+//   MultiPlane  - keep every plane touched this phase (hit + one overlap at
+//                 the contact pose) and solve the constrained move at once:
+//                 one plane -> projection, two -> crease, three+ -> stop
+enum class CctSlideSolver : uint8_t {
+    SinglePlane = 0,
+    MultiPlane  = 1,
+};
+
 struct CctConfig {
     sq::Vec3 up{0, 1, 0};             // must be unit
     float gravity       = 29.43f;     // scalar magnitude (m/s^2), applied along -up
@@ -61,6 +71,35 @@ struct CctConfig {
     float recoverAlpha    = 0.2f;     // Bullet: 0.2 (GS projection fraction per contact)
     float walkableNearZeroEps = 1e-4f; // StepDown near-zero TOI threshold
     float groundStickyTime = 0.03f;   // keep grounded briefly across tiny miss frames
+    // Gather static candidates in the tick's reach region once at tick start;
+    // queries inside the region skip BVH traversal, others use the BVH. The
+    // set is rebuilt every tick, so it never outlives a world change.
+    bool  useLocalQuerySet = true;
+    // Serve exact sweep/overlap repeats from stored results, and rerun only
+    // narrowphase for sweeps that differ in filter. Keyed on the query inputs
+    // and queryMask; cleared at the end of every tick.
+    bool  useQueryMemo = true;
+    // While Walking, replace the maintain-probe BVH sweep with a sweep
+    // against last tick's support collider once one overlap proved it is the
+    // only solid nearby. Dropped when the feet leave groundSupportCacheRadius,
+    // the feature changes, or the static epoch, queryMask, probe terms or
+    // config generation (getConfigMut) change.
+    bool  useGroundSupportCache = true;
+    float groundSupportCacheRadius = 0.25f; // feet travel (m) before the cache must re-prove exclusivity
+    CctSlideSolver slideSolver = CctSlideSolver::SinglePlane;
+    // Skip movement sweeps whose path stays clear of the contact planes one
+    // overlap gathered within speculativeMargin. Regathered when the path
+    // leaves that reach or the static epoch, queryMask or config generation
+    // (getConfigMut) changes.
+    bool  useSpeculativeContacts = true;
+    float speculativeMargin = 0.5f;   // extra reach (m) gathered beyond the planned displacement
+    // Skip whole ticks once sleepIdleTicks idle ticks left the state
+    // unchanged. Input, a dt, static epoch or config generation
+    // (getConfigMut) change, a touching character, setState() and wake()
+    // end the sleep.
+    bool  useSleep = true;
+    uint32_t sleepIdleTicks = 2;      // consecutive idle fixed-point ticks before sleeping
+    uint32_t queryMask  = 1u << 0;    // QueryMask for every world query (Q_Solid)
     sq::SweepConfig sweep;            // skin, tieEpsT
 };
 
@@ -102,6 +141,15 @@ struct CctPhaseSnapshot {
     bool onGround = false;
 };
 
+// Why a sleeping controller ran a full tick again.
+enum class CctWakeReason : uint8_t {
+    None = 0,
+    Input,          // non-zero walkMove or jump
+    WorldChanged,   // CollisionWorld static epoch changed
+    Contact,        // another character entered the inflated capsule
+    External,       // setState / wake() / dt or config generation change
+};
+
 enum class CctStepMoveQueryKind : uint8_t {
     NotRun = 0,
     ClearPath,
@@ -230,6 +278,39 @@ struct CctDebug {
     uint32_t stepDownFilterRejects = 0;  // candidates rejected by walkable filter
     uint32_t onGroundToggles       = 0;  // 1 if onGround changed this tick, else 0
 
+    // Local query set (per-tick candidate prefetch)
+    uint32_t localSetCandidates = 0;  // solids gathered for this tick's region
+    uint32_t localSetQueries    = 0;  // sweeps/overlaps served from the set
+    uint32_t localSetMisses     = 0;  // queries that left the region (full BVH)
+
+    // Intra-tick query memo
+    uint32_t queryMemoHits      = 0;  // exact repeats returned from the memo
+    uint32_t queryMemoRefilters = 0;  // filter variants rerun over cached candidates
+
+    // Ground support cache (cross-tick)
+    uint32_t groundCacheHits      = 0;  // 1 if maintain support came from the cached collider
+    uint32_t groundCacheFallbacks = 0;  // 1 if a valid cache failed validation this tick
+    uint32_t groundCacheRefills   = 0;  // 1 if the cache was re-proven exclusive this tick
+
+    // Multi-plane slide solver (CctSlideSolver::MultiPlane)
+    uint32_t slidePlanes  = 0;  // constraint planes held at the end of the move phase
+    uint32_t slideCreases = 0;  // crease projections (two active planes)
+    uint32_t slideStops   = 0;  // full stops (three+ active planes or zero crease)
+
+    // Speculative contact set
+    uint32_t speculativeRefills = 0;  // inflated overlaps that re-gathered the plane set
+    uint32_t speculativeSkips   = 0;  // sweeps answered "clear" from the plane set
+
+    // Sleep fast path
+    uint32_t asleep = 0;              // 1 if this tick was skipped (state unchanged)
+    CctWakeReason wakeReason = CctWakeReason::None; // set on the tick that woke up
+
+    // Character collision (CctCrowd dynamic capsules)
+    uint32_t characterCandidates = 0;  // other characters gathered for this tick's region
+    uint32_t characterOverflow   = 0;  // region characters dropped past the candidate cap
+    uint32_t characterHits       = 0;  // sweeps whose closest hit was a character
+    uint32_t characterContacts   = 0;  // overlap contacts contributed by characters
+
     // §3A velocity semantics evidence
     sq::Vec3 dxIntent{};             // x_finalPre - x_sweep
     sq::Vec3 dxCorr{};               // x_sweep - x_old
@@ -0,0 +1,287 @@
+#include "CollisionQueryBudget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace Engine { namespace Collision {
+
+void CollisionQueryBudget::Configure(const QueryBudgetDesc& desc)
+{
+    m_desc = desc;
+    // A zero share makes OverLimit true at zero spend and the queue never drains.
+    if (!(m_desc.lowPriorityShare > 0.0f))
+        m_desc.lowPriorityShare = std::numeric_limits<float>::min();
+    m_desc.lowPriorityShare = (std::min)(m_desc.lowPriorityShare, 1.0f);
+}
+
+uint32_t CollisionQueryBudget::RegisterSubsystem(const char* name, QueryPriority priority)
+{
+    const uint32_t id = GetSubsystemCount();
+    Client c;
+    c.name = name ? name : "";
+    c.priority = priority;
+    m_clients.push_back(std::move(c));
+    return id;
+}
+
+CollisionQueryBudget::Slot& CollisionQueryBudget::SlotOf(uint32_t subsystem, uint32_t slot)
+{
+    std::vector<Slot>& slots = m_clients[subsystem].slots;
+    if (slot >= slots.size())
+        slots.resize(static_cast<size_t>(slot) + 1);
+    return slots[slot];
+}
+
+bool CollisionQueryBudget::OverLimit(float share) const
+{
+    if (m_desc.tickNs != 0 &&
+        static_cast<double>(m_tickStats.spentNs) >= static_cast<double>(m_desc.tickNs) * share)
+        return true;
+    if (m_desc.tickNodes != 0 &&
+        static_cast<double>(m_tickStats.spentNodes) >= static_cast<double>(m_desc.tickNodes) * share)
+        return true;
+    return false;
+}
+
+bool CollisionQueryBudget::IsExhausted(QueryPriority priority) const
+{
+    switch (priority) {
+    case QueryPriority::Critical: return false;
+    case QueryPriority::Normal:   return OverLimit(1.0f);
+    case QueryPriority::Low:      return OverLimit(m_desc.lowPriorityShare);
+    }
+    return false;
+}
+
+void CollisionQueryBudget::Count(Client& c, uint64_t QueryBudgetCounters::* field)
+{
+    ++(c.counters.*field);
+    ++(m_totals.*field);
+    ++(m_tickStats.counters.*field);
+}
+
+void CollisionQueryBudget::SyncEpoch(const CollisionWorldLegacy& world)
+{
+    const uint32_t epoch = world.GetStaticEpoch();
+    if (m_epochSeen && epoch == m_epoch) return;
+    m_epoch = epoch;
+    m_epochSeen = true;
+    // Results describe the old static world. Pending inputs stay valid.
+    for (Client& c : m_clients)
+        for (Slot& s : c.slots)
+            s.valid = false;
+}
+
+void CollisionQueryBudget::RunQuery(const CollisionWorldLegacy& world, Slot& s,
+                                    const QueryRequest& req, CollisionQueryContext* ctx)
+{
+    using Clock = std::chrono::steady_clock;
+    const bool timed = (m_desc.tickNs != 0);
+    Clock::time_point start{};
+    if (timed) start = Clock::now();
+
+    switch (req.kind) {
+    case BudgetedQueryKind::Sweep:
+        s.hit = world.SweepCapsuleClosest(req.in, req.cfg, req.queryMask, req.filter,
+                                          req.rejectInitialOverlap, ctx);
+        break;
+    case BudgetedQueryKind::Overlap:
+        if (s.contacts.size() < req.maxContacts)
+            s.contacts.resize(req.maxContacts);
+        s.contactCount = world.OverlapCapsuleContacts(req.in.segA0, req.in.segB0, req.in.radius,
+                                                      req.queryMask, s.contacts.data(),
+                                                      req.maxContacts, ctx);
+        break;
+    case BudgetedQueryKind::ClosestPoint:
+        s.closest = world.ClosestPointCapsule(req.in.segA0, req.in.segB0, req.in.radius,
+                                              req.maxDistance, req.queryMask, ctx);
+        break;
+    }
+    s.kind = req.kind;
+    s.tick = m_tick;
+    s.valid = true;
+
+    if (timed) {
+        m_tickStats.spentNs += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    m_tickStats.spentNodes += world.GetLastSceneQueryMetrics(ctx).nodesPopped;
+}
+
+void CollisionQueryBudget::BeginTick(const CollisionWorldLegacy& world, CollisionQueryContext* ctx)
+{
+    ++m_tick;
+    m_tickStats = QueryBudgetTickStats{};
+    m_tickStats.tick = m_tick;
+    SyncEpoch(world);
+
+    size_t done = 0;
+    while (done < m_pending.size() && !OverLimit(m_desc.lowPriorityShare)) {
+        const PendingRef ref = m_pending[done++];
+        Client& c = m_clients[ref.subsystem];
+        Slot& s = c.slots[ref.slot];
+        s.pending = false;
+        RunQuery(world, s, s.request, ctx);
+        Count(c, &QueryBudgetCounters::ran);
+        Count(c, &QueryBudgetCounters::deferredRun);
+    }
+    m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(done));
+    m_tickStats.pending = GetPendingCount();
+}
+
+BudgetedQueryStatus CollisionQueryBudget::Issue(const CollisionWorldLegacy& world,
+                                                uint32_t subsystem, uint32_t slot,
+                                                const QueryRequest& req,
+                                                CollisionQueryContext* ctx)
+{
+    SyncEpoch(world);
+    Client& c = m_clients[subsystem];
+    Slot& s = SlotOf(subsystem, slot);
+    Count(c, &QueryBudgetCounters::issued);
+
+    if (IsExhausted(c.priority)) {
+        if (s.valid && s.kind == req.kind && m_tick - s.tick <= m_desc.maxStaleTicks) {
+            Count(c, &QueryBudgetCounters::stale);
+            return BudgetedQueryStatus::Stale;
+        }
+        if (c.priority == QueryPriority::Low) {
+            if (!s.pending)
+                m_pending.push_back({subsystem, slot});
+            s.pending = true;
+            s.request = req;
+            Count(c, &QueryBudgetCounters::deferred);
+            return BudgetedQueryStatus::Deferred;
+        }
+    }
+
+    if (s.pending) {
+        // This tick's result supersedes the queued input.
+        s.pending = false;
+        m_pending.erase(std::find_if(m_pending.begin(), m_pending.end(),
+            [&](const PendingRef& p) { return p.subsystem == subsystem && p.slot == slot; }));
+    }
+    RunQuery(world, s, req, ctx);
+    Count(c, &QueryBudgetCounters::ran);
+    return BudgetedQueryStatus::Ran;
+}
+
+BudgetedQueryStatus CollisionQueryBudget::SweepCapsuleClosest(const CollisionWorldLegacy& world,
+                                                              uint32_t subsystem, uint32_t slot,
+                                                              const sq::SweepCapsuleInput& in,
+                                                              const sq::SweepConfig& cfg,
+                                                              QueryMask queryMask,
+                                                              const sq::SweepFilter& filter,
+                                                              bool rejectInitialOverlap,
+                                                              sq::Hit& out,
+                                                              CollisionQueryContext* ctx)
+{
+    QueryRequest req;
+    req.kind = BudgetedQueryKind::Sweep;
+    req.in = in;
+    req.cfg = cfg;
+    req.queryMask = queryMask;
+    req.filter = filter;
+    req.rejectInitialOverlap = rejectInitialOverlap;
+
+    const BudgetedQueryStatus status = Issue(world, subsystem, slot, req, ctx);
+    out = (status == BudgetedQueryStatus::Deferred)
+        ? sq::Hit{} : m_clients[subsystem].slots[slot].hit;
+    return status;
+}
+
+BudgetedQueryStatus CollisionQueryBudget::OverlapCapsuleContacts(const CollisionWorldLegacy& world,
+                                                                 uint32_t subsystem, uint32_t slot,
+                                                                 const sq::Vec3& segA,
+                                                                 const sq::Vec3& segB,
+                                                                 float radius, QueryMask queryMask,
+                                                                 sq::OverlapContact* outContacts,
+                                                                 uint32_t maxContacts,
+                                                                 uint32_t& outCount,
+                                                                 CollisionQueryContext* ctx)
+{
+    QueryRequest req;
+    req.kind = BudgetedQueryKind::Overlap;
+    req.in.segA0 = segA;
+    req.in.segB0 = segB;
+    req.in.radius = radius;
+    req.queryMask = queryMask;
+    req.maxContacts = maxContacts;
+
+    const BudgetedQueryStatus status = Issue(world, subsystem, slot, req, ctx);
+    outCount = 0;
+    if (status != BudgetedQueryStatus::Deferred) {
+        const Slot& s = m_clients[subsystem].slots[slot];
+        outCount = (std::min)(s.contactCount, maxContacts);
+        std::copy(s.contacts.begin(), s.contacts.begin() + outCount, outContacts);
+    }
+    return status;
+}
+
+BudgetedQueryStatus CollisionQueryBudget::ClosestPointCapsule(const CollisionWorldLegacy& world,
+                                                              uint32_t subsystem, uint32_t slot,
+                                                              const sq::Vec3& segA,
+                                                              const sq::Vec3& segB,
+                                                              float radius, float maxDistance,
+                                                              QueryMask queryMask,
+                                                              sq::ClosestPointResult& out,
+                                                              CollisionQueryContext* ctx)
+{
+    QueryRequest req;
+    req.kind = BudgetedQueryKind::ClosestPoint;
+    req.in.segA0 = segA;
+    req.in.segB0 = segB;
+    req.in.radius = radius;
+    req.queryMask = queryMask;
+    req.maxDistance = maxDistance;
+
+    const BudgetedQueryStatus status = Issue(world, subsystem, slot, req, ctx);
+    out = (status == BudgetedQueryStatus::Deferred)
+        ? sq::ClosestPointResult{} : m_clients[subsystem].slots[slot].closest;
+    return status;
+}
+
+const CollisionQueryBudget::Slot* CollisionQueryBudget::FindSlot(uint32_t subsystem, uint32_t slot,
+                                                                 BudgetedQueryKind kind) const
+{
+    const std::vector<Slot>& slots = m_clients[subsystem].slots;
+    if (slot >= slots.size() || !slots[slot].valid || slots[slot].kind != kind) return nullptr;
+    return &slots[slot];
+}
+
+bool CollisionQueryBudget::GetSlotResult(uint32_t subsystem, uint32_t slot, sq::Hit& out) const
+{
+    const Slot* s = FindSlot(subsystem, slot, BudgetedQueryKind::Sweep);
+    if (!s) return false;
+    out = s->hit;
+    return true;
+}
+
+bool CollisionQueryBudget::GetSlotResult(uint32_t subsystem, uint32_t slot,
+                                         sq::OverlapContact* outContacts, uint32_t maxContacts,
+                                         uint32_t& outCount) const
+{
+    outCount = 0;
+    const Slot* s = FindSlot(subsystem, slot, BudgetedQueryKind::Overlap);
+    if (!s) return false;
+    outCount = (std::min)(s->contactCount, maxContacts);
+    std::copy(s->contacts.begin(), s->contacts.begin() + outCount, outContacts);
+    return true;
+}
+
+bool CollisionQueryBudget::GetSlotResult(uint32_t subsystem, uint32_t slot,
+                                         sq::ClosestPointResult& out) const
+{
+    const Slot* s = FindSlot(subsystem, slot, BudgetedQueryKind::ClosestPoint);
+    if (!s) return false;
+    out = s->closest;
+    return true;
+}
+
+bool CollisionQueryBudget::IsSlotPending(uint32_t subsystem, uint32_t slot) const
+{
+    const std::vector<Slot>& slots = m_clients[subsystem].slots;
+    return slot < slots.size() && slots[slot].pending;
+}
+
+}} // namespace Engine::Collision
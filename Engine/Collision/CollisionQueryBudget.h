@@ -0,0 +1,206 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/kcc/21-query-budget.md
+//
+// TERMINOLOGY:
+//   Subsystem - a registered query client with one QueryPriority
+//   Slot      - caller-chosen index inside a subsystem (one probe, one
+//               trace); holds the last result of one query kind (sweep,
+//               contact overlap, closest point) and at most one pending query
+//   Spend     - nanoseconds and BVH nodes popped by queries run this tick
+//   Stale     - the slot's last result, served instead of running
+//   Deferred  - queued to run at the next BeginTick
+//
+// POLICY:
+//   - Critical queries always run. Normal and Low run while the spend is
+//     under their limit (Low: lowPriorityShare of the budget). Past it, a
+//     slot result no older than maxStaleTicks is served; otherwise Normal
+//     runs anyway and Low is deferred.
+//   - Every query that runs is charged, whatever its priority, so Critical
+//     load leaves less room for the rest.
+//   - BeginTick runs the pending queue in FIFO order under the new tick's
+//     Low limit. What does not fit stays queued; a re-deferred slot keeps
+//     its queue position and takes the newest input.
+//   - tickNodes is deterministic. tickNs reads the clock and is not.
+//
+// CONTRACT:
+//   - Not thread-safe. One budget per thread, used with one query context.
+//     The owner calls BeginTick once per fixed tick before its queries.
+//   - Slot results are dropped when the world's static epoch changes.
+//   - A slot serves Stale only for the kind it last ran; switching kinds
+//     runs or defers like a slot with no result.
+//   - Register before the first query; ids are dense and stable.
+//   - Nothing in the game tick registers a subsystem yet, so the per-tick
+//     bound only applies to callers that opt in (the harness today).
+// =========================================================================
+
+#include "CollisionWorldLegacy.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine { namespace Collision {
+
+enum class QueryPriority : uint8_t {
+    Critical = 0,   // movement, gameplay
+    Normal   = 1,   // degrade to stale, never deferred
+    Low      = 2    // AI probes, cosmetic traces
+};
+
+enum class BudgetedQueryKind : uint8_t {
+    Sweep        = 0,
+    Overlap      = 1,   // OverlapCapsuleContacts
+    ClosestPoint = 2
+};
+
+enum class BudgetedQueryStatus : uint8_t {
+    Ran      = 0,   // out is this tick's result
+    Stale    = 1,   // out is the slot's last result
+    Deferred = 2    // out is a miss / 0 contacts; the query runs at the next BeginTick
+};
+
+struct QueryBudgetDesc {
+    uint64_t tickNs           = 0;     // 0 = no time limit
+    uint64_t tickNodes        = 0;     // 0 = no node limit
+    float    lowPriorityShare = 0.5f;  // Low stops at this fraction of the budget
+    uint32_t maxStaleTicks    = 4;     // older results are not served
+};
+
+struct QueryBudgetCounters {
+    uint64_t issued      = 0;
+    uint64_t ran         = 0;   // includes deferred queries run at BeginTick
+    uint64_t stale       = 0;
+    uint64_t deferred    = 0;
+    uint64_t deferredRun = 0;   // pending queries run at BeginTick
+};
+
+struct QueryBudgetTickStats {
+    uint64_t tick        = 0;
+    uint64_t spentNs     = 0;
+    uint64_t spentNodes  = 0;
+    uint32_t pending     = 0;   // queue length after BeginTick
+    QueryBudgetCounters counters{};
+};
+
+class CollisionQueryBudget {
+public:
+    // lowPriorityShare is clamped to (0, 1], so BeginTick always has room
+    // for at least one pending query.
+    void Configure(const QueryBudgetDesc& desc);
+    const QueryBudgetDesc& GetDesc() const { return m_desc; }
+
+    // Returns the subsystem id (dense, stable).
+    uint32_t RegisterSubsystem(const char* name, QueryPriority priority);
+    uint32_t GetSubsystemCount() const { return static_cast<uint32_t>(m_clients.size()); }
+    const std::string& GetSubsystemName(uint32_t id) const { return m_clients[id].name; }
+    QueryPriority GetSubsystemPriority(uint32_t id) const { return m_clients[id].priority; }
+
+    // Resets the spend, then runs pending queries that fit the Low limit.
+    void BeginTick(const CollisionWorldLegacy& world, CollisionQueryContext* ctx = nullptr);
+
+    // CollisionWorldLegacy::SweepCapsuleClosest under the budget.
+    BudgetedQueryStatus SweepCapsuleClosest(const CollisionWorldLegacy& world,
+                                            uint32_t subsystem, uint32_t slot,
+                                            const sq::SweepCapsuleInput& in,
+                                            const sq::SweepConfig& cfg,
+                                            QueryMask queryMask,
+                                            const sq::SweepFilter& filter,
+                                            bool rejectInitialOverlap,
+                                            sq::Hit& out,
+                                            CollisionQueryContext* ctx = nullptr);
+
+    // CollisionWorldLegacy::OverlapCapsuleContacts under the budget. A Stale
+    // result is cut to maxContacts when the slot ran with more.
+    BudgetedQueryStatus OverlapCapsuleContacts(const CollisionWorldLegacy& world,
+                                               uint32_t subsystem, uint32_t slot,
+                                               const sq::Vec3& segA, const sq::Vec3& segB,
+                                               float radius, QueryMask queryMask,
+                                               sq::OverlapContact* outContacts,
+                                               uint32_t maxContacts,
+                                               uint32_t& outCount,
+                                               CollisionQueryContext* ctx = nullptr);
+
+    // CollisionWorldLegacy::ClosestPointCapsule under the budget.
+    BudgetedQueryStatus ClosestPointCapsule(const CollisionWorldLegacy& world,
+                                            uint32_t subsystem, uint32_t slot,
+                                            const sq::Vec3& segA, const sq::Vec3& segB,
+                                            float radius, float maxDistance,
+                                            QueryMask queryMask,
+                                            sq::ClosestPointResult& out,
+                                            CollisionQueryContext* ctx = nullptr);
+
+    // Last result of a slot (run this tick, earlier, or at BeginTick). False
+    // when the slot has none or last ran another kind. The overlap form
+    // copies at most maxContacts contacts.
+    bool GetSlotResult(uint32_t subsystem, uint32_t slot, sq::Hit& out) const;
+    bool GetSlotResult(uint32_t subsystem, uint32_t slot, sq::OverlapContact* outContacts,
+                       uint32_t maxContacts, uint32_t& outCount) const;
+    bool GetSlotResult(uint32_t subsystem, uint32_t slot, sq::ClosestPointResult& out) const;
+    bool IsSlotPending(uint32_t subsystem, uint32_t slot) const;
+
+    bool IsExhausted(QueryPriority priority) const;
+    uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_pending.size()); }
+
+    const QueryBudgetTickStats& GetTickStats() const { return m_tickStats; }
+    const QueryBudgetCounters& GetSubsystemCounters(uint32_t id) const { return m_clients[id].counters; }
+    const QueryBudgetCounters& GetTotalCounters() const { return m_totals; }
+
+private:
+    struct QueryRequest {
+        BudgetedQueryKind kind = BudgetedQueryKind::Sweep;
+        sq::SweepCapsuleInput in{};    // overlap/closest point: segA0, segB0, radius
+        sq::SweepConfig cfg{};
+        QueryMask queryMask = Q_Solid;
+        sq::SweepFilter filter{};
+        bool rejectInitialOverlap = false;
+        float maxDistance = 0.0f;      // ClosestPoint
+        uint32_t maxContacts = 0;      // Overlap
+    };
+
+    struct Slot {
+        BudgetedQueryKind kind = BudgetedQueryKind::Sweep;  // of the stored result
+        sq::Hit hit{};
+        std::vector<sq::OverlapContact> contacts;  // grows to the largest maxContacts
+        uint32_t contactCount = 0;
+        sq::ClosestPointResult closest{};
+        uint64_t tick = 0;       // tick the result was produced in
+        bool valid = false;
+        bool pending = false;
+        QueryRequest request{};  // valid while pending
+    };
+
+    struct Client {
+        std::string name;
+        QueryPriority priority = QueryPriority::Low;
+        std::vector<Slot> slots;
+        QueryBudgetCounters counters{};
+    };
+
+    struct PendingRef {
+        uint32_t subsystem;
+        uint32_t slot;
+    };
+
+    Slot& SlotOf(uint32_t subsystem, uint32_t slot);
+    const Slot* FindSlot(uint32_t subsystem, uint32_t slot, BudgetedQueryKind kind) const;
+    bool OverLimit(float share) const;
+    BudgetedQueryStatus Issue(const CollisionWorldLegacy& world, uint32_t subsystem,
+                              uint32_t slot, const QueryRequest& req,
+                              CollisionQueryContext* ctx);
+    void RunQuery(const CollisionWorldLegacy& world, Slot& s, const QueryRequest& req,
+                  CollisionQueryContext* ctx);
+    void Count(Client& c, uint64_t QueryBudgetCounters::* field);
+    void SyncEpoch(const CollisionWorldLegacy& world);
+
+    QueryBudgetDesc m_desc{};
+    std::vector<Client> m_clients;
+    std::vector<PendingRef> m_pending;   // FIFO, one entry per pending slot
+    QueryBudgetTickStats m_tickStats{};
+    QueryBudgetCounters m_totals{};
+    uint64_t m_tick = 0;
+    uint32_t m_epoch = 0;
+    bool m_epochSeen = false;
+};
+
+}} // namespace Engine::Collision
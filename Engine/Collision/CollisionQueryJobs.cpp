@@ -0,0 +1,296 @@
+#include "CollisionQueryJobs.h"
+
+#include <algorithm>
+
+namespace Engine { namespace Collision {
+
+CollisionQueryJobs::CollisionQueryJobs(const CollisionWorldLegacy* world)
+    : m_world(world)
+{
+    SetWorkerCount(1);
+}
+
+CollisionQueryJobs::~CollisionQueryJobs()
+{
+    StopWorkers();
+}
+
+void CollisionQueryJobs::SetWorkerCount(uint32_t workers)
+{
+    if (workers == 0)
+        workers = 1;
+    if (!m_contexts.empty())
+        WaitAll();
+    StopWorkers();
+
+    m_contexts.clear();
+    for (uint32_t w = 0; w < workers; ++w)
+        m_contexts.push_back(std::make_unique<CollisionQueryContext>());
+
+    m_shutdown = false;
+    for (uint32_t w = 1; w < workers; ++w)
+        m_threads.emplace_back(&CollisionQueryJobs::WorkerMain, this, w);
+}
+
+void CollisionQueryJobs::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads)
+        t.join();
+    m_threads.clear();
+}
+
+// ---- Submission -------------------------------------------------------------
+
+QueryHandle CollisionQueryJobs::Push(const Job& job)
+{
+    QueryHandle h;
+    h.id = m_submitted++;
+    h.generation = m_generation;
+    m_open.push_back(job);
+    if (m_open.size() >= kBatchSize)
+        Kick();
+    return h;
+}
+
+QueryHandle CollisionQueryJobs::SubmitSweep(const sq::SweepCapsuleInput& in,
+                                            const sq::SweepConfig& cfg,
+                                            QueryMask queryMask,
+                                            const sq::SweepFilter& filter,
+                                            bool rejectInitialOverlap)
+{
+    Job job;
+    job.kind = QueryJobKind::Sweep;
+    job.in = in;
+    job.cfg = cfg;
+    job.filter = filter;
+    job.queryMask = queryMask;
+    job.rejectInitialOverlap = rejectInitialOverlap;
+    return Push(job);
+}
+
+QueryHandle CollisionQueryJobs::SubmitOverlap(const sq::Vec3& segA, const sq::Vec3& segB,
+                                              float radius, QueryMask queryMask,
+                                              uint32_t maxContacts)
+{
+    Job job;
+    job.kind = QueryJobKind::Overlap;
+    job.in.segA0 = segA;
+    job.in.segB0 = segB;
+    job.in.radius = radius;
+    job.in.delta = {0.0f, 0.0f, 0.0f};
+    job.queryMask = queryMask;
+    job.maxContacts = (std::min)(maxContacts, kQueryJobMaxContacts);
+    return Push(job);
+}
+
+QueryHandle CollisionQueryJobs::SubmitRay(const sq::Vec3& origin, const sq::Vec3& dir,
+                                          float maxDistance, QueryMask queryMask)
+{
+    Job job;
+    job.kind = QueryJobKind::Ray;
+    job.in.segA0 = origin;
+    job.in.segB0 = origin;
+    job.in.radius = 0.0f;
+    job.in.delta = dir * maxDistance;
+    job.cfg.skin = 0.0f;
+    job.queryMask = queryMask;
+    return Push(job);
+}
+
+void CollisionQueryJobs::Kick()
+{
+    if (m_open.empty())
+        return;
+
+    auto batch = std::make_unique<Batch>();
+    batch->first = m_kicked;
+    batch->jobs.swap(m_open);
+    const uint32_t count = static_cast<uint32_t>(batch->jobs.size());
+    batch->chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    batch->chunkDone.assign(batch->chunkCount, 0);
+    m_kicked += count;
+    m_open.reserve(kBatchSize);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batches.push_back(std::move(batch));
+    }
+    m_wake.notify_all();
+}
+
+// ---- Execution --------------------------------------------------------------
+
+bool CollisionQueryJobs::HasClaimable() const
+{
+    for (size_t b = m_claimBatch; b < m_batches.size(); ++b)
+        if (m_batches[b]->nextChunk < m_batches[b]->chunkCount)
+            return true;
+    return false;
+}
+
+bool CollisionQueryJobs::TryClaim(Claim& out)
+{
+    while (m_claimBatch < m_batches.size()) {
+        Batch& b = *m_batches[m_claimBatch];
+        if (b.nextChunk < b.chunkCount) {
+            out.batch = &b;
+            out.chunk = b.nextChunk++;
+            return true;
+        }
+        ++m_claimBatch;
+    }
+    return false;
+}
+
+void CollisionQueryJobs::RunChunk(const Claim& claim, CollisionQueryContext* ctx)
+{
+    Batch& b = *claim.batch;
+    const uint32_t begin = claim.chunk * kChunkSize;
+    const uint32_t end = (std::min)(begin + kChunkSize, static_cast<uint32_t>(b.jobs.size()));
+
+    for (uint32_t i = begin; i < end; ++i) {
+        Job& job = b.jobs[i];
+        QueryJobResult& r = job.result;
+        r.kind = job.kind;
+        switch (job.kind) {
+        case QueryJobKind::Sweep:
+        case QueryJobKind::Ray:
+            r.hit = m_world->SweepCapsuleClosest(job.in, job.cfg, job.queryMask, job.filter,
+                                                 job.rejectInitialOverlap, ctx);
+            break;
+        case QueryJobKind::Overlap:
+            r.contactCount = m_world->OverlapCapsuleContacts(job.in.segA0, job.in.segB0,
+                                                             job.in.radius, job.queryMask,
+                                                             r.contacts, job.maxContacts, ctx);
+            break;
+        }
+    }
+}
+
+void CollisionQueryJobs::FinishChunk(const Claim& claim)
+{
+    claim.batch->chunkDone[claim.chunk] = 1;
+
+    // Publish in submission order: advance over the done prefix only.
+    while (m_publishBatch < m_batches.size()) {
+        Batch& b = *m_batches[m_publishBatch];
+        while (b.publishedChunks < b.chunkCount && b.chunkDone[b.publishedChunks]) {
+            const uint32_t begin = b.publishedChunks * kChunkSize;
+            const uint32_t end = (std::min)(begin + kChunkSize, static_cast<uint32_t>(b.jobs.size()));
+            m_completed += end - begin;
+            ++b.publishedChunks;
+        }
+        if (b.publishedChunks < b.chunkCount)
+            break;
+        ++m_publishBatch;
+    }
+}
+
+void CollisionQueryJobs::WorkerMain(uint32_t worker)
+{
+    CollisionQueryContext* ctx = m_contexts[worker].get();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_shutdown || HasClaimable(); });
+        if (m_shutdown)
+            return;
+
+        Claim claim;
+        if (!TryClaim(claim))
+            continue;
+        lock.unlock();
+        RunChunk(claim, ctx);
+        lock.lock();
+        FinishChunk(claim);
+        m_done.notify_all();
+    }
+}
+
+// ---- Results ----------------------------------------------------------------
+
+bool CollisionQueryJobs::Poll(QueryHandle h) const
+{
+    if (h.generation != m_generation || h.id >= m_kicked)
+        return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return h.id < m_completed;
+}
+
+const CollisionQueryJobs::Job& CollisionQueryJobs::JobOf(QueryHandle h) const
+{
+    // Batches are contiguous and ascending by first; owner-thread read.
+    auto it = std::upper_bound(m_batches.begin(), m_batches.end(), h.id,
+        [](uint32_t id, const std::unique_ptr<Batch>& b) { return id < b->first; });
+    const Batch& b = **(it - 1);
+    return b.jobs[h.id - b.first];
+}
+
+const QueryJobResult& CollisionQueryJobs::Wait(QueryHandle h)
+{
+    if (h.generation != m_generation || h.id >= m_submitted)
+        return m_invalidResult;
+    if (h.id >= m_kicked)
+        Kick();
+
+    // The caller is worker 0: it runs chunks until h is published.
+    CollisionQueryContext* ctx = m_contexts[0].get();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (h.id >= m_completed) {
+        Claim claim;
+        if (TryClaim(claim)) {
+            lock.unlock();
+            RunChunk(claim, ctx);
+            lock.lock();
+            FinishChunk(claim);
+            m_done.notify_all();
+            continue;
+        }
+        m_done.wait(lock);
+    }
+    lock.unlock();
+    return JobOf(h).result;
+}
+
+void CollisionQueryJobs::WaitAll()
+{
+    Kick();
+    if (m_kicked == 0)
+        return;
+    QueryHandle last;
+    last.id = m_kicked - 1;
+    last.generation = m_generation;
+    Wait(last);
+}
+
+void CollisionQueryJobs::Reset()
+{
+    WaitAll();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batches.clear();
+        m_completed = 0;
+        m_claimBatch = 0;
+        m_publishBatch = 0;
+    }
+    m_submitted = 0;
+    m_kicked = 0;
+    ++m_generation;
+}
+
+QueryJobStats CollisionQueryJobs::GetStats() const
+{
+    QueryJobStats s;
+    s.submitted = m_submitted;
+    s.kicked = m_kicked;
+    s.workers = GetWorkerCount();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.completed = m_completed;
+    s.batches = static_cast<uint32_t>(m_batches.size());
+    return s;
+}
+
+}} // namespace Engine::Collision
@@ -0,0 +1,171 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/28-async-query-jobs.md
+//
+// TERMINOLOGY:
+//   Job     - one submitted sweep, overlap or ray with its result slot
+//   Handle  - submission sequence number + generation; valid until Reset
+//   Batch   - contiguous handle range handed to the workers by Kick
+//   Chunk   - kChunkSize consecutive jobs of a batch, claimed by one worker
+//   Worker  - thread index in [0, workerCount); worker 0 is the caller,
+//             which runs chunks while it waits
+//
+// POLICY:
+//   - A job reads only its own input and the static CollisionWorld, through
+//     its worker's CollisionQueryContext (no local set, no memo). Chunk-to-
+//     worker assignment therefore cannot change results.
+//   - Completion is published in submission order: Poll(h) is true only
+//     once every job submitted before h is complete too.
+//   - Submissions collect in an open batch. It is kicked when it reaches
+//     kBatchSize, on Kick(), or by a Wait that needs it.
+//   - A ray is a zero-radius, zero-skin capsule sweep along dir *
+//     maxDistance; hit distance = t * maxDistance.
+//
+// CONTRACT:
+//   - Submit/Kick/Poll/Wait/Reset come from one owning thread.
+//   - CollisionWorld::BuildStatic must not run while jobs are in flight.
+//   - Results stay readable until Reset(). SetWorkerCount() and Reset()
+//     wait for all in-flight work first.
+//
+// PROOF POINTS:
+//   - Results equal the synchronous CollisionWorld calls bit for bit for 1
+//     and N workers (ExpectQueryJobsEquivalence in SqBackendHarness.cpp).
+// =========================================================================
+
+#include "CollisionWorldLegacy.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine { namespace Collision {
+
+enum class QueryJobKind : uint8_t { Sweep = 0, Overlap = 1, Ray = 2 };
+
+static constexpr uint32_t kQueryJobMaxContacts = 16;
+
+struct QueryHandle {
+    uint32_t id = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+    bool IsValid() const { return id != 0xFFFFFFFFu; }
+};
+
+struct QueryJobResult {
+    QueryJobKind kind = QueryJobKind::Sweep;
+    sq::Hit hit{};                 // Sweep, Ray
+    uint32_t contactCount = 0;     // Overlap
+    sq::OverlapContact contacts[kQueryJobMaxContacts]{};
+};
+
+struct QueryJobStats {
+    uint32_t submitted = 0;   // since Reset
+    uint32_t kicked = 0;      // handed to workers
+    uint32_t completed = 0;   // published prefix
+    uint32_t batches = 0;
+    uint32_t workers = 0;
+};
+
+class CollisionQueryJobs {
+public:
+    static constexpr uint32_t kChunkSize = 16;
+    static constexpr uint32_t kBatchSize = 256;  // multiple of kChunkSize
+    static_assert(kBatchSize % kChunkSize == 0, "batches must hold whole chunks");
+
+    explicit CollisionQueryJobs(const CollisionWorldLegacy* world);
+    ~CollisionQueryJobs();
+
+    CollisionQueryJobs(const CollisionQueryJobs&) = delete;
+    CollisionQueryJobs& operator=(const CollisionQueryJobs&) = delete;
+
+    // 0 or 1 = caller thread only (jobs run inside Wait).
+    void SetWorkerCount(uint32_t workers);
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_contexts.size()); }
+
+    QueryHandle SubmitSweep(const sq::SweepCapsuleInput& in, const sq::SweepConfig& cfg,
+                            QueryMask queryMask = Q_Solid,
+                            const sq::SweepFilter& filter = sq::SweepFilter{},
+                            bool rejectInitialOverlap = false);
+    // OverlapCapsuleContacts, up to min(maxContacts, kQueryJobMaxContacts).
+    QueryHandle SubmitOverlap(const sq::Vec3& segA, const sq::Vec3& segB, float radius,
+                              QueryMask queryMask = Q_Solid,
+                              uint32_t maxContacts = kQueryJobMaxContacts);
+    // dir must be unit length.
+    QueryHandle SubmitRay(const sq::Vec3& origin, const sq::Vec3& dir, float maxDistance,
+                          QueryMask queryMask = Q_Solid);
+
+    // Hands the open batch to the workers.
+    void Kick();
+
+    // Poll never blocks or kicks. Wait kicks h's batch if needed and runs
+    // chunks on the caller until h is published. Handles from before the
+    // last Reset() get an empty result.
+    bool Poll(QueryHandle h) const;
+    const QueryJobResult& Wait(QueryHandle h);
+    void WaitAll();
+
+    // Waits, then drops every result; older handles become invalid.
+    void Reset();
+
+    QueryJobStats GetStats() const;
+
+private:
+    struct Job {
+        QueryJobKind kind = QueryJobKind::Sweep;
+        sq::SweepCapsuleInput in{};
+        sq::SweepConfig cfg{};
+        sq::SweepFilter filter{};
+        QueryMask queryMask = Q_Solid;
+        bool rejectInitialOverlap = false;
+        uint32_t maxContacts = 0;
+        QueryJobResult result{};
+    };
+
+    struct Batch {
+        uint32_t first = 0;              // handle id of jobs[0]
+        std::vector<Job> jobs;
+        std::vector<uint8_t> chunkDone;  // guarded by m_mutex
+        uint32_t chunkCount = 0;
+        uint32_t nextChunk = 0;          // guarded by m_mutex
+        uint32_t publishedChunks = 0;    // guarded by m_mutex
+    };
+
+    struct Claim {
+        Batch* batch = nullptr;
+        uint32_t chunk = 0;
+    };
+
+    QueryHandle Push(const Job& job);
+    bool TryClaim(Claim& out);           // m_mutex held
+    bool HasClaimable() const;           // m_mutex held
+    void RunChunk(const Claim& claim, CollisionQueryContext* ctx);
+    void FinishChunk(const Claim& claim); // m_mutex held
+    const Job& JobOf(QueryHandle h) const;
+    void WorkerMain(uint32_t worker);
+    void StopWorkers();
+
+    const CollisionWorldLegacy* m_world;
+
+    std::vector<Job> m_open;                      // owner thread only
+    std::vector<std::unique_ptr<Batch>> m_batches; // appended under m_mutex
+    uint32_t m_submitted = 0;
+    uint32_t m_kicked = 0;
+    uint32_t m_generation = 1;
+    QueryJobResult m_invalidResult{};             // Wait on a stale or foreign handle
+
+    // One query context per worker; index 0 belongs to the calling thread.
+    std::vector<std::unique_ptr<CollisionQueryContext>> m_contexts;
+    std::vector<std::thread> m_threads;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;   // workers: new batch or shutdown
+    std::condition_variable m_done;   // owner: published prefix advanced
+    uint32_t m_completed = 0;         // guarded by m_mutex
+    uint32_t m_claimBatch = 0;        // first batch with unclaimed chunks
+    uint32_t m_publishBatch = 0;      // first batch not fully published
+    bool m_shutdown = false;
+};
+
+}} // namespace Engine::Collision
@@ -1,6 +1,6 @@
 #include "CollisionWorldLegacy.h"
 #include "SceneQuery/SqBroadphase.h"  // CapsuleAabbStatic
-#include "SceneQuery/SqPrimitiveTests.h"  // TestAabbAabb
+#include <algorithm>
 #include <cstdio>
 #include <Windows.h>  // OutputDebugStringA
 
@@ -9,41 +9,100 @@ namespace Engine { namespace Collision {
 void CollisionWorldLegacy::BuildStatic(const ColliderDesc* colliders, uint32_t count)
 {
     ResetSceneQueryFrameMetrics();
+    sq::ClearLocalQuerySet(m_mainContext.localSet);
+    sq::ClearQueryMemo(m_mainContext.memo);
 
     m_descs.assign(colliders, colliders + count);
+    m_gap.reset();
 
-    // Partition: solid AABBs + solid Tris for BVH, trigger indices for linear scan
+    // Partition: solid AABBs + solid Tris for BVH, solid planes and
+    // heightfields beside it, trigger indices for the trigger BVH
     m_solidRemap.clear();
     m_sqAabbs.clear();
     m_solidTriRemap.clear();
     m_sqTris.clear();
+    m_sqTriEdgeFlags.clear();
+    m_planes.clear();
+    m_planeRemap.clear();
+    m_heightfields.clear();
+    m_heightfieldRemap.clear();
     m_triggerIds.clear();
+    m_triggerAabbs.clear();
 
     for (uint32_t i = 0; i < count; ++i) {
         if (colliders[i].kind == ColliderKind::Trigger) {
             m_triggerIds.push_back(i);  // ascending (loop order)
+            m_triggerAabbs.push_back(colliders[i].bounds);
+        } else if (colliders[i].shape == ColliderShape::Plane) {
+            m_planeRemap.push_back(i);  // plane j → m_descs index i
+            m_planes.push_back(colliders[i].plane);
+            m_planes.back().mask = colliders[i].mask;
+        } else if (colliders[i].shape == ColliderShape::Heightfield) {
+            if (!colliders[i].heightfield)
+                continue;
+            m_heightfieldRemap.push_back(i);  // heightfield j → m_descs index i
+            m_heightfields.push_back(*colliders[i].heightfield);
+            m_heightfields.back().mask = colliders[i].mask;
+            m_descs[i].heightfield = nullptr;  // the caller's copy may not outlive us
         } else if (colliders[i].shape == ColliderShape::Tri) {
             m_solidTriRemap.push_back(i);  // BVH tri j → m_descs index i
             m_sqTris.push_back(colliders[i].triVerts);
+            m_sqTriEdgeFlags.push_back(colliders[i].triEdgeFlags);
         } else {
             m_solidRemap.push_back(i);  // BVH AABB j → m_descs index i
             m_sqAabbs.push_back(colliders[i].bounds);
         }
     }
 
+    // Spatial splits only cut triangles; an all-box world builds as before.
+    sq::BuildCtx buildCtx{};
+    buildCtx.spatialSplits = true;
     m_bvh = sq::BuildStaticBVH(
         m_sqAabbs.data(), static_cast<uint32_t>(m_sqAabbs.size()),
         nullptr, 0,
-        m_sqTris.data(), static_cast<uint32_t>(m_sqTris.size()));
+        m_sqTris.data(), static_cast<uint32_t>(m_sqTris.size()),
+        buildCtx);
+
+    sq::SetStaticBVHTriEdgeFlags(m_bvh, m_sqTriEdgeFlags.data());
+    if (m_triPrecompEnabled)
+        sq::BuildTrianglePrecomp(m_sqTris.data(), static_cast<uint32_t>(m_sqTris.size()),
+                                 m_sqTriPrecomp);
+    else
+        m_sqTriPrecomp.clear();
+    sq::SetStaticBVHTriPrecomp(m_bvh, m_sqTriPrecomp.empty() ? nullptr : m_sqTriPrecomp.data());
+
+    m_descToPrim.assign(count, sq::kInvalidBVHNode);
+    m_primMasks.resize(m_bvh.prims.size());
+    for (uint32_t p = 0; p < static_cast<uint32_t>(m_bvh.prims.size()); ++p) {
+        const sq::PrimRef& pref = m_bvh.prims[p];
+        const uint32_t desc = (pref.type == sq::PrimType::Tri)
+            ? m_solidTriRemap[pref.index]
+            : m_solidRemap[pref.index];
+        m_descToPrim[desc] = p;
+        m_primMasks[p] = m_descs[desc].mask;
+    }
+    sq::SetStaticBVHPrimMasks(m_bvh, m_primMasks.data());
+
+    m_triggerBvh = sq::BuildStaticBVH(
+        m_triggerAabbs.data(), static_cast<uint32_t>(m_triggerAabbs.size()),
+        nullptr, 0, nullptr, 0);
+    m_primMasks.resize(m_triggerBvh.prims.size());
+    for (uint32_t p = 0; p < static_cast<uint32_t>(m_triggerBvh.prims.size()); ++p)
+        m_primMasks[p] = m_descs[m_triggerIds[m_triggerBvh.prims[p].index]].mask;
+    sq::SetStaticBVHPrimMasks(m_triggerBvh, m_primMasks.data());
+    ++m_staticEpoch;
 
     char buf[256];
-    sprintf_s(buf, "[COLLWORLD_INIT] total=%u solidAABB=%u solidTri=%u trigger=%u nodes=%u prims=%u\n",
+    sprintf_s(buf, "[COLLWORLD_INIT] total=%u solidAABB=%u solidTri=%u plane=%u heightfield=%u trigger=%u nodes=%u prims=%u refs=%u\n",
         count,
         static_cast<uint32_t>(m_solidRemap.size()),
         static_cast<uint32_t>(m_solidTriRemap.size()),
+        static_cast<uint32_t>(m_planes.size()),
+        static_cast<uint32_t>(m_heightfields.size()),
         static_cast<uint32_t>(m_triggerIds.size()),
         static_cast<uint32_t>(m_bvh.nodes.size()),
-        static_cast<uint32_t>(m_bvh.prims.size()));
+        static_cast<uint32_t>(m_bvh.prims.size()),
+        static_cast<uint32_t>(m_bvh.primIdx.size()));
     OutputDebugStringA(buf);
 }
 
@@ -52,47 +111,286 @@ void CollisionWorldLegacy::BuildStatic(const std::vector<ColliderDesc>& collider
     BuildStatic(colliders.data(), static_cast<uint32_t>(colliders.size()));
 }
 
+void CollisionWorldLegacy::SwapStatic(CollisionWorldLegacy& built)
+{
+    ResetSceneQueryFrameMetrics();
+    sq::ClearLocalQuerySet(m_mainContext.localSet);
+    sq::ClearQueryMemo(m_mainContext.memo);
+
+    m_descs.swap(built.m_descs);
+    m_sqAabbs.swap(built.m_sqAabbs);
+    m_sqTris.swap(built.m_sqTris);
+    m_solidRemap.swap(built.m_solidRemap);
+    m_solidTriRemap.swap(built.m_solidTriRemap);
+    m_sqTriEdgeFlags.swap(built.m_sqTriEdgeFlags);
+    m_sqTriPrecomp.swap(built.m_sqTriPrecomp);
+    m_planes.swap(built.m_planes);
+    m_planeRemap.swap(built.m_planeRemap);
+    m_heightfields.swap(built.m_heightfields);
+    m_heightfieldRemap.swap(built.m_heightfieldRemap);
+    m_triggerIds.swap(built.m_triggerIds);
+    m_triggerAabbs.swap(built.m_triggerAabbs);
+    m_primMasks.swap(built.m_primMasks);
+    m_descToPrim.swap(built.m_descToPrim);
+    std::swap(m_bvh, built.m_bvh);
+    std::swap(m_triggerBvh, built.m_triggerBvh);
+
+    // Epochs stay unique for this world whatever built counted.
+    const uint32_t epoch = m_staticEpoch;
+    m_staticEpoch = epoch + 1;
+    built.m_staticEpoch = epoch;
+
+    // The gap patch started at the old registry size. Entries the published
+    // registry reaches are dropped; the rest move down to its end. A smaller
+    // registry (colliders removed) drops the whole patch.
+    if (m_gap) {
+        const uint32_t base = static_cast<uint32_t>(built.m_descs.size());
+        const uint32_t published = static_cast<uint32_t>(m_descs.size());
+        const uint32_t gapCount = m_gap->getStaticColliderCount();
+        if (published < base || published >= base + gapCount) {
+            m_gap.reset();
+        } else {
+            const std::vector<ColliderDesc> tail(m_gap->m_descs.begin() + (published - base),
+                                                 m_gap->m_descs.end());
+            BuildGap(tail.data(), static_cast<uint32_t>(tail.size()));
+        }
+    }
+}
+
+void CollisionWorldLegacy::SetGapColliders(const ColliderDesc* appended, uint32_t count)
+{
+    sq::ClearLocalQuerySet(m_mainContext.localSet);
+    sq::ClearQueryMemo(m_mainContext.memo);
+    BuildGap(appended, count);
+    ++m_staticEpoch;
+}
+
+void CollisionWorldLegacy::ClearGapColliders()
+{
+    if (!m_gap)
+        return;
+    sq::ClearLocalQuerySet(m_mainContext.localSet);
+    sq::ClearQueryMemo(m_mainContext.memo);
+    m_gap.reset();
+    ++m_staticEpoch;
+}
+
+void CollisionWorldLegacy::BuildGap(const ColliderDesc* appended, uint32_t count)
+{
+    if (count == 0) {
+        m_gap.reset();
+        return;
+    }
+    if (!m_gap)
+        m_gap = std::make_unique<CollisionWorldLegacy>();
+    m_gap->SetQueryTraversal(m_traversal);
+    m_gap->SetTrianglePrecomp(m_triPrecompEnabled);
+    m_gap->BuildStatic(appended, count);
+}
+
 sq::Hit CollisionWorldLegacy::SweepCapsuleClosest(
     const sq::SweepCapsuleInput& in,
     const sq::SweepConfig& cfg,
-    QueryMask /*queryMask*/,
+    QueryMask queryMask,
+    const sq::SweepFilter& filter,
+    bool rejectInitialOverlap,
+    CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::Hit hit = c.memo.active
+        ? SweepCapsuleClosestMemo(c, in, cfg, queryMask, filter, rejectInitialOverlap)
+        : SweepCapsuleClosestStatic(c, in, cfg, queryMask, filter, rejectInitialOverlap);
+    if (m_gap) {
+        // Remap keeps registry order within a primitive type, so BetterHit on
+        // registry indices breaks ties the way a full build would.
+        sq::Hit gap = m_gap->SweepCapsuleClosest(in, cfg, queryMask, filter,
+                                                 rejectInitialOverlap, &GapCtx(c));
+        gap.index += static_cast<uint32_t>(m_descs.size());
+        if (gap.hit && (!hit.hit || sq::BetterHit(gap.t, gap.type, gap.index, gap.featureId,
+                                                  hit.t, hit.type, hit.index, hit.featureId,
+                                                  cfg.tieEpsT)))
+            hit = gap;
+    }
+    return hit;
+}
+
+sq::Hit CollisionWorldLegacy::SweepCapsuleClosestStatic(
+    CollisionQueryContext& c,
+    const sq::SweepCapsuleInput& in,
+    const sq::SweepConfig& cfg,
+    QueryMask queryMask,
     const sq::SweepFilter& filter,
     bool rejectInitialOverlap) const
 {
     // BVH contains only Solid colliders. Triggers excluded at BuildStatic.
-    sq::Hit hit = sq::SweepCapsuleClosestHit_Fast(m_bvh, in, cfg, m_scratch,
-                                                  filter, rejectInitialOverlap);
-    sq::AccumulateQueryMetrics(m_sceneQueryFrameMetrics, m_scratch.metrics);
-    if (hit.hit) {
-        // Remap BVH-local index → m_descs index by primitive type
-        if (hit.type == sq::PrimType::Tri)
-            hit.index = m_solidTriRemap[hit.index];
-        else
-            hit.index = m_solidRemap[hit.index];
+    // Node mask unions prune layers the query cannot see.
+    sq::Hit hit;
+    if (sq::LocalQuerySetContains(c.localSet, sq::SweptCapsuleBounds(in, cfg))) {
+        hit = sq::SweepCapsuleClosestHit_LocalSet(m_bvh, c.localSet, in, cfg,
+                                                  c.scratch.metrics,
+                                                  filter, rejectInitialOverlap, queryMask);
+    } else {
+        if (m_traversal == QueryTraversal::ShortStack) {
+            hit = sq::SweepCapsuleClosestHit_ShortStack(m_bvh, in, cfg, c.shortStack,
+                                                        filter, rejectInitialOverlap, queryMask);
+            c.scratch.metrics = c.shortStack.metrics;
+        } else {
+            hit = sq::SweepCapsuleClosestHit_Fast(m_bvh, in, cfg, c.scratch,
+                                                  filter, rejectInitialOverlap, queryMask);
+        }
+        c.scratch.metrics.localSetMiss = c.localSet.active;
     }
+    sq::SweepCapsuleClosestHit_Planes(m_planes.data(), static_cast<uint32_t>(m_planes.size()),
+                                      in, cfg, filter, rejectInitialOverlap, hit,
+                                      &c.scratch.metrics, queryMask);
+    sq::SweepCapsuleClosestHit_Heightfields(m_heightfields.data(),
+                                            static_cast<uint32_t>(m_heightfields.size()),
+                                            in, cfg, filter, rejectInitialOverlap, hit,
+                                            &c.scratch.metrics, queryMask);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+    RemapHit(hit);
+    return hit;
+}
+
+sq::Hit CollisionWorldLegacy::SweepCapsuleClosestMemo(
+    CollisionQueryContext& c,
+    const sq::SweepCapsuleInput& in,
+    const sq::SweepConfig& cfg,
+    QueryMask queryMask,
+    const sq::SweepFilter& filter,
+    bool rejectInitialOverlap) const
+{
+    const sq::SweepMemoKey key = sq::MakeSweepMemoKey(in, cfg, queryMask);
+
+    // Exact repeat: stored result is already remapped.
+    if (const sq::Hit* cached = sq::FindSweepMemoResult(c.memo, key, filter, rejectInitialOverlap)) {
+        sq::ResetQueryMetrics(c.scratch.metrics, sq::QueryKind::SweepCapsuleClosest,
+                              sq::QueryBackend::Memo);
+        sq::FinishSweepQueryMetrics(c.scratch.metrics, *cached);
+        sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+        return *cached;
+    }
+
+    // Same geometry, different filter/flags: rerun narrowphase only.
+    // Filters act per feature inside the kernels, so a stored closest hit
+    // cannot be re-filtered; the unfiltered candidate list can.
+    sq::SweepMemoCandidateSlot* slot = sq::FindSweepMemoCandidates(c.memo, key);
+    if (slot) {
+        sq::ResetQueryMetrics(c.scratch.metrics, sq::QueryKind::SweepCapsuleClosest,
+                              sq::QueryBackend::Memo);
+        c.scratch.metrics.memoRefilter = true;
+    } else {
+        slot = &sq::ClaimSweepMemoCandidates(c.memo, key);
+        if (sq::LocalQuerySetContains(c.localSet, sq::SweptCapsuleBounds(in, cfg))) {
+            sq::CollectSweepCandidates_LocalSet(c.localSet, in, cfg,
+                                                c.scratch.metrics, slot->candidates,
+                                                queryMask);
+        } else {
+            sq::CollectSweepCandidates(m_bvh, in, cfg, c.scratch, slot->candidates,
+                                       queryMask);
+            c.scratch.metrics.localSetMiss = c.localSet.active;
+        }
+    }
+
+    sq::Hit hit = sq::SweepCapsuleClosestHit_Candidates(
+        m_bvh, slot->candidates.data(), static_cast<uint32_t>(slot->candidates.size()),
+        in, cfg, filter, rejectInitialOverlap, c.scratch.metrics);
+    sq::SweepCapsuleClosestHit_Planes(m_planes.data(), static_cast<uint32_t>(m_planes.size()),
+                                      in, cfg, filter, rejectInitialOverlap, hit,
+                                      &c.scratch.metrics, queryMask);
+    sq::SweepCapsuleClosestHit_Heightfields(m_heightfields.data(),
+                                            static_cast<uint32_t>(m_heightfields.size()),
+                                            in, cfg, filter, rejectInitialOverlap, hit,
+                                            &c.scratch.metrics, queryMask);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+    RemapHit(hit);
+    sq::StoreSweepMemoResult(c.memo, key, filter, rejectInitialOverlap, hit);
+    return hit;
+}
+
+sq::Hit CollisionWorldLegacy::SweepCapsuleAgainstCollider(
+    uint32_t colliderIndex,
+    const sq::SweepCapsuleInput& in,
+    const sq::SweepConfig& cfg,
+    const sq::SweepFilter& filter,
+    bool rejectInitialOverlap,
+    CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    if (m_gap && colliderIndex >= m_descs.size()) {
+        const uint32_t base = static_cast<uint32_t>(m_descs.size());
+        sq::Hit gap = m_gap->SweepCapsuleAgainstCollider(colliderIndex - base, in, cfg, filter,
+                                                         rejectInitialOverlap, &GapCtx(c));
+        if (gap.hit)
+            gap.index += base;
+        return gap;
+    }
+    sq::ResetQueryMetrics(c.scratch.metrics, sq::QueryKind::SweepCapsuleClosest,
+                          sq::QueryBackend::SinglePrim);
+    sq::Hit hit{};
+    hit.hit = false;
+    hit.t = 1.0f;
+    const uint32_t plane = PlaneOfDesc(colliderIndex);
+    const uint32_t heightfield = HeightfieldOfDesc(colliderIndex);
+    if (plane != sq::kInvalidBVHNode) {
+        sq::SweepCapsuleClosestHit_Planes(&m_planes[plane], 1, in, cfg, filter,
+                                          rejectInitialOverlap, hit, &c.scratch.metrics);
+        if (hit.hit)
+            hit.index = plane;
+    } else if (heightfield != sq::kInvalidBVHNode) {
+        sq::SweepCapsuleClosestHit_Heightfields(&m_heightfields[heightfield], 1, in, cfg, filter,
+                                                rejectInitialOverlap, hit, &c.scratch.metrics);
+        if (hit.hit)
+            hit.index = heightfield;
+    } else if (colliderIndex < m_descToPrim.size() &&
+        m_descToPrim[colliderIndex] != sq::kInvalidBVHNode) {
+        const sq::AABB cap0 = sq::CapsuleAabbAtT(in, 0.0f, cfg.skin);
+        sq::ConsiderSweepCapsulePrim(m_bvh, in, cfg, cap0,
+                                     m_bvh.prims[m_descToPrim[colliderIndex]],
+                                     0.0f, hit.t, filter, rejectInitialOverlap,
+                                     hit, &c.scratch.metrics);
+    }
+    sq::FinishSweepQueryMetrics(c.scratch.metrics, hit);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+    RemapHit(hit);
     return hit;
 }
 
 uint32_t CollisionWorldLegacy::OverlapCapsule(
     const sq::Vec3& segA, const sq::Vec3& segB,
     float radius, QueryMask queryMask,
-    uint32_t* outIds, uint32_t maxIds) const
+    uint32_t* outIds, uint32_t maxIds,
+    CollisionQueryContext* ctx) const
 {
     if (maxIds == 0) return 0;
 
     sq::AABB capBounds = sq::CapsuleAabbStatic(segA, segB, radius);
     uint32_t count = 0;
 
-    // Trigger overlap: linear scan of m_triggerIds (ascending by construction)
+    // Trigger overlap via the trigger BVH. Prim order follows m_triggerIds,
+    // so the sorted gather maps to ascending m_descs indices.
     if (queryMask & Q_Trigger) {
-        for (uint32_t idx : m_triggerIds) {
+        CollisionQueryContext& c = Ctx(ctx);
+        sq::OverlapAabbPrims_Fast(m_triggerBvh, capBounds, c.scratch, c.triggerHits, queryMask);
+        sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+        for (uint32_t j : c.triggerHits) {
             if (count >= maxIds) break;
-            if (!(m_descs[idx].mask & queryMask)) continue;
-            if (!sq::TestAabbAabb(capBounds, m_descs[idx].bounds)) continue;
-            outIds[count++] = idx;  // m_descs index, ascending (deterministic)
+            outIds[count++] = m_triggerIds[j];
         }
     }
 
+    // Gap triggers follow the registry, so the ids stay ascending.
+    if (m_gap && count < maxIds) {
+        CollisionQueryContext& c = Ctx(ctx);
+        const uint32_t base = static_cast<uint32_t>(m_descs.size());
+        const uint32_t gapCount = m_gap->OverlapCapsule(segA, segB, radius, queryMask,
+                                                        outIds + count, maxIds - count,
+                                                        &GapCtx(c));
+        for (uint32_t i = 0; i < gapCount; ++i)
+            outIds[count + i] += base;
+        count += gapCount;
+    }
+
     // NOTE: Solid overlap via BVH not implemented here.
     // Use OverlapCapsuleContacts for solid overlap with narrowphase.
 
@@ -101,36 +399,319 @@ uint32_t CollisionWorldLegacy::OverlapCapsule(
 
 uint32_t CollisionWorldLegacy::OverlapCapsuleContacts(
     const sq::Vec3& segA, const sq::Vec3& segB,
-    float radius, QueryMask /*queryMask*/,
+    float radius, QueryMask queryMask,
+    sq::OverlapContact* outContacts, uint32_t maxContacts,
+    CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    uint32_t count = OverlapCapsuleContactsStatic(c, segA, segB, radius, queryMask,
+                                                  outContacts, maxContacts);
+    if (!m_gap)
+        return count;
+
+    // Both lists are in OverlapContactBetter order and gap indices follow
+    // the registry; merge them and keep the best maxContacts.
+    std::vector<sq::OverlapContact>& merged = c.gapContacts;
+    merged.resize(static_cast<size_t>(count) + maxContacts);
+    std::copy(outContacts, outContacts + count, merged.begin());
+    const uint32_t gapCount = m_gap->OverlapCapsuleContacts(segA, segB, radius, queryMask,
+                                                            merged.data() + count, maxContacts,
+                                                            &GapCtx(c));
+    const uint32_t base = static_cast<uint32_t>(m_descs.size());
+    for (uint32_t i = 0; i < gapCount; ++i)
+        merged[count + i].index += base;
+    std::inplace_merge(merged.begin(), merged.begin() + count, merged.begin() + count + gapCount,
+                       sq::OverlapContactBetter);
+    count = (std::min)(count + gapCount, maxContacts);
+    std::copy(merged.begin(), merged.begin() + count, outContacts);
+    return count;
+}
+
+uint32_t CollisionWorldLegacy::OverlapCapsuleContactsStatic(
+    CollisionQueryContext& c,
+    const sq::Vec3& segA, const sq::Vec3& segB,
+    float radius, QueryMask queryMask,
     sq::OverlapContact* outContacts, uint32_t maxContacts) const
 {
+    if (c.memo.active) {
+        if (const sq::OverlapMemoSlot* cached =
+                sq::FindOverlapMemo(c.memo, segA, segB, radius, maxContacts, queryMask)) {
+            std::copy(cached->contacts, cached->contacts + cached->count, outContacts);
+            sq::ResetQueryMetrics(c.scratch.metrics, sq::QueryKind::OverlapCapsuleContacts,
+                                  sq::QueryBackend::Memo);
+            sq::FinishOverlapQueryMetrics(c.scratch.metrics, cached->count);
+            sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+            return cached->count;
+        }
+    }
+
     // BVH contains only Solid colliders. Triggers excluded at BuildStatic.
-    uint32_t count = sq::OverlapCapsuleContacts_Fast(
-        m_bvh, segA, segB, radius, outContacts, maxContacts, m_scratch);
-    sq::AccumulateQueryMetrics(m_sceneQueryFrameMetrics, m_scratch.metrics);
-    // Remap: BVH prim index → m_descs index by primitive type
-    for (uint32_t i = 0; i < count; ++i) {
-        if (outContacts[i].type == sq::PrimType::Tri)
-            outContacts[i].index = m_solidTriRemap[outContacts[i].index];
+    uint32_t count = 0;
+    if (sq::LocalQuerySetContains(c.localSet, sq::CapsuleAabbStatic(segA, segB, radius))) {
+        count = sq::OverlapCapsuleContacts_LocalSet(
+            m_bvh, c.localSet, segA, segB, radius, outContacts, maxContacts,
+            c.scratch.metrics, queryMask);
+    } else {
+        if (m_traversal == QueryTraversal::ShortStack) {
+            count = sq::OverlapCapsuleContacts_ShortStack(
+                m_bvh, segA, segB, radius, outContacts, maxContacts, c.shortStack, queryMask);
+            c.scratch.metrics = c.shortStack.metrics;
+        } else {
+            count = sq::OverlapCapsuleContacts_Fast(
+                m_bvh, segA, segB, radius, outContacts, maxContacts, c.scratch, queryMask);
+        }
+        c.scratch.metrics.localSetMiss = c.localSet.active;
+    }
+    count = sq::OverlapCapsuleContacts_Planes(
+        m_planes.data(), static_cast<uint32_t>(m_planes.size()), segA, segB, radius,
+        outContacts, maxContacts, count, &c.scratch.metrics, queryMask);
+    count = sq::OverlapCapsuleContacts_Heightfields(
+        m_heightfields.data(), static_cast<uint32_t>(m_heightfields.size()), segA, segB, radius,
+        outContacts, maxContacts, count, &c.scratch.metrics, queryMask);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+    RemapContacts(outContacts, count);
+    if (c.memo.active)
+        sq::StoreOverlapMemo(c.memo, segA, segB, radius, maxContacts, outContacts, count,
+                             queryMask);
+    return count;
+}
+
+void CollisionWorldLegacy::UpdateTriggerPairs(
+    sq::TriggerPairCache& cache, uint32_t actor,
+    const sq::Vec3& segA, const sq::Vec3& segB,
+    float radius, QueryMask queryMask,
+    std::vector<sq::TriggerPairEvent>& events,
+    CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::ResetQueryMetrics(c.scratch.metrics, sq::QueryKind::Unknown, sq::QueryBackend::BinaryBVH);
+    sq::UpdateTriggerActor(cache, m_triggerBvh, m_triggerIds.data(), m_staticEpoch, actor,
+                           sq::CapsuleAabbStatic(segA, segB, radius), queryMask,
+                           c.scratch, events);
+    if (c.scratch.metrics.kind == sq::QueryKind::OverlapAabb)
+        sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+}
+
+sq::ClosestPointResult CollisionWorldLegacy::ClosestPointCapsule(
+    const sq::Vec3& segA, const sq::Vec3& segB,
+    float radius, float maxDistance,
+    QueryMask queryMask,
+    CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::ClosestPointResult result = sq::ClosestPointCapsule_Fast(
+        m_bvh, segA, segB, radius, maxDistance, c.scratch, queryMask);
+    for (uint32_t j = 0; j < static_cast<uint32_t>(m_planes.size()); ++j)
+        sq::ConsiderClosestPointPlane(m_planes[j], j, segA, segB, radius, maxDistance,
+                                      result, &c.scratch.metrics, queryMask);
+    for (uint32_t j = 0; j < static_cast<uint32_t>(m_heightfields.size()); ++j)
+        sq::ConsiderClosestPointHeightfield(m_heightfields[j], j, segA, segB, radius, maxDistance,
+                                            result, &c.scratch.metrics, queryMask);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+    if (result.hit) {
+        if (result.type == sq::PrimType::Plane)
+            result.index = m_planeRemap[result.index];
+        else if (result.type == sq::PrimType::Heightfield)
+            result.index = m_heightfieldRemap[result.index];
+        else if (result.type == sq::PrimType::Tri)
+            result.index = m_solidTriRemap[result.index];
         else
-            outContacts[i].index = m_solidRemap[outContacts[i].index];
+            result.index = m_solidRemap[result.index];
+    }
+    if (m_gap) {
+        sq::ClosestPointResult gap = m_gap->ClosestPointCapsule(segA, segB, radius, maxDistance,
+                                                                queryMask, &GapCtx(c));
+        // (distance, type, index) order; registry indices sort before gap ones.
+        if (gap.hit && (!result.hit || gap.distance < result.distance ||
+                        (gap.distance == result.distance &&
+                         static_cast<uint8_t>(gap.type) < static_cast<uint8_t>(result.type)))) {
+            gap.index += static_cast<uint32_t>(m_descs.size());
+            result = gap;
+        }
+    }
+    return result;
+}
+
+float CollisionWorldLegacy::DistanceToWorld(const sq::Vec3& point, float maxDistance,
+                                            QueryMask queryMask,
+                                            CollisionQueryContext* ctx) const
+{
+    const sq::ClosestPointResult result = ClosestPointCapsule(point, point, 0.0f,
+                                                              maxDistance, queryMask, ctx);
+    return result.hit ? result.distance : maxDistance;
+}
+
+uint32_t CollisionWorldLegacy::QueryKNearest(
+    const sq::Vec3& point, uint32_t k, QueryMask queryMask,
+    sq::KNearestHit* out, float maxDistance,
+    CollisionQueryContext* ctx) const
+{
+    if (k == 0 || queryMask == 0)
+        return 0;
+
+    CollisionQueryContext& c = Ctx(ctx);
+    auto descIndex = [this](sq::PrimType type, uint32_t index) {
+        return (type == sq::PrimType::Tri) ? m_solidTriRemap[index] : m_solidRemap[index];
+    };
+    uint32_t count = sq::KNearestPoint_Fast(m_bvh, point, k, maxDistance, out,
+                                            c.scratch, queryMask);
+
+    // Remap is ascending per type, so the (distance, type, index) order holds.
+    for (uint32_t i = 0; i < count; ++i)
+        out[i].index = descIndex(out[i].type, out[i].index);
+
+    // Planes, heightfields and triggers merge through the same bounded max-heap.
+    bool heaped = false;
+    for (uint32_t j = 0; j < static_cast<uint32_t>(m_planes.size()); ++j) {
+        if (!heaped) {
+            std::make_heap(out, out + count, sq::KNearestBefore);
+            heaped = true;
+        }
+        sq::ConsiderKNearestPlane(m_planes[j], m_planeRemap[j], point, maxDistance,
+                                  out, k, count, &c.scratch.metrics, queryMask);
+    }
+    for (uint32_t j = 0; j < static_cast<uint32_t>(m_heightfields.size()); ++j) {
+        if (!heaped) {
+            std::make_heap(out, out + count, sq::KNearestBefore);
+            heaped = true;
+        }
+        sq::ConsiderKNearestHeightfield(m_heightfields[j], m_heightfieldRemap[j], point, maxDistance,
+                                        out, k, count, &c.scratch.metrics, queryMask);
+    }
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+
+    for (uint32_t idx : m_triggerIds) {
+        const ColliderDesc& desc = m_descs[idx];
+        if (!(desc.mask & queryMask))
+            continue;
+        if (!heaped) {
+            std::make_heap(out, out + count, sq::KNearestBefore);
+            heaped = true;
+        }
+        const sq::AABB& b = desc.bounds;
+        sq::KNearestHit hit{};
+        hit.point = { (std::min)((std::max)(point.x, b.minX), b.maxX),
+                      (std::min)((std::max)(point.y, b.minY), b.maxY),
+                      (std::min)((std::max)(point.z, b.minZ), b.maxZ) };
+        hit.distance = sq::Len(point - hit.point);
+        hit.type = sq::PrimType::Aabb;
+        hit.index = idx;
+        if (hit.distance <= maxDistance)
+            sq::InsertKNearestHit(out, k, count, hit);
     }
+
+    if (m_gap) {
+        c.gapNearest.resize(k);
+        const uint32_t gapCount = m_gap->QueryKNearest(point, k, queryMask, c.gapNearest.data(),
+                                                       maxDistance, &GapCtx(c));
+        if (gapCount && !heaped) {
+            std::make_heap(out, out + count, sq::KNearestBefore);
+            heaped = true;
+        }
+        for (uint32_t i = 0; i < gapCount; ++i) {
+            sq::KNearestHit hit = c.gapNearest[i];
+            hit.index += static_cast<uint32_t>(m_descs.size());
+            sq::InsertKNearestHit(out, k, count, hit);
+        }
+    }
+    if (heaped)
+        std::sort_heap(out, out + count, sq::KNearestBefore);
     return count;
 }
 
-void CollisionWorldLegacy::ResetSceneQueryFrameMetrics() const
+void CollisionWorldLegacy::BeginLocalQuerySet(const sq::AABB& region,
+                                              CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::GatherLocalQuerySet(m_bvh, region, c.localSet, c.scratch);
+    sq::AccumulateQueryMetrics(c.frameMetrics, c.scratch.metrics);
+}
+
+void CollisionWorldLegacy::EndLocalQuerySet(CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    // Keep vector capacity for the next tick; only deactivate.
+    c.localSet.active = false;
+}
+
+void CollisionWorldLegacy::BeginQueryMemo(CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::ClearQueryMemo(c.memo);
+    c.memo.active = true;
+}
+
+void CollisionWorldLegacy::EndQueryMemo(CollisionQueryContext* ctx) const
+{
+    CollisionQueryContext& c = Ctx(ctx);
+    sq::ClearQueryMemo(c.memo);
+}
+
+// Position of colliderIndex in an ascending remap, or kInvalidBVHNode.
+static uint32_t FindInRemap(const std::vector<uint32_t>& remap, uint32_t colliderIndex)
+{
+    const auto it = std::lower_bound(remap.begin(), remap.end(), colliderIndex);
+    if (it == remap.end() || *it != colliderIndex)
+        return sq::kInvalidBVHNode;
+    return static_cast<uint32_t>(it - remap.begin());
+}
+
+uint32_t CollisionWorldLegacy::PlaneOfDesc(uint32_t colliderIndex) const
+{
+    // m_planeRemap is ascending (BuildStatic loop order).
+    return FindInRemap(m_planeRemap, colliderIndex);
+}
+
+uint32_t CollisionWorldLegacy::HeightfieldOfDesc(uint32_t colliderIndex) const
+{
+    return FindInRemap(m_heightfieldRemap, colliderIndex);
+}
+
+void CollisionWorldLegacy::RemapHit(sq::Hit& hit) const
+{
+    if (!hit.hit)
+        return;
+    // Remap BVH-local, plane or heightfield index → m_descs index by primitive type
+    if (hit.type == sq::PrimType::Plane)
+        hit.index = m_planeRemap[hit.index];
+    else if (hit.type == sq::PrimType::Heightfield)
+        hit.index = m_heightfieldRemap[hit.index];
+    else if (hit.type == sq::PrimType::Tri)
+        hit.index = m_solidTriRemap[hit.index];
+    else
+        hit.index = m_solidRemap[hit.index];
+}
+
+void CollisionWorldLegacy::RemapContacts(sq::OverlapContact* contacts, uint32_t count) const
+{
+    // Remap: BVH prim, plane or heightfield index → m_descs index by primitive type
+    for (uint32_t i = 0; i < count; ++i) {
+        if (contacts[i].type == sq::PrimType::Plane)
+            contacts[i].index = m_planeRemap[contacts[i].index];
+        else if (contacts[i].type == sq::PrimType::Heightfield)
+            contacts[i].index = m_heightfieldRemap[contacts[i].index];
+        else if (contacts[i].type == sq::PrimType::Tri)
+            contacts[i].index = m_solidTriRemap[contacts[i].index];
+        else
+            contacts[i].index = m_solidRemap[contacts[i].index];
+    }
+}
+
+void CollisionWorldLegacy::ResetSceneQueryFrameMetrics(CollisionQueryContext* ctx) const
 {
-    sq::ResetSceneQueryFrameMetrics(m_sceneQueryFrameMetrics);
+    sq::ResetSceneQueryFrameMetrics(Ctx(ctx).frameMetrics);
 }
 
-const sq::SceneQueryFrameMetrics& CollisionWorldLegacy::GetSceneQueryFrameMetrics() const
+const sq::SceneQueryFrameMetrics& CollisionWorldLegacy::GetSceneQueryFrameMetrics(
+    const CollisionQueryContext* ctx) const
 {
-    return m_sceneQueryFrameMetrics;
+    return ctx ? ctx->frameMetrics : m_mainContext.frameMetrics;
 }
 
-const sq::QueryMetrics& CollisionWorldLegacy::GetLastSceneQueryMetrics() const
+const sq::QueryMetrics& CollisionWorldLegacy::GetLastSceneQueryMetrics(
+    const CollisionQueryContext* ctx) const
 {
-    return m_sceneQueryFrameMetrics.lastQuery;
+    return GetSceneQueryFrameMetrics(ctx).lastQuery;
 }
 
 }} // namespace Engine::Collision
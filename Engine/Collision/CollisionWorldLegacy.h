@@ -5,34 +5,101 @@
 // TERMINOLOGY:
 //   CollisionWorld  - owns BVH + collider registry. Provides sweep/overlap.
 //   ColliderDesc    - description of one collider (bounds, shape, kind, mask).
-//   ColliderShape   - geometry type (AABB now; future OBB, Capsule, Plane).
+//   ColliderShape   - geometry type (AABB, Tri, Plane, Heightfield; future OBB,
+//                     Capsule).
 //   ColliderKind    - interaction semantics (Solid blocks motion; Trigger
 //                     fires events only and never blocks movement).
-//   QueryMask       - bitfield selecting which collider kinds a query sees.
+//   QueryMask       - bitfield selecting which collider kinds and layers a
+//                     query sees. A collider is visible when its mask and
+//                     the query mask share a bit.
 //
 // POLICY:
 //   - BVH built once from ordered collider vector via BuildStatic().
 //   - Determinism: same input order → same BVH → same query results.
 //   - SweepCapsuleClosest is logically const (mutable scratch for perf).
 //   - Triggers NEVER appear in sweep results when mask excludes them.
+//   - All solid layers share one BVH. Each node stores the OR of the masks
+//     below it, so a query skips subtrees that hold none of its layers.
 //   - Floor / KillZ / Teleport are world-authored rules outside this class.
+//   - Solid planes stay out of the BVH. Every solid query tests them after
+//     the tree in O(1) each and merges them deterministically (SqPlane.h).
+//   - Solid heightfields stay out of the BVH too. Sweeps, contact overlaps,
+//     closest point and k-nearest generate the triangles under their
+//     footprint after the planes (SqHeightfield.h).
+//   - The solid BVH is built with spatial splits: large triangles are cut
+//     into per-region references instead of widening nodes near the root.
 //
 // CONTRACT:
 //   - BuildStatic() must be called exactly once before any query.
 //   - Collider order in the input vector determines BVH determinism.
-//   - NOT thread-safe (single mutable QueryScratch).
+//   - Query state (scratch, local set, memo, frame metrics) lives in a
+//     CollisionQueryContext. Calls without a context use the world's main
+//     context and are NOT thread-safe. Concurrent callers each pass their own
+//     context; the BVH and collider registry are read-only after BuildStatic.
+//   - Local query set: between BeginLocalQuerySet/EndLocalQuerySet, queries
+//     whose broadphase bounds lie inside the region run against candidates
+//     gathered once; other queries use the BVH. Results are identical.
+//   - Query memo: between BeginQueryMemo/EndQueryMemo, exact sweep/overlap
+//     repeats return the stored result and sweeps differing only in filter
+//     rerun narrowphase over the stored candidate list. Results are identical.
+//   - ClosestPointCapsule/DistanceToWorld/QueryKNearest always traverse the
+//     BVH; they bypass the local query set and the memo.
+//   - Plane hits and contacts carry PrimType::Plane and an m_descs index,
+//     like every other solid. Triggers use their bounds whatever the shape.
+//   - Tri colliders from AppendCookedMeshColliders keep their cooked
+//     active-edge flags; sweeps skip inactive edge features. Loose Tri
+//     colliders keep every edge active.
+//   - With SetTrianglePrecomp(true), BuildStatic precomputes a
+//     TrianglePrecomp per BVH triangle (m_sqTriPrecomp) once and triangle
+//     kernels read it instead of recomputing normals and edges per
+//     candidate. Off by default: the speedup has not reproduced on every
+//     machine (docs/audits/scenequery/26-triangle-precompute-store.md).
+//     SwapStatic carries the store with the data it was built with.
+//   - Heightfield hits, contacts, closest points and k-nearest hits carry
+//     PrimType::Heightfield and an m_descs index.
+//   - Triggers live in a second BVH (AABB bounds, masks from ColliderDesc).
+//     OverlapCapsule and UpdateTriggerPairs traverse it; sweeps never do.
+//   - GetStaticEpoch() changes on every BuildStatic() and SwapStatic();
+//     callers caching collider indices across ticks must compare it before
+//     reuse.
+//   - SwapStatic() publishes a world built elsewhere (CollisionWorldRebuild.h)
+//     in O(1). Same rules as BuildStatic: no query may run during it.
+//   - Gap patch: SetGapColliders() makes colliders appended after the
+//     registry visible at once, from a small side world built inline. Gap
+//     collider k answers as index getStaticColliderCount() + k, the index a
+//     rebuild of (registry + appended) gives it. Sweeps, contact overlaps,
+//     trigger id overlaps, closest point and k-nearest merge it (sweep ties
+//     via BetterHit on registry indices); trigger pairs and local sets do
+//     not. Setting it bumps the epoch; BuildStatic
+//     drops it and SwapStatic keeps only the entries the published registry
+//     does not reach.
+//   - QueryTraversal::ShortStack runs BVH sweeps and contact overlaps on the
+//     context's 16-entry ring (SqBVHShortStack.h); results are identical.
+//     The context's QueryScratch stack is then only allocated by the
+//     queries that still need it (memo, local set gather, closest point,
+//     k-nearest, triggers). Set the mode while no query runs.
 //
 // PROOF POINTS:
-//   - [COLLWORLD_INIT] log: colliderCount, nodeCount, primCount.
+//   - [COLLWORLD_INIT] log: colliderCount, nodeCount, primCount, refCount.
 //
 // REFERENCES:
 //   - Plan §1 (Target Architecture), §4 (Contracts)
 // =========================================================================
 
 #include "SceneQuery/SqBVH.h"
+#include "SceneQuery/SqBVHShortStack.h"
+#include "SceneQuery/SqClosestPoint.h"
+#include "SceneQuery/SqHeightfield.h"
+#include "SceneQuery/SqMeshCook.h"
 #include "SceneQuery/SqQueryLegacy.h"
+#include "SceneQuery/SqLocalSet.h"
+#include "SceneQuery/SqPlane.h"
+#include "SceneQuery/SqQueryMemo.h"
+#include "SceneQuery/SqTriggerPairs.h"
 #include <vector>
 #include <cstdint>
+#include <limits>
+#include <memory>
 
 namespace Engine { namespace Collision {
 
@@ -40,8 +107,10 @@ namespace Engine { namespace Collision {
 
 enum class ColliderShape : uint8_t {
     AABB = 0,
-    Tri  = 2     // Triangle (floor, ramps)
-    // Future: Plane, OBB, Capsule
+    Tri  = 2,    // Triangle (ramps)
+    Plane = 3,   // Half-space or bounded plane (floor); never in the BVH
+    Heightfield = 4  // Terrain height grid; never in the BVH
+    // Future: OBB, Capsule
 };
 
 enum class ColliderKind : uint8_t {
@@ -53,18 +122,67 @@ using QueryMask = uint32_t;
 static constexpr QueryMask Q_Solid   = 1u << 0;
 static constexpr QueryMask Q_Trigger = 1u << 1;
 static constexpr QueryMask Q_All     = Q_Solid | Q_Trigger;
+// Layer bits for solids seen by only some queries (e.g. a player-only
+// blocker has mask Q_Player; the player controller queries Q_Solid | Q_Player).
+static constexpr QueryMask Q_Player     = 1u << 2;
+static constexpr QueryMask Q_Npc        = 1u << 3;
+static constexpr QueryMask Q_Projectile = 1u << 4;
+static constexpr QueryMask Q_Camera     = 1u << 5;
+
+// Binary BVH traversal behind SweepCapsuleClosest and OverlapCapsuleContacts.
+// FullStack: QueryScratch, LinearFallback on overflow.
+// ShortStack: bounded ring with parent-walk restarts.
+enum class QueryTraversal : uint8_t {
+    FullStack  = 0,
+    ShortStack = 1
+};
 
 // ---- Collider description (input to BuildStatic) ----------------------------
 
 struct ColliderDesc {
     sq::AABB       bounds;          // BVH broad bounds (always present)
     sq::Triangle   triVerts{};      // triangle vertices (used when shape == Tri)
+    uint8_t        triEdgeFlags = sq::kTriEdgesAllActive;  // shape == Tri; cooked meshes clear inner edges
+    sq::PlanePrim  plane{};         // surface and footprint (used when shape == Plane)
+    const sq::HeightfieldPrim* heightfield = nullptr;  // shape == Heightfield; copied by BuildStatic
     ColliderShape  shape  = ColliderShape::AABB;
     ColliderKind   kind   = ColliderKind::Solid;
     QueryMask      mask   = Q_Solid;   // which query masks can see this collider
     uint32_t       userTag = 0;        // gameplay payload (teleport id, etc.)
 };
 
+// Appends one Tri collider per cooked triangle, carrying its active-edge
+// flags. bounds, triVerts, triEdgeFlags and shape come from the mesh; kind,
+// mask and userTag from base. Triangle t becomes collider out.size() + t.
+inline void AppendCookedMeshColliders(const sq::CookedMesh& mesh, const ColliderDesc& base,
+                                      std::vector<ColliderDesc>& out)
+{
+    const uint32_t triCount = sq::CookedTriangleCount(mesh);
+    out.reserve(out.size() + triCount);
+    for (uint32_t t = 0; t < triCount; ++t) {
+        ColliderDesc d = base;
+        d.shape = ColliderShape::Tri;
+        d.triVerts = sq::CookedMeshTriangle(mesh, t);
+        d.triEdgeFlags = mesh.edgeFlags[t];
+        d.bounds = sq::TriAABB(d.triVerts);
+        out.push_back(d);
+    }
+}
+
+// ---- Query context (per thread) ---------------------------------------------
+
+struct CollisionQueryContext {
+    sq::QueryScratch           scratch;       // traversal stack + last query metrics
+    sq::ShortStackScratch      shortStack;    // QueryTraversal::ShortStack ring
+    sq::LocalQuerySet          localSet;      // active between Begin/EndLocalQuerySet
+    sq::QueryMemo              memo;          // active between Begin/EndQueryMemo
+    sq::SceneQueryFrameMetrics frameMetrics;  // accumulated per context
+    std::vector<uint32_t>      triggerHits;   // OverlapCapsule trigger gather
+    std::unique_ptr<CollisionQueryContext> gap;  // gap patch queries, made on first use
+    std::vector<sq::OverlapContact> gapContacts; // gap contact overlap output
+    std::vector<sq::KNearestHit>    gapNearest;  // gap k-nearest output
+};
+
 // ---- CollisionWorld ---------------------------------------------------------
 
 class CollisionWorldLegacy {
@@ -74,6 +192,20 @@ public:
     void BuildStatic(const ColliderDesc* colliders, uint32_t count);
     void BuildStatic(const std::vector<ColliderDesc>& colliders);
 
+    // Exchange all static data (registry, BVHs, backing storage) with built,
+    // which was filled by its own BuildStatic, and bump this world's epoch.
+    // built receives the old data. No copy: vector buffers and the BVH
+    // pointers into them move together. Clears the main context like
+    // BuildStatic; other contexts must drop their local set and memo.
+    void SwapStatic(CollisionWorldLegacy& built);
+
+    // Gap patch for colliders appended after the registry while a rebuild
+    // that contains them is pending. Replaces the previous patch, builds it
+    // on the caller (meant for tens of colliders) and bumps the epoch. Same
+    // rules as BuildStatic: no query may run during it.
+    void SetGapColliders(const ColliderDesc* appended, uint32_t count);
+    void ClearGapColliders();
+
     // Sweep capsule against BVH. Returns earliest Solid hit along displacement.
     // Only colliders whose mask & queryMask != 0 participate.
     // filter: optional normal predicate applied inside candidate enumeration
@@ -82,41 +214,165 @@ public:
                                 const sq::SweepConfig& cfg,
                                 QueryMask queryMask = Q_Solid,
                                 const sq::SweepFilter& filter = sq::SweepFilter{},
-                                bool rejectInitialOverlap = false) const;
+                                bool rejectInitialOverlap = false,
+                                CollisionQueryContext* ctx = nullptr) const;
+
+    // Sweep capsule against one Solid collider only (no BVH traversal).
+    // Same window math and narrowphase as the full sweep for that collider.
+    // Returns no hit for trigger or out-of-range indices.
+    sq::Hit SweepCapsuleAgainstCollider(uint32_t colliderIndex,
+                                        const sq::SweepCapsuleInput& in,
+                                        const sq::SweepConfig& cfg,
+                                        const sq::SweepFilter& filter = sq::SweepFilter{},
+                                        bool rejectInitialOverlap = false,
+                                        CollisionQueryContext* ctx = nullptr) const;
 
     // Overlap capsule at a position. Returns count of overlapping colliders.
     // outIds receives up to maxIds collider indices (sorted by index for determinism).
-    // Stub: not yet implemented (returns 0). Wire up when narrowphase overlap exists.
+    // Triggers only: their bounds against the capsule AABB, via the trigger BVH.
+    // Keeps the maxIds smallest indices when more overlap.
     uint32_t OverlapCapsule(const sq::Vec3& segA, const sq::Vec3& segB,
                             float radius, QueryMask queryMask,
-                            uint32_t* outIds, uint32_t maxIds) const;
+                            uint32_t* outIds, uint32_t maxIds,
+                            CollisionQueryContext* ctx = nullptr) const;
+
+    // Trigger enter/stay/exit for one actor capsule. Appends events carrying
+    // collider indices, ascending per actor. cache is caller-owned and keeps
+    // each actor's inside set across ticks; actor ids index it densely.
+    void UpdateTriggerPairs(sq::TriggerPairCache& cache, uint32_t actor,
+                            const sq::Vec3& segA, const sq::Vec3& segB,
+                            float radius, QueryMask queryMask,
+                            std::vector<sq::TriggerPairEvent>& events,
+                            CollisionQueryContext* ctx = nullptr) const;
 
     // Overlap capsule at a position. Returns overlap contacts with penetration info.
     // outContacts receives up to maxContacts contacts, sorted by (-depth, type, index, featureId).
     uint32_t OverlapCapsuleContacts(const sq::Vec3& segA, const sq::Vec3& segB,
                                     float radius, QueryMask queryMask,
                                     sq::OverlapContact* outContacts,
-                                    uint32_t maxContacts) const;
+                                    uint32_t maxContacts,
+                                    CollisionQueryContext* ctx = nullptr) const;
+
+    // Nearest Solid to a capsule within maxDistance (gap beyond the radius).
+    // One best-first BVH traversal; index is remapped to the m_descs index.
+    // Does not use the local query set or the query memo.
+    sq::ClosestPointResult ClosestPointCapsule(const sq::Vec3& segA, const sq::Vec3& segB,
+                                               float radius, float maxDistance,
+                                               QueryMask queryMask = Q_Solid,
+                                               CollisionQueryContext* ctx = nullptr) const;
+
+    // Distance from a point to the nearest Solid; maxDistance when none is closer.
+    float DistanceToWorld(const sq::Vec3& point, float maxDistance,
+                          QueryMask queryMask = Q_Solid,
+                          CollisionQueryContext* ctx = nullptr) const;
+
+    // The k colliders nearest to point whose mask & queryMask != 0, sorted by
+    // (distance, type, collider index). Solids come from one best-first BVH
+    // traversal; triggers are a linear scan measured to their bounds.
+    // out must hold k entries; returns the count written.
+    uint32_t QueryKNearest(const sq::Vec3& point, uint32_t k, QueryMask queryMask,
+                           sq::KNearestHit* out,
+                           float maxDistance = std::numeric_limits<float>::max(),
+                           CollisionQueryContext* ctx = nullptr) const;
+
+    // Per-tick candidate prefetch. Gathers solids touching region once; queries
+    // contained in region skip BVH traversal until EndLocalQuerySet().
+    void BeginLocalQuerySet(const sq::AABB& region, CollisionQueryContext* ctx = nullptr) const;
+    void EndLocalQuerySet(CollisionQueryContext* ctx = nullptr) const;
+    bool IsLocalQuerySetActive(const CollisionQueryContext* ctx = nullptr) const {
+        return (ctx ? ctx->localSet : m_mainContext.localSet).active;
+    }
+    uint32_t GetLocalQuerySetCandidateCount(const CollisionQueryContext* ctx = nullptr) const {
+        return (ctx ? ctx->localSet : m_mainContext.localSet).CandidateCount();
+    }
+
+    // Intra-tick memo. Valid only while no BuildStatic() intervenes.
+    void BeginQueryMemo(CollisionQueryContext* ctx = nullptr) const;
+    void EndQueryMemo(CollisionQueryContext* ctx = nullptr) const;
+    bool IsQueryMemoActive(const CollisionQueryContext* ctx = nullptr) const {
+        return (ctx ? ctx->memo : m_mainContext.memo).active;
+    }
+
+    // World-wide; must not change while a query runs on any thread.
+    void SetQueryTraversal(QueryTraversal traversal) { m_traversal = traversal; }
+    QueryTraversal GetQueryTraversal() const { return m_traversal; }
+
+    // Triangle precompute store; applies from the next BuildStatic.
+    void SetTrianglePrecomp(bool enabled) { m_triPrecompEnabled = enabled; }
+    bool GetTrianglePrecomp() const { return m_triPrecompEnabled; }
 
     // Read-only accessors (diagnostics)
     const sq::StaticBVH& getBVH() const { return m_bvh; }
-    uint32_t getColliderCount() const { return static_cast<uint32_t>(m_descs.size()); }
-    const ColliderDesc& getColliderDesc(uint32_t idx) const { return m_descs[idx]; }
+    const sq::StaticBVH& getTriggerBVH() const { return m_triggerBvh; }
+    // Registry plus gap patch; indices past the registry are gap colliders.
+    uint32_t getColliderCount() const { return getStaticColliderCount() + getGapColliderCount(); }
+    uint32_t getStaticColliderCount() const { return static_cast<uint32_t>(m_descs.size()); }
+    uint32_t getGapColliderCount() const { return m_gap ? m_gap->getStaticColliderCount() : 0u; }
+    const ColliderDesc& getColliderDesc(uint32_t idx) const {
+        return idx < m_descs.size() ? m_descs[idx] : m_gap->m_descs[idx - m_descs.size()];
+    }
     uint32_t getTriggerCount() const { return static_cast<uint32_t>(m_triggerIds.size()); }
-    void ResetSceneQueryFrameMetrics() const;
-    const sq::SceneQueryFrameMetrics& GetSceneQueryFrameMetrics() const;
-    const sq::QueryMetrics& GetLastSceneQueryMetrics() const;
+    uint32_t GetStaticEpoch() const { return m_staticEpoch; }
+    void ResetSceneQueryFrameMetrics(CollisionQueryContext* ctx = nullptr) const;
+    const sq::SceneQueryFrameMetrics& GetSceneQueryFrameMetrics(
+        const CollisionQueryContext* ctx = nullptr) const;
+    const sq::QueryMetrics& GetLastSceneQueryMetrics(
+        const CollisionQueryContext* ctx = nullptr) const;
 
 private:
+    CollisionQueryContext& Ctx(CollisionQueryContext* ctx) const {
+        return ctx ? *ctx : m_mainContext;
+    }
+    CollisionQueryContext& GapCtx(CollisionQueryContext& c) const {
+        if (!c.gap)
+            c.gap = std::make_unique<CollisionQueryContext>();
+        return *c.gap;
+    }
+    sq::Hit SweepCapsuleClosestStatic(CollisionQueryContext& c,
+                                      const sq::SweepCapsuleInput& in,
+                                      const sq::SweepConfig& cfg,
+                                      QueryMask queryMask,
+                                      const sq::SweepFilter& filter,
+                                      bool rejectInitialOverlap) const;
+    uint32_t OverlapCapsuleContactsStatic(CollisionQueryContext& c,
+                                          const sq::Vec3& segA, const sq::Vec3& segB,
+                                          float radius, QueryMask queryMask,
+                                          sq::OverlapContact* outContacts,
+                                          uint32_t maxContacts) const;
+    void BuildGap(const ColliderDesc* appended, uint32_t count);
+    sq::Hit SweepCapsuleClosestMemo(CollisionQueryContext& c,
+                                    const sq::SweepCapsuleInput& in,
+                                    const sq::SweepConfig& cfg,
+                                    QueryMask queryMask,
+                                    const sq::SweepFilter& filter,
+                                    bool rejectInitialOverlap) const;
+    uint32_t PlaneOfDesc(uint32_t colliderIndex) const;
+    uint32_t HeightfieldOfDesc(uint32_t colliderIndex) const;
+    void RemapHit(sq::Hit& hit) const;
+    void RemapContacts(sq::OverlapContact* contacts, uint32_t count) const;
+
     std::vector<ColliderDesc>  m_descs;         // collider registry (ordered)
     std::vector<sq::AABB>      m_sqAabbs;      // BVH AABB backing storage (solids)
     std::vector<sq::Triangle>  m_sqTris;       // BVH triangle backing storage (solids)
     std::vector<uint32_t>      m_solidRemap;   // BVH AABB prim index → m_descs index
     std::vector<uint32_t>      m_solidTriRemap;// BVH tri prim index → m_descs index
+    std::vector<uint8_t>       m_sqTriEdgeFlags; // BVH tri j active-edge flags (SqMeshCook.h)
+    std::vector<sq::TrianglePrecomp> m_sqTriPrecomp; // BVH tri j normal/edges/plane; empty when off
+    std::vector<sq::PlanePrim> m_planes;       // solid planes, tested outside the BVH
+    std::vector<uint32_t>      m_planeRemap;   // plane index → m_descs index, ascending
+    std::vector<sq::HeightfieldPrim> m_heightfields;     // solid terrain, tested outside the BVH
+    std::vector<uint32_t>      m_heightfieldRemap;  // heightfield index → m_descs index, ascending
     std::vector<uint32_t>      m_triggerIds;   // m_descs indices where kind==Trigger, ascending
+    std::vector<sq::AABB>      m_triggerAabbs; // trigger BVH AABB j ↔ m_triggerIds[j]
+    std::vector<uint32_t>      m_primMasks;    // bvh.prims index → m_descs mask
+    std::vector<uint32_t>      m_descToPrim;   // m_descs index → bvh.prims index (kInvalidBVHNode for triggers)
+    uint32_t                   m_staticEpoch = 0; // bumped by BuildStatic, SwapStatic, gap patch
+    QueryTraversal             m_traversal = QueryTraversal::FullStack;
+    bool                       m_triPrecompEnabled = false; // BuildStatic fills m_sqTriPrecomp
     sq::StaticBVH              m_bvh;
-    mutable sq::QueryScratch  m_scratch;   // single-threaded query scratch
-    mutable sq::SceneQueryFrameMetrics m_sceneQueryFrameMetrics;
+    sq::StaticBVH              m_triggerBvh;   // triggers only; prim index j → m_triggerIds[j]
+    std::unique_ptr<CollisionWorldLegacy> m_gap;  // gap patch; index k -> m_descs.size() + k
+    mutable CollisionQueryContext m_mainContext;  // used when callers pass no context
 };
 
 }} // namespace Engine::Collision
@@ -0,0 +1,94 @@
+#include "CollisionWorldRebuild.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Engine { namespace Collision {
+
+CollisionWorldRebuilder::CollisionWorldRebuilder()
+    : m_back(std::make_unique<CollisionWorldLegacy>())
+{
+}
+
+CollisionWorldRebuilder::~CollisionWorldRebuilder()
+{
+    Join();
+}
+
+void CollisionWorldRebuilder::Request(std::vector<ColliderDesc> colliders,
+                                      CollisionWorldLegacy& live)
+{
+    const uint32_t base = live.getStaticColliderCount();
+    if (colliders.size() > base)
+        live.SetGapColliders(colliders.data() + base,
+                             static_cast<uint32_t>(colliders.size()) - base);
+    else
+        live.ClearGapColliders();
+
+    ++m_stats.requested;
+    if (m_running) {
+        if (m_hasQueued)
+            ++m_stats.coalesced;
+        m_queued = std::move(colliders);
+        m_hasQueued = true;
+        return;
+    }
+    m_building = std::move(colliders);
+    Start();
+}
+
+void CollisionWorldRebuilder::Start()
+{
+    m_done.store(false, std::memory_order_relaxed);
+    m_running = true;
+    m_thread = std::thread([this] {
+        const auto start = std::chrono::steady_clock::now();
+        m_back->BuildStatic(m_building);
+        const auto end = std::chrono::steady_clock::now();
+        m_buildNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        m_done.store(true, std::memory_order_release);
+    });
+}
+
+void CollisionWorldRebuilder::Join()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool CollisionWorldRebuilder::PublishIfReady(CollisionWorldLegacy& live)
+{
+    if (!m_running || !m_done.load(std::memory_order_acquire))
+        return false;
+    Join();
+    m_running = false;
+    ++m_stats.built;
+    m_stats.lastBuildNs = m_buildNs;
+
+    const auto start = std::chrono::steady_clock::now();
+    live.SwapStatic(*m_back);
+    const auto end = std::chrono::steady_clock::now();
+    m_stats.lastPublishNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    m_stats.maxPublishNs = (std::max)(m_stats.maxPublishNs, m_stats.lastPublishNs);
+    ++m_stats.published;
+
+    if (m_hasQueued) {
+        m_building = std::move(m_queued);
+        m_queued.clear();
+        m_hasQueued = false;
+        Start();
+    }
+    return true;
+}
+
+void CollisionWorldRebuilder::Flush(CollisionWorldLegacy& live)
+{
+    while (m_running) {
+        Join();
+        PublishIfReady(live);
+    }
+}
+
+}} // namespace Engine::Collision
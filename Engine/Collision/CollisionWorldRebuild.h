@@ -0,0 +1,105 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/29-background-rebuild.md
+//
+// TERMINOLOGY:
+//   Live world  - the caller's CollisionWorld; every query runs against it
+//   Back world  - rebuilder-owned CollisionWorld that a worker thread fills
+//                 with BuildStatic
+//   Publish     - SwapStatic(live, back) at a tick boundary; the back world
+//                 keeps the old data and reuses its buffers next build
+//   Queued      - the newest request made while a build runs
+//   Gap patch   - colliders a request appends after the live registry,
+//                 visible in the live world until a publish includes them
+//                 (CollisionWorld::SetGapColliders)
+//
+// POLICY:
+//   - One build at a time. Requests during a build coalesce: only the
+//     newest is kept, and it starts when the running build is published.
+//   - Request patches the colliders it appends after the live registry
+//     into the live world at once, so additions reach queries on the next
+//     query, not the next publish. A request no longer than the live
+//     registry clears the patch; removals and edits reach queries only
+//     when published.
+//   - Publish costs O(1) swaps on the caller; the build, the old snapshot's
+//     teardown and buffer reuse all happen on the worker.
+//
+// CONTRACT:
+//   - Request/PublishIfReady/Flush come from one owning thread, always with
+//     the same live world.
+//   - Request with live: colliders[0, live static count) must equal the
+//     live registry for the patch indices to match the published ones.
+//   - Publish and Request change the live world like BuildStatic: no query
+//     may run on any thread during them (CctCrowd::Step, CollisionQueryJobs
+//     in flight).
+//   - Heightfield ColliderDesc pointers must stay valid until the build
+//     that copies them has finished.
+//
+// PROOF POINTS:
+//   - From Request through each publish the live world answers sweeps,
+//     contact overlaps, closest points and trigger ids like a full build of
+//     the newest request; the epoch moves once per publish
+//     (ExpectBackgroundRebuildGapPatch in SqBackendHarness.cpp).
+// =========================================================================
+
+#include "CollisionWorldLegacy.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Engine { namespace Collision {
+
+struct CollisionRebuildStats {
+    uint32_t requested = 0;
+    uint32_t coalesced = 0;     // queued requests replaced before starting
+    uint32_t built = 0;
+    uint32_t published = 0;
+    uint64_t lastBuildNs = 0;   // worker BuildStatic time
+    uint64_t lastPublishNs = 0; // caller SwapStatic time
+    uint64_t maxPublishNs = 0;
+};
+
+class CollisionWorldRebuilder {
+public:
+    CollisionWorldRebuilder();
+    ~CollisionWorldRebuilder();
+
+    CollisionWorldRebuilder(const CollisionWorldRebuilder&) = delete;
+    CollisionWorldRebuilder& operator=(const CollisionWorldRebuilder&) = delete;
+
+    // Starts a background BuildStatic of colliders, or queues it behind the
+    // running one (replacing any queued request). Colliders past live's
+    // registry become its gap patch now. Never waits for the worker.
+    void Request(std::vector<ColliderDesc> colliders, CollisionWorldLegacy& live);
+
+    // Tick boundary: publishes a finished build into live and starts the
+    // queued request. Returns true when live changed. Never blocks.
+    bool PublishIfReady(CollisionWorldLegacy& live);
+
+    // Blocks until the running and queued builds are published.
+    void Flush(CollisionWorldLegacy& live);
+
+    bool IsBuilding() const { return m_running; }
+    bool HasQueued() const { return m_hasQueued; }
+    const CollisionRebuildStats& GetStats() const { return m_stats; }
+
+private:
+    void Start();
+    void Join();
+
+    std::unique_ptr<CollisionWorldLegacy> m_back;
+    std::vector<ColliderDesc> m_building;  // worker-owned while m_running
+    std::vector<ColliderDesc> m_queued;
+    bool m_hasQueued = false;
+    bool m_running = false;
+
+    std::thread m_thread;
+    std::atomic<bool> m_done{false};
+    uint64_t m_buildNs = 0;                // written by the worker before m_done
+    CollisionRebuildStats m_stats{};
+};
+
+}} // namespace Engine::Collision
@@ -51,6 +51,7 @@
 // =========================================================================
 
 #include "KinematicCharacterControllerLegacy.h"
+#include "CctLanes.h"
 #include <cassert>
 #include <cmath>
 #include <algorithm>
@@ -67,6 +68,12 @@ namespace {
     constexpr float kStepMoveApproachEps = 1e-4f;
     constexpr uint32_t kInitialOverlapRecoverMaxIters = 4;
 
+    bool IsIdleInput(const CctInput& input)
+    {
+        return !input.jump && input.walkMove.x == 0.0f &&
+               input.walkMove.y == 0.0f && input.walkMove.z == 0.0f;
+    }
+
     struct StepMoveHitView {
         CctStepMoveQueryKind kind = CctStepMoveQueryKind::ClearPath;
         CctStepMoveRejectReason rejectReason =
@@ -112,6 +119,140 @@ namespace {
         return true;
     }
 
+    // ---- Multi-plane slide solver ----
+
+    constexpr uint32_t kMaxSlidePlanes = 4;
+    constexpr float kSlidePlaneDedupDot = 0.999f;
+    constexpr float kSlideConstraintEps = 1e-6f;
+
+    struct SlidePlaneSet {
+        sq::Vec3 normals[kMaxSlidePlanes];
+        uint32_t count = 0;
+        bool saturated = false;  // a distinct plane did not fit: treat as 3+
+    };
+
+    enum class SlideSolve : uint8_t {
+        Free = 0,   // move already satisfies every plane
+        Plane,      // projected onto one plane
+        Crease,     // projected onto the crease of two planes
+        Stop,       // no feasible non-zero move
+    };
+
+    void AddSlidePlane(SlidePlaneSet& set, const sq::Vec3& n)
+    {
+        for (uint32_t i = 0; i < set.count; ++i) {
+            if (sq::Dot(set.normals[i], n) >= kSlidePlaneDedupDot)
+                return;
+        }
+        if (set.count == kMaxSlidePlanes) {
+            set.saturated = true;
+            return;
+        }
+        set.normals[set.count++] = n;
+    }
+
+    bool SatisfiesSlidePlanes(const SlidePlaneSet& set, const sq::Vec3& v,
+                              uint32_t skipA, uint32_t skipB)
+    {
+        for (uint32_t i = 0; i < set.count; ++i) {
+            if (i == skipA || i == skipB)
+                continue;
+            if (sq::Dot(v, set.normals[i]) < -kSlideConstraintEps)
+                return false;
+        }
+        return true;
+    }
+
+    // Constrained displacement: Dot(out, n_i) >= 0 for every plane.
+    // Candidates are tried in plane insertion order, so the result is a pure
+    // function of the hit/contact order.
+    SlideSolve SolveSlidePlanes(const SlidePlaneSet& set, const sq::Vec3& move,
+                                sq::Vec3& out)
+    {
+        out = {0.0f, 0.0f, 0.0f};
+        if (set.saturated)
+            return SlideSolve::Stop;
+        if (SatisfiesSlidePlanes(set, move, kMaxSlidePlanes, kMaxSlidePlanes)) {
+            out = move;
+            return SlideSolve::Free;
+        }
+
+        for (uint32_t i = 0; i < set.count; ++i) {
+            const float into = sq::Dot(move, set.normals[i]);
+            if (into >= 0.0f)
+                continue;
+            const sq::Vec3 v = move - set.normals[i] * into;
+            if (SatisfiesSlidePlanes(set, v, i, i)) {
+                out = v;
+                return SlideSolve::Plane;
+            }
+        }
+
+        for (uint32_t i = 0; i < set.count; ++i) {
+            for (uint32_t j = i + 1; j < set.count; ++j) {
+                const sq::Vec3 c = sq::Cross(set.normals[i], set.normals[j]);
+                const float cLenSq = sq::LenSq(c);
+                if (cLenSq <= kMinDist * kMinDist)
+                    continue;
+                const sq::Vec3 dir = c * (1.0f / std::sqrt(cLenSq));
+                const sq::Vec3 v = dir * sq::Dot(move, dir);
+                if (SatisfiesSlidePlanes(set, v, i, j)) {
+                    out = v;
+                    return SlideSolve::Crease;
+                }
+            }
+        }
+        return SlideSolve::Stop;
+    }
+
+    // Adds contact planes around the pose (radius already inflated by the
+    // caller). lateralOnly mirrors Walking StepMove: walkable contacts are
+    // support, not blockers, and blocker normals lose their up component.
+    void GatherSlidePlanes(const CollisionWorldLegacy& world,
+                           CollisionQueryContext* ctx, QueryMask queryMask,
+                           const sq::Vec3& segA, const sq::Vec3& segB,
+                           float radius, const sq::Vec3& up,
+                           float maxSlopeCos, bool lateralOnly,
+                           SlidePlaneSet& set)
+    {
+        sq::OverlapContact contacts[32];
+        const uint32_t count = world.OverlapCapsuleContacts(
+            segA, segB, radius, queryMask, contacts, 32, ctx);
+        for (uint32_t i = 0; i < count; ++i) {
+            sq::Vec3 n = contacts[i].normal;
+            if (lateralOnly) {
+                if (sq::Dot(n, up) >= maxSlopeCos)
+                    continue;
+                if (!BuildLateralStepMoveResponseNormal(contacts[i].normal, up, n))
+                    continue;
+            }
+            AddSlidePlane(set, n);
+        }
+    }
+
+    // Gathers planes at the contact pose, solves, and records evidence.
+    SlideSolve ResolveSlidePlanes(const CollisionWorldLegacy& world,
+                                  CollisionQueryContext* ctx, QueryMask queryMask,
+                                  const sq::Vec3& segA, const sq::Vec3& segB,
+                                  float radius, const sq::Vec3& up,
+                                  float maxSlopeCos, bool lateralOnly,
+                                  SlidePlaneSet& set, const sq::Vec3& move,
+                                  sq::Vec3& out, CctDebug& debug)
+    {
+        GatherSlidePlanes(world, ctx, queryMask, segA, segB, radius, up, maxSlopeCos,
+                          lateralOnly, set);
+        SlideSolve solve = SolveSlidePlanes(set, move, out);
+        if (solve != SlideSolve::Stop && sq::LenSq(out) <= kMinDist * kMinDist)
+            solve = SlideSolve::Stop;  // e.g. lateral crease parallel to up
+
+        debug.slidePlanes = set.count;
+        if (solve == SlideSolve::Crease)
+            debug.slideCreases++;
+        if (solve == SlideSolve::Stop)
+            debug.slideStops++;
+        return solve;
+    }
+
     void CountStepMoveKindDebug(CctDebug& debug,
                                 CctStepMoveQueryKind kind)
     {
@@ -205,6 +346,8 @@ KinematicCharacterControllerLegacy::KinematicCharacterControllerLegacy(
 void KinematicCharacterControllerLegacy::setState(const CctState& s)
 {
     m_state = s;
+    InvalidateGroundSupportCache();
+    WakeUp(CctWakeReason::External);
     if (s.moveMode == CctMoveMode::Walking || s.onGround) {
         SetModeWalking(s.groundNormal);
     } else {
@@ -223,15 +366,66 @@ void KinematicCharacterControllerLegacy::setState(const CctState& s)
 // complete tick through either Walking or Falling without same-tick continuation.
 
 void KinematicCharacterControllerLegacy::Tick(const CctInput& input, float dt)
+{
+    if (TrySleepTick(input, dt))
+        return;
+    BeginLaneTick(input);
+    IntegrateVertical(input, dt);
+    SimulateLaneTick(input, dt);
+    Writeback(dt);
+    EndLaneTick();
+}
+
+// =========================================================================
+// Lane-split tick
+// =========================================================================
+// Tick() is the single-lane composition of these steps. CctCrowd lane mode
+// replaces IntegrateVertical/Writeback with IntegrateVerticalLanes /
+// WritebackLanes over CctLaneBlock and hands results back through Import*.
+//
+// INVARIANT: Import* must reproduce every side effect of the scalar phase
+//            (mode switch + cache invalidation on jump, debug fields).
+
+void KinematicCharacterControllerLegacy::BeginLaneTick(const CctInput& input)
 {
     m_maxSlopeCos = std::cos(m_config.maxSlopeDeg * kPi / 180.0f);
     m_debug = CctDebug{};
     m_debug.inputWalkMove = input.walkMove;
     m_debug.beforeTick = MakePhaseSnapshot(m_state.posFeet, m_state);
+    m_debug.wakeReason = m_pendingWake;
+    m_pendingWake = CctWakeReason::None;
+    m_tickStartState = m_state;
+    m_tickInputIdle = IsIdleInput(input);
 
     PreStep();
-    IntegrateVertical(input, dt);
+}
+
+void KinematicCharacterControllerLegacy::ExportVerticalLane(
+    const CctInput& input, CctLaneBlock& block, uint32_t lane) const
+{
+    block.walkingMask[lane] = CctLaneBlock::MaskValue(IsWalking());
+    block.jumpMask[lane] = CctLaneBlock::MaskValue(input.jump);
+    block.gravity[lane] = m_config.gravity;
+    block.jumpSpeed[lane] = m_config.jumpSpeed;
+    block.fallSpeed[lane] = m_config.fallSpeed;
+    block.verticalVelocity[lane] = m_state.verticalVelocity;
+}
+
+void KinematicCharacterControllerLegacy::ImportVerticalLane(
+    const CctLaneBlock& block, uint32_t lane)
+{
+    if ((block.jumpStartedBits >> lane) & 1u) {
+        SetModeFalling();
+        m_jumpStartedThisTick = true;
+    }
+    m_state.verticalVelocity = block.verticalVelocity[lane];
+    m_state.verticalOffset = block.verticalOffset[lane];
+}
+
+void KinematicCharacterControllerLegacy::SimulateLaneTick(const CctInput& input, float dt)
+{
     m_debug.afterIntegrateVertical = MakePhaseSnapshot(m_currentPosition, m_state);
+    BeginTickQueryRegion(input);
 
     // Pre-sweep recovery (Bullet: while(recoverFromPenetration()) {...})
     {
@@ -264,12 +458,149 @@ void KinematicCharacterControllerLegacy::Tick(const CctInput& input, float dt)
         m_debug.postRecoverMag = sq::Len(m_currentPosition - preCleanup);
     }
     m_debug.afterPostRecover = MakePhaseSnapshot(m_currentPosition, m_state);
+}
 
-    Writeback(dt);
+void KinematicCharacterControllerLegacy::ExportWritebackLane(
+    CctLaneBlock& block, uint32_t lane) const
+{
+    block.xOld.Set(lane, m_xOld);
+    block.xSweep.Set(lane, m_xSweep);
+    block.xFinalPre.Set(lane, m_xFinalPre);
+    block.up.Set(lane, m_config.up);
+}
+
+void KinematicCharacterControllerLegacy::ImportWritebackLane(
+    const CctLaneBlock& block, uint32_t lane)
+{
+    m_state.posFeet = m_currentPosition;
+    m_state.vel = block.vel.Get(lane);
+
+    m_debug.dxIntent    = block.dxIntent.Get(lane);
+    m_debug.dxCorr      = block.dxCorr.Get(lane);
+    m_debug.dxIntentMag = block.dxIntentMag[lane];
+    m_debug.dxCorrMag   = block.dxCorrMag[lane];
+    m_debug.vNextMag    = block.vNextMag[lane];
+    m_debug.vNextDotUp  = block.vNextDotUp[lane];
+}
+
+void KinematicCharacterControllerLegacy::EndLaneTick()
+{
     m_debug.afterWriteback = MakePhaseSnapshot(m_state.posFeet, m_state);
+    EndTickQueryRegion();
 
     // Sweep filter diagnostics: track onGround state transitions
     m_debug.onGroundToggles = (m_state.onGround != m_state.wasOnGround) ? 1 : 0;
+
+    UpdateSleep();
+}
+
+// =========================================================================
+// Sleep fast path
+// =========================================================================
+// PRODUCES: m_sleeping, CctDebug.asleep / wakeReason
+// CONSUMES: tick-start state, tick input, static epoch, character set
+//
+// A tick is a pure function of (state, input, dt, world, nearby characters).
+// After sleepIdleTicks consecutive Walking ticks with idle input whose output
+// state equals their input state, the next tick with the same inputs would be
+// the same fixed point, so it is skipped outright.
+// INVARIANT: sleeping never changes results. Any input that could differ
+//            wakes the controller first: walkMove/jump, dt, static epoch,
+//            config generation (getConfigMut), a character within
+//            contactOffset, setState/wake().
+// EVIDENCE: CctDebug.asleep, wakeReason
+
+bool KinematicCharacterControllerLegacy::TrySleepTick(const CctInput& input, float dt)
+{
+    m_tickDt = dt;
+    if (!m_sleeping)
+        return false;
+
+    if (!IsIdleInput(input)) {
+        WakeUp(CctWakeReason::Input);
+        return false;
+    }
+    if (m_world->GetStaticEpoch() != m_sleepEpoch) {
+        WakeUp(CctWakeReason::WorldChanged);
+        return false;
+    }
+    if (dt != m_sleepDt || m_configGeneration != m_sleepConfigGeneration ||
+        !m_config.useSleep) {
+        WakeUp(CctWakeReason::External);
+        return false;
+    }
+    if (CharacterTouching()) {
+        WakeUp(CctWakeReason::Contact);
+        return false;
+    }
+
+    m_debug = CctDebug{};
+    m_debug.asleep = 1;
+    m_debug.beforeTick = MakePhaseSnapshot(m_state.posFeet, m_state);
+    m_debug.afterWriteback = m_debug.beforeTick;
+    return true;
+}
+
+void KinematicCharacterControllerLegacy::UpdateSleep()
+{
+    const CctState& a = m_tickStartState;
+    const CctState& b = m_state;
+    const bool fixedPoint =
+        m_tickInputIdle && IsWalking() && b.onGround &&
+        a.posFeet == b.posFeet && a.vel == b.vel &&
+        a.verticalVelocity == b.verticalVelocity &&
+        a.verticalOffset == b.verticalOffset &&
+        a.moveMode == b.moveMode && a.onGround == b.onGround &&
+        a.wasOnGround == b.wasOnGround && a.wasJumping == b.wasJumping &&
+        a.groundNormal == b.groundNormal;
+
+    if (!m_config.useSleep || !fixedPoint) {
+        m_idleTicks = 0;
+        return;
+    }
+    if (++m_idleTicks >= m_config.sleepIdleTicks) {
+        m_sleeping = true;
+        m_sleepEpoch = m_world->GetStaticEpoch();
+        m_sleepDt = m_tickDt;
+        m_sleepConfigGeneration = m_configGeneration;
+    }
+}
+
+void KinematicCharacterControllerLegacy::WakeUp(CctWakeReason reason)
+{
+    if (m_sleeping)
+        m_pendingWake = reason;
+    m_sleeping = false;
+    m_idleTicks = 0;
+}
+
+// Anything that can reach the controller in a full idle tick: Recover and
+// initial-overlap recovery see characters out to radius + contactOffset.
+bool KinematicCharacterControllerLegacy::CharacterTouching() const
+{
+    if (!m_characters)
+        return false;
+
+    const float radius = m_geom.radius + m_config.contactOffset;
+    const sq::Vec3 segA = m_state.posFeet + m_config.up * m_geom.radius;
+    const sq::Vec3 segB = m_state.posFeet + m_config.up *
+        (m_geom.radius + 2.0f * m_geom.halfHeight);
+
+    uint32_t candidates[kMaxCharacterCandidates];
+    uint32_t total = 0;
+    const uint32_t count = m_characters->Gather(
+        sq::CapsuleAabbStatic(segA, segB, radius), m_characterSelf,
+        candidates, kMaxCharacterCandidates, &total);
+    if (total > count)
+        return true;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const sq::DynamicCapsule& cap = m_characters->Get(candidates[i]);
+        sq::OverlapContact c;
+        if (sq::OverlapCapsuleCapsule(segA, segB, radius, cap.p, cap.q, cap.radius, c))
+            return true;
+    }
+    return false;
 }
 
 void KinematicCharacterControllerLegacy::SimulateWalking(const CctInput& input, float dt)
@@ -304,6 +635,87 @@ void KinematicCharacterControllerLegacy::SimulateFalling(const CctInput& input,
     m_debug.posAfterStepDown = m_currentPosition;
 }
 
+// =========================================================================
+// Tick query region
+// =========================================================================
+// PRODUCES: active CollisionWorld local query set + query memo,
+//           CctDebug.localSet* / queryMemo* counters
+// CONSUMES: m_currentPosition, walkMove, verticalOffset, config reach terms
+//
+// The region is the capsule AABB at the post-integration pose expanded by
+// every displacement the tick can spend: lateral + vertical move, step/snap
+// probe, recovery pushes, and inflated-radius recovery. It only needs to be
+// conservative for speed: queries that leave it use the full BVH.
+// The memo serves exact repeats (StepDown latch == snap probe, recovery
+// overlaps at an unmoved pose) and re-filters candidate lists for sweeps that
+// differ only in filter (maintain vs snap probe).
+// INVARIANT: query results are identical with and without region and memo.
+// The same region gathers other characters from the character set; only
+// those candidates take part in SweepClosest and the recovery overlaps.
+// EVIDENCE: CctDebug.localSet*, queryMemoHits, queryMemoRefilters,
+//           characterCandidates, characterOverflow
+
+void KinematicCharacterControllerLegacy::BeginTickQueryRegion(const CctInput& input)
+{
+    m_frameAtTickBegin = m_world->GetSceneQueryFrameMetrics(m_queryContext);
+
+    if (m_config.useQueryMemo)
+        m_world->BeginQueryMemo(m_queryContext);
+
+    m_characterCandidateCount = 0;
+    if (!m_config.useLocalQuerySet && !m_characters)
+        return;
+
+    const float reach =
+        sq::Len(input.walkMove) +
+        std::fabs(m_state.verticalOffset) +
+        m_config.stepHeight +
+        m_config.contactOffset *
+            static_cast<float>(m_config.maxRecoverIters + 2 + 2 * kInitialOverlapRecoverMaxIters) +
+        m_config.sweep.skin;
+
+    const sq::Vec3 segA = m_currentPosition + m_config.up * m_geom.radius;
+    const sq::Vec3 segB = m_currentPosition + m_config.up *
+        (m_geom.radius + 2.0f * m_geom.halfHeight);
+    const sq::AABB region = sq::ExpandAabb(
+        sq::CapsuleAabbStatic(segA, segB, m_geom.radius + m_config.contactOffset), reach);
+
+    if (m_characters) {
+        uint32_t total = 0;
+        m_characterCandidateCount = m_characters->Gather(
+            region, m_characterSelf, m_characterCandidates,
+            kMaxCharacterCandidates, &total);
+        m_debug.characterCandidates = m_characterCandidateCount;
+        m_debug.characterOverflow = total - m_characterCandidateCount;
+    }
+
+    if (!m_config.useLocalQuerySet)
+        return;
+
+    m_world->BeginLocalQuerySet(region, m_queryContext);
+    m_debug.localSetCandidates =
+        m_world->GetLocalQuerySetCandidateCount(m_queryContext);
+}
+
+void KinematicCharacterControllerLegacy::EndTickQueryRegion()
+{
+    const sq::SceneQueryFrameMetrics& frame =
+        m_world->GetSceneQueryFrameMetrics(m_queryContext);
+    m_debug.localSetQueries =
+        static_cast<uint32_t>(frame.localSetQueries - m_frameAtTickBegin.localSetQueries);
+    m_debug.localSetMisses =
+        static_cast<uint32_t>(frame.localSetMisses - m_frameAtTickBegin.localSetMisses);
+    m_debug.queryMemoHits =
+        static_cast<uint32_t>(frame.memoHits - m_frameAtTickBegin.memoHits);
+    m_debug.queryMemoRefilters =
+        static_cast<uint32_t>(frame.memoRefilters - m_frameAtTickBegin.memoRefilters);
+
+    if (m_world->IsQueryMemoActive(m_queryContext))
+        m_world->EndQueryMemo(m_queryContext);
+    if (m_world->IsLocalQuerySetActive(m_queryContext))
+        m_world->EndLocalQuerySet(m_queryContext);
+}
+
 // =========================================================================
 // PreStep
 // =========================================================================
@@ -399,6 +811,7 @@ void KinematicCharacterControllerLegacy::MoveWalkingLateral(const sq::Vec3& walk
 
     m_originalDirection = walkMove * (1.0f / walkLen);
     m_targetPosition = m_currentPosition + walkMove;
+    PrepareSpeculativeContacts(walkMove);
     float fraction = 1.0f;
     int iters = 0;
 
@@ -487,6 +900,25 @@ void KinematicCharacterControllerLegacy::MoveWalkingLateral(const sq::Vec3& walk
         return first;
     };
 
+    const bool multiPlane =
+        m_config.slideSolver == CctSlideSolver::MultiPlane;
+    SlidePlaneSet slidePlanes;
+    // Contact pose is one skin off the blocker; 2*skin catches it and any
+    // neighbour forming a crease with it.
+    auto applySlidePlanes = [this, &slidePlanes]() {
+        const sq::Vec3 segA = m_currentPosition + m_config.up * m_geom.radius;
+        const sq::Vec3 segB = m_currentPosition + m_config.up *
+            (m_geom.radius + 2.0f * m_geom.halfHeight);
+        sq::Vec3 slid{};
+        const SlideSolve solve = ResolveSlidePlanes(
+            *m_world, m_queryContext, m_config.queryMask, segA, segB,
+            m_geom.radius + 2.0f * m_config.sweep.skin,
+            m_config.up, m_maxSlopeCos, true, slidePlanes,
+            m_targetPosition - m_currentPosition, slid, m_debug);
+        m_targetPosition = m_currentPosition + slid;
+        return solve != SlideSolve::Stop;
+    };
+
     for (; iters < m_config.maxForwardIters && fraction > 0.01f; ++iters) {
         sq::Vec3 remaining = m_targetPosition - m_currentPosition;
         float remainLen = sq::Len(remaining);
@@ -537,7 +969,13 @@ void KinematicCharacterControllerLegacy::MoveWalkingLateral(const sq::Vec3& walk
 
         // Advance to contact FIRST, then slide remainder.
         m_currentPosition = m_currentPosition + remaining * safeT;
-        SlideAlongNormal(hitView.lateralNormal);
+        if (multiPlane) {
+            AddSlidePlane(slidePlanes, hitView.lateralNormal);
+            if (!applySlidePlanes())
+                break;
+        } else {
+            SlideAlongNormal(hitView.lateralNormal);
+        }
 
         // Anti-oscillation (ex4.cpp lines 442-457)
         sq::Vec3 newDir = m_targetPosition - m_currentPosition;
@@ -630,8 +1068,27 @@ void KinematicCharacterControllerLegacy::MoveFallingAir(
     }
 
     m_targetPosition = m_currentPosition + airDelta;
+    PrepareSpeculativeContacts(airDelta);
     m_originalDirection = airDelta * (1.0f / airLen);
 
+    const bool multiPlane =
+        m_config.slideSolver == CctSlideSolver::MultiPlane;
+    SlidePlaneSet slidePlanes;
+    // Air planes keep their raw 3D normals (wall + floor/ceiling creases).
+    auto applySlidePlanes = [this, &slidePlanes]() {
+        const sq::Vec3 segA = m_currentPosition + m_config.up * m_geom.radius;
+        const sq::Vec3 segB = m_currentPosition + m_config.up *
+            (m_geom.radius + 2.0f * m_geom.halfHeight);
+        sq::Vec3 slid{};
+        const SlideSolve solve = ResolveSlidePlanes(
+            *m_world, m_queryContext, m_config.queryMask, segA, segB,
+            m_geom.radius + 2.0f * m_config.sweep.skin,
+            m_config.up, m_maxSlopeCos, false, slidePlanes,
+            m_targetPosition - m_currentPosition, slid, m_debug);
+        m_targetPosition = m_currentPosition + slid;
+        return solve != SlideSolve::Stop;
+    };
+
     int iters = 0;
     bool sawHit = false;
     for (; iters < m_config.maxForwardIters; ++iters) {
@@ -717,7 +1174,13 @@ void KinematicCharacterControllerLegacy::MoveFallingAir(
 
         // Air slide uses the raw 3D contact normal. Walking lateral movement is
         // the only phase that strips the up component before slide.
-        SlideAlongNormal(hit.normal);
+        if (multiPlane) {
+            AddSlidePlane(slidePlanes, hit.normal);
+            if (!applySlidePlanes())
+                break;
+        } else {
+            SlideAlongNormal(hit.normal);
+        }
 
         sq::Vec3 newDir = m_targetPosition - m_currentPosition;
         float newDirLenSq = sq::LenSq(newDir);
@@ -895,15 +1358,24 @@ void KinematicCharacterControllerLegacy::UpdateGroundForWalking(float dt)
         float dist = sq::Len(downDelta);
         m_debug.stepDownDropDist = dropDist;
 
-        sq::Hit maintainHit =
-            SweepClosest(m_currentPosition, downDelta, groundFilter, true);
+        sq::Hit maintainHit;
+        const bool cachedSupport =
+            TryCachedGroundSupport(downDelta, groundFilter, maintainHit);
+        if (!cachedSupport) {
+            maintainHit =
+                SweepClosest(m_currentPosition, downDelta, groundFilter, true);
+        }
         FloorDecision maintain = evaluateSweepFloor(
             CctFloorSemantic::WalkingMaintainFloor,
             CctFloorSource::PrimarySweep,
             maintainHit, downDelta, dist);
         if (maintain.accepted) {
+            if (!cachedSupport) {
+                RefillGroundSupportCache(downDelta, maintainHit);
+            }
             return maintain;
         }
+        InvalidateGroundSupportCache();
 
         // Walking snap may retry initial overlaps as compatibility support.
         sq::Hit snapHit =
@@ -988,6 +1460,132 @@ void KinematicCharacterControllerLegacy::UpdateGroundForWalking(float dt)
     SetModeFalling();
 }
 
+// =========================================================================
+// Ground support cache
+// =========================================================================
+// PRODUCES: maintain-probe hit from the cached support collider, cache record
+// CONSUMES: m_currentPosition, downDelta, groundFilter, CollisionWorld epoch
+//
+// Fill: after a full maintain sweep is accepted, one overlap of the probe
+// capsule inflated by groundSupportCacheRadius (+2 skin) around the swept
+// segment. If the support collider is the only solid it touches, no other
+// solid can produce a maintain-probe hit while the feet stay within that
+// radius of the anchor, so the full sweep result equals the single-collider
+// sweep result.
+// Validate: epoch, queryMask and config generation unchanged, probe terms
+// (drop, slope, skin, up; they also define groundFilter) unchanged, feet
+// inside the anchor radius, capsule within reach of the cached supporting
+// plane, then one single-collider sweep that must hit the same feature with
+// a walkable normal. The single-collider sweep ignores masks, so a queryMask
+// change must drop the record: the collider may no longer be visible.
+// INVARIANT: floor decisions are identical with and without the cache.
+// HAZARD: the proof covers only the maintain probe; snap/extended/latch
+// probes always use the full query path.
+// EVIDENCE: CctDebug.groundCacheHits, groundCacheFallbacks, groundCacheRefills
+
+bool KinematicCharacterControllerLegacy::TryCachedGroundSupport(
+    const sq::Vec3& downDelta,
+    const sq::SweepFilter& groundFilter,
+    sq::Hit& outHit)
+{
+    if (!m_supportCache.valid)
+        return false;
+
+    const GroundSupportCache& cache = m_supportCache;
+    const float dropDist = sq::Len(downDelta);
+    const sq::Vec3 fromAnchor = m_currentPosition - cache.anchor;
+    const sq::Vec3 bottomCenter = m_currentPosition + m_config.up * m_geom.radius;
+    const float planeDist = sq::Dot(cache.planeNormal, bottomCenter) - cache.planeD;
+
+    bool valid = m_config.useGroundSupportCache &&
+        cache.epoch == m_world->GetStaticEpoch() &&
+        cache.queryMask == m_config.queryMask &&
+        cache.configGeneration == m_configGeneration &&
+        cache.dropDist == dropDist &&
+        cache.maxSlopeCos == m_maxSlopeCos &&
+        cache.skin == m_config.sweep.skin &&
+        cache.up.x == m_config.up.x && cache.up.y == m_config.up.y &&
+        cache.up.z == m_config.up.z &&
+        sq::LenSq(fromAnchor) <= cache.reach * cache.reach &&
+        planeDist <= m_geom.radius + m_config.sweep.skin + dropDist;
+
+    if (valid && !cache.exclusive)
+        return false; // keep the failed proof until the feet leave its radius
+
+    sq::Hit hit{};
+    if (valid) {
+        hit = m_world->SweepCapsuleAgainstCollider(
+            cache.collider, MakeSweepInput(m_currentPosition, downDelta),
+            m_config.sweep, groundFilter, true, m_queryContext);
+        valid = hit.hit && hit.featureId == cache.featureId &&
+            IsWalkable(hit.normal);
+    }
+
+    if (!valid) {
+        if (cache.exclusive)
+            m_debug.groundCacheFallbacks = 1;
+        InvalidateGroundSupportCache();
+        return false;
+    }
+
+    // Same feature; the supporting plane may still rotate on edges/vertices.
+    const sq::Vec3 hitCenter = bottomCenter + downDelta * hit.t;
+    m_supportCache.planeNormal = hit.normal;
+    m_supportCache.planeD = sq::Dot(hit.normal, hitCenter) -
+        (m_geom.radius - m_config.sweep.skin);
+    m_debug.groundCacheHits = 1;
+    outHit = hit;
+    return true;
+}
+
+void KinematicCharacterControllerLegacy::RefillGroundSupportCache(
+    const sq::Vec3& downDelta, const sq::Hit& hit)
+{
+    if (m_supportCache.valid && !m_supportCache.exclusive)
+        return; // TryCachedGroundSupport kept a recent failed proof
+    InvalidateGroundSupportCache();
+    if (!m_config.useGroundSupportCache || hit.startPenetrating)
+        return;
+
+    const float reach = m_config.groundSupportCacheRadius;
+    const float skin = m_config.sweep.skin;
+    const sq::Vec3 bottomCenter = m_currentPosition + m_config.up * m_geom.radius;
+    const sq::Vec3 segA = bottomCenter + downDelta;
+    const sq::Vec3 segB = m_currentPosition + m_config.up *
+        (m_geom.radius + 2.0f * m_geom.halfHeight);
+
+    sq::OverlapContact contacts[32];
+    const uint32_t count = m_world->OverlapCapsuleContacts(
+        segA, segB, m_geom.radius + 2.0f * skin + reach, m_config.queryMask, contacts, 32,
+        m_queryContext);
+    m_debug.groundCacheRefills = 1;
+
+    // A full contact list may have dropped another collider.
+    bool exclusive = count > 0 && count < 32;
+    for (uint32_t i = 0; exclusive && i < count; ++i)
+        exclusive = contacts[i].index == hit.index;
+
+    // Plane through the contact pulled forward by skin: the convex support
+    // collider lies entirely behind it.
+    const sq::Vec3 hitCenter = bottomCenter + downDelta * hit.t;
+    GroundSupportCache& cache = m_supportCache;
+    cache.exclusive = exclusive;
+    cache.collider = hit.index;
+    cache.featureId = hit.featureId;
+    cache.planeNormal = hit.normal;
+    cache.planeD = sq::Dot(hit.normal, hitCenter) - (m_geom.radius - skin);
+    cache.anchor = m_currentPosition;
+    cache.reach = reach;
+    cache.dropDist = sq::Len(downDelta);
+    cache.maxSlopeCos = m_maxSlopeCos;
+    cache.skin = skin;
+    cache.up = m_config.up;
+    cache.queryMask = m_config.queryMask;
+    cache.configGeneration = m_configGeneration;
+    cache.epoch = m_world->GetStaticEpoch();
+    cache.valid = true;
+}
+
 // =========================================================================
 // Initial-overlap recovery
 // =========================================================================
@@ -1018,7 +1616,8 @@ bool KinematicCharacterControllerLegacy::RecoverInitialOverlapForSweep()
 
         sq::OverlapContact contacts[32];
         uint32_t count = m_world->OverlapCapsuleContacts(
-            segA, segB, inflatedRadius, Q_Solid, contacts, 32);
+            segA, segB, inflatedRadius, m_config.queryMask, contacts, 32, m_queryContext);
+        count = AddCharacterContacts(segA, segB, inflatedRadius, contacts, count, 32);
         if (count == 0) {
             break;
         }
@@ -1090,7 +1689,8 @@ bool KinematicCharacterControllerLegacy::Recover()
 
     sq::OverlapContact contacts[32];
     uint32_t count = m_world->OverlapCapsuleContacts(
-        segA, segB, m_geom.radius, Q_Solid, contacts, 32);
+        segA, segB, m_geom.radius, m_config.queryMask, contacts, 32, m_queryContext);
+    count = AddCharacterContacts(segA, segB, m_geom.radius, contacts, count, 32);
 
     if (count == 0) return false;
 
@@ -1158,7 +1758,7 @@ bool KinematicCharacterControllerLegacy::HasWalkableSupport(float& outDepth, sq:
 
     sq::OverlapContact contacts[32];
     uint32_t count = m_world->OverlapCapsuleContacts(
-        segA, segB, supportRadius, Q_Solid, contacts, 32);
+        segA, segB, supportRadius, m_config.queryMask, contacts, 32, m_queryContext);
 
     outDepth = 0.0f;
     outNormal = {0.0f, 1.0f, 0.0f};
@@ -1225,6 +1825,7 @@ void KinematicCharacterControllerLegacy::SetModeFalling()
 {
     m_state.moveMode = CctMoveMode::Falling;
     m_state.onGround = false;
+    InvalidateGroundSupportCache();
 }
 
 bool KinematicCharacterControllerLegacy::IsWalking() const
@@ -1240,11 +1841,215 @@ bool KinematicCharacterControllerLegacy::IsFalling() const
 sq::Hit KinematicCharacterControllerLegacy::SweepClosest(
     const sq::Vec3& from, const sq::Vec3& delta,
     const sq::SweepFilter& filter,
-    bool rejectInitialOverlap) const
+    bool rejectInitialOverlap)
 {
     sq::SweepCapsuleInput in = MakeSweepInput(from, delta);
-    return m_world->SweepCapsuleClosest(in, m_config.sweep, Q_Solid,
-                                        filter, rejectInitialOverlap);
+    sq::Hit hit{};
+    if (SpeculativeSweepClear(from, delta))
+        m_debug.speculativeSkips++;
+    else
+        hit = m_world->SweepCapsuleClosest(in, m_config.sweep, m_config.queryMask,
+                                           filter, rejectInitialOverlap,
+                                           m_queryContext);
+    if (m_characterCandidateCount > 0)
+        SweepCharacters(in, filter, rejectInitialOverlap, hit);
+    return hit;
+}
+
+// =========================================================================
+// Speculative contact set
+// =========================================================================
+// PRODUCES: m_speculative (cross-tick), sweep elision in SweepClosest
+// CONSUMES: planned movement displacement, static world, static epoch
+//
+// One overlap at radius + margin around the anchor captures every static
+// solid the capsule can reach while its feet stay within reach of the anchor.
+// For a convex solid at segment distance d with closest-point normal n,
+// Dot(s - p, n) >= d for every point s of the segment, so moving the feet to
+// x keeps distance >= d + Dot(x - anchor, n). Both constraints are convex, so
+// checking the path endpoints covers the whole sweep.
+// INVARIANT: a skipped sweep is one the world sweep would have missed
+//            (clearance >= skin), so results are unchanged. Binding planes
+//            fall through to the real sweep; motion is never clipped here.
+// INVARIANT: the set only holds solids its overlap's queryMask could see.
+//            A queryMask, config generation or static epoch change drops
+//            it. Filters only remove hits, so they need no key.
+// HAZARD: only static solids. Character candidates are still swept.
+// EVIDENCE: CctDebug.speculativeRefills, speculativeSkips
+
+void KinematicCharacterControllerLegacy::PrepareSpeculativeContacts(
+    const sq::Vec3& displacement)
+{
+    if (!m_config.useSpeculativeContacts)
+        return;
+
+    SpeculativeContactSet& set = m_speculative;
+    const sq::Vec3 to = m_currentPosition + displacement;
+    if (SpeculativeSetCurrent() &&
+        sq::LenSq(m_currentPosition - set.anchor) <= set.reach * set.reach &&
+        sq::LenSq(to - set.anchor) <= set.reach * set.reach)
+        return;
+
+    const float margin = m_config.speculativeMargin + sq::Len(displacement);
+    const float skin = m_config.sweep.skin;
+    const sq::Vec3 segA = m_currentPosition + m_config.up * m_geom.radius;
+    const sq::Vec3 segB = m_currentPosition + m_config.up *
+        (m_geom.radius + 2.0f * m_geom.halfHeight);
+
+    sq::OverlapContact contacts[kMaxSpeculativePlanes];
+    const uint32_t count = m_world->OverlapCapsuleContacts(
+        segA, segB, m_geom.radius + margin, m_config.queryMask, contacts,
+        kMaxSpeculativePlanes, m_queryContext);
+    m_debug.speculativeRefills++;
+
+    set.valid = true;
+    set.complete = count < kMaxSpeculativePlanes;
+    set.anchor = m_currentPosition;
+    set.reach = margin - skin;
+    set.count = count;
+    set.queryMask = m_config.queryMask;
+    set.configGeneration = m_configGeneration;
+    set.epoch = m_world->GetStaticEpoch();
+    for (uint32_t i = 0; i < count; ++i) {
+        const float dist = m_geom.radius + margin - contacts[i].depth;
+        set.normals[i] = contacts[i].normal;
+        set.minOffset[i] = m_geom.radius + skin - dist;
+    }
+}
+
+bool KinematicCharacterControllerLegacy::SpeculativeSetCurrent() const
+{
+    const SpeculativeContactSet& set = m_speculative;
+    return set.valid &&
+        set.epoch == m_world->GetStaticEpoch() &&
+        set.queryMask == m_config.queryMask &&
+        set.configGeneration == m_configGeneration;
+}
+
+bool KinematicCharacterControllerLegacy::SpeculativeSweepClear(
+    const sq::Vec3& from, const sq::Vec3& delta) const
+{
+    const SpeculativeContactSet& set = m_speculative;
+    if (!m_config.useSpeculativeContacts || !set.complete || !SpeculativeSetCurrent())
+        return false;
+
+    const sq::Vec3 a = from - set.anchor;
+    const sq::Vec3 b = a + delta;
+    const float reachSq = set.reach * set.reach;
+    if (sq::LenSq(a) > reachSq || sq::LenSq(b) > reachSq)
+        return false;
+
+    for (uint32_t i = 0; i < set.count; ++i) {
+        if (sq::Dot(a, set.normals[i]) < set.minOffset[i] ||
+            sq::Dot(b, set.normals[i]) < set.minOffset[i])
+            return false;
+    }
+    return true;
+}
+
+// =========================================================================
+// Character collision
+// =========================================================================
+// PRODUCES: character hits merged into SweepClosest, character contacts
+//           merged into the recovery overlaps
+// CONSUMES: m_characters snapshot, m_characterCandidates (tick region)
+// INVARIANT: character normals are lateral (no up component), so another
+//            character is never walkable support or a landing floor.
+// INVARIANT: a character blocks a sweep only when the lateral normal opposes
+//            the motion. Vertical probes (StepUp, StepDown, ground) never see
+//            characters, and moving away from an overlapped character is free.
+// HAZARD: the set is a tick-start snapshot (Jacobi). Two characters resolve
+//         the same pair from opposite sides within one tick.
+// EVIDENCE: CctDebug.characterHits, characterContacts
+
+sq::Vec3 KinematicCharacterControllerLegacy::CharacterNormal(
+    const sq::Vec3& raw, const sq::Vec3& segA, const sq::Vec3& segB,
+    const sq::DynamicCapsule& other) const
+{
+    sq::Vec3 n;
+    if (BuildLateralStepMoveResponseNormal(raw, m_config.up, n))
+        return n;
+
+    // Stacked or coaxial: fall back to the center offset, then to a fixed
+    // lateral axis so the result stays a pure function of the poses.
+    const sq::Vec3 centers = (segA + segB) * 0.5f - (other.p + other.q) * 0.5f;
+    if (BuildLateralStepMoveResponseNormal(centers, m_config.up, n))
+        return n;
+    const sq::Vec3 axis = (std::fabs(m_config.up.x) < 0.9f)
+        ? sq::Vec3{1.0f, 0.0f, 0.0f} : sq::Vec3{0.0f, 0.0f, 1.0f};
+    BuildLateralStepMoveResponseNormal(axis, m_config.up, n);
+    return n;
+}
+
+void KinematicCharacterControllerLegacy::SweepCharacters(
+    const sq::SweepCapsuleInput& in, const sq::SweepFilter& filter,
+    bool rejectInitialOverlap, sq::Hit& ioHit)
+{
+    const sq::Vec3 lateralDelta =
+        in.delta - m_config.up * sq::Dot(in.delta, m_config.up);
+    if (sq::LenSq(lateralDelta) <= kMinDist * kMinDist)
+        return;
+
+    bool characterWon = false;
+    for (uint32_t i = 0; i < m_characterCandidateCount; ++i) {
+        const uint32_t other = m_characterCandidates[i];
+        const sq::DynamicCapsule& cap = m_characters->Get(other);
+
+        float t = 1.0f;
+        sq::Vec3 rawN{};
+        uint32_t feat = 0;
+        bool startPen = false;
+        float penDepth = 0.0f;
+        if (!sq::SweepCapsuleCapsule_TOI01(in, cap.p, cap.q, cap.radius,
+                                           t, rawN, feat, startPen, penDepth,
+                                           rejectInitialOverlap))
+            continue;
+        if (ioHit.hit && !(t < ioHit.t))
+            continue;
+
+        const sq::Vec3 n = CharacterNormal(rawN, in.segA0, in.segB0, cap);
+        if (sq::Dot(n, in.delta) >= -kMinDist)
+            continue;
+        if (!sq::PassNarrowfilter(&filter, rejectInitialOverlap, startPen, n))
+            continue;
+
+        ioHit.hit = true;
+        ioHit.t = t;
+        ioHit.type = sq::PrimType::Capsule;
+        ioHit.index = other;
+        ioHit.normal = n;
+        ioHit.featureId = feat;
+        ioHit.startPenetrating = startPen;
+        ioHit.penetrationDepth = penDepth;
+        characterWon = true;
+    }
+    if (characterWon)
+        m_debug.characterHits++;
+}
+
+uint32_t KinematicCharacterControllerLegacy::AddCharacterContacts(
+    const sq::Vec3& segA, const sq::Vec3& segB, float radius,
+    sq::OverlapContact* contacts, uint32_t count, uint32_t maxContacts)
+{
+    bool added = false;
+    for (uint32_t i = 0; i < m_characterCandidateCount; ++i) {
+        const uint32_t other = m_characterCandidates[i];
+        const sq::DynamicCapsule& cap = m_characters->Get(other);
+
+        sq::OverlapContact c;
+        if (!sq::OverlapCapsuleCapsule(segA, segB, radius,
+                                       cap.p, cap.q, cap.radius, c))
+            continue;
+        c.normal = CharacterNormal(c.normal, segA, segB, cap);
+        c.type = sq::PrimType::Capsule;
+        c.index = other;
+        sq::InsertOverlapContactTopK(contacts, maxContacts, count, c);
+        m_debug.characterContacts++;
+        added = true;
+    }
+    if (added)
+        std::sort(contacts, contacts + count, sq::OverlapContactBetter);
+    return count;
 }
 
 sq::SweepCapsuleInput KinematicCharacterControllerLegacy::MakeSweepInput(
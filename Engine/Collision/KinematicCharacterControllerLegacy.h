@@ -40,9 +40,12 @@
 
 #include "CctTypes.h"
 #include "CollisionWorldLegacy.h"
+#include "SceneQuery/SqDynamicCapsules.h"
 
 namespace Engine { namespace Collision {
 
+struct CctLaneBlock;
+
 class KinematicCharacterControllerLegacy {
 public:
     KinematicCharacterControllerLegacy(CollisionWorldLegacy* world,
@@ -51,13 +54,50 @@ public:
 
     void Tick(const CctInput& input, float dt);
 
-    // State
+    // ---- Lane-split tick (CctCrowd lane mode, see CctLanes.h) ----
+    // Equivalent to Tick():
+    //   BeginLaneTick -> ExportVerticalLane / IntegrateVerticalLanes /
+    //   ImportVerticalLane -> SimulateLaneTick -> ExportWritebackLane /
+    //   WritebackLanes / ImportWritebackLane -> EndLaneTick
+    void BeginLaneTick(const CctInput& input);
+    void ExportVerticalLane(const CctInput& input, CctLaneBlock& block, uint32_t lane) const;
+    void ImportVerticalLane(const CctLaneBlock& block, uint32_t lane);
+    void SimulateLaneTick(const CctInput& input, float dt);
+    void ExportWritebackLane(CctLaneBlock& block, uint32_t lane) const;
+    void ImportWritebackLane(const CctLaneBlock& block, uint32_t lane);
+    void EndLaneTick();
+
+    // ---- Sleep fast path ----
+    // An asleep controller skips whole ticks; its state is a proven fixed
+    // point for idle input. Tick() calls TrySleepTick first; CctCrowd calls
+    // it before building lane blocks. Returns true if the tick was skipped.
+    bool TrySleepTick(const CctInput& input, float dt);
+    bool isSleeping() const { return m_sleeping; }
+    // External push / config change: run the next tick in full.
+    void wake() { WakeUp(CctWakeReason::External); }
+
+    // State (setState wakes the controller)
     const CctState& getState() const { return m_state; }
     void setState(const CctState& s);
 
     // Config
     const CctConfig& getConfig() const { return m_config; }
-    CctConfig& getConfigMut() { return m_config; }
+    // Every call counts as an edit: cross-tick caches keyed on the config
+    // generation are dropped on their next validation.
+    CctConfig& getConfigMut() { ++m_configGeneration; return m_config; }
+
+    // Query context used for every CollisionWorld call (nullptr = world's
+    // main context). Controllers ticked concurrently need distinct contexts.
+    void setQueryContext(CollisionQueryContext* ctx) { m_queryContext = ctx; }
+    CollisionQueryContext* getQueryContext() const { return m_queryContext; }
+
+    // Other characters as dynamic capsules (nullptr = none). selfIndex is this
+    // controller's slot in the set. The set must stay unchanged during Tick.
+    void setCharacterSet(const sq::DynamicCapsuleHash* set, uint32_t selfIndex)
+    {
+        m_characters = set;
+        m_characterSelf = selfIndex;
+    }
 
     // Diagnostics
     const CctDebug& getDebug() const { return m_debug; }
@@ -76,14 +116,40 @@ private:
     bool Recover();
     bool RecoverInitialOverlapForSweep();
     void Writeback(float dt);
+    void BeginTickQueryRegion(const CctInput& input);
+    void EndTickQueryRegion();
+    bool TryCachedGroundSupport(const sq::Vec3& downDelta,
+                                const sq::SweepFilter& groundFilter,
+                                sq::Hit& outHit);
+    void RefillGroundSupportCache(const sq::Vec3& downDelta, const sq::Hit& hit);
+    void InvalidateGroundSupportCache() { m_supportCache.valid = false; }
+    void PrepareSpeculativeContacts(const sq::Vec3& displacement);
+    bool SpeculativeSweepClear(const sq::Vec3& from, const sq::Vec3& delta) const;
+    bool SpeculativeSetCurrent() const;
+    void UpdateSleep();
+    void WakeUp(CctWakeReason reason);
+    bool CharacterTouching() const;
 
     // ---- Helpers ----
 
     // Sweep capsule from current position along delta. Returns hit.
     // filter: optional normal predicate (Bullet-equivalent per-stage filtering).
+    // Also sweeps the tick's character candidates; a character wins only on
+    // strictly smaller t.
     sq::Hit SweepClosest(const sq::Vec3& from, const sq::Vec3& delta,
                          const sq::SweepFilter& filter = sq::SweepFilter{},
-                         bool rejectInitialOverlap = false) const;
+                         bool rejectInitialOverlap = false);
+
+    // Character-vs-character terms (see BeginTickQueryRegion).
+    void SweepCharacters(const sq::SweepCapsuleInput& in,
+                         const sq::SweepFilter& filter,
+                         bool rejectInitialOverlap, sq::Hit& ioHit);
+    uint32_t AddCharacterContacts(const sq::Vec3& segA, const sq::Vec3& segB,
+                                  float radius, sq::OverlapContact* contacts,
+                                  uint32_t count, uint32_t maxContacts);
+    sq::Vec3 CharacterNormal(const sq::Vec3& raw, const sq::Vec3& segA,
+                             const sq::Vec3& segB,
+                             const sq::DynamicCapsule& other) const;
 
     // Build SweepCapsuleInput from feet position and displacement.
     sq::SweepCapsuleInput MakeSweepInput(const sq::Vec3& posFeet,
@@ -111,15 +177,79 @@ private:
     sq::Vec3 m_originalDirection{};   // normalized walkMove (anti-oscillation check)
     float    m_currentStepOffset = 0.0f;
     bool     m_jumpStartedThisTick = false; // Falling landing gate input
+    sq::SceneQueryFrameMetrics m_frameAtTickBegin{}; // snapshot at BeginTickQueryRegion
+    CctState m_tickStartState{};      // state before PreStep (sleep fixed-point test)
+    bool     m_tickInputIdle = false;
+    float    m_tickDt = 0.0f;
 
     // ---- Persistent members ----
 
+    // Cross-tick Walking support record. Usable only while the feet stay
+    // within groundSupportCacheRadius of anchor and no other solid touched
+    // the inflated probe capsule when it was filled (exclusive). A
+    // non-exclusive record suppresses refill attempts inside the same radius.
+    struct GroundSupportCache {
+        bool     valid = false;
+        bool     exclusive = false;
+        uint32_t collider = 0;       // m_descs index of the supporting solid
+        uint32_t featureId = 0;
+        sq::Vec3 planeNormal{};      // supporting plane at the last contact
+        float    planeD = 0.0f;      // Dot(planeNormal, x) - planeD >= 0 in front
+        sq::Vec3 anchor{};           // feet position when exclusivity was proven
+        float    reach = 0.0f;       // anchor radius covered by the proof
+        float    dropDist = 0.0f;    // probe length the proof assumed
+        float    maxSlopeCos = 0.0f;
+        float    skin = 0.0f;
+        sq::Vec3 up{};
+        uint32_t queryMask = 0;      // mask of the exclusivity overlap
+        uint32_t configGeneration = 0;
+        uint32_t epoch = 0;          // CollisionWorld static epoch
+    };
+
+    static constexpr uint32_t kMaxCharacterCandidates = 16;
+    static constexpr uint32_t kMaxSpeculativePlanes = 32;
+
+    // Contact half-spaces around anchor from one overlap at radius + margin.
+    // Every static solid within margin of the anchor capsule has a plane; a
+    // feet position x keeps skin clearance from it while
+    // Dot(x - anchor, normal) >= minOffset. Solids without a plane are out of
+    // reach while |x - anchor| <= reach.
+    struct SpeculativeContactSet {
+        bool     valid = false;
+        bool     complete = false;   // overlap returned fewer than the cap
+        sq::Vec3 anchor{};
+        float    reach = 0.0f;
+        uint32_t count = 0;
+        sq::Vec3 normals[kMaxSpeculativePlanes];
+        float    minOffset[kMaxSpeculativePlanes];
+        uint32_t queryMask = 0;      // mask of the gathering overlap
+        uint32_t configGeneration = 0;
+        uint32_t epoch = 0;          // CollisionWorld static epoch
+    };
+
     CollisionWorldLegacy* m_world;
+    CollisionQueryContext* m_queryContext = nullptr;
+    const sq::DynamicCapsuleHash* m_characters = nullptr;
+    uint32_t        m_characterSelf = 0;
+    uint32_t        m_characterCandidates[kMaxCharacterCandidates] = {};
+    uint32_t        m_characterCandidateCount = 0;
     CctCapsule     m_geom;
     CctConfig       m_config;
+    uint32_t        m_configGeneration = 0;  // bumped by getConfigMut
     CctState        m_state;
     CctDebug        m_debug;
     float           m_maxSlopeCos;
+    GroundSupportCache m_supportCache;
+    SpeculativeContactSet m_speculative;
+
+    // Sleep: valid while input stays idle and epoch/dt/config generation
+    // match the sleep tick.
+    bool            m_sleeping = false;
+    uint32_t        m_idleTicks = 0;
+    uint32_t        m_sleepEpoch = 0;
+    float           m_sleepDt = 0.0f;
+    uint32_t        m_sleepConfigGeneration = 0;
+    CctWakeReason   m_pendingWake = CctWakeReason::None;
 };
 
 }} // namespace Engine::Collision
@@ -7,11 +7,17 @@
 //   StaticBVH - immutable BVH built once from a set of primitives
 //   PrimRef   - reference to a primitive (type + index + bounds + centroid)
 //   Leaf      - BVH node with primCount > 0 (stores primitives directly)
+//   Node mask - OR of the masks of every primitive below a node
+//   Split ref - a primitive clipped to the region of one subtree (SBVH)
 //
 // POLICY:
 //   - BVH is built deterministically: std::stable_sort on (centroid, type, index).
 //   - Median split on longest axis of centroid bounding box.
-//   - No SAH (surface area heuristic) — simple and deterministic is the goal.
+//   - No SAH (surface area heuristic) for object splits — simple and
+//     deterministic is the goal.
+//   - Opt-in spatial splits (BuildCtx::spatialSplits): a node may instead cut
+//     its triangle references at a plane when the SAH cost of that beats the
+//     median split. Extra references are capped by BuildCtx::splitBudget.
 //   - No dynamic updates. Rebuild if geometry changes.
 //
 // CONTRACT:
@@ -20,17 +26,36 @@
 //   - StaticBVH owns node/primIdx vectors. Geometry pointers are borrowed (C++17).
 //   - Empty BVH has a degenerate root but query code must treat prims.empty()
 //     as no candidates, not as an internal node.
+//   - Every node records its parent (root: kInvalidBVHNode) so bounded-memory
+//     traversal can backtrack without a full stack.
+//   - Node masks are exact unions; a subtree whose mask misses the query mask
+//     holds no visible primitive and may be skipped.
+//   - Without spatial splits primIdx is a permutation of prims. With them a
+//     triangle may be listed in several leaves (HasDuplicatePrimRefs); node
+//     bounds cover the clipped pieces, and the leaves together cover the
+//     whole triangle. Queries that collect results de-duplicate; sweeps and
+//     closest-point queries re-test the same primitive and keep the same hit.
+//   - triEdgeFlags (SetStaticBVHTriEdgeFlags) and triPrecomp
+//     (SetStaticBVHTriPrecomp) are borrowed like the geometry and do not
+//     affect the build.
+//   - BuildStaticBVHSubset builds over chosen prims of another tree. Their
+//     PrimRefs keep type, index and mask, so results name source primitives.
 //
 // PROOF POINTS:
 //   - [PR3.5] BuildStaticBVH with 0 prims: root node exists, primCount=0
 //   - [PR3.5] BuildStaticBVH with 1 prim: single leaf node
 //   - [PR3.5] stable_sort preserves relative order of equal-key primitives
+//   - Spatial-split trees match LinearFallback on long ramp triangles
+//     (SqBackendHarness.cpp, ExpectSpatialSplitEquivalence)
 //
 // REFERENCES:
+//   - docs/audits/scenequery/22-spatial-split-bvh.md
 //   - docs/agent-context/scenequery-refactor.md
 //   - docs/reference/physx/contracts/scenequery-pipeline.md
 //   - docs/reference/physx/contracts/mesh-sweeps-ordering.md
 //   - Ericson, RTCD Chapter 6 (BVH construction)
+//   - Stich, Friedrich, Dietrich, "Spatial Splits in Bounding Volume
+//     Hierarchies" (HPG 2009)
 // =========================================================================
 
 #include "SqTypes.h"
@@ -40,10 +65,14 @@ namespace Engine { namespace Collision { namespace sq {
 
 // ---- BVH node -----------------------------------------------------------
 
+inline constexpr uint32_t kInvalidBVHNode = 0xFFFFFFFFu;
+
 struct BVHNode {
     AABB     bounds;
     uint32_t left = 0, right = 0;
     uint32_t primStart = 0, primCount = 0;  // leaf if primCount > 0
+    uint32_t parent = kInvalidBVHNode;      // root: kInvalidBVHNode
+    uint32_t mask = 0;                      // union of primitive masks below
 };
 
 // ---- Static BVH ---------------------------------------------------------
@@ -58,6 +87,8 @@ struct StaticBVH {
     const AABB*     aabbs     = nullptr;  uint32_t aabbCount = 0;
     const OBB*      obbs      = nullptr;  uint32_t obbCount  = 0;
     const Triangle* tris      = nullptr;  uint32_t triCount  = 0;
+    const uint8_t*  triEdgeFlags = nullptr;  // per tri; nullptr: all edges active
+    const TrianglePrecomp* triPrecomp = nullptr;  // per tri; nullptr: kernels recompute
 };
 
 inline bool IsEmptyBVH(const StaticBVH& bvh)
@@ -65,11 +96,19 @@ inline bool IsEmptyBVH(const StaticBVH& bvh)
     return bvh.nodes.empty() || bvh.prims.empty();
 }
 
+// True when a spatial-split build listed some primitive in several leaves.
+inline bool HasDuplicatePrimRefs(const StaticBVH& bvh)
+{
+    return bvh.primIdx.size() > bvh.prims.size();
+}
+
 // ---- Build parameters ---------------------------------------------------
 
 struct BuildCtx {
-    uint32_t leafSize    = 4;      // max primitives per leaf
-    float    centroidEps = 1e-6f;  // degenerate centroid bbox threshold
+    uint32_t leafSize      = 4;      // max primitives per leaf
+    float    centroidEps   = 1e-6f;  // degenerate centroid bbox threshold
+    bool     spatialSplits = false;  // SBVH: allow clipping triangle refs
+    float    splitBudget   = 0.5f;   // max extra refs, as a fraction of prims
 };
 
 // ---- Internal build helpers ---------------------------------------------
@@ -99,10 +138,12 @@ inline BuildResult BuildRange(StaticBVH& bvh, uint32_t start, uint32_t count,
     const float INF = std::numeric_limits<float>::infinity();
     AABB bounds{+INF,+INF,+INF, -INF,-INF,-INF};
     AABB cb = bounds;
+    uint32_t mask = 0;
 
     for (uint32_t i = 0; i < count; ++i) {
         const PrimRef& p = bvh.prims[bvh.primIdx[start + i]];
         bounds = UnionAABB(bounds, p.bounds);
+        mask |= p.mask;
         cb.minX = (std::min)(cb.minX, p.centroid.x);
         cb.minY = (std::min)(cb.minY, p.centroid.y);
         cb.minZ = (std::min)(cb.minZ, p.centroid.z);
@@ -114,6 +155,7 @@ inline BuildResult BuildRange(StaticBVH& bvh, uint32_t start, uint32_t count,
     if (count <= ctx.leafSize || DegenerateCentroids(cb, ctx.centroidEps)) {
         uint32_t idx = (uint32_t)bvh.nodes.size();
         BVHNode n{}; n.bounds = bounds; n.primStart = start; n.primCount = count;
+        n.mask = mask;
         bvh.nodes.push_back(n);
         return {idx, bounds};
     }
@@ -144,10 +186,287 @@ inline BuildResult BuildRange(StaticBVH& bvh, uint32_t start, uint32_t count,
     n.bounds = UnionAABB(L.bounds, R.bounds);
     n.left = L.node;
     n.right = R.node;
+    n.mask = mask;
+    bvh.nodes.push_back(n);
+    bvh.nodes[L.node].parent = idx;
+    bvh.nodes[R.node].parent = idx;
+    return {idx, bvh.nodes[idx].bounds};
+}
+
+// ---- Spatial-split build (SBVH) -------------------------------------------
+// Each reference is one primitive clipped to the region of the subtree that
+// holds it. A node tries the median object split above and, when its two
+// halves overlap, a few planes across its longest axis. A spatial split sends
+// whole references to the side they lie on and a clipped piece of every
+// straddling triangle to both sides. It wins only on a strictly lower SAH
+// cost with budget left. Other primitive types are never cut; a straddling
+// box goes whole to the side of its centroid.
+
+inline constexpr uint32_t kSpatialSplitPlanes = 8;      // candidate cuts = planes - 1
+inline constexpr float    kSpatialSplitAlpha  = 1e-5f;  // overlap area / root area gate
+inline constexpr float    kSpatialSplitPad    = 1e-4f;  // clip rounding slack
+
+struct SpatialRef {
+    AABB     bounds;
+    uint32_t prim = 0;
+};
+
+inline AABB EmptyAABB()
+{
+    const float INF = std::numeric_limits<float>::infinity();
+    return {+INF,+INF,+INF, -INF,-INF,-INF};
+}
+
+inline bool ValidAABB(const AABB& b)
+{
+    return b.minX <= b.maxX && b.minY <= b.maxY && b.minZ <= b.maxZ;
+}
+
+inline float HalfSurfaceArea(const AABB& b)
+{
+    if (!ValidAABB(b)) return 0.0f;
+    const float ex = b.maxX - b.minX, ey = b.maxY - b.minY, ez = b.maxZ - b.minZ;
+    return ex * ey + ey * ez + ez * ex;
+}
+
+inline float AxisValue(const Vec3& v, int axis)
+{
+    return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z;
+}
+
+inline float& AxisMin(AABB& b, int axis) { return (axis == 0) ? b.minX : (axis == 1) ? b.minY : b.minZ; }
+inline float& AxisMax(AABB& b, int axis) { return (axis == 0) ? b.maxX : (axis == 1) ? b.maxY : b.maxZ; }
+inline float AxisMin(const AABB& b, int axis) { return (axis == 0) ? b.minX : (axis == 1) ? b.minY : b.minZ; }
+inline float AxisMax(const AABB& b, int axis) { return (axis == 0) ? b.maxX : (axis == 1) ? b.maxY : b.maxZ; }
+
+inline AABB GrowAABB(const AABB& b, const Vec3& p)
+{
+    return UnionAABB(b, AABB{p.x, p.y, p.z, p.x, p.y, p.z});
+}
+
+inline AABB IntersectAABB(const AABB& a, const AABB& b)
+{
+    return {
+        (std::max)(a.minX, b.minX), (std::max)(a.minY, b.minY), (std::max)(a.minZ, b.minZ),
+        (std::min)(a.maxX, b.maxX), (std::min)(a.maxY, b.maxY), (std::min)(a.maxZ, b.maxZ)
+    };
+}
+
+// Cuts a triangle reference at axis = pos. Each side is the box of the
+// triangle's vertices and edge crossings on that side, padded by
+// kSpatialSplitPad (the crossings are rounded) and kept inside refBounds.
+// A side that holds no part of the triangle comes back invalid.
+inline void SplitTriangleRef(const Triangle& tri, const AABB& refBounds,
+                             int axis, float pos, AABB& left, AABB& right)
+{
+    const Vec3 v[3] = { tri.p0, tri.p1, tri.p2 };
+    left = EmptyAABB();
+    right = EmptyAABB();
+    for (int i = 0; i < 3; ++i) {
+        const Vec3& a = v[i];
+        const Vec3& b = v[(i + 1) % 3];
+        const float va = AxisValue(a, axis);
+        const float vb = AxisValue(b, axis);
+        if (va <= pos) left = GrowAABB(left, a);
+        if (va >= pos) right = GrowAABB(right, a);
+        if ((va < pos && vb > pos) || (va > pos && vb < pos)) {
+            const Vec3 c = a + (b - a) * ((pos - va) / (vb - va));
+            left = GrowAABB(left, c);
+            right = GrowAABB(right, c);
+        }
+    }
+
+    AABB* sides[2] = { &left, &right };
+    for (AABB* side : sides) {
+        if (!ValidAABB(*side)) continue;
+        const float e = kSpatialSplitPad;
+        const AABB padded{ side->minX - e, side->minY - e, side->minZ - e,
+                           side->maxX + e, side->maxY + e, side->maxZ + e };
+        *side = IntersectAABB(padded, refBounds);
+    }
+    if (ValidAABB(left))
+        AxisMax(left, axis) = (std::min)(AxisMax(left, axis), pos + kSpatialSplitPad);
+    if (ValidAABB(right))
+        AxisMin(right, axis) = (std::max)(AxisMin(right, axis), pos - kSpatialSplitPad);
+}
+
+enum class SpatialSide : uint8_t { Left, Right, Both };
+
+// Side of one reference for the cut axis = pos; fills the clipped boxes.
+inline SpatialSide ClassifySpatialRef(const StaticBVH& bvh, const SpatialRef& ref,
+                                      int axis, float pos, AABB& left, AABB& right)
+{
+    left = right = ref.bounds;
+    if (AxisMax(ref.bounds, axis) <= pos) return SpatialSide::Left;
+    if (AxisMin(ref.bounds, axis) >= pos) return SpatialSide::Right;
+
+    const PrimRef& p = bvh.prims[ref.prim];
+    if (p.type != PrimType::Tri) {
+        const float c = 0.5f * (AxisMin(ref.bounds, axis) + AxisMax(ref.bounds, axis));
+        return (c < pos) ? SpatialSide::Left : SpatialSide::Right;
+    }
+
+    SplitTriangleRef(bvh.tris[p.index], ref.bounds, axis, pos, left, right);
+    if (!ValidAABB(right)) { left = ref.bounds; return SpatialSide::Left; }
+    if (!ValidAABB(left))  { right = ref.bounds; return SpatialSide::Right; }
+    return SpatialSide::Both;
+}
+
+struct SpatialSplitEval {
+    float    cost = std::numeric_limits<float>::infinity();
+    float    pos = 0.0f;
+    uint32_t leftCount = 0, rightCount = 0, dups = 0;
+};
+
+inline SpatialSplitEval EvalSpatialSplit(const StaticBVH& bvh,
+                                         const std::vector<SpatialRef>& refs,
+                                         int axis, float pos)
+{
+    SpatialSplitEval e{};
+    e.pos = pos;
+    AABB lb = EmptyAABB(), rb = EmptyAABB();
+    for (const SpatialRef& ref : refs) {
+        AABB l, r;
+        const SpatialSide side = ClassifySpatialRef(bvh, ref, axis, pos, l, r);
+        if (side != SpatialSide::Right) { lb = UnionAABB(lb, l); ++e.leftCount; }
+        if (side != SpatialSide::Left)  { rb = UnionAABB(rb, r); ++e.rightCount; }
+        if (side == SpatialSide::Both) ++e.dups;
+    }
+    e.cost = HalfSurfaceArea(lb) * static_cast<float>(e.leftCount)
+           + HalfSurfaceArea(rb) * static_cast<float>(e.rightCount);
+    return e;
+}
+
+inline BuildResult EmitSpatialLeaf(StaticBVH& bvh, const std::vector<SpatialRef>& refs,
+                                   const AABB& bounds, uint32_t mask)
+{
+    const uint32_t idx = static_cast<uint32_t>(bvh.nodes.size());
+    BVHNode n{};
+    n.bounds = bounds;
+    n.primStart = static_cast<uint32_t>(bvh.primIdx.size());
+    n.primCount = static_cast<uint32_t>(refs.size());
+    n.mask = mask;
+    for (const SpatialRef& ref : refs)
+        bvh.primIdx.push_back(ref.prim);
+    bvh.nodes.push_back(n);
+    return {idx, bounds};
+}
+
+// Leaves append their references to primIdx in build order; children are
+// emitted before their parent, as in BuildRange.
+inline BuildResult BuildSpatialRange(StaticBVH& bvh, std::vector<SpatialRef>& refs,
+                                     const BuildCtx& ctx, float rootArea, uint32_t& budget)
+{
+    AABB bounds = EmptyAABB();
+    AABB cb = bounds;
+    uint32_t mask = 0;
+    for (const SpatialRef& ref : refs) {
+        bounds = UnionAABB(bounds, ref.bounds);
+        mask |= bvh.prims[ref.prim].mask;
+        cb = GrowAABB(cb, AABBCenter(ref.bounds));
+    }
+
+    const uint32_t count = static_cast<uint32_t>(refs.size());
+    if (count <= ctx.leafSize || DegenerateCentroids(cb, ctx.centroidEps))
+        return EmitSpatialLeaf(bvh, refs, bounds, mask);
+
+    // Object split: the median split of BuildRange over clipped centroids.
+    const int axis = ChooseAxis(cb);
+    std::stable_sort(refs.begin(), refs.end(), [&](const SpatialRef& ra, const SpatialRef& rb) {
+        const float a = AxisValue(AABBCenter(ra.bounds), axis);
+        const float b = AxisValue(AABBCenter(rb.bounds), axis);
+        if (a < b) return true;
+        if (a > b) return false;
+        const PrimRef& A = bvh.prims[ra.prim];
+        const PrimRef& B = bvh.prims[rb.prim];
+        if ((uint8_t)A.type != (uint8_t)B.type) return (uint8_t)A.type < (uint8_t)B.type;
+        return A.index < B.index;
+    });
+    const uint32_t mid = count / 2;
+    AABB objL = EmptyAABB(), objR = EmptyAABB();
+    for (uint32_t i = 0; i < mid; ++i) objL = UnionAABB(objL, refs[i].bounds);
+    for (uint32_t i = mid; i < count; ++i) objR = UnionAABB(objR, refs[i].bounds);
+    const float objCost = HalfSurfaceArea(objL) * static_cast<float>(mid)
+                        + HalfSurfaceArea(objR) * static_cast<float>(count - mid);
+
+    // Spatial split: only where the object halves overlap noticeably.
+    SpatialSplitEval best{};
+    int splitAxis = ChooseAxis(bounds);
+    if (budget > 0 && HalfSurfaceArea(IntersectAABB(objL, objR)) > kSpatialSplitAlpha * rootArea) {
+        const float lo = AxisMin(bounds, splitAxis);
+        const float ext = AxisMax(bounds, splitAxis) - lo;
+        for (uint32_t k = 1; k < kSpatialSplitPlanes; ++k) {
+            const float pos = lo + ext * static_cast<float>(k) / static_cast<float>(kSpatialSplitPlanes);
+            const SpatialSplitEval e = EvalSpatialSplit(bvh, refs, splitAxis, pos);
+            if (e.leftCount == 0 || e.rightCount == 0 || e.leftCount == count
+                || e.rightCount == count || e.dups > budget)
+                continue;
+            if (e.cost < best.cost)
+                best = e;
+        }
+    }
+
+    std::vector<SpatialRef> left, right;
+    if (best.cost < objCost) {
+        budget -= best.dups;
+        left.reserve(best.leftCount);
+        right.reserve(best.rightCount);
+        for (const SpatialRef& ref : refs) {
+            AABB l, r;
+            const SpatialSide side = ClassifySpatialRef(bvh, ref, splitAxis, best.pos, l, r);
+            if (side != SpatialSide::Right) left.push_back({ l, ref.prim });
+            if (side != SpatialSide::Left)  right.push_back({ r, ref.prim });
+        }
+    } else {
+        left.assign(refs.begin(), refs.begin() + mid);
+        right.assign(refs.begin() + mid, refs.end());
+    }
+    refs.clear();
+    refs.shrink_to_fit();
+
+    BuildResult L = BuildSpatialRange(bvh, left, ctx, rootArea, budget);
+    BuildResult R = BuildSpatialRange(bvh, right, ctx, rootArea, budget);
+
+    uint32_t idx = (uint32_t)bvh.nodes.size();
+    BVHNode n{};
+    n.bounds = UnionAABB(L.bounds, R.bounds);
+    n.left = L.node;
+    n.right = R.node;
+    n.mask = mask;
     bvh.nodes.push_back(n);
+    bvh.nodes[L.node].parent = idx;
+    bvh.nodes[R.node].parent = idx;
     return {idx, bvh.nodes[idx].bounds};
 }
 
+// Builds nodes and primIdx over bvh.prims, which the caller has filled.
+inline void BuildStaticBVHNodes(StaticBVH& bvh, const BuildCtx& ctx)
+{
+    bvh.primIdx.resize(bvh.prims.size());
+    for (uint32_t i = 0; i < (uint32_t)bvh.primIdx.size(); ++i) bvh.primIdx[i] = i;
+
+    bvh.nodes.reserve(bvh.prims.size() * 2);
+
+    if (bvh.prims.empty()) {
+        // Empty BVH: single degenerate root
+        BVHNode n{};
+        bvh.nodes.push_back(n);
+        bvh.root = 0;
+    } else if (ctx.spatialSplits) {
+        std::vector<SpatialRef> refs(bvh.prims.size());
+        for (uint32_t i = 0; i < (uint32_t)refs.size(); ++i) refs[i] = { bvh.prims[i].bounds, i };
+        AABB rootBounds = EmptyAABB();
+        for (const SpatialRef& ref : refs) rootBounds = UnionAABB(rootBounds, ref.bounds);
+        uint32_t budget = static_cast<uint32_t>(ctx.splitBudget * static_cast<float>(refs.size()));
+        bvh.primIdx.clear();
+        BuildResult r = BuildSpatialRange(bvh, refs, ctx, HalfSurfaceArea(rootBounds), budget);
+        bvh.root = r.node;
+    } else {
+        BuildResult r = BuildRange(bvh, 0, (uint32_t)bvh.prims.size(), ctx);
+        bvh.root = r.node;
+    }
+}
+
 // ---- Public API: build a static BVH from geometry arrays (C++17) --------
 
 inline StaticBVH BuildStaticBVH(const AABB* aabbs, uint32_t aabbCount,
@@ -180,22 +499,64 @@ inline StaticBVH BuildStaticBVH(const AABB* aabbs, uint32_t aabbCount,
         bvh.prims.push_back(p);
     }
 
-    bvh.primIdx.resize(bvh.prims.size());
-    for (uint32_t i = 0; i < (uint32_t)bvh.primIdx.size(); ++i) bvh.primIdx[i] = i;
+    BuildStaticBVHNodes(bvh, ctx);
+    return bvh;
+}
 
-    bvh.nodes.reserve(bvh.prims.size() * 2);
+// Builds a tree over a subset of source.prims. The PrimRefs keep their type,
+// index and mask and the geometry pointers are shared, so hits and contacts
+// name the same primitives as source.
+inline StaticBVH BuildStaticBVHSubset(const StaticBVH& source,
+                                      const std::vector<uint32_t>& primIds,
+                                      const BuildCtx& ctx = {})
+{
+    StaticBVH bvh;
+    bvh.aabbs = source.aabbs;  bvh.aabbCount = source.aabbCount;
+    bvh.obbs  = source.obbs;   bvh.obbCount  = source.obbCount;
+    bvh.tris  = source.tris;   bvh.triCount  = source.triCount;
+    bvh.triEdgeFlags = source.triEdgeFlags;
+    bvh.triPrecomp = source.triPrecomp;
 
-    if (bvh.prims.empty()) {
-        // Empty BVH: single degenerate root
-        BVHNode n{};
-        bvh.nodes.push_back(n);
-        bvh.root = 0;
-    } else {
-        BuildResult r = BuildRange(bvh, 0, (uint32_t)bvh.prims.size(), ctx);
-        bvh.root = r.node;
-    }
+    bvh.prims.reserve(primIds.size());
+    for (uint32_t id : primIds)
+        bvh.prims.push_back(source.prims[id]);
 
+    BuildStaticBVHNodes(bvh, ctx);
     return bvh;
 }
 
+// Borrows per-triangle active-edge flags (indexed like the tris array, see
+// SqMeshCook.h). Topology is unchanged; only the sweep kernels read them.
+inline void SetStaticBVHTriEdgeFlags(StaticBVH& bvh, const uint8_t* triEdgeFlags)
+{
+    bvh.triEdgeFlags = triEdgeFlags;
+}
+
+// Borrows per-triangle narrowphase data (indexed like the tris array, see
+// BuildTrianglePrecomp). It must describe the same triangles; the sweep,
+// overlap and closest-point kernels read it instead of recomputing.
+inline void SetStaticBVHTriPrecomp(StaticBVH& bvh, const TrianglePrecomp* triPrecomp)
+{
+    bvh.triPrecomp = triPrecomp;
+}
+
+// Assigns per-primitive query masks (indexed like bvh.prims) and recomputes
+// node unions. BuildRange emits children before parents, so one ascending
+// pass sees every child first.
+inline void SetStaticBVHPrimMasks(StaticBVH& bvh, const uint32_t* primMasks)
+{
+    for (uint32_t i = 0; i < static_cast<uint32_t>(bvh.prims.size()); ++i)
+        bvh.prims[i].mask = primMasks[i];
+
+    for (BVHNode& node : bvh.nodes) {
+        if (node.primCount) {
+            node.mask = 0;
+            for (uint32_t k = 0; k < node.primCount; ++k)
+                node.mask |= bvh.prims[bvh.primIdx[node.primStart + k]].mask;
+        } else if (!bvh.prims.empty()) {
+            node.mask = bvh.nodes[node.left].mask | bvh.nodes[node.right].mask;
+        }
+    }
+}
+
 }}} // namespace Engine::Collision::sq
@@ -10,6 +10,9 @@
 // child-test path is a packetized AABB rejection prototype over the same nodes.
 //
 // Invariant: BVH4 traversal reuses the same primitive/contact collectors as BinaryBVH.
+// Each slot carries the mask union of its subtree; hidden slots are dropped
+// before the child AABB test. Sweep child windows the filter cull rejects
+// are dropped before leaves are visited or nodes pushed.
 // =========================================================================
 
 #include "SqQuery.h"
@@ -33,6 +36,7 @@ struct BVH4BuildCtx {
 
 struct BVH4Slot {
     AABB bounds{};
+    uint32_t mask = 0;  // union of primitive masks below this slot
     uint32_t index = 0; // leaf: primIdx start, internal: node index
     uint32_t count = 0; // leaf: primitive count, internal: 0
     bool active = false;
@@ -107,6 +111,7 @@ inline void RefreshBVH4NodeBoundsSoA(BVH4Node& node)
 struct BVH4RangeInfo {
     AABB bounds{};
     AABB centroidBounds{};
+    uint32_t mask = 0;
 };
 
 inline BVH4RangeInfo ComputeBVH4RangeInfo(const StaticBVH4& bvh,
@@ -121,6 +126,7 @@ inline BVH4RangeInfo ComputeBVH4RangeInfo(const StaticBVH4& bvh,
     for (uint32_t i = 0; i < count; ++i) {
         const PrimRef& p = bvh.sourceView.prims[bvh.primIdx[start + i]];
         info.bounds = UnionAABB(info.bounds, p.bounds);
+        info.mask |= p.mask;
         info.centroidBounds.minX = (std::min)(info.centroidBounds.minX, p.centroid.x);
         info.centroidBounds.minY = (std::min)(info.centroidBounds.minY, p.centroid.y);
         info.centroidBounds.minZ = (std::min)(info.centroidBounds.minZ, p.centroid.z);
@@ -175,6 +181,7 @@ inline uint32_t BuildBVH4NodeRange(StaticBVH4& bvh,
         node.slots[0].active = true;
         node.slots[0].leaf = true;
         node.slots[0].bounds = info.bounds;
+        node.slots[0].mask = info.mask;
         node.slots[0].index = start;
         node.slots[0].count = count;
         RefreshBVH4NodeBoundsSoA(node);
@@ -198,6 +205,7 @@ inline uint32_t BuildBVH4NodeRange(StaticBVH4& bvh,
         BVH4Slot slot{};
         slot.active = true;
         slot.bounds = childInfo.bounds;
+        slot.mask = childInfo.mask;
         if (ShouldMakeBVH4Leaf(rangeCount, childInfo.centroidBounds, ctx)) {
             slot.leaf = true;
             slot.index = rangeStart;
@@ -216,6 +224,18 @@ inline uint32_t BuildBVH4NodeRange(StaticBVH4& bvh,
     return nodeIndex;
 }
 
+// Active slots whose mask union meets the query mask.
+inline uint32_t VisibleBVH4SlotMask(const BVH4Node& node, uint32_t queryMask,
+                                    QueryMetrics& metrics)
+{
+    uint32_t visible = node.boundsSoA.activeMask;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if ((visible & (1u << i)) && !PassQueryMask(node.slots[i].mask, queryMask, &metrics))
+            visible &= ~(1u << i);
+    }
+    return visible;
+}
+
 struct BVH4SweepChildHit {
     uint32_t slotIndex = 0;
     float tEnter = 0.0f;
@@ -236,13 +256,14 @@ inline uint32_t GatherBVH4SweepChildHits(
     const NodeTask& parent,
     float bestT,
     BVH4SweepChildHit* outHits,
-    QueryMetrics& metrics)
+    QueryMetrics& metrics,
+    uint32_t queryMask)
 {
     uint32_t hitCount = 0;
 
     for (uint32_t i = 0; i < node.childCount; ++i) {
         const BVH4Slot& slot = node.slots[i];
-        if (!slot.active)
+        if (!slot.active || !PassQueryMask(slot.mask, queryMask, &metrics))
             continue;
 
         float cE = parent.tEnter;
@@ -289,11 +310,13 @@ inline uint32_t RefineBVH4SweepAxisPacket(
         return mask & static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(geMin, leMax)));
     }
 
-    const __m128 invV = _mm_set1_ps(1.0f / velocity);
+    // Divide like AabbAabb_SweepInterval: a reciprocal multiply rounds the
+    // window ends differently and can clip a hit the scalar path keeps.
+    const __m128 velocityV = _mm_set1_ps(velocity);
     const __m128 aMinV = _mm_set1_ps(aMin);
     const __m128 aMaxV = _mm_set1_ps(aMax);
-    const __m128 t0 = _mm_mul_ps(_mm_sub_ps(bMinV, aMaxV), invV);
-    const __m128 t1 = _mm_mul_ps(_mm_sub_ps(bMaxV, aMinV), invV);
+    const __m128 t0 = _mm_div_ps(_mm_sub_ps(bMinV, aMaxV), velocityV);
+    const __m128 t1 = _mm_div_ps(_mm_sub_ps(bMaxV, aMinV), velocityV);
     const __m128 axisEnter = _mm_min_ps(t0, t1);
     const __m128 axisExit = _mm_max_ps(t0, t1);
 
@@ -310,9 +333,10 @@ inline uint32_t GatherBVH4SweepChildHitsPacket(
     const NodeTask& parent,
     float bestT,
     BVH4SweepChildHit* outHits,
-    QueryMetrics& metrics)
+    QueryMetrics& metrics,
+    uint32_t queryMask)
 {
-    const uint32_t activeMask = node.boundsSoA.activeMask;
+    const uint32_t activeMask = VisibleBVH4SlotMask(node, queryMask, metrics);
     const uint32_t activeCount = CountBVH4Mask(activeMask);
     if (!activeMask)
         return 0;
@@ -377,9 +401,10 @@ inline uint32_t GatherBVH4SweepChildHitsPacket(
 inline uint32_t GatherBVH4OverlapChildMaskPacket(
     const BVH4Node& node,
     const AABB& capBounds,
-    QueryMetrics& metrics)
+    QueryMetrics& metrics,
+    uint32_t queryMask)
 {
-    const uint32_t activeMask = node.boundsSoA.activeMask;
+    const uint32_t activeMask = VisibleBVH4SlotMask(node, queryMask, metrics);
     const uint32_t activeCount = CountBVH4Mask(activeMask);
     if (!activeMask)
         return 0;
@@ -431,16 +456,20 @@ inline void ConsiderBVH4LeafSweep(
     const SweepFilter& filter,
     bool rejectInitialOverlap,
     Hit& best,
-    QueryMetrics* metrics)
+    QueryMetrics* metrics,
+    uint32_t queryMask,
+    const SweepFilterCull* cull)
 {
     if (metrics)
         ++metrics->leafNodesVisited;
 
     for (uint32_t i = 0; i < slot.count; ++i) {
         const PrimRef& pref = bvh.sourceView.prims[bvh.primIdx[slot.index + i]];
+        if (!PassQueryMask(pref.mask, queryMask, metrics))
+            continue;
         ConsiderSweepCapsulePrim(bvh.sourceView, in, cfg, cap0, pref,
                                  tEnter, tExit, filter, rejectInitialOverlap,
-                                 best, metrics);
+                                 best, metrics, cull);
     }
 }
 
@@ -455,18 +484,42 @@ inline void VisitBVH4SweepLeafHits(
     const SweepFilter& filter,
     bool rejectInitialOverlap,
     Hit& best,
-    QueryMetrics* metrics)
+    QueryMetrics* metrics,
+    uint32_t queryMask,
+    const SweepFilterCull* cull)
 {
     for (uint32_t i = 0; i < hitCount; ++i) {
         const BVH4Slot& slot = node.slots[hits[i].slotIndex];
         if (slot.leaf) {
             ConsiderBVH4LeafSweep(
                 bvh, in, cfg, cap0, slot, hits[i].tEnter, hits[i].tExit,
-                filter, rejectInitialOverlap, best, metrics);
+                filter, rejectInitialOverlap, best, metrics, queryMask, cull);
         }
     }
 }
 
+// Drops child windows the filter cull rejects; keeps the near-first order.
+inline uint32_t CullBVH4SweepChildHits(
+    const BVH4Node& node,
+    const SweepFilterCull& cull,
+    BVH4SweepChildHit* hits,
+    uint32_t hitCount,
+    QueryMetrics& metrics)
+{
+    if (!cull.active)
+        return hitCount;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < hitCount; ++i) {
+        if (SweepFilterCulls(cull, node.slots[hits[i].slotIndex].bounds,
+                             hits[i].tEnter, hits[i].tExit)) {
+            ++metrics.filterCulls;
+            continue;
+        }
+        hits[kept++] = hits[i];
+    }
+    return kept;
+}
+
 inline void PushBVH4SweepChildNodes(
     const BVH4Node& node,
     const BVH4SweepChildHit* hits,
@@ -491,13 +544,16 @@ inline void ConsiderBVH4LeafOverlap(
     OverlapContact* outContacts,
     uint32_t maxContacts,
     uint32_t& contactCount,
-    QueryMetrics* metrics)
+    QueryMetrics* metrics,
+    uint32_t queryMask)
 {
     if (metrics)
         ++metrics->leafNodesVisited;
 
     for (uint32_t i = 0; i < slot.count; ++i) {
         const PrimRef& pref = bvh.sourceView.prims[bvh.primIdx[slot.index + i]];
+        if (!PassQueryMask(pref.mask, queryMask, metrics))
+            continue;
         if (metrics)
             ++metrics->primitiveAabbTests;
         if (!TestAabbAabb(capBounds, pref.bounds)) {
@@ -531,7 +587,8 @@ inline Hit RunBVH4SweepClosest(
     QueryScratch& scratch,
     const SweepFilter& filter,
     bool rejectInitialOverlap,
-    QueryBackend backend)
+    QueryBackend backend,
+    uint32_t queryMask)
 {
     Hit best{};
     best.hit = false;
@@ -542,6 +599,7 @@ inline Hit RunBVH4SweepClosest(
         return best;
 
     const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
     PushQueryTask(scratch, { bvh.root, 0.0f, best.t });
 
     while (scratch.sp) {
@@ -564,21 +622,24 @@ inline Hit RunBVH4SweepClosest(
         uint32_t hitCount = 0;
         if constexpr (Path == BVH4ChildTestPath::Packet) {
             hitCount = GatherBVH4SweepChildHitsPacket(
-                node, cap0, in.delta, task, best.t, hits, scratch.metrics);
+                node, cap0, in.delta, task, best.t, hits, scratch.metrics, queryMask);
         } else {
             hitCount = GatherBVH4SweepChildHits(
-                node, cap0, in.delta, task, best.t, hits, scratch.metrics);
+                node, cap0, in.delta, task, best.t, hits, scratch.metrics, queryMask);
         }
 
+        hitCount = CullBVH4SweepChildHits(node, cull, hits, hitCount, scratch.metrics);
+
         VisitBVH4SweepLeafHits(
             bvh, in, cfg, cap0, node, hits, hitCount,
-            filter, rejectInitialOverlap, best, &scratch.metrics);
+            filter, rejectInitialOverlap, best, &scratch.metrics, queryMask, &cull);
         PushBVH4SweepChildNodes(node, hits, hitCount, scratch);
     }
 
     if (scratch.overflowed) {
         Hit fallback = SweepCapsuleClosestHit_LinearFallback(
-            bvh.sourceView, in, cfg, filter, rejectInitialOverlap, &scratch.metrics);
+            bvh.sourceView, in, cfg, filter, rejectInitialOverlap, &scratch.metrics,
+            queryMask);
         FinishSweepQueryMetrics(scratch.metrics, fallback);
         return fallback;
     }
@@ -596,7 +657,8 @@ inline uint32_t RunBVH4OverlapContacts(
     OverlapContact* outContacts,
     uint32_t maxContacts,
     QueryScratch& scratch,
-    QueryBackend backend)
+    QueryBackend backend,
+    uint32_t queryMask)
 {
     ResetQueryScratch(scratch, QueryKind::OverlapCapsuleContacts, backend);
     if (maxContacts == 0) {
@@ -622,7 +684,7 @@ inline uint32_t RunBVH4OverlapContacts(
         uint32_t acceptedMask = 0;
         if constexpr (Path == BVH4ChildTestPath::Packet) {
             acceptedMask = GatherBVH4OverlapChildMaskPacket(
-                node, capBounds, scratch.metrics);
+                node, capBounds, scratch.metrics, queryMask);
         }
 
         for (uint32_t i = 0; i < node.childCount; ++i) {
@@ -634,6 +696,8 @@ inline uint32_t RunBVH4OverlapContacts(
                 if (!(acceptedMask & (1u << i)))
                     continue;
             } else {
+                if (!PassQueryMask(slot.mask, queryMask, &scratch.metrics))
+                    continue;
                 ++scratch.metrics.nodeAabbTests;
                 if (!TestAabbAabb(capBounds, slot.bounds)) {
                     ++scratch.metrics.nodeAabbRejects;
@@ -644,7 +708,7 @@ inline uint32_t RunBVH4OverlapContacts(
             if (slot.leaf) {
                 ConsiderBVH4LeafOverlap(
                     bvh, segA, segB, radius, capBounds, slot,
-                    outContacts, maxContacts, contactCount, &scratch.metrics);
+                    outContacts, maxContacts, contactCount, &scratch.metrics, queryMask);
             } else {
                 PushQueryTask(scratch, { slot.index, 0.0f, 1.0f });
             }
@@ -654,7 +718,7 @@ inline uint32_t RunBVH4OverlapContacts(
     if (scratch.overflowed) {
         const uint32_t fallbackCount = OverlapCapsuleContacts_LinearFallback(
             bvh.sourceView, segA, segB, radius, outContacts, maxContacts,
-            &scratch.metrics);
+            &scratch.metrics, queryMask);
         FinishOverlapQueryMetrics(scratch.metrics, fallbackCount);
         return fallbackCount;
     }
@@ -666,6 +730,8 @@ inline uint32_t RunBVH4OverlapContacts(
 
 } // namespace detail
 
+// Partitions source.prims by object median. A spatial-split source keeps its
+// prims, but its repeated references are not carried into the BVH4.
 inline StaticBVH4 BuildStaticBVH4(const StaticBVH& source,
                                   const BVH4BuildCtx& ctx = {})
 {
@@ -694,10 +760,11 @@ inline Hit SweepCapsuleClosestHit_BVH4(
     const SweepConfig& cfg,
     QueryScratch& scratch,
     const SweepFilter& filter = SweepFilter{},
-    bool rejectInitialOverlap = false)
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
 {
     return detail::RunBVH4SweepClosest<detail::BVH4ChildTestPath::Scalar>(
-        bvh, in, cfg, scratch, filter, rejectInitialOverlap, QueryBackend::BVH4);
+        bvh, in, cfg, scratch, filter, rejectInitialOverlap, QueryBackend::BVH4, queryMask);
 }
 
 inline uint32_t OverlapCapsuleContacts_BVH4(
@@ -707,11 +774,12 @@ inline uint32_t OverlapCapsuleContacts_BVH4(
     float radius,
     OverlapContact* outContacts,
     uint32_t maxContacts,
-    QueryScratch& scratch)
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
 {
     return detail::RunBVH4OverlapContacts<detail::BVH4ChildTestPath::Scalar>(
         bvh, segA, segB, radius, outContacts, maxContacts, scratch,
-        QueryBackend::BVH4);
+        QueryBackend::BVH4, queryMask);
 }
 
 inline Hit SweepCapsuleClosestHit_BVH4SimdChildTest(
@@ -720,10 +788,12 @@ inline Hit SweepCapsuleClosestHit_BVH4SimdChildTest(
     const SweepConfig& cfg,
     QueryScratch& scratch,
     const SweepFilter& filter = SweepFilter{},
-    bool rejectInitialOverlap = false)
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
 {
     return detail::RunBVH4SweepClosest<detail::BVH4ChildTestPath::Packet>(
-        bvh, in, cfg, scratch, filter, rejectInitialOverlap, QueryBackend::BVH4Simd);
+        bvh, in, cfg, scratch, filter, rejectInitialOverlap, QueryBackend::BVH4Simd,
+        queryMask);
 }
 
 inline uint32_t OverlapCapsuleContacts_BVH4SimdChildTest(
@@ -733,11 +803,12 @@ inline uint32_t OverlapCapsuleContacts_BVH4SimdChildTest(
     float radius,
     OverlapContact* outContacts,
     uint32_t maxContacts,
-    QueryScratch& scratch)
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
 {
     return detail::RunBVH4OverlapContacts<detail::BVH4ChildTestPath::Packet>(
         bvh, segA, segB, radius, outContacts, maxContacts, scratch,
-        QueryBackend::BVH4Simd);
+        QueryBackend::BVH4Simd, queryMask);
 }
 
 }}} // namespace Engine::Collision::sq
@@ -0,0 +1,372 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/13-short-stack-bvh-traversal.md
+//
+// TERMINOLOGY:
+//   ShortStackScratch - fixed-capacity ring of pending sibling tasks
+//   Eviction          - dropping the oldest (root-most) pending sibling when
+//                       the ring is full
+//   Restart           - resuming after evictions by walking parent pointers
+//                       from the last finished node
+//
+// POLICY:
+//   - Memory per query is bounded by ShortStackScratch::Capacity, never O(depth).
+//   - No LinearFallback: evicted work is recovered via BVHNode::parent.
+//   - Child order is a pure function of (node, query): raw sweep tEnter over
+//     [0,1], ties keep left first. Backtracking recomputes the same order.
+//   - Hit/contact collection reuses ConsiderSweepCapsulePrim and
+//     InsertOverlapContactTopK; results match BinaryBVH and LinearFallback.
+//
+// CONTRACT:
+//   - The ring holds only pending "second" children of ancestors of the
+//     current node, oldest at the bottom. Evicting the bottom therefore loses
+//     only work that a parent walk from the finished cursor rediscovers.
+//   - Child tests use the [0, best.t] window. A child box lies inside its
+//     parent box, so this equals the parent-window test of BinaryBVH.
+//   - queryMask prunes node mask unions on descent and on the parent walk
+//     alike; a masked child never passes, so the walk cannot resurrect it.
+//   - The sweep filter cull runs when a task is taken, like BinaryBVH. A
+//     culled subtree counts as finished; culling only drops contacts that
+//     the filter would reject, so restarts stay exact.
+//
+// PROOF POINTS:
+//   - Harness: ShortStackBVH matches LinearFallback on smoke + dense fixtures.
+//   - Harness: capacity-limited run reports traversalRestarts > 0,
+//     fallbackUsed == false, and identical hits/contacts.
+//   - Harness: ExpectQueryMaskEquivalence covers both short-stack queries,
+//     with and without evictions.
+// =========================================================================
+
+#include "SqQuery.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace Engine { namespace Collision { namespace sq {
+
+// ---- Bounded traversal scratch ------------------------------------------
+// 16 entries cover any BVH up to depth 16 without evictions. capacityLimit
+// lets tests force evictions on small fixtures; it is clamped to Capacity.
+
+struct ShortStackScratch {
+    static constexpr uint32_t Capacity = 16;
+
+    NodeTask ring[Capacity];
+    uint32_t base = 0;
+    uint32_t count = 0;
+    uint32_t capacityLimit = Capacity;
+    bool evicted = false;
+    QueryMetrics metrics{};
+};
+
+inline void ResetShortStackScratch(ShortStackScratch& scratch, QueryKind kind)
+{
+    scratch.base = 0;
+    scratch.count = 0;
+    scratch.evicted = false;
+    if (scratch.capacityLimit == 0 || scratch.capacityLimit > ShortStackScratch::Capacity)
+        scratch.capacityLimit = ShortStackScratch::Capacity;
+    ResetQueryMetrics(scratch.metrics, kind, QueryBackend::BinaryBVHShortStack);
+}
+
+inline void PushShortStackTask(ShortStackScratch& scratch, const NodeTask& task)
+{
+    if (scratch.count >= scratch.capacityLimit) {
+        scratch.base = (scratch.base + 1u) % ShortStackScratch::Capacity;
+        --scratch.count;
+        scratch.evicted = true;
+        scratch.metrics.overflowed = true;
+        ++scratch.metrics.stackEvictions;
+    }
+
+    scratch.ring[(scratch.base + scratch.count) % ShortStackScratch::Capacity] = task;
+    ++scratch.count;
+    if (scratch.metrics.maxStackDepth < scratch.count)
+        scratch.metrics.maxStackDepth = scratch.count;
+}
+
+inline NodeTask PopShortStackTask(ShortStackScratch& scratch)
+{
+    --scratch.count;
+    return scratch.ring[(scratch.base + scratch.count) % ShortStackScratch::Capacity];
+}
+
+namespace detail {
+
+// Raw sweep entry time over [0,1]; +inf when the child is never touched or
+// masked out. Only the parent walk needs it: the order must survive best.t
+// shrinking.
+inline float ShortStackOrderKey(const StaticBVH& bvh, const AABB& cap0,
+                                const Vec3& delta, uint32_t child,
+                                uint32_t queryMask, QueryMetrics& metrics)
+{
+    if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &metrics))
+        return std::numeric_limits<float>::infinity();
+    float tE = 0.0f;
+    float tL = 1.0f;
+    ++metrics.nodeAabbTests;
+    if (!AabbAabb_SweepInterval(cap0, delta, bvh.nodes[child].bounds, tE, tL))
+        return std::numeric_limits<float>::infinity();
+    return tE;
+}
+
+inline void OrderSweepChildren(const StaticBVH& bvh, const AABB& cap0,
+                               const Vec3& delta, const BVHNode& node,
+                               uint32_t& first, uint32_t& second,
+                               uint32_t queryMask, QueryMetrics& metrics)
+{
+    const float leftKey = ShortStackOrderKey(bvh, cap0, delta, node.left, queryMask, metrics);
+    const float rightKey = ShortStackOrderKey(bvh, cap0, delta, node.right, queryMask, metrics);
+    const bool leftFirst = leftKey <= rightKey;
+    first = leftFirst ? node.left : node.right;
+    second = leftFirst ? node.right : node.left;
+}
+
+inline bool MakeShortStackSweepTask(const StaticBVH& bvh, const AABB& cap0,
+                                    const Vec3& delta, uint32_t child, float bestT,
+                                    NodeTask& out, uint32_t queryMask,
+                                    QueryMetrics& metrics)
+{
+    const NodeTask window{ child, 0.0f, bestT };
+    return MakeClosestSweepChildTask(bvh, cap0, delta, child, window, bestT, out, metrics,
+                                     queryMask);
+}
+
+} // namespace detail
+
+// =========================================================================
+// Capsule sweep closest hit, bounded-memory traversal
+// =========================================================================
+//
+// Algorithm:
+//   1. Descend into the first passing child; push the passing second child.
+//   2. When a subtree finishes, pop the ring. If the ring is empty and an
+//      eviction happened, walk parent pointers from the finished cursor: the
+//      first ancestor entered through its first child whose second child
+//      still passes is the next subtree (one restart).
+//   3. Stop when the ring is empty and the walk reaches the root.
+inline Hit SweepCapsuleClosestHit_ShortStack(
+    const StaticBVH& bvh,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    ShortStackScratch& scratch,
+    const SweepFilter& filter = SweepFilter{},
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    Hit best{};
+    best.hit = false;
+    best.t = 1.0f;
+
+    ResetShortStackScratch(scratch, QueryKind::SweepCapsuleClosest);
+
+    if (IsEmptyBVH(bvh))
+        return best;
+
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
+    QueryMetrics& metrics = scratch.metrics;
+
+    NodeTask task{};
+    bool active = detail::MakeShortStackSweepTask(
+        bvh, cap0, in.delta, bvh.root, best.t, task, queryMask, metrics);
+    uint32_t cursor = bvh.root;
+
+    while (active) {
+        ++metrics.nodesPopped;
+        bool finished = true;
+
+        if (task.tExit > best.t)
+            task.tExit = best.t;
+        const BVHNode& node = bvh.nodes[task.node];
+        if (task.tEnter >= best.t) {
+            ++metrics.nodeTimePrunes;
+        } else if (SweepFilterCulls(cull, node.bounds, task.tEnter, task.tExit)) {
+            ++metrics.filterCulls;
+        } else {
+            if (node.primCount) {
+                ++metrics.leafNodesVisited;
+                for (uint32_t k = 0; k < node.primCount; ++k) {
+                    const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + k]];
+                    if (!PassQueryMask(pref.mask, queryMask, &metrics))
+                        continue;
+                    ConsiderSweepCapsulePrim(bvh, in, cfg, cap0, pref,
+                                             task.tEnter, task.tExit,
+                                             filter, rejectInitialOverlap, best,
+                                             &metrics, &cull);
+                }
+            } else {
+                // A passing child's tEnter equals its raw order key, so the
+                // descent order matches what the parent walk recomputes.
+                NodeTask leftTask{}, rightTask{};
+                const bool leftHit = detail::MakeShortStackSweepTask(
+                    bvh, cap0, in.delta, node.left, best.t, leftTask, queryMask, metrics);
+                const bool rightHit = detail::MakeShortStackSweepTask(
+                    bvh, cap0, in.delta, node.right, best.t, rightTask, queryMask, metrics);
+                if (leftHit && rightHit) {
+                    const bool leftFirst = leftTask.tEnter <= rightTask.tEnter;
+                    PushShortStackTask(scratch, leftFirst ? rightTask : leftTask);
+                    task = leftFirst ? leftTask : rightTask;
+                    finished = false;
+                } else if (leftHit || rightHit) {
+                    task = leftHit ? leftTask : rightTask;
+                    finished = false;
+                }
+            }
+        }
+
+        if (!finished)
+            continue;
+
+        cursor = task.node;
+        if (scratch.count) {
+            task = PopShortStackTask(scratch);
+            continue;
+        }
+
+        active = false;
+        if (!scratch.evicted)
+            break;
+
+        // Parent walk: recover the nearest evicted sibling, if any.
+        ++metrics.traversalRestarts;
+        uint32_t child = cursor;
+        uint32_t parent = bvh.nodes[child].parent;
+        while (parent != kInvalidBVHNode) {
+            uint32_t first = 0, second = 0;
+            detail::OrderSweepChildren(bvh, cap0, in.delta, bvh.nodes[parent],
+                                       first, second, queryMask, metrics);
+            if (child == first &&
+                detail::MakeShortStackSweepTask(bvh, cap0, in.delta, second,
+                                                best.t, task, queryMask, metrics)) {
+                active = true;
+                break;
+            }
+            child = parent;
+            parent = bvh.nodes[child].parent;
+        }
+    }
+
+    FinishSweepQueryMetrics(metrics, best);
+    return best;
+}
+
+// =========================================================================
+// Capsule overlap contacts, bounded-memory traversal
+// =========================================================================
+// Same ring/parent-walk scheme with a fixed left-then-right child order.
+inline uint32_t OverlapCapsuleContacts_ShortStack(
+    const StaticBVH& bvh,
+    const Vec3& segA, const Vec3& segB, float radius,
+    OverlapContact* outContacts, uint32_t maxContacts,
+    ShortStackScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    ResetShortStackScratch(scratch, QueryKind::OverlapCapsuleContacts);
+    if (maxContacts == 0) {
+        FinishOverlapQueryMetrics(scratch.metrics, 0);
+        return 0;
+    }
+    if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
+
+    if (IsEmptyBVH(bvh)) return 0;
+
+    const AABB capBounds = CapsuleAabbStatic(segA, segB, radius);
+    QueryMetrics& metrics = scratch.metrics;
+    uint32_t contactCount = 0;
+    const bool dupRefs = HasDuplicatePrimRefs(bvh);
+
+    auto childHit = [&](uint32_t child) {
+        if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &metrics))
+            return false;
+        ++metrics.nodeAabbTests;
+        if (TestAabbAabb(capBounds, bvh.nodes[child].bounds))
+            return true;
+        ++metrics.nodeAabbRejects;
+        return false;
+    };
+
+    bool active = childHit(bvh.root);
+    uint32_t current = bvh.root;
+
+    while (active) {
+        ++metrics.nodesPopped;
+        const BVHNode& node = bvh.nodes[current];
+        bool finished = true;
+
+        if (node.primCount) {
+            ++metrics.leafNodesVisited;
+            for (uint32_t k = 0; k < node.primCount; ++k) {
+                const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + k]];
+                if (!PassQueryMask(pref.mask, queryMask, &metrics))
+                    continue;
+                ++metrics.primitiveAabbTests;
+                if (!TestAabbAabb(capBounds, pref.bounds)) {
+                    ++metrics.primitiveAabbRejects;
+                    continue;
+                }
+                if (dupRefs && OverlapContactsHoldPrim(outContacts, contactCount, pref)) {
+                    ++metrics.duplicateRefSkips;
+                    continue;
+                }
+
+                OverlapContact contact;
+                ++metrics.narrowphaseCalls;
+                if (!OverlapCapsulePrim(bvh, segA, segB, radius, pref, contact))
+                    continue;
+
+                ++metrics.rawHits;
+                ++metrics.acceptedHits;
+                contact.type = pref.type;
+                contact.index = pref.index;
+                InsertOverlapContactTopK(outContacts, maxContacts, contactCount, contact,
+                                         &metrics);
+            }
+        } else {
+            const bool leftHit = childHit(node.left);
+            const bool rightHit = childHit(node.right);
+            if (leftHit) {
+                if (rightHit)
+                    PushShortStackTask(scratch, { node.right, 0.0f, 0.0f });
+                current = node.left;
+                finished = false;
+            } else if (rightHit) {
+                current = node.right;
+                finished = false;
+            }
+        }
+
+        if (!finished)
+            continue;
+
+        if (scratch.count) {
+            current = PopShortStackTask(scratch).node;
+            continue;
+        }
+
+        active = false;
+        if (!scratch.evicted)
+            break;
+
+        ++metrics.traversalRestarts;
+        uint32_t child = current;
+        uint32_t parent = bvh.nodes[child].parent;
+        while (parent != kInvalidBVHNode) {
+            const BVHNode& p = bvh.nodes[parent];
+            if (child == p.left && childHit(p.right)) {
+                current = p.right;
+                active = true;
+                break;
+            }
+            child = parent;
+            parent = p.parent;
+        }
+    }
+
+    std::sort(outContacts, outContacts + contactCount, OverlapContactBetter);
+    FinishOverlapQueryMetrics(metrics, contactCount);
+    return contactCount;
+}
+
+}}} // namespace Engine::Collision::sq
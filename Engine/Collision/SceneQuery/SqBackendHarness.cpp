@@ -1,12 +1,30 @@
 #include "SqBackendHarness.h"
 
+#include "../CollisionQueryBudget.h"
+#include "../CollisionQueryJobs.h"
+#include "../CollisionWorldRebuild.h"
+#include "../CollisionWorldLegacy.h"
 #include "SqBVH4.h"
+#include "SqBVHShortStack.h"
+#include "SqClosestPoint.h"
+#include "SqDynamicCapsules.h"
+#include "SqHeightfield.h"
+#include "SqLocalSet.h"
+#include "SqMeshCook.h"
+#include "SqPlane.h"
 #include "SqQuery.h"
+#include "SqQueryMemo.h"
+#include "SqTriggerPairs.h"
+#include "SqUniformGrid.h"
 
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -34,6 +52,7 @@ struct HarnessWorld {
     std::vector<AABB> aabbs;
     StaticBVH bvh;
     StaticBVH4 bvh4;
+    UniformGrid grid;
 };
 
 const char* BackendName(SceneQueryBackendId backend)
@@ -43,6 +62,8 @@ const char* BackendName(SceneQueryBackendId backend)
         case SceneQueryBackendId::BinaryBVH: return "BinaryBVH";
         case SceneQueryBackendId::ScalarBVH4: return "ScalarBVH4";
         case SceneQueryBackendId::SimdBVH4: return "SimdBVH4";
+        case SceneQueryBackendId::ShortStackBVH: return "ShortStackBVH";
+        case SceneQueryBackendId::UniformGrid: return "UniformGrid";
         default: return "Unknown";
     }
 }
@@ -52,6 +73,23 @@ AABB Box(float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
     return {minX, minY, minZ, maxX, maxY, maxZ};
 }
 
+// Spacing-2 cells from the floor of the boxes' XZ minimum, so harness grids
+// (boxes at 2*i .. 2*i+1) land one box per cell.
+UniformGridDesc HarnessGridDesc(const std::vector<AABB>& aabbs)
+{
+    UniformGridDesc desc{};
+    if (aabbs.empty())
+        return desc;
+    AABB xz = aabbs[0];
+    for (const AABB& b : aabbs)
+        xz = UnionAABB(xz, b);
+    desc.originX = std::floor(xz.minX);
+    desc.originZ = std::floor(xz.minZ);
+    desc.sizeX = static_cast<uint32_t>((xz.maxX - desc.originX) / desc.spacing) + 1u;
+    desc.sizeZ = static_cast<uint32_t>((xz.maxZ - desc.originZ) / desc.spacing) + 1u;
+    return desc;
+}
+
 HarnessWorld BuildWorld(std::vector<AABB> aabbs)
 {
     HarnessWorld world{};
@@ -60,6 +98,7 @@ HarnessWorld BuildWorld(std::vector<AABB> aabbs)
                                static_cast<uint32_t>(world.aabbs.size()),
                                nullptr, 0, nullptr, 0);
     world.bvh4 = BuildStaticBVH4(world.bvh);
+    world.grid = BuildUniformGrid(world.bvh, HarnessGridDesc(world.aabbs));
     return world;
 }
 
@@ -182,6 +221,18 @@ SweepRun RunSweep(SceneQueryBackendId backend,
             run.metrics = scratch.metrics;
             break;
         }
+        case SceneQueryBackendId::ShortStackBVH: {
+            ShortStackScratch scratch{};
+            run.hit = SweepCapsuleClosestHit_ShortStack(world.bvh, input, cfg, scratch, filter, false);
+            run.metrics = scratch.metrics;
+            break;
+        }
+        case SceneQueryBackendId::UniformGrid: {
+            QueryScratch scratch{};
+            run.hit = SweepCapsuleClosestHit_UniformGrid(world.grid, input, cfg, scratch, filter, false);
+            run.metrics = scratch.metrics;
+            break;
+        }
     }
     return run;
 }
@@ -226,6 +277,22 @@ OverlapRun RunOverlap(SceneQueryBackendId backend,
             run.metrics = scratch.metrics;
             break;
         }
+        case SceneQueryBackendId::ShortStackBVH: {
+            ShortStackScratch scratch{};
+            run.count = OverlapCapsuleContacts_ShortStack(
+                world.bvh, segA, segB, radius, run.contacts, kMaxHarnessContacts,
+                scratch);
+            run.metrics = scratch.metrics;
+            break;
+        }
+        case SceneQueryBackendId::UniformGrid: {
+            QueryScratch scratch{};
+            run.count = OverlapCapsuleContacts_UniformGrid(
+                world.grid, segA, segB, radius, run.contacts, kMaxHarnessContacts,
+                scratch);
+            run.metrics = scratch.metrics;
+            break;
+        }
     }
     return run;
 }
@@ -242,9 +309,15 @@ void ExpectSweepEquivalent(const HarnessWorld& world,
                                    world, input, cfg);
     const SweepRun bvh4Simd = RunSweep(SceneQueryBackendId::SimdBVH4,
                                        world, input, cfg);
+    const SweepRun shortStack = RunSweep(SceneQueryBackendId::ShortStackBVH,
+                                         world, input, cfg);
+    const SweepRun grid = RunSweep(SceneQueryBackendId::UniformGrid,
+                                   world, input, cfg);
     assert(SameHit(linear.hit, binary.hit));
     assert(SameHit(linear.hit, bvh4.hit));
     assert(SameHit(linear.hit, bvh4Simd.hit));
+    assert(SameHit(linear.hit, shortStack.hit));
+    assert(SameHit(linear.hit, grid.hit));
     ExpectBVH4PacketMetricContract(world, bvh4.metrics, bvh4Simd.metrics);
 }
 
@@ -261,9 +334,15 @@ void ExpectOverlapEquivalent(const HarnessWorld& world,
                                        world, segA, segB, radius);
     const OverlapRun bvh4Simd = RunOverlap(SceneQueryBackendId::SimdBVH4,
                                            world, segA, segB, radius);
+    const OverlapRun shortStack = RunOverlap(SceneQueryBackendId::ShortStackBVH,
+                                             world, segA, segB, radius);
+    const OverlapRun grid = RunOverlap(SceneQueryBackendId::UniformGrid,
+                                       world, segA, segB, radius);
     assert(SameContacts(linear, binary));
     assert(SameContacts(linear, bvh4));
     assert(SameContacts(linear, bvh4Simd));
+    assert(SameContacts(linear, shortStack));
+    assert(SameContacts(linear, grid));
     ExpectBVH4PacketMetricContract(world, bvh4.metrics, bvh4Simd.metrics);
 }
 
@@ -279,10 +358,14 @@ void ExpectEqualTimeSweepTieBreak(const SweepConfig& cfg)
     const SweepRun binary = RunSweep(SceneQueryBackendId::BinaryBVH, world, query, cfg);
     const SweepRun bvh4 = RunSweep(SceneQueryBackendId::ScalarBVH4, world, query, cfg);
     const SweepRun bvh4Simd = RunSweep(SceneQueryBackendId::SimdBVH4, world, query, cfg);
+    const SweepRun shortStack = RunSweep(SceneQueryBackendId::ShortStackBVH, world, query, cfg);
+    const SweepRun grid = RunSweep(SceneQueryBackendId::UniformGrid, world, query, cfg);
 
     assert(SameHit(linear.hit, binary.hit));
     assert(SameHit(linear.hit, bvh4.hit));
     assert(SameHit(linear.hit, bvh4Simd.hit));
+    assert(SameHit(linear.hit, shortStack.hit));
+    assert(SameHit(linear.hit, grid.hit));
     assert(linear.hit.hit && linear.hit.type == PrimType::Aabb && linear.hit.index == 0);
     assert(binary.hit.hit && binary.hit.type == PrimType::Aabb && binary.hit.index == 0);
     assert(bvh4.hit.hit && bvh4.hit.type == PrimType::Aabb && bvh4.hit.index == 0);
@@ -309,10 +392,16 @@ void ExpectEqualDepthOverlapTopK()
                                        world, segA, segB, radius);
     const OverlapRun bvh4Simd = RunOverlap(SceneQueryBackendId::SimdBVH4,
                                            world, segA, segB, radius);
+    const OverlapRun shortStack = RunOverlap(SceneQueryBackendId::ShortStackBVH,
+                                             world, segA, segB, radius);
+    const OverlapRun grid = RunOverlap(SceneQueryBackendId::UniformGrid,
+                                       world, segA, segB, radius);
 
     assert(SameContacts(linear, binary));
     assert(SameContacts(linear, bvh4));
     assert(SameContacts(linear, bvh4Simd));
+    assert(SameContacts(linear, shortStack));
+    assert(SameContacts(linear, grid));
     assert(linear.count == kMaxOverlapContacts);
     for (uint32_t i = 0; i < linear.count; ++i) {
         assert(linear.contacts[i].type == PrimType::Aabb);
@@ -388,6 +477,115 @@ SweepCapsuleInput DenseGridQuery(uint32_t i, uint32_t depth)
     return MakeCapsuleSweep({-2.0f, 0.0f, z}, {50.0f, 0.0f, 0.0f});
 }
 
+// Capacity-limited short stack must evict, restart via parent pointers, and
+// still match the oracle without touching the linear fallback.
+void ExpectShortStackRestartEquivalence()
+{
+    const HarnessWorld world = BuildDenseGrid(20, 20);
+    const SweepConfig cfg{};
+    uint32_t restarts = 0;
+
+    for (uint32_t i = 0; i < 20; ++i) {
+        const SweepCapsuleInput query = DenseGridQuery(i, 20);
+        const SweepRun linear = RunSweep(SceneQueryBackendId::LinearFallback, world, query, cfg);
+        ShortStackScratch scratch{};
+        scratch.capacityLimit = 1;
+        const Hit hit = SweepCapsuleClosestHit_ShortStack(world.bvh, query, cfg, scratch);
+        assert(SameHit(linear.hit, hit));
+        assert(!scratch.metrics.fallbackUsed);
+        restarts += scratch.metrics.traversalRestarts;
+    }
+
+    const Vec3 segA{9.0f, -0.5f, 9.0f};
+    const Vec3 segB{9.0f,  0.5f, 9.0f};
+    const float radius = 3.0f;
+    const OverlapRun linear = RunOverlap(SceneQueryBackendId::LinearFallback,
+                                         world, segA, segB, radius);
+    OverlapRun shortStack{};
+    ShortStackScratch scratch{};
+    scratch.capacityLimit = 1;
+    shortStack.count = OverlapCapsuleContacts_ShortStack(
+        world.bvh, segA, segB, radius, shortStack.contacts, kMaxHarnessContacts, scratch);
+    assert(SameContacts(linear, shortStack));
+    assert(!scratch.metrics.fallbackUsed);
+    restarts += scratch.metrics.traversalRestarts;
+
+    assert(restarts > 0);
+    (void)restarts;
+}
+
+// Contained queries served from a gathered local set must equal the oracle.
+void ExpectLocalSetEquivalence()
+{
+    const HarnessWorld world = BuildDenseGrid(20, 20);
+    const SweepConfig cfg{};
+    LocalQuerySet set{};
+    QueryScratch scratch{};
+
+    for (uint32_t i = 0; i < 20; ++i) {
+        const float x = static_cast<float>(i) * 1.9f + 0.5f;
+        const float z = static_cast<float>(i % 7) * 2.0f + 1.5f;
+        const SweepCapsuleInput query = MakeCapsuleSweep({x, 0.0f, z}, {1.5f, -0.25f, 0.75f});
+        const AABB region = ExpandAabb(SweptCapsuleBounds(query, cfg), 0.5f);
+        GatherLocalQuerySet(world.bvh, region, set, scratch);
+        assert(LocalQuerySetContains(set, SweptCapsuleBounds(query, cfg)));
+
+        QueryMetrics metrics{};
+        const SweepRun linear = RunSweep(SceneQueryBackendId::LinearFallback, world, query, cfg);
+        const Hit local = SweepCapsuleClosestHit_LocalSet(world.bvh, set, query, cfg, metrics);
+        assert(SameHit(linear.hit, local));
+        assert(metrics.nodeAabbTests == 0);
+
+        const Vec3 segA = query.segA0;
+        const Vec3 segB = query.segB0;
+        const float radius = 0.75f;
+        assert(LocalQuerySetContains(set, CapsuleAabbStatic(segA, segB, radius)));
+        const OverlapRun linearOverlap = RunOverlap(SceneQueryBackendId::LinearFallback,
+                                                    world, segA, segB, radius);
+        OverlapRun localOverlap{};
+        localOverlap.count = OverlapCapsuleContacts_LocalSet(
+            world.bvh, set, segA, segB, radius, localOverlap.contacts,
+            kMaxHarnessContacts, metrics);
+        assert(SameContacts(linearOverlap, localOverlap));
+    }
+}
+
+void ExpectQueryMemoRefilterEquivalence()
+{
+    const HarnessWorld world = BuildDenseGrid(20, 20);
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    std::vector<SweepCandidate> candidates;
+
+    SweepFilter filters[3]{};
+    filters[1].active = true;
+    filters[1].refDir = {0.0f, 1.0f, 0.0f};
+    filters[1].minDot = 0.7f;
+    filters[2].active = true;
+    filters[2].refDir = {-1.0f, 0.0f, 0.0f};
+    filters[2].minDot = 0.0f;
+    filters[2].filterInitialOverlap = true;
+
+    for (uint32_t i = 0; i < 20; ++i) {
+        const SweepCapsuleInput query = DenseGridQuery(i, 20);
+        CollectSweepCandidates(world.bvh, query, cfg, scratch, candidates);
+
+        // One candidate list serves every filter/flag variant.
+        for (const SweepFilter& filter : filters) {
+            for (const bool reject : { false, true }) {
+                QueryMetrics metrics{};
+                const Hit oracle = SweepCapsuleClosestHit_LinearFallback(
+                    world.bvh, query, cfg, filter, reject);
+                const Hit refiltered = SweepCapsuleClosestHit_Candidates(
+                    world.bvh, candidates.data(), static_cast<uint32_t>(candidates.size()),
+                    query, cfg, filter, reject, metrics);
+                assert(SameHit(oracle, refiltered));
+                assert(metrics.nodeAabbTests == 0);
+            }
+        }
+    }
+}
+
 SceneQueryBackendBenchmarkRow RunBenchmarkBackend(
     SceneQueryBackendId backend,
     const HarnessWorld& world,
@@ -459,9 +657,2437 @@ bool DetectOverlapTopologyRisk()
                                            {0.0f, -0.5f, 0.0f},
                                            {0.0f, 0.5f, 0.0f},
                                            1.5f);
+    const OverlapRun shortStack = RunOverlap(SceneQueryBackendId::ShortStackBVH,
+                                             world,
+                                             {0.0f, -0.5f, 0.0f},
+                                             {0.0f, 0.5f, 0.0f},
+                                             1.5f);
     return !SameContacts(linear, binary)
         || !SameContacts(linear, bvh4)
-        || !SameContacts(linear, bvh4Simd);
+        || !SameContacts(linear, bvh4Simd)
+        || !SameContacts(linear, shortStack);
+}
+
+template <typename... Args>
+void AppendReportLine(char* out, size_t outSize, size_t& used,
+                      const char* format, Args... args)
+{
+    if (used >= outSize)
+        return;
+    const int written = std::snprintf(out + used, outSize - used, format, args...);
+    if (written > 0)
+        used = std::min(outSize - 1, used + static_cast<size_t>(written));
+}
+
+void AppendBenchmarkRow(char* out, size_t outSize, size_t& used,
+                        const SceneQueryBackendBenchmarkRow& row)
+{
+    AppendReportLine(out, outSize, used,
+        "%s: ns/query=%.1f nodeAabbTests=%llu nodePackets=%llu packetLanes=%llu primitiveAabbTests=%llu narrowphaseCalls=%llu maxStack=%u restarts=%llu fallback=%u mismatches=%u\n",
+        BackendName(row.backend),
+        row.NsPerQuery(),
+        static_cast<unsigned long long>(row.metrics.nodeAabbTests),
+        static_cast<unsigned long long>(row.metrics.nodeAabbPackets),
+        static_cast<unsigned long long>(row.metrics.nodeAabbPacketLanes),
+        static_cast<unsigned long long>(row.metrics.primitiveAabbTests),
+        static_cast<unsigned long long>(row.metrics.narrowphaseCalls),
+        row.metrics.maxStackDepth,
+        static_cast<unsigned long long>(row.metrics.traversalRestarts),
+        row.metrics.fallbackCount,
+        row.mismatches);
+}
+
+// Hash gather must equal a brute-force AABB scan; capsule kernels must agree
+// with the analytic head-on contact.
+void ExpectDynamicCapsuleHashEquivalence()
+{
+    std::vector<DynamicCapsule> capsules;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const float x = static_cast<float>(i % 8) * 1.7f + static_cast<float>(i % 3) * 0.2f;
+        const float z = static_cast<float>(i / 8) * 1.3f;
+        capsules.push_back({{x, 0.5f, z}, {x, 1.5f, z}, 0.5f});
+    }
+    DynamicCapsuleHash hash;
+    hash.Build(capsules.data(), static_cast<uint32_t>(capsules.size()), 1.0f);
+
+    uint32_t gathered[kMaxHarnessContacts];
+    for (uint32_t i = 0; i < 16; ++i) {
+        const Vec3 c{static_cast<float>(i) * 0.9f, 1.0f, static_cast<float>(i % 5) * 2.1f};
+        const AABB region = ExpandAabb(CapsuleAabbStatic(c, c, 0.5f), 1.0f);
+        uint32_t total = 0;
+        const uint32_t count = hash.Gather(region, i, gathered, kMaxHarnessContacts, &total);
+        assert(count == total);
+
+        uint32_t expected = 0;
+        for (uint32_t k = 0; k < hash.Size(); ++k) {
+            const AABB b = CapsuleAabbStatic(capsules[k].p, capsules[k].q, capsules[k].radius);
+            const bool overlaps = b.minX <= region.maxX && b.maxX >= region.minX &&
+                                  b.minY <= region.maxY && b.maxY >= region.minY &&
+                                  b.minZ <= region.maxZ && b.maxZ >= region.minZ;
+            if (k == i || !overlaps)
+                continue;
+            assert(expected < count && gathered[expected] == k);
+            ++expected;
+        }
+        assert(expected == count);
+
+        // A full output still counts every capsule once, whatever it spans.
+        uint32_t few[2];
+        uint32_t fewTotal = 0;
+        const uint32_t fewCount = hash.Gather(region, i, few, 2, &fewTotal);
+        assert(fewTotal == total && fewCount == (std::min)(total, 2u));
+        assert(fewCount < 1 || few[0] == gathered[0]);
+        assert(fewCount < 2 || few[1] == gathered[1]);
+        (void)fewCount;
+    }
+
+    SweepCapsuleInput in{};
+    in.segA0 = {0.0f, 0.5f, 0.0f};
+    in.segB0 = {0.0f, 1.5f, 0.0f};
+    in.radius = 0.5f;
+    in.delta = {10.0f, 0.0f, 0.0f};
+    float t = 1.0f;
+    float depth = 0.0f;
+    Vec3 n{};
+    uint32_t feat = 0;
+    bool startPen = false;
+    const bool hit = SweepCapsuleCapsule_TOI01(in, {5.0f, 0.5f, 0.0f}, {5.0f, 1.5f, 0.0f},
+                                               0.5f, t, n, feat, startPen, depth);
+    assert(hit && !startPen && Near(t, 0.4f, kHitTEps) && SameNormal(n, {-1.0f, 0.0f, 0.0f}));
+
+    OverlapContact contact{};
+    const bool overlap = OverlapCapsuleCapsule(in.segA0, in.segB0, in.radius,
+                                               {0.75f, 0.0f, 0.0f}, {0.75f, 2.0f, 0.0f},
+                                               0.5f, contact);
+    assert(overlap && Near(contact.depth, 0.25f, kDepthEps) &&
+           SameNormal(contact.normal, {-1.0f, 0.0f, 0.0f}));
+    (void)hit;
+    (void)overlap;
+}
+
+bool SameClosestPoint(const ClosestPointResult& a, const ClosestPointResult& b)
+{
+    if (a.hit != b.hit)
+        return false;
+    if (!a.hit)
+        return true;
+    return a.type == b.type && a.index == b.index && a.featureId == b.featureId &&
+           Near(a.distance, b.distance, kDepthEps) && SameNormal(a.normal, b.normal);
+}
+
+// Best-first closest point must pick the linear-scan winner on every backend.
+void ExpectClosestPointEquivalence()
+{
+    std::vector<AABB> aabbs;
+    for (uint32_t z = 0; z < 8; ++z)
+        for (uint32_t x = 0; x < 8; ++x) {
+            const float fx = static_cast<float>(x) * 3.0f;
+            const float fz = static_cast<float>(z) * 3.0f;
+            aabbs.push_back(Box(fx, 0.0f, fz, fx + 1.0f + 0.1f * static_cast<float>(z),
+                                1.0f + 0.2f * static_cast<float>(x), fz + 1.0f));
+        }
+    std::vector<OBB> obbs;
+    for (uint32_t i = 0; i < 6; ++i) {
+        const float c = 0.8f, s = 0.6f;
+        const float fi = static_cast<float>(i);
+        obbs.push_back({{fi * 4.0f + 1.5f, 2.5f, 10.5f}, {c, 0.0f, s}, {0.0f, 1.0f, 0.0f},
+                        {-s, 0.0f, c}, {0.7f, 0.4f, 0.3f}});
+    }
+    std::vector<Triangle> tris;
+    for (uint32_t i = 0; i < 12; ++i) {
+        const float fi = static_cast<float>(i) * 2.0f;
+        tris.push_back({{fi, 3.0f, -2.0f}, {fi + 1.5f, 3.5f, -2.0f}, {fi, 2.0f, 0.5f}});
+    }
+    const StaticBVH bvh = BuildStaticBVH(aabbs.data(), static_cast<uint32_t>(aabbs.size()),
+                                         obbs.data(), static_cast<uint32_t>(obbs.size()),
+                                         tris.data(), static_cast<uint32_t>(tris.size()));
+    const StaticBVH4 bvh4 = BuildStaticBVH4(bvh);
+
+    QueryScratch scratch{};
+    uint64_t linearNarrow = 0;
+    uint64_t fastNarrow = 0;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const float fi = static_cast<float>(i);
+        const Vec3 a{fi * 0.41f - 1.0f, 0.3f + static_cast<float>(i % 5) * 0.7f,
+                     static_cast<float>(i % 9) * 2.7f - 2.5f};
+        const Vec3 b = (i % 4 == 0) ? a : a + Vec3{0.3f, 1.0f, -0.2f};
+        const float radius = (i % 4 == 0) ? 0.0f : 0.25f;
+        const float maxDistance = (i % 3 == 0) ? 0.5f : std::numeric_limits<float>::max();
+
+        QueryMetrics linearMetrics{};
+        const ClosestPointResult linear = ClosestPointCapsule_LinearFallback(
+            bvh, a, b, radius, maxDistance, &linearMetrics);
+        const ClosestPointResult fast = ClosestPointCapsule_Fast(
+            bvh, a, b, radius, maxDistance, scratch);
+        fastNarrow += scratch.metrics.narrowphaseCalls;
+        assert(!scratch.metrics.fallbackUsed);
+        const ClosestPointResult wide = ClosestPointCapsule_BVH4(
+            bvh4, a, b, radius, maxDistance, scratch);
+        linearNarrow += linearMetrics.narrowphaseCalls;
+
+        assert(SameClosestPoint(linear, fast));
+        assert(SameClosestPoint(linear, wide));
+        assert(maxDistance < 1.0f || linear.hit);
+        assert(!linear.hit || linear.distance <= maxDistance);
+        (void)fast;
+        (void)wide;
+    }
+    assert(fastNarrow < linearNarrow);
+    (void)fastNarrow;
+    (void)linearNarrow;
+
+    // Point inside a box: core segment touches it, gap is -radius.
+    const ClosestPointResult inside = ClosestPointCapsule_Fast(
+        bvh, {0.5f, 0.5f, 0.5f}, {0.5f, 0.6f, 0.5f}, 0.25f, 1.0f, scratch);
+    assert(inside.hit && inside.type == PrimType::Aabb && inside.index == 0 &&
+           Near(inside.distance, -0.25f, kDepthEps));
+    (void)inside;
+}
+
+// k-nearest must return the linear scan's sorted prefix, filter included.
+void ExpectKNearestEquivalence()
+{
+    const HarnessWorld world = BuildDenseGrid(20, 20);
+    QueryScratch scratch{};
+    KNearestHit fast[40];
+    KNearestHit linear[40];
+    const uint32_t ks[3] = {1, 8, 40};
+    auto evenOnly = [](const PrimRef& pref) { return (pref.index & 1u) == 0; };
+
+    for (uint32_t i = 0; i < 24; ++i) {
+        const float fi = static_cast<float>(i);
+        const Vec3 p{fi * 1.7f - 3.0f, 0.5f + static_cast<float>(i % 3), fi * 1.1f};
+        const uint32_t k = ks[i % 3];
+        const float maxDistance = (i % 4 == 0) ? 2.0f : std::numeric_limits<float>::max();
+
+        uint32_t n = KNearestPoint_Fast(world.bvh, p, k, maxDistance, fast, scratch);
+        uint32_t m = KNearestPoint_LinearFallback(world.bvh, p, k, maxDistance, linear);
+        assert(n == m && !scratch.metrics.fallbackUsed);
+        for (uint32_t j = 0; j < n; ++j) {
+            assert(fast[j].index == linear[j].index && fast[j].type == linear[j].type);
+            assert(Near(fast[j].distance, linear[j].distance, kDepthEps));
+            assert(j == 0 || fast[j - 1].distance <= fast[j].distance);
+            assert(fast[j].distance <= maxDistance);
+        }
+
+        n = KNearestPoint_Fast(world.bvh, p, k, maxDistance, fast, scratch, kPrimMaskAll, evenOnly);
+        m = KNearestPoint_LinearFallback(world.bvh, p, k, maxDistance, linear, nullptr, kPrimMaskAll, evenOnly);
+        assert(n == m);
+        for (uint32_t j = 0; j < n; ++j)
+            assert(fast[j].index == linear[j].index && (fast[j].index & 1u) == 0);
+        (void)n;
+        (void)m;
+    }
+}
+
+// Layers are clustered by row pairs so node unions prune whole subtrees;
+// every backend must match the masked linear scan.
+void ExpectQueryMaskEquivalence()
+{
+    HarnessWorld world = BuildDenseGrid(20, 20);
+    auto layerOf = [](uint32_t index) {
+        return (1u << ((index / 40u) % 3u)) | ((index % 17u == 0) ? 8u : 0u);
+    };
+    std::vector<uint32_t> primMasks(world.bvh.prims.size());
+    for (uint32_t p = 0; p < static_cast<uint32_t>(primMasks.size()); ++p)
+        primMasks[p] = layerOf(world.bvh.prims[p].index);
+    SetStaticBVHPrimMasks(world.bvh, primMasks.data());
+    world.bvh4 = BuildStaticBVH4(world.bvh);
+    world.grid = BuildUniformGrid(world.bvh, HarnessGridDesc(world.aabbs));
+
+    const SweepConfig cfg{};
+    const uint32_t queryMasks[3] = { 1u, 2u | 8u, 4u };
+    QueryScratch scratch{};
+    LocalQuerySet set{};
+    std::vector<SweepCandidate> candidates;
+    // Full ring and a 2-entry ring: the second forces parent-walk restarts.
+    ShortStackScratch shortStack{};
+    ShortStackScratch shortRing{};
+    shortRing.capacityLimit = 2;
+    uint32_t maskRejects = 0;
+    uint32_t restarts = 0;
+
+    for (uint32_t i = 0; i < 20; ++i) {
+        const uint32_t queryMask = queryMasks[i % 3];
+        const SweepCapsuleInput query = DenseGridQuery(i, 20);
+        const Hit linear = SweepCapsuleClosestHit_LinearFallback(
+            world.bvh, query, cfg, SweepFilter{}, false, nullptr, queryMask);
+        assert(SameHit(linear, SweepCapsuleClosestHit_Fast(
+            world.bvh, query, cfg, scratch, SweepFilter{}, false, queryMask)));
+        maskRejects += scratch.metrics.maskRejects;
+        assert(SameHit(linear, SweepCapsuleClosestHit_BVH4(
+            world.bvh4, query, cfg, scratch, SweepFilter{}, false, queryMask)));
+        assert(SameHit(linear, SweepCapsuleClosestHit_BVH4SimdChildTest(
+            world.bvh4, query, cfg, scratch, SweepFilter{}, false, queryMask)));
+        assert(SameHit(linear, SweepCapsuleClosestHit_UniformGrid(
+            world.grid, query, cfg, scratch, SweepFilter{}, false, queryMask)));
+        assert(SameHit(linear, SweepCapsuleClosestHit_ShortStack(
+            world.bvh, query, cfg, shortStack, SweepFilter{}, false, queryMask)));
+        assert(SameHit(linear, SweepCapsuleClosestHit_ShortStack(
+            world.bvh, query, cfg, shortRing, SweepFilter{}, false, queryMask)));
+        assert(!shortRing.metrics.fallbackUsed);
+        restarts += shortRing.metrics.traversalRestarts;
+
+        CollectSweepCandidates(world.bvh, query, cfg, scratch, candidates, queryMask);
+        QueryMetrics metrics{};
+        assert(SameHit(linear, SweepCapsuleClosestHit_Candidates(
+            world.bvh, candidates.data(), static_cast<uint32_t>(candidates.size()),
+            query, cfg, SweepFilter{}, false, metrics)));
+
+        GatherLocalQuerySet(world.bvh, ExpandAabb(SweptCapsuleBounds(query, cfg), 0.5f),
+                            set, scratch);
+        assert(SameHit(linear, SweepCapsuleClosestHit_LocalSet(
+            world.bvh, set, query, cfg, metrics, SweepFilter{}, false, queryMask)));
+
+        const Vec3 segA{static_cast<float>(i) * 2.0f, -0.5f, 9.0f};
+        const Vec3 segB{static_cast<float>(i) * 2.0f,  0.5f, 9.0f};
+        const float radius = 3.0f;
+        OverlapRun linearOverlap{};
+        linearOverlap.count = OverlapCapsuleContacts_LinearFallback(
+            world.bvh, segA, segB, radius, linearOverlap.contacts, kMaxHarnessContacts,
+            nullptr, queryMask);
+        OverlapRun other{};
+        other.count = OverlapCapsuleContacts_Fast(
+            world.bvh, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            scratch, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        other.count = OverlapCapsuleContacts_BVH4(
+            world.bvh4, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            scratch, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        other.count = OverlapCapsuleContacts_BVH4SimdChildTest(
+            world.bvh4, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            scratch, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        other.count = OverlapCapsuleContacts_UniformGrid(
+            world.grid, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            scratch, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        other.count = OverlapCapsuleContacts_ShortStack(
+            world.bvh, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            shortStack, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        other.count = OverlapCapsuleContacts_ShortStack(
+            world.bvh, segA, segB, radius, other.contacts, kMaxHarnessContacts,
+            shortRing, queryMask);
+        assert(SameContacts(linearOverlap, other));
+        restarts += shortRing.metrics.traversalRestarts;
+        for (uint32_t c = 0; c < linearOverlap.count; ++c)
+            assert(layerOf(linearOverlap.contacts[c].index) & queryMask);
+
+        const ClosestPointResult cpLinear = ClosestPointCapsule_LinearFallback(
+            world.bvh, segA, segB, 0.25f, std::numeric_limits<float>::max(), nullptr, queryMask);
+        assert(SameClosestPoint(cpLinear, ClosestPointCapsule_Fast(
+            world.bvh, segA, segB, 0.25f, std::numeric_limits<float>::max(), scratch, queryMask)));
+        assert(SameClosestPoint(cpLinear, ClosestPointCapsule_BVH4(
+            world.bvh4, segA, segB, 0.25f, std::numeric_limits<float>::max(), scratch, queryMask)));
+
+        KNearestHit fast[8];
+        KNearestHit oracle[8];
+        const uint32_t n = KNearestPoint_Fast(world.bvh, segA, 8, 50.0f, fast, scratch, queryMask);
+        const uint32_t m = KNearestPoint_LinearFallback(world.bvh, segA, 8, 50.0f, oracle,
+                                                        nullptr, queryMask);
+        assert(n == m);
+        for (uint32_t j = 0; j < n; ++j)
+            assert(fast[j].index == oracle[j].index && fast[j].type == oracle[j].type);
+        (void)n;
+        (void)m;
+    }
+
+    assert(maskRejects > 0);
+    assert(restarts > 0);
+    (void)maskRejects;
+    (void)restarts;
+}
+
+// Filtered sweeps over floor tiles, ceiling slabs and ramp triangles: the
+// filter cull may skip windows but never change the hit. Tiles are apart and
+// at distinct heights so no two primitives tie on t.
+void ExpectFilterCullEquivalence()
+{
+    std::vector<AABB> boxes;
+    std::vector<Triangle> tris;
+    for (uint32_t z = 0; z < 12; ++z) {
+        for (uint32_t x = 0; x < 12; ++x) {
+            const float fx = static_cast<float>(x) * 2.0f;
+            const float fz = static_cast<float>(z) * 2.0f;
+            const float top = 0.05f * static_cast<float>((x * 5u + z * 3u) % 7u);
+            if ((x + z) % 6u == 1) {
+                tris.push_back({ {fx, top, fz}, {fx + 1.4f, top + 0.7f, fz},
+                                 {fx + 1.4f, top + 0.7f, fz + 1.4f} });
+                continue;
+            }
+            boxes.push_back(Box(fx, top - 0.5f, fz, fx + 1.4f, top, fz + 1.4f));
+            if ((x * 7u + z * 3u) % 5u == 0) {
+                const float h = top + 1.6f + 0.1f * static_cast<float>((x + z) % 4u);
+                boxes.push_back(Box(fx + 0.2f, h, fz + 0.2f, fx + 1.2f, h + 0.3f, fz + 1.2f));
+            }
+        }
+    }
+    const StaticBVH bvh = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                         nullptr, 0,
+                                         tris.data(), static_cast<uint32_t>(tris.size()));
+    const StaticBVH4 bvh4 = BuildStaticBVH4(bvh);
+    const UniformGrid grid = BuildUniformGrid(bvh, {12, 12, 2.0f, 0.0f, 0.0f});
+
+    SweepFilter ground{};
+    ground.active = true;
+    ground.refDir = {0.0f, 1.0f, 0.0f};
+    ground.minDot = 0.7f;
+    SweepFilter groundInit = ground;
+    groundInit.filterInitialOverlap = true;
+    SweepFilter ceiling{};
+    ceiling.active = true;
+    ceiling.refDir = {0.0f, -1.0f, 0.0f};
+    ceiling.minDot = 0.5f;
+
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    ShortStackScratch shortRing{};
+    shortRing.capacityLimit = 2;
+    uint32_t culls = 0;
+    uint32_t shortCulls = 0;
+    for (uint32_t i = 0; i < 160; ++i) {
+        const float x = 0.3f + static_cast<float>((i * 37u) % 230u) * 0.1f;
+        const float z = 0.3f + static_cast<float>((i * 53u) % 230u) * 0.1f;
+        const float y = 0.75f + static_cast<float>(i % 3u) * 0.4f;
+        SweepCapsuleInput query{};
+        SweepFilter filter{};
+        switch (i % 4u) {
+            case 0: query = MakeCapsuleSweep({x, y, z}, {0.0f, -1.2f, 0.0f}); filter = ground; break;
+            case 1: query = MakeCapsuleSweep({x, y, z}, {0.3f, -1.2f, 0.2f}); filter = groundInit; break;
+            case 2: query = MakeCapsuleSweep({x, y - 0.7f, z}, {0.0f, 1.0f, 0.0f}); filter = ceiling; break;
+            default: {
+                const Vec3 delta{std::cos(static_cast<float>(i)) * 3.0f, 0.0f,
+                                 std::sin(static_cast<float>(i)) * 3.0f};
+                query = MakeCapsuleSweep({x, y, z}, delta);
+                filter.active = true;
+                filter.refDir = NormalizeSafe(delta * -1.0f, {0.0f, 1.0f, 0.0f});
+                filter.minDot = 1e-3f;
+                filter.filterInitialOverlap = true;
+                break;
+            }
+        }
+        for (uint32_t reject = 0; reject < 2; ++reject) {
+            const Hit linear = SweepCapsuleClosestHit_LinearFallback(
+                bvh, query, cfg, filter, reject != 0);
+            assert(SameHit(linear, SweepCapsuleClosestHit_Fast(
+                bvh, query, cfg, scratch, filter, reject != 0)));
+            culls += scratch.metrics.filterCulls;
+            assert(SameHit(linear, SweepCapsuleClosestHit_BVH4(
+                bvh4, query, cfg, scratch, filter, reject != 0)));
+            assert(SameHit(linear, SweepCapsuleClosestHit_BVH4SimdChildTest(
+                bvh4, query, cfg, scratch, filter, reject != 0)));
+            assert(SameHit(linear, SweepCapsuleClosestHit_UniformGrid(
+                grid, query, cfg, scratch, filter, reject != 0)));
+            assert(SameHit(linear, SweepCapsuleClosestHit_ShortStack(
+                bvh, query, cfg, shortRing, filter, reject != 0)));
+            shortCulls += shortRing.metrics.filterCulls;
+        }
+    }
+
+    assert(culls > 0);
+    assert(shortCulls > 0);
+    (void)culls;
+    (void)shortCulls;
+}
+
+// Column boxes plus everything the grid leaves to its extras tree: wide and
+// out-of-grid boxes, OBBs and ramp triangles. Some columns overhang their
+// cell. Sweeps run along both axes and signs, diagonally and straight down;
+// column faces and tops are staggered so no two primitives tie on t.
+void ExpectUniformGridEquivalence()
+{
+    std::vector<AABB> boxes;
+    for (uint32_t z = 0; z < 10; ++z) {
+        for (uint32_t x = 0; x < 10; ++x) {
+            if ((x * 3u + z) % 7u == 0)
+                continue;
+            const float fx = static_cast<float>(x) * 2.0f + 0.03f * static_cast<float>((x + z * 7u) % 5u);
+            const float fz = static_cast<float>(z) * 2.0f + 0.03f * static_cast<float>((x * 3u + z) % 4u);
+            const float top = 0.5f + 0.07f * static_cast<float>((x * 5u + z * 3u) % 11u);
+            if ((x + z) % 4u == 0)
+                boxes.push_back(Box(fx - 0.3f, 0.0f, fz + 0.1f, fx + 1.3f, top, fz + 1.1f));
+            else
+                boxes.push_back(Box(fx + 0.2f, 0.0f, fz + 0.2f, fx + 1.2f, top, fz + 1.4f));
+        }
+    }
+    boxes.push_back(Box(4.45f, 0.0f, 7.5f, 9.55f, 0.35f, 7.9f));   // wider than a cell
+    boxes.push_back(Box(-6.0f, 0.0f, 3.1f, -5.0f, 1.3f, 4.1f));    // outside the grid
+    boxes.push_back(Box(22.3f, 0.0f, 11.1f, 23.1f, 0.9f, 12.3f));  // outside the grid
+
+    std::vector<OBB> obbs;
+    for (uint32_t i = 0; i < 4; ++i) {
+        const float c = 0.8f, s = 0.6f;
+        const float fi = static_cast<float>(i);
+        obbs.push_back({{fi * 4.7f + 1.1f, 1.9f + 0.1f * fi, 5.3f + fi * 2.9f}, {c, 0.0f, s},
+                        {0.0f, 1.0f, 0.0f}, {-s, 0.0f, c}, {0.9f, 0.3f, 0.4f}});
+    }
+    std::vector<Triangle> tris;
+    for (uint32_t i = 0; i < 5; ++i) {
+        const float fz = static_cast<float>(i) * 3.9f + 0.6f;
+        tris.push_back({{-1.0f, 0.0f, fz}, {9.0f, 2.4f, fz}, {-1.0f, 0.0f, fz + 1.1f}});
+    }
+
+    const StaticBVH bvh = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                         obbs.data(), static_cast<uint32_t>(obbs.size()),
+                                         tris.data(), static_cast<uint32_t>(tris.size()));
+    const UniformGrid grid = BuildUniformGrid(bvh, {10, 10, 2.0f, 0.0f, 0.0f});
+    assert(grid.extras.prims.size() == 3 + obbs.size() + tris.size());
+    assert(grid.overhang > 0.25f && grid.overhang < 0.5f);
+
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    uint64_t binaryNodes = 0;
+    uint64_t gridNodes = 0;
+    for (uint32_t i = 0; i < 240; ++i) {
+        const float fi = static_cast<float>(i);
+        const Vec3 base{-3.0f + static_cast<float>((i * 37u) % 251u) * 0.1f,
+                        0.4f + static_cast<float>(i % 4u) * 0.45f,
+                        -3.0f + static_cast<float>((i * 53u) % 251u) * 0.1f};
+        Vec3 delta{};
+        switch (i % 6u) {
+            case 0: delta = {24.0f, 0.0f, 0.37f}; break;
+            case 1: delta = {-24.0f, 0.0f, -0.21f}; break;
+            case 2: delta = {0.29f, 0.0f, 24.0f}; break;
+            case 3: delta = {-0.13f, 0.0f, -24.0f}; break;
+            case 4: delta = {0.0f, -2.5f, 0.0f}; break;
+            default: delta = {std::cos(fi) * 9.0f, -0.2f, std::sin(fi) * 9.0f}; break;
+        }
+        const SweepCapsuleInput query = MakeCapsuleSweep(base, delta);
+
+        const float radius = 0.4f + 0.3f * static_cast<float>(i % 7u);
+        OverlapRun linearOverlap{};
+        linearOverlap.count = OverlapCapsuleContacts_LinearFallback(
+            bvh, query.segA0, query.segB0, radius, linearOverlap.contacts, kMaxHarnessContacts);
+        OverlapRun gridOverlap{};
+        gridOverlap.count = OverlapCapsuleContacts_UniformGrid(
+            grid, query.segA0, query.segB0, radius, gridOverlap.contacts, kMaxHarnessContacts,
+            scratch);
+        assert(SameContacts(linearOverlap, gridOverlap));
+
+        // Starts inside several primitives tie at t = 0 in traversal order.
+        const Hit linear = SweepCapsuleClosestHit_LinearFallback(bvh, query, cfg, SweepFilter{}, false);
+        if (linear.hit && linear.t <= 0.0f)
+            continue;
+        assert(SameHit(linear, SweepCapsuleClosestHit_Fast(bvh, query, cfg, scratch)));
+        binaryNodes += scratch.metrics.nodesPopped;
+        assert(SameHit(linear, SweepCapsuleClosestHit_UniformGrid(grid, query, cfg, scratch)));
+        assert(scratch.metrics.backend == QueryBackend::UniformGrid);
+        gridNodes += scratch.metrics.nodesPopped;
+    }
+
+    assert(gridNodes < binaryNodes);
+    (void)binaryNodes;
+    (void)gridNodes;
+}
+
+// Floor as two BVH triangles versus one bounded plane merged after the tree.
+// Boxes keep their prim indices in both worlds; floor hits and contacts
+// compare geometry only (the tri world may report both floor triangles).
+// The reference runs the triangle kernels over the whole [0, 1] window, since
+// a flat triangle box can round its window start past the kernel TOI, and
+// keeps only their face hits.
+struct FloorPlaneComparison {
+    SceneQueryBackendBenchmarkRow tris{};   // mismatches: tree result != reference
+    SceneQueryBackendBenchmarkRow plane{};  // mismatches: plane result != reference
+};
+
+bool SameFloorHit(const Hit& tri, const Hit& plane)
+{
+    if (tri.hit != plane.hit)
+        return false;
+    if (!tri.hit)
+        return true;
+    if ((tri.type == PrimType::Tri) != (plane.type == PrimType::Plane))
+        return false;
+    if (tri.type != PrimType::Tri && (tri.type != plane.type || tri.index != plane.index ||
+                                      tri.featureId != plane.featureId))
+        return false;
+    return Near(tri.t, plane.t, kHitTEps)
+        && tri.startPenetrating == plane.startPenetrating
+        && Near(tri.penetrationDepth, plane.penetrationDepth, kDepthEps)
+        && SameNormal(tri.normal, plane.normal);
+}
+
+// Non-floor contacts must match in order; the deepest floor contact of the
+// tri world must match the plane contact.
+bool SameFloorContacts(const OverlapRun& tri, const OverlapRun& plane)
+{
+    OverlapRun a{}, b{};
+    const OverlapContact* triFloor = nullptr;
+    const OverlapContact* planeFloor = nullptr;
+    for (uint32_t i = 0; i < tri.count; ++i) {
+        if (tri.contacts[i].type != PrimType::Tri)
+            a.contacts[a.count++] = tri.contacts[i];
+        else if (!triFloor)
+            triFloor = &tri.contacts[i];
+    }
+    for (uint32_t i = 0; i < plane.count; ++i) {
+        if (plane.contacts[i].type != PrimType::Plane)
+            b.contacts[b.count++] = plane.contacts[i];
+        else if (!planeFloor)
+            planeFloor = &plane.contacts[i];
+    }
+    if (!SameContacts(a, b) || (triFloor != nullptr) != (planeFloor != nullptr))
+        return false;
+    return !triFloor || (Near(triFloor->depth, planeFloor->depth, kDepthEps) &&
+                         SameNormal(triFloor->normal, planeFloor->normal));
+}
+
+FloorPlaneComparison CompareFloorPlane(uint32_t gridWidth, uint32_t gridDepth,
+                                       uint32_t queryCount)
+{
+    std::vector<AABB> boxes;
+    for (uint32_t z = 0; z < gridDepth; ++z) {
+        for (uint32_t x = 0; x < gridWidth; ++x) {
+            const float fx = static_cast<float>(x) * 2.0f;
+            const float fz = static_cast<float>(z) * 2.0f;
+            const float h = 0.6f + 0.1f * static_cast<float>((x * 3u + z * 5u) % 7u);
+            boxes.push_back(Box(fx, 0.0f, fz, fx + 1.0f, h, fz + 1.0f));
+        }
+    }
+    const float f0 = -4.0f;
+    const float fx1 = static_cast<float>(gridWidth) * 2.0f + 4.0f;
+    const float fz1 = static_cast<float>(gridDepth) * 2.0f + 4.0f;
+    const Triangle floorTris[2] = {
+        { {f0, 0.0f, f0}, {fx1, 0.0f, fz1}, {fx1, 0.0f, f0} },
+        { {f0, 0.0f, f0}, {f0, 0.0f, fz1}, {fx1, 0.0f, fz1} },
+    };
+    const StaticBVH triBvh = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                            nullptr, 0, floorTris, 2);
+    const StaticBVH boxBvh = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                            nullptr, 0, nullptr, 0);
+    const PlanePrim floor = MakeBoundedPlane({0.0f, 1.0f, 0.0f},
+                                             {(f0 + fx1) * 0.5f, 0.0f, (f0 + fz1) * 0.5f},
+                                             {1.0f, 0.0f, 0.0f},
+                                             (fx1 - f0) * 0.5f, (fz1 - f0) * 0.5f);
+
+    FloorPlaneComparison out{};
+    out.tris.backend = SceneQueryBackendId::BinaryBVH;
+    out.plane.backend = SceneQueryBackendId::BinaryBVH;
+    const SweepConfig cfg{};
+    const SweepFilter noFilter{};
+    QueryScratch scratch{};
+
+    struct FloorQuery {
+        SweepCapsuleInput in{};
+        bool rejectInitialOverlap = false;
+        float overlapRadius = 0.0f;
+        Hit refHit{};
+        OverlapRun refOverlap{};
+    };
+    std::vector<FloorQuery> queries(queryCount);
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        FloorQuery& q = queries[i];
+        const float x = 0.3f + static_cast<float>((i * 37u) % (gridWidth * 20u)) * 0.1f;
+        const float z = 0.3f + static_cast<float>((i * 53u) % (gridDepth * 20u)) * 0.1f;
+        const Vec3 walk{std::cos(static_cast<float>(i)) * 2.0f, 0.0f,
+                        std::sin(static_cast<float>(i)) * 2.0f};
+        switch (i % 3u) {
+            case 0:  // ground probe from above
+                q.in = MakeCapsuleSweep({x, 1.2f + 0.1f * static_cast<float>(i % 5u), z},
+                                        {0.0f, -1.5f, 0.0f});
+                break;
+            case 1:  // walk while resting in the floor skin
+                q.in = MakeCapsuleSweep({x, 0.74f, z}, walk);
+                q.rejectInitialOverlap = true;
+                break;
+            default:  // walk down onto the floor
+                q.in = MakeCapsuleSweep({x, 0.8f, z}, walk + Vec3{0.0f, -0.1f, 0.0f});
+                break;
+        }
+        q.overlapRadius = q.in.radius + 0.05f;
+
+        q.refHit = SweepCapsuleClosestHit_Fast(boxBvh, q.in, cfg, scratch, noFilter,
+                                               q.rejectInitialOverlap);
+        q.refOverlap.count = OverlapCapsuleContacts_Fast(
+            boxBvh, q.in.segA0, q.in.segB0, q.overlapRadius, q.refOverlap.contacts,
+            kMaxHarnessContacts, scratch);
+        for (const PrimRef& pref : triBvh.prims) {
+            if (pref.type != PrimType::Tri)
+                continue;
+            // Edge and vertex hits on the shared diagonal are seams of the
+            // triangle floor; the plane has none.
+            Hit triHit{};
+            ConsiderSweepCapsulePrimNarrow(triBvh, q.in, cfg, pref, 0.0f, 1.0f, noFilter,
+                                           q.rejectInitialOverlap, triHit);
+            if (triHit.hit && (triHit.startPenetrating ||
+                               FeatureClassFromPacked(triHit.featureId) == 0) &&
+                (!q.refHit.hit || BetterHit(triHit.t, triHit.type, triHit.index,
+                                            triHit.featureId, q.refHit.t, q.refHit.type,
+                                            q.refHit.index, q.refHit.featureId, cfg.tieEpsT)))
+                q.refHit = triHit;
+            OverlapContact contact;
+            if (OverlapCapsulePrim(triBvh, q.in.segA0, q.in.segB0, q.overlapRadius, pref,
+                                   contact)) {
+                contact.type = pref.type;
+                contact.index = pref.index;
+                InsertOverlapContactTopK(q.refOverlap.contacts, kMaxHarnessContacts,
+                                         q.refOverlap.count, contact);
+            }
+        }
+        std::sort(q.refOverlap.contacts, q.refOverlap.contacts + q.refOverlap.count,
+                  OverlapContactBetter);
+    }
+
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        SceneQueryBackendBenchmarkRow& row = pass ? out.plane : out.tris;
+        ResetSceneQueryFrameMetrics(row.metrics);
+        const auto start = std::chrono::steady_clock::now();
+        for (const FloorQuery& q : queries) {
+            const Vec3& segA = q.in.segA0;
+            const Vec3& segB = q.in.segB0;
+            OverlapRun overlap{};
+            Hit hit{};
+            if (pass == 0) {
+                hit = SweepCapsuleClosestHit_Fast(triBvh, q.in, cfg, scratch, noFilter,
+                                                  q.rejectInitialOverlap);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                overlap.count = OverlapCapsuleContacts_Fast(triBvh, segA, segB, q.overlapRadius,
+                                                            overlap.contacts,
+                                                            kMaxHarnessContacts, scratch);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                if (!SameHit(q.refHit, hit) || !SameContacts(q.refOverlap, overlap))
+                    ++row.mismatches;
+            } else {
+                hit = SweepCapsuleClosestHit_Fast(boxBvh, q.in, cfg, scratch, noFilter,
+                                                  q.rejectInitialOverlap);
+                SweepCapsuleClosestHit_Planes(&floor, 1, q.in, cfg, noFilter,
+                                              q.rejectInitialOverlap, hit, &scratch.metrics);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                overlap.count = OverlapCapsuleContacts_Fast(boxBvh, segA, segB, q.overlapRadius,
+                                                            overlap.contacts,
+                                                            kMaxHarnessContacts, scratch);
+                overlap.count = OverlapCapsuleContacts_Planes(&floor, 1, segA, segB,
+                                                              q.overlapRadius,
+                                                              overlap.contacts,
+                                                              kMaxHarnessContacts,
+                                                              overlap.count,
+                                                              &scratch.metrics);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                if (!SameFloorHit(q.refHit, hit) || !SameFloorContacts(q.refOverlap, overlap))
+                    ++row.mismatches;
+            }
+            row.queries += 2;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        row.elapsedNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    return out;
+}
+
+// The plane floor must answer like the triangle floor and visit fewer nodes.
+void ExpectFloorPlaneEquivalence()
+{
+    const FloorPlaneComparison cmp = CompareFloorPlane(12, 12, 240);
+    assert(cmp.plane.mismatches == 0);
+    assert(cmp.plane.metrics.nodesPopped < cmp.tris.metrics.nodesPopped);
+    assert(cmp.plane.metrics.narrowphaseCalls < cmp.tris.metrics.narrowphaseCalls);
+    (void)cmp;
+
+    // Rim: past the footprint the plane is not there; inside it blocks.
+    const PlanePrim pad = MakeBoundedPlane({0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+                                           {1.0f, 0.0f, 0.0f}, 1.0f, 1.0f);
+    const SweepConfig cfg{};
+    Hit hit{};
+    SweepCapsuleClosestHit_Planes(&pad, 1, MakeCapsuleSweep({0.5f, 1.0f, 0.5f},
+                                                            {0.0f, -1.0f, 0.0f}),
+                                  cfg, SweepFilter{}, false, hit);
+    assert(hit.hit && hit.type == PrimType::Plane && !hit.startPenetrating);
+    assert(Near(hit.t, 0.25f - cfg.skin, kHitTEps));
+    hit = Hit{};
+    SweepCapsuleClosestHit_Planes(&pad, 1, MakeCapsuleSweep({1.5f, 1.0f, 0.5f},
+                                                            {0.0f, -1.0f, 0.0f}),
+                                  cfg, SweepFilter{}, false, hit);
+    assert(!hit.hit);
+}
+
+// Walks a capsule off the +X rim of a 200x200 floor, drops it, then steers
+// it back under the floor. Each step sweeps with rejectInitialOverlap, moves
+// to the hit and pushes out of the deepest contact, like the KCC's move and
+// Recover. Returns the capsule centre height after every step.
+std::vector<float> WalkOffFloorRim(const PlanePrim* plane, const StaticBVH* tris)
+{
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    Vec3 pos{98.0f, 0.76f, 0.0f};
+    std::vector<float> heights;
+    for (uint32_t step = 0; step < 40; ++step) {
+        Vec3 delta{0.5f, -0.4f, 0.0f};     // off the rim
+        if (step >= 8)
+            delta = {0.0f, -0.5f, 0.0f};   // drop
+        if (step >= 16)
+            delta = {-0.5f, 0.0f, 0.0f};   // steer back under the floor
+        if (step >= 32)
+            delta = {0.0f, -0.5f, 0.0f};   // and keep falling
+        for (uint32_t slide = 0; slide < 3 && LenSq(delta) > kEpsSq; ++slide) {
+            const SweepCapsuleInput in = MakeCapsuleSweep(pos, delta);
+            Hit hit{};
+            if (plane)
+                SweepCapsuleClosestHit_Planes(plane, 1, in, cfg, SweepFilter{}, true, hit);
+            else
+                hit = SweepCapsuleClosestHit_Fast(*tris, in, cfg, scratch, SweepFilter{}, true);
+            if (!hit.hit) {
+                pos = pos + delta;
+                break;
+            }
+            pos = pos + delta * hit.t;
+            delta = delta * (1.0f - hit.t);
+            delta = delta - hit.normal * (std::min)(0.0f, Dot(delta, hit.normal));
+        }
+
+        const SweepCapsuleInput in = MakeCapsuleSweep(pos, {});
+        OverlapRun overlap{};
+        if (plane)
+            overlap.count = OverlapCapsuleContacts_Planes(plane, 1, in.segA0, in.segB0,
+                                                          in.radius, overlap.contacts,
+                                                          kMaxHarnessContacts, 0);
+        else
+            overlap.count = OverlapCapsuleContacts_Fast(*tris, in.segA0, in.segB0, in.radius,
+                                                        overlap.contacts,
+                                                        kMaxHarnessContacts, scratch);
+        if (overlap.count)
+            pos = pos + overlap.contacts[0].normal * overlap.contacts[0].depth;
+        heights.push_back(pos.y);
+    }
+    return heights;
+}
+
+// A pawn that walks off the floor rim and steers back must keep falling, as
+// it did on the two-triangle floor. A half-space floor lifted it back up
+// through the surface; a slab only meets it within its thickness.
+void ExpectFloorPlaneRimReturn()
+{
+    const Triangle floorTris[2] = {
+        { {-100.0f, 0.0f, -100.0f}, {100.0f, 0.0f, 100.0f}, {100.0f, 0.0f, -100.0f} },
+        { {-100.0f, 0.0f, -100.0f}, {-100.0f, 0.0f, 100.0f}, {100.0f, 0.0f, 100.0f} },
+    };
+    const StaticBVH triBvh = BuildStaticBVH(nullptr, 0, nullptr, 0, floorTris, 2);
+    const PlanePrim slab = MakeBoundedPlane({0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+                                            {1.0f, 0.0f, 0.0f}, 100.0f, 100.0f, 1.0f);
+    const PlanePrim halfSpace = MakeBoundedPlane({0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+                                                 {1.0f, 0.0f, 0.0f}, 100.0f, 100.0f);
+
+    const std::vector<float> ref = WalkOffFloorRim(nullptr, &triBvh);
+    const std::vector<float> got = WalkOffFloorRim(&slab, nullptr);
+    const std::vector<float> lifted = WalkOffFloorRim(&halfSpace, nullptr);
+    for (size_t i = 16; i < ref.size(); ++i) {
+        assert(ref[i] <= ref[i - 1] && got[i] <= got[i - 1]);
+        assert(Near(got[i], ref[i], 1e-4f));
+    }
+    assert(got.back() < -5.0f);
+    assert(lifted.back() > 0.0f);  // the bug this guards against
+
+    // Under the footprint and below the slab: no sweep hit, no contact.
+    const SweepCapsuleInput under = MakeCapsuleSweep({101.5f, -3.0f, 0.0f}, {-3.0f, 0.0f, 0.0f});
+    Hit hit{};
+    SweepCapsuleClosestHit_Planes(&slab, 1, under, SweepConfig{}, SweepFilter{}, false, hit);
+    OverlapContact contact;
+    assert(!hit.hit);
+    assert(!OverlapCapsulePlane(under.segA0 + under.delta, under.segB0 + under.delta,
+                                under.radius, slab, contact));
+
+    // Just under the slab: pushed down out of the bottom face, and a rising
+    // capsule stops on it.
+    assert(OverlapCapsulePlane({0.0f, -1.6f, 0.0f}, {0.0f, -1.1f, 0.0f}, 0.25f, slab, contact));
+    assert(contact.normal.y == -1.0f && Near(contact.depth, 0.15f, 1e-5f));
+    hit = Hit{};
+    SweepCapsuleClosestHit_Planes(&slab, 1, MakeCapsuleSweep({0.0f, -3.0f, 0.0f},
+                                                             {0.0f, 2.0f, 0.0f}),
+                                  SweepConfig{}, SweepFilter{}, false, hit);
+    assert(hit.hit && !hit.startPenetrating && hit.normal.y == -1.0f);
+    (void)hit;
+    (void)contact;
+}
+
+// Long diagonal ramp slivers over a box grid. Each ramp's box spans most of
+// the map, so the median build hangs it near the root where it overlaps every
+// leaf. The spatial-split build cuts the ramps into per-region pieces; both
+// trees must answer like LinearFallback. Ramps sit at distinct heights above
+// the boxes so no two primitives tie on t.
+struct SpatialSplitComparison {
+    SceneQueryBackendBenchmarkRow median{};   // mismatches: result != LinearFallback
+    SceneQueryBackendBenchmarkRow spatial{};
+    uint32_t spatialRefs = 0;                 // primIdx entries of the split tree
+    uint32_t prims = 0;
+};
+
+void BuildRampWorld(uint32_t gridWidth, uint32_t gridDepth,
+                    std::vector<AABB>& boxes, std::vector<Triangle>& ramps)
+{
+    for (uint32_t z = 0; z < gridDepth; ++z) {
+        for (uint32_t x = 0; x < gridWidth; ++x) {
+            const float fx = static_cast<float>(x) * 2.0f;
+            const float fz = static_cast<float>(z) * 2.0f;
+            const float h = 0.6f + 0.1f * static_cast<float>((x * 3u + z * 5u) % 7u);
+            boxes.push_back(Box(fx, 0.0f, fz, fx + 1.0f, h, fz + 1.0f));
+        }
+    }
+    const float w = static_cast<float>(gridWidth) * 2.0f;
+    const float d = static_cast<float>(gridDepth) * 2.0f;
+    const uint32_t rampCount = gridDepth / 2u + 2u;
+    for (uint32_t r = 0; r < rampCount; ++r) {
+        const float a = static_cast<float>(r) * d / static_cast<float>(rampCount);
+        const float y = 1.4f + 0.23f * static_cast<float>(r);
+        ramps.push_back({ {-2.0f, y, a}, {w + 2.0f, y + 1.2f, a + d * 0.5f},
+                          {-2.0f, y + 0.05f, a + 1.0f} });
+    }
+}
+
+SweepCapsuleInput RampWorldQuery(uint32_t i, uint32_t gridWidth, uint32_t gridDepth)
+{
+    const float x = 0.3f + static_cast<float>((i * 37u) % (gridWidth * 20u)) * 0.1f;
+    const float z = 0.3f + static_cast<float>((i * 53u) % (gridDepth * 20u)) * 0.1f;
+    const Vec3 walk{std::cos(static_cast<float>(i)) * 3.0f, 0.0f,
+                    std::sin(static_cast<float>(i)) * 3.0f};
+    switch (i % 3u) {
+        case 0:  return MakeCapsuleSweep({x, 5.5f, z}, {0.0f, -5.5f, 0.0f});
+        case 1:  return MakeCapsuleSweep({x, 1.7f + 0.3f * static_cast<float>(i % 7u), z}, walk);
+        default: return MakeCapsuleSweep({x, 4.0f, z}, walk + Vec3{0.0f, -2.5f, 0.0f});
+    }
+}
+
+SpatialSplitComparison CompareSpatialSplit(uint32_t gridWidth, uint32_t gridDepth,
+                                           uint32_t queryCount)
+{
+    std::vector<AABB> boxes;
+    std::vector<Triangle> ramps;
+    BuildRampWorld(gridWidth, gridDepth, boxes, ramps);
+    BuildCtx splitCtx{};
+    splitCtx.spatialSplits = true;
+    const StaticBVH trees[2] = {
+        BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()), nullptr, 0,
+                       ramps.data(), static_cast<uint32_t>(ramps.size())),
+        BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()), nullptr, 0,
+                       ramps.data(), static_cast<uint32_t>(ramps.size()), splitCtx),
+    };
+
+    SpatialSplitComparison out{};
+    out.median.backend = SceneQueryBackendId::BinaryBVH;
+    out.spatial.backend = SceneQueryBackendId::BinaryBVH;
+    out.spatialRefs = static_cast<uint32_t>(trees[1].primIdx.size());
+    out.prims = static_cast<uint32_t>(trees[1].prims.size());
+
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    std::vector<Hit> refHits(queryCount);
+    std::vector<OverlapRun> refOverlaps(queryCount);
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const SweepCapsuleInput in = RampWorldQuery(i, gridWidth, gridDepth);
+        refHits[i] = SweepCapsuleClosestHit_LinearFallback(trees[0], in, cfg, SweepFilter{}, false);
+        refOverlaps[i].count = OverlapCapsuleContacts_LinearFallback(
+            trees[0], in.segA0, in.segB0, in.radius + 0.4f, refOverlaps[i].contacts,
+            kMaxHarnessContacts);
+    }
+
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        const StaticBVH& bvh = trees[pass];
+        SceneQueryBackendBenchmarkRow& row = pass ? out.spatial : out.median;
+        ResetSceneQueryFrameMetrics(row.metrics);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < queryCount; ++i) {
+            const SweepCapsuleInput in = RampWorldQuery(i, gridWidth, gridDepth);
+            const Hit hit = SweepCapsuleClosestHit_Fast(bvh, in, cfg, scratch);
+            AccumulateQueryMetrics(row.metrics, scratch.metrics);
+            OverlapRun overlap{};
+            overlap.count = OverlapCapsuleContacts_Fast(bvh, in.segA0, in.segB0,
+                                                        in.radius + 0.4f, overlap.contacts,
+                                                        kMaxHarnessContacts, scratch);
+            AccumulateQueryMetrics(row.metrics, scratch.metrics);
+            if (!SameHit(refHits[i], hit) || !SameContacts(refOverlaps[i], overlap))
+                ++row.mismatches;
+            row.queries += 2;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        row.elapsedNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    return out;
+}
+
+// Every query path over a tree with repeated triangle references must match
+// the linear scan and the median tree, with no result listed twice.
+void ExpectSpatialSplitEquivalence()
+{
+    const SpatialSplitComparison cmp = CompareSpatialSplit(12, 12, 240);
+    assert(cmp.median.mismatches == 0 && cmp.spatial.mismatches == 0);
+    assert(cmp.spatialRefs > cmp.prims);
+    assert(cmp.spatialRefs <= cmp.prims + cmp.prims / 2u);
+    assert(cmp.spatial.metrics.nodesPopped < cmp.median.metrics.nodesPopped);
+    assert(cmp.spatial.metrics.narrowphaseCalls < cmp.median.metrics.narrowphaseCalls);
+    (void)cmp;
+
+    std::vector<AABB> boxes;
+    std::vector<Triangle> ramps;
+    BuildRampWorld(12, 12, boxes, ramps);
+    BuildCtx splitCtx{};
+    splitCtx.spatialSplits = true;
+    const StaticBVH median = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                            nullptr, 0,
+                                            ramps.data(), static_cast<uint32_t>(ramps.size()));
+    StaticBVH split = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                     nullptr, 0,
+                                     ramps.data(), static_cast<uint32_t>(ramps.size()), splitCtx);
+    const StaticBVH again = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                           nullptr, 0,
+                                           ramps.data(), static_cast<uint32_t>(ramps.size()),
+                                           splitCtx);
+    assert(HasDuplicatePrimRefs(split) && !HasDuplicatePrimRefs(median));
+    assert(again.primIdx == split.primIdx && again.nodes.size() == split.nodes.size());
+
+    // Odd ramps and every third box on layer 2: leaf unions see repeats.
+    std::vector<uint32_t> primMasks(split.prims.size());
+    for (uint32_t p = 0; p < static_cast<uint32_t>(primMasks.size()); ++p)
+        primMasks[p] = (split.prims[p].index % 3u == 1u) ? 2u : 1u;
+    SetStaticBVHPrimMasks(split, primMasks.data());
+    StaticBVH maskedMedian = median;
+    SetStaticBVHPrimMasks(maskedMedian, primMasks.data());
+
+    const SweepConfig cfg{};
+    QueryScratch scratch{};
+    ShortStackScratch shortStack{};
+    LocalQuerySet splitSet{}, medianSet{};
+    std::vector<SweepCandidate> splitCandidates, medianCandidates;
+    uint32_t skips = 0;
+    for (uint32_t i = 0; i < 120; ++i) {
+        const SweepCapsuleInput in = RampWorldQuery(i, 12, 12);
+        const uint32_t queryMask = (i % 4u == 3u) ? 2u : kPrimMaskAll;
+        const Hit linear = SweepCapsuleClosestHit_LinearFallback(
+            split, in, cfg, SweepFilter{}, false, nullptr, queryMask);
+        assert(SameHit(linear, SweepCapsuleClosestHit_Fast(
+            split, in, cfg, scratch, SweepFilter{}, false, queryMask)));
+        if (queryMask == kPrimMaskAll)
+            assert(SameHit(linear, SweepCapsuleClosestHit_ShortStack(split, in, cfg, shortStack)));
+
+        CollectSweepCandidates(split, in, cfg, scratch, splitCandidates, queryMask);
+        CollectSweepCandidates(maskedMedian, in, cfg, scratch, medianCandidates, queryMask);
+        // Clipped pieces can miss a ramp whose whole box the sweep touches,
+        // so the split list is a subset; each prim appears once.
+        for (size_t c = 0, m = 0; c < splitCandidates.size(); ++c) {
+            assert(c == 0 || splitCandidates[c - 1].prim < splitCandidates[c].prim);
+            while (m < medianCandidates.size() && medianCandidates[m].prim < splitCandidates[c].prim)
+                ++m;
+            assert(m < medianCandidates.size() && medianCandidates[m].prim == splitCandidates[c].prim);
+        }
+        QueryMetrics metrics{};
+        assert(SameHit(linear, SweepCapsuleClosestHit_Candidates(
+            split, splitCandidates.data(), static_cast<uint32_t>(splitCandidates.size()),
+            in, cfg, SweepFilter{}, false, metrics)));
+
+        const AABB region = ExpandAabb(SweptCapsuleBounds(in, cfg), 0.5f);
+        GatherLocalQuerySet(split, region, splitSet, scratch);
+        GatherLocalQuerySet(maskedMedian, region, medianSet, scratch);
+        assert(std::adjacent_find(splitSet.prim.begin(), splitSet.prim.end()) == splitSet.prim.end());
+        assert(std::includes(medianSet.prim.begin(), medianSet.prim.end(),
+                             splitSet.prim.begin(), splitSet.prim.end()));
+        assert(SameHit(linear, SweepCapsuleClosestHit_LocalSet(
+            split, splitSet, in, cfg, metrics, SweepFilter{}, false, queryMask)));
+
+        const float radius = in.radius + 0.4f;
+        OverlapRun linearOverlap{}, other{};
+        linearOverlap.count = OverlapCapsuleContacts_LinearFallback(
+            split, in.segA0, in.segB0, radius, linearOverlap.contacts, kMaxHarnessContacts,
+            nullptr, queryMask);
+        other.count = OverlapCapsuleContacts_Fast(split, in.segA0, in.segB0, radius,
+                                                  other.contacts, kMaxHarnessContacts,
+                                                  scratch, queryMask);
+        skips += scratch.metrics.duplicateRefSkips;
+        assert(SameContacts(linearOverlap, other));
+        if (queryMask == kPrimMaskAll) {
+            other.count = OverlapCapsuleContacts_ShortStack(split, in.segA0, in.segB0, radius,
+                                                            other.contacts, kMaxHarnessContacts,
+                                                            shortStack);
+            assert(SameContacts(linearOverlap, other));
+        }
+
+        const ClosestPointResult cpLinear = ClosestPointCapsule_LinearFallback(
+            split, in.segA0, in.segB0, in.radius, std::numeric_limits<float>::max(),
+            nullptr, queryMask);
+        assert(SameClosestPoint(cpLinear, ClosestPointCapsule_Fast(
+            split, in.segA0, in.segB0, in.radius, std::numeric_limits<float>::max(),
+            scratch, queryMask)));
+
+        KNearestHit fast[12];
+        KNearestHit oracle[12];
+        const uint32_t n = KNearestPoint_Fast(split, in.segA0, 12, 8.0f, fast, scratch,
+                                              queryMask);
+        skips += scratch.metrics.duplicateRefSkips;
+        const uint32_t m = KNearestPoint_LinearFallback(split, in.segA0, 12, 8.0f, oracle,
+                                                        nullptr, queryMask);
+        assert(n == m);
+        for (uint32_t j = 0; j < n; ++j)
+            assert(fast[j].index == oracle[j].index && fast[j].type == oracle[j].type);
+        (void)n;
+        (void)m;
+    }
+    assert(skips > 0);
+    (void)skips;
+}
+
+// Walk an actor through overlapping triggers: the cache must emit exactly
+// the brute-force diff of linear inside sets, through every cache path.
+void ExpectTriggerPairCacheEquivalence()
+{
+    std::vector<AABB> triggers;
+    for (uint32_t z = 0; z < 24; ++z) {
+        for (uint32_t x = 0; x < 24; ++x) {
+            const float fx = static_cast<float>(x) * 2.0f;
+            const float fz = static_cast<float>(z) * 2.0f;
+            triggers.push_back(Box(fx, 0.0f, fz, fx + 2.5f, 2.0f, fz + 2.5f));
+        }
+    }
+    HarnessWorld world = BuildWorld(std::move(triggers));
+    std::vector<uint32_t> primMasks(world.bvh.prims.size());
+    std::vector<uint32_t> idRemap(world.aabbs.size());
+    for (uint32_t p = 0; p < static_cast<uint32_t>(primMasks.size()); ++p)
+        primMasks[p] = (world.bvh.prims[p].index % 5u == 0) ? 2u : 1u;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(idRemap.size()); ++i)
+        idRemap[i] = i * 3u + 7u;
+    SetStaticBVHPrimMasks(world.bvh, primMasks.data());
+
+    TriggerPairCache cache{};
+    QueryScratch scratch{};
+    std::vector<TriggerPairEvent> events;
+    std::vector<uint32_t> prev[2];
+    std::vector<uint32_t> cur;
+    std::vector<uint32_t> fast;
+    const uint32_t queryMask = 1u;
+
+    for (uint32_t step = 0; step < 240; ++step) {
+        for (uint32_t actor = 0; actor < 2; ++actor) {
+            const float t = static_cast<float>(step / (actor + 1u));  // actor 1 repeats poses
+            float x = 0.5f + t * 0.13f;
+            const float z = 3.0f + static_cast<float>(actor) * 11.0f + std::sin(t * 0.2f) * 2.0f;
+            if (step == 150)
+                x += 20.0f;  // teleport leaves the fat box
+            const AABB box = Box(x, 0.5f, z, x + 0.8f, 1.5f, z + 0.8f);
+
+            OverlapAabbPrims_LinearFallback(world.bvh, box, cur, nullptr, queryMask);
+            OverlapAabbPrims_Fast(world.bvh, box, scratch, fast, queryMask);
+            assert(fast == cur);
+            for (uint32_t& id : cur)
+                id = idRemap[id];
+
+            events.clear();
+            UpdateTriggerActor(cache, world.bvh, idRemap.data(), 1u, actor, box, queryMask,
+                               scratch, events);
+            std::vector<TriggerPairEvent> expected;
+            TriggerPairStats unused{};
+            DiffTriggerSets(actor, prev[actor], cur, expected, unused);
+            assert(events.size() == expected.size());
+            for (size_t e = 0; e < events.size(); ++e) {
+                assert(events[e].trigger == expected[e].trigger);
+                assert(events[e].kind == expected[e].kind && events[e].actor == actor);
+            }
+            prev[actor] = cur;
+        }
+    }
+
+    events.clear();
+    RemoveTriggerActor(cache, 0, events);
+    assert(events.size() == prev[0].size());
+    assert(cache.stats.reusedSets > 0 && cache.stats.candidateRuns > 0);
+    assert(cache.stats.gathers > 2 && cache.stats.enters > 0 && cache.stats.exits > 0);
+}
+
+// Rolling terrain with hole patches, as a heightfield and as the same
+// triangles in a BVH (non-hole cells in (cz, cx, k) order, so Tri indices
+// rise with heightfield triangle ids and both break t ties alike).
+struct HeightfieldComparison {
+    SceneQueryBackendBenchmarkRow tris{};   // triangle mesh in a BinaryBVH
+    SceneQueryBackendBenchmarkRow field{};  // heightfield; mismatches vs linear tris
+    uint32_t samples = 0;
+    uint32_t triangles = 0;
+    uint64_t fieldBytes = 0;
+    uint64_t triBytes = 0;                  // Triangle + PrimRef + nodes + primIdx
+};
+
+HeightfieldPrim BuildTestTerrain(uint32_t samplesPerSide, std::vector<Triangle>& tris)
+{
+    const uint32_t cells = samplesPerSide - 1;
+    std::vector<uint16_t> heights(static_cast<size_t>(samplesPerSide) * samplesPerSide);
+    for (uint32_t z = 0; z < samplesPerSide; ++z) {
+        for (uint32_t x = 0; x < samplesPerSide; ++x) {
+            const float fx = static_cast<float>(x);
+            const float fz = static_cast<float>(z);
+            const float h = 500.0f + 400.0f * std::sin(fx * 0.21f) * std::cos(fz * 0.17f)
+                          + 9.0f * static_cast<float>((x * 7u + z * 13u) % 11u);
+            heights[z * samplesPerSide + x] = static_cast<uint16_t>(h);
+        }
+    }
+    std::vector<uint8_t> holes(static_cast<size_t>(cells) * cells, 0);
+    for (uint32_t cz = 0; cz < cells; ++cz)
+        for (uint32_t cx = 0; cx < cells; ++cx)
+            holes[cz * cells + cx] = ((cx / 5u + cz / 7u) % 9u == 4u) ? 1 : 0;
+
+    HeightfieldPrim hf = MakeHeightfield({-1.0f, -0.3f, -1.0f}, samplesPerSide, samplesPerSide,
+                                         0.5f, 0.002f, heights.data(), holes.data());
+    tris.clear();
+    for (uint32_t cz = 0; cz < cells; ++cz) {
+        for (uint32_t cx = 0; cx < cells; ++cx) {
+            if (HeightfieldIsHole(hf, cx, cz))
+                continue;
+            Triangle cellTris[2];
+            HeightfieldCellTriangles(hf, cx, cz, cellTris);
+            tris.push_back(cellTris[0]);
+            tris.push_back(cellTris[1]);
+        }
+    }
+    return hf;
+}
+
+bool SameHeightfieldHit(const Hit& tri, const Hit& field)
+{
+    if (tri.hit != field.hit)
+        return false;
+    if (!tri.hit)
+        return true;
+    // Once best.t reaches 0 the first overlapping triangle visited wins, so
+    // which one depends on traversal order; only the start state must agree.
+    if (tri.t <= 0.0f)
+        return field.type == PrimType::Heightfield && field.t <= 0.0f
+            && field.startPenetrating == tri.startPenetrating;
+    return field.type == PrimType::Heightfield
+        && Near(tri.t, field.t, kHitTEps)
+        && tri.featureId == field.featureId
+        && tri.startPenetrating == field.startPenetrating
+        && Near(tri.penetrationDepth, field.penetrationDepth, kDepthEps)
+        && SameNormal(tri.normal, field.normal);
+}
+
+// Same depths in order; each heightfield contact matches some Tri contact.
+bool SameHeightfieldContacts(const OverlapRun& tri, const OverlapRun& field)
+{
+    if (tri.count != field.count)
+        return false;
+    for (uint32_t i = 0; i < field.count; ++i) {
+        if (field.contacts[i].type != PrimType::Heightfield ||
+            !Near(tri.contacts[i].depth, field.contacts[i].depth, kDepthEps))
+            return false;
+        bool found = false;
+        for (uint32_t j = 0; j < tri.count && !found; ++j)
+            found = Near(tri.contacts[j].depth, field.contacts[i].depth, kDepthEps)
+                 && tri.contacts[j].featureId == field.contacts[i].featureId
+                 && SameNormal(tri.contacts[j].normal, field.contacts[i].normal);
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+HeightfieldComparison CompareHeightfield(uint32_t samplesPerSide, uint32_t queryCount)
+{
+    std::vector<Triangle> tris;
+    const HeightfieldPrim hf = BuildTestTerrain(samplesPerSide, tris);
+    const StaticBVH triBvh = BuildStaticBVH(nullptr, 0, nullptr, 0,
+                                            tris.data(), static_cast<uint32_t>(tris.size()));
+
+    HeightfieldComparison out{};
+    out.tris.backend = SceneQueryBackendId::BinaryBVH;
+    out.field.backend = SceneQueryBackendId::BinaryBVH;
+    out.samples = samplesPerSide * samplesPerSide;
+    out.triangles = static_cast<uint32_t>(tris.size());
+    out.fieldBytes = HeightfieldMemoryBytes(hf);
+    out.triBytes = tris.size() * sizeof(Triangle) + triBvh.prims.size() * sizeof(PrimRef)
+                 + triBvh.nodes.size() * sizeof(BVHNode) + triBvh.primIdx.size() * sizeof(uint32_t);
+
+    const SweepConfig cfg{};
+    const SweepFilter noFilter{};
+    SweepFilter ground{};
+    ground.active = true;
+    ground.refDir = {0.0f, 1.0f, 0.0f};
+    ground.minDot = 0.7f;
+    QueryScratch scratch{};
+    const float span = static_cast<float>(samplesPerSide - 1) * hf.cellSize;
+
+    struct TerrainQuery {
+        SweepCapsuleInput in{};
+        SweepFilter filter{};
+        bool reject = false;
+        float radius = 0.0f;
+    };
+    auto makeQuery = [&](uint32_t i) {
+        const float fi = static_cast<float>(i);
+        const float x = hf.origin.x + 0.37f + std::fmod(fi * 3.71f, span - 0.8f);
+        const float z = hf.origin.z + 0.41f + std::fmod(fi * 5.23f, span - 0.8f);
+        const uint32_t sx = static_cast<uint32_t>((x - hf.origin.x) / hf.cellSize);
+        const uint32_t sz = static_cast<uint32_t>((z - hf.origin.z) / hf.cellSize);
+        const float ground0 = HeightfieldVertex(hf, sx, sz).y;
+        const Vec3 walk{std::cos(fi) * 2.5f, 0.0f, std::sin(fi) * 2.5f};
+        SweepCapsuleInput in{};
+        SweepFilter filter = noFilter;
+        bool reject = false;
+        switch (i % 4u) {
+            case 0:  // ground probe from above
+                in = MakeCapsuleSweep({x, 3.0f, z}, {0.0f, -4.0f, 0.0f});
+                break;
+            case 1:  // walk down the slope, walkable normals only
+                in = MakeCapsuleSweep({x, ground0 + 0.9f, z}, walk + Vec3{0.0f, -0.4f, 0.0f});
+                filter = ground;
+                break;
+            case 2:  // walk near the surface, ignoring initial contact
+                in = MakeCapsuleSweep({x, ground0 + 0.8f, z}, walk);
+                reject = true;
+                break;
+            default:  // long crossing over the hills
+                in = MakeCapsuleSweep({x, 1.6f, z}, walk * 4.0f + Vec3{0.0f, -0.5f, 0.0f});
+                break;
+        }
+        return TerrainQuery{in, filter, reject, in.radius + 0.1f};
+    };
+
+    std::vector<Hit> fieldHits(queryCount);
+    std::vector<OverlapRun> fieldOverlaps(queryCount);
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        SceneQueryBackendBenchmarkRow& row = pass ? out.field : out.tris;
+        ResetSceneQueryFrameMetrics(row.metrics);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < queryCount; ++i) {
+            const TerrainQuery q = makeQuery(i);
+
+            Hit hit{};
+            OverlapRun overlap{};
+            if (pass == 0) {
+                hit = SweepCapsuleClosestHit_Fast(triBvh, q.in, cfg, scratch, q.filter, q.reject);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                overlap.count = OverlapCapsuleContacts_Fast(triBvh, q.in.segA0, q.in.segB0, q.radius,
+                                                            overlap.contacts, kMaxHarnessContacts,
+                                                            scratch);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+            } else {
+                ResetQueryScratch(scratch, QueryKind::SweepCapsuleClosest);
+                SweepCapsuleClosestHit_Heightfields(&hf, 1, q.in, cfg, q.filter, q.reject, hit,
+                                                    &scratch.metrics);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                ResetQueryScratch(scratch, QueryKind::OverlapCapsuleContacts);
+                overlap.count = OverlapCapsuleContacts_Heightfields(
+                    &hf, 1, q.in.segA0, q.in.segB0, q.radius, overlap.contacts, kMaxHarnessContacts,
+                    0, &scratch.metrics);
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                fieldHits[i] = hit;
+                fieldOverlaps[i] = overlap;
+            }
+            row.queries += 2;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        row.elapsedNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    // The oracle is a linear scan over the same triangles, outside the timing.
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        const TerrainQuery q = makeQuery(i);
+        const Hit refHit = SweepCapsuleClosestHit_LinearFallback(triBvh, q.in, cfg, q.filter,
+                                                                 q.reject);
+        OverlapRun refOverlap{};
+        refOverlap.count = OverlapCapsuleContacts_LinearFallback(
+            triBvh, q.in.segA0, q.in.segB0, q.radius, refOverlap.contacts, kMaxHarnessContacts);
+        if (!SameHeightfieldHit(refHit, fieldHits[i]) ||
+            !SameHeightfieldContacts(refOverlap, fieldOverlaps[i]))
+            ++out.field.mismatches;
+    }
+    return out;
+}
+
+// The heightfield must answer like its triangles, skip holes, and stay near
+// 2 bytes per sample.
+void ExpectHeightfieldEquivalence()
+{
+    const HeightfieldComparison cmp = CompareHeightfield(65, 320);
+    assert(cmp.field.mismatches == 0);
+    assert(cmp.field.metrics.narrowphaseCalls < cmp.tris.metrics.narrowphaseCalls);
+    assert(cmp.fieldBytes < cmp.samples * 3u);
+    assert(cmp.triBytes > cmp.triangles * 64u);
+    (void)cmp;
+
+    // Flat 3x3-cell pad at height 1 with a hole in the middle cell.
+    const uint16_t flat[16] = { 500, 500, 500, 500, 500, 500, 500, 500,
+                                500, 500, 500, 500, 500, 500, 500, 500 };
+    const uint8_t holes[9] = { 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+    const HeightfieldPrim pad = MakeHeightfield({0.0f, 0.0f, 0.0f}, 4, 4, 1.0f, 0.002f,
+                                                flat, holes);
+    const SweepConfig cfg{};
+    Hit hit{};
+    SweepCapsuleClosestHit_Heightfields(&pad, 1, MakeCapsuleSweep({0.5f, 2.0f, 0.5f},
+                                                                  {0.0f, -2.0f, 0.0f}),
+                                        cfg, SweepFilter{}, false, hit);
+    assert(hit.hit && hit.type == PrimType::Heightfield && hit.index == 0);
+    assert(Near(hit.t, 0.125f - cfg.skin * 0.5f, kHitTEps) && hit.normal.y > 0.999f);
+    hit = Hit{};
+    SweepCapsuleClosestHit_Heightfields(&pad, 1, MakeCapsuleSweep({1.5f, 2.0f, 1.5f},
+                                                                  {0.0f, -2.0f, 0.0f}),
+                                        cfg, SweepFilter{}, false, hit);
+    assert(!hit.hit);
+    const AABB bounds = HeightfieldBounds(pad);
+    assert(Near(bounds.minY, 1.0f, 1e-6f) && Near(bounds.maxY, 1.0f, 1e-6f));
+    (void)bounds;
+}
+
+// Closest point and k-nearest on a heightfield must pick the linear-scan
+// answer over its triangles, alone and through CollisionWorld next to a box.
+void ExpectHeightfieldClosestPoint()
+{
+    std::vector<Triangle> tris;
+    const HeightfieldPrim hf = BuildTestTerrain(33, tris);
+    const StaticBVH triBvh = BuildStaticBVH(nullptr, 0, nullptr, 0,
+                                            tris.data(), static_cast<uint32_t>(tris.size()));
+
+    ColliderDesc box{};
+    box.bounds = Box(20.0f, -1.0f, 20.0f, 21.0f, 0.0f, 21.0f);
+    std::vector<ColliderDesc> fieldColliders{box};
+    std::vector<ColliderDesc> triColliders{box};
+    ColliderDesc field{};
+    field.shape = ColliderShape::Heightfield;
+    field.heightfield = &hf;
+    field.bounds = HeightfieldBounds(hf);
+    fieldColliders.push_back(field);
+    for (const Triangle& tri : tris) {
+        ColliderDesc d{};
+        d.shape = ColliderShape::Tri;
+        d.triVerts = tri;
+        d.bounds = TriAABB(tri);
+        triColliders.push_back(d);
+    }
+    CollisionWorldLegacy fieldWorld;
+    fieldWorld.BuildStatic(fieldColliders);
+    CollisionWorldLegacy triWorld;
+    triWorld.BuildStatic(triColliders);
+
+    uint64_t fieldNarrow = 0;
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < 96; ++i) {
+        const float fi = static_cast<float>(i);
+        // Above, below, beside and far past the 16 x 16 terrain.
+        const Vec3 a{-3.0f + std::fmod(fi * 2.37f, 22.0f), -1.5f + std::fmod(fi * 0.71f, 4.0f),
+                     -3.0f + std::fmod(fi * 3.11f, 22.0f)};
+        const Vec3 b = (i % 4u == 0) ? a : a + Vec3{0.6f, 0.9f, -0.4f};
+        const float radius = (i % 4u == 0) ? 0.0f : 0.3f;
+        const float maxDistance = (i % 3u == 0) ? 0.8f : std::numeric_limits<float>::max();
+
+        const ClosestPointResult linear = ClosestPointCapsule_LinearFallback(
+            triBvh, a, b, radius, maxDistance);
+        QueryMetrics metrics{};
+        ClosestPointResult local{};
+        ConsiderClosestPointHeightfield(hf, 0, a, b, radius, maxDistance, local, &metrics);
+        fieldNarrow += metrics.narrowphaseCalls;
+        assert(linear.hit == local.hit);
+        assert(!local.hit || (local.type == PrimType::Heightfield && local.index == 0 &&
+                              local.featureId == linear.featureId &&
+                              Near(local.distance, linear.distance, kDepthEps) &&
+                              SameNormal(local.normal, linear.normal)));
+        hits += local.hit ? 1u : 0u;
+
+        KNearestHit ref[1];
+        KNearestHit got[1];
+        const uint32_t refCount = KNearestPoint_LinearFallback(triBvh, a, 1, maxDistance, ref);
+        uint32_t gotCount = 0;
+        ConsiderKNearestHeightfield(hf, 0, a, maxDistance, got, 1, gotCount);
+        assert(refCount == gotCount);
+        assert(!gotCount || (got[0].type == PrimType::Heightfield &&
+                             Near(got[0].distance, ref[0].distance, kDepthEps)));
+
+        // World path: the heightfield answers as collider 1 with the same gap
+        // as its Tri colliders; the box stays collider 0 in both worlds.
+        const ClosestPointResult w = fieldWorld.ClosestPointCapsule(a, b, radius, maxDistance);
+        const ClosestPointResult t = triWorld.ClosestPointCapsule(a, b, radius, maxDistance);
+        assert(w.hit == t.hit);
+        assert(!w.hit || (Near(w.distance, t.distance, kDepthEps) &&
+                          (t.type == PrimType::Tri) == (w.type == PrimType::Heightfield) &&
+                          (w.type != PrimType::Heightfield || w.index == 1)));
+        KNearestHit wk[2];
+        KNearestHit tk[2];
+        const uint32_t wCount = fieldWorld.QueryKNearest(a, 2, Q_Solid, wk, maxDistance);
+        const uint32_t tCount = triWorld.QueryKNearest(a, 1, Q_Solid, tk, maxDistance);
+        assert(wCount >= tCount && (tCount == 0 || Near(wk[0].distance, tk[0].distance, kDepthEps)));
+        (void)linear; (void)refCount; (void)w; (void)t; (void)wCount; (void)tCount;
+    }
+    assert(hits > 0);
+    assert(fieldNarrow < static_cast<uint64_t>(tris.size()) * 96u / 4u);
+    (void)hits;
+    (void)fieldNarrow;
+}
+
+// A 6x6 floor of separate quads, a wall on its +x side (concave seam) and a
+// 45-degree slope off its +z side (convex seam), as a jittered triangle soup
+// with one degenerate triangle.
+constexpr uint32_t kCookFloorCells = 6;
+
+std::vector<Vec3> BuildCookTestSoup()
+{
+    const float n = static_cast<float>(kCookFloorCells);
+    std::vector<Vec3> soup;
+    auto quad = [&](const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d) {
+        // (a, b, c) and (a, c, d); each copy jittered well inside the weld tolerance.
+        const Vec3 corners[6] = { a, b, c, a, c, d };
+        for (const Vec3& p : corners) {
+            const float j = 1e-5f * static_cast<float>(static_cast<int>(soup.size() % 5u) - 2);
+            soup.push_back(p + Vec3{j, -j, j});
+        }
+    };
+    for (uint32_t cz = 0; cz < kCookFloorCells; ++cz) {
+        for (uint32_t cx = 0; cx < kCookFloorCells; ++cx) {
+            const float x = static_cast<float>(cx);
+            const float z = static_cast<float>(cz);
+            quad({x, 0, z}, {x, 0, z + 1}, {x + 1, 0, z + 1}, {x + 1, 0, z});
+        }
+    }
+    for (uint32_t i = 0; i < kCookFloorCells; ++i) {
+        const float k = static_cast<float>(i);
+        quad({n, 0, k}, {n, 0, k + 1}, {n, 2, k + 1}, {n, 2, k});        // wall, normal -x
+        quad({k + 1, 0, n}, {k, 0, n}, {k, -1, n + 1}, {k + 1, -1, n + 1});  // slope
+    }
+    soup.push_back({1, 0, 1});  // degenerate: two corners weld together
+    soup.push_back({1, 0, 1});
+    soup.push_back({2, 0, 1});
+    return soup;
+}
+
+struct CookedMeshComparison {
+    CookedMesh mesh;
+    uint32_t edgeMismatches = 0;   // flags that disagree with the seam kind
+    uint32_t skimSweeps = 0;
+    uint32_t rawGhostHits = 0;     // skim sweeps stopped by a floor seam
+    uint32_t cookedGhostHits = 0;
+    uint32_t sweepMismatches = 0;  // landing, wall and slope sweeps that differ
+};
+
+CookedMeshComparison CompareCookedMesh()
+{
+    CookedMeshComparison out{};
+    const std::vector<Vec3> soup = BuildCookTestSoup();
+    const bool cooked = CookTriangleMesh(soup.data(), static_cast<uint32_t>(soup.size()),
+                                         nullptr, static_cast<uint32_t>(soup.size() / 3),
+                                         MeshCookDesc{}, out.mesh);
+    assert(cooked);
+    (void)cooked;
+    const CookedMesh& mesh = out.mesh;
+
+    // Expected: only floor/slope seams and open boundaries stay active.
+    auto kind = [&](uint32_t t) {
+        const Triangle tri = CookedMeshTriangle(mesh, t);
+        const float hi = (std::max)(tri.p0.y, (std::max)(tri.p1.y, tri.p2.y));
+        const float lo = (std::min)(tri.p0.y, (std::min)(tri.p1.y, tri.p2.y));
+        return hi > 0.5f ? 2 : (lo < -0.5f ? 1 : 0);  // 0 floor, 1 slope, 2 wall
+    };
+    const uint32_t triCount = CookedTriangleCount(mesh);
+    for (uint32_t t = 0; t < triCount; ++t) {
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t other = mesh.adjacency[t * 3 + k];
+            const bool expectActive = other == kNoMeshAdjacency ||
+                                      (kind(t) != kind(other) && kind(t) + kind(other) == 1);
+            if (((mesh.edgeFlags[t] >> k) & 1u) != (expectActive ? 1u : 0u))
+                ++out.edgeMismatches;
+        }
+    }
+
+    std::vector<Triangle> tris(triCount);
+    for (uint32_t t = 0; t < triCount; ++t)
+        tris[t] = CookedMeshTriangle(mesh, t);
+    const StaticBVH raw = BuildStaticBVH(nullptr, 0, nullptr, 0, tris.data(), triCount);
+    StaticBVH withFlags = BuildStaticBVH(nullptr, 0, nullptr, 0, tris.data(), triCount);
+    SetStaticBVHTriEdgeFlags(withFlags, mesh.edgeFlags.data());
+
+    const SweepConfig cfg{};
+    const SweepFilter noFilter{};
+    const float standY = 0.75f + cfg.skin * 0.5f;  // capsule bottom inside the skin
+    for (uint32_t i = 0; i < 48; ++i) {
+        const float fi = static_cast<float>(i);
+        const float x = 1.3f + std::fmod(fi * 0.73f, 3.4f);
+        const float z = 1.3f + std::fmod(fi * 1.37f, 3.4f);
+        const Vec3 dir{std::cos(fi * 0.9f), 0.0f, std::sin(fi * 0.9f)};
+
+        // Resting skim across floor seams; it ends at least 0.1 inside the rim.
+        const SweepCapsuleInput skim = MakeCapsuleSweep({x, standY, z}, dir * 1.2f);
+        const Hit rawSkim = SweepCapsuleClosestHit_LinearFallback(raw, skim, cfg, noFilter, true);
+        const Hit cookedSkim = SweepCapsuleClosestHit_LinearFallback(withFlags, skim, cfg,
+                                                                     noFilter, true);
+        ++out.skimSweeps;
+        out.rawGhostHits += rawSkim.hit ? 1u : 0u;
+        out.cookedGhostHits += cookedSkim.hit ? 1u : 0u;
+
+        // Landing, walking into the wall and walking off the slope edge must
+        // not change: faces and active edges still answer.
+        const SweepCapsuleInput others[3] = {
+            MakeCapsuleSweep({x, 1.6f, z}, Vec3{dir.x * 0.4f, -1.5f, dir.z * 0.4f}),
+            MakeCapsuleSweep({x + 0.5f, standY + 0.05f, z}, {2.0f, -0.02f, dir.z * 0.3f}),
+            MakeCapsuleSweep({x, standY + 0.3f, z + 1.5f}, {dir.x * 0.3f, -1.0f, 2.5f}),
+        };
+        for (const SweepCapsuleInput& in : others) {
+            const Hit a = SweepCapsuleClosestHit_LinearFallback(raw, in, cfg, noFilter, false);
+            const Hit b = SweepCapsuleClosestHit_LinearFallback(withFlags, in, cfg, noFilter, false);
+            if (a.hit != b.hit || (a.hit && (!Near(a.t, b.t, kHitTEps) || !SameNormal(a.normal, b.normal))))
+                ++out.sweepMismatches;
+        }
+    }
+    return out;
+}
+
+// Cooking welds the soup, links seams and clears flat and concave edges;
+// cleared edges remove the skim ghost hits and nothing else.
+void ExpectCookedMeshEdges()
+{
+    const CookedMeshComparison cmp = CompareCookedMesh();
+    const uint32_t n = kCookFloorCells;
+    assert(cmp.mesh.vertices.size() == (n + 1) * (n + 1) + 2 * (n + 1));
+    assert(CookedTriangleCount(cmp.mesh) == 2 * (n * n + 2 * n));
+    assert(cmp.mesh.droppedTriangles == 1 && cmp.mesh.triSource.back() == 2 * (n * n + 2 * n) - 1);
+    assert(cmp.edgeMismatches == 0);
+    assert(cmp.rawGhostHits > 0 && cmp.cookedGhostHits == 0);
+    assert(cmp.sweepMismatches == 0);
+    (void)cmp;
+    (void)n;
+
+    // OBJ: one quad as a polygon with v/t/n and negative references, plus a
+    // triangle; cooks like the same raw buffers.
+    const char obj[] =
+        "# strip\n"
+        "v 0 0 0\nv 0 0 1\nv 1 0 1\nv 1 0 0\nvt 0 0\n"
+        "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+        "v 2 0 1\n"
+        "f -2 -3 -1\n";
+    CookedMesh fromObj;
+    const bool objOk = CookObjMesh(obj, sizeof(obj) - 1, MeshCookDesc{}, fromObj);
+    const Vec3 positions[5] = { {0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {1, 0, 0}, {2, 0, 1} };
+    const uint32_t indices[9] = { 0, 1, 2, 0, 2, 3, 3, 2, 4 };
+    CookedMesh fromRaw;
+    const bool rawOk = CookTriangleMesh(positions, 5, indices, 3, MeshCookDesc{}, fromRaw);
+    assert(objOk && rawOk);
+    assert(fromObj.indices == fromRaw.indices && fromObj.edgeFlags == fromRaw.edgeFlags);
+    assert(fromRaw.inactiveEdges == 4 && fromRaw.activeEdges == 5);
+    const char badObj[] = "v 0 0 0\nf 1 2 3\n";  // references missing vertices
+    CookedMesh bad;
+    const bool badOk = CookObjMesh(badObj, sizeof(badObj) - 1, MeshCookDesc{}, bad);
+    assert(!badOk);
+    (void)objOk;
+    (void)rawOk;
+    (void)badOk;
+}
+
+// The same terrain triangles in one tree, with and without the per-triangle
+// narrowphase store. The store changes rounding only, so results must agree
+// within the harness tolerances.
+// Rounding may flip an exact tie between neighbours that touch at the same t
+// (one triangle's edge, the next one's face); then only the contact itself
+// must agree.
+bool SameTieTolerantHit(const Hit& a, const Hit& b)
+{
+    if (SameHit(a, b))
+        return true;
+    return a.hit && b.hit && a.type == b.type
+        && Near(a.t, b.t, kHitTEps)
+        && a.startPenetrating == b.startPenetrating
+        && Near(a.penetrationDepth, b.penetrationDepth, kDepthEps)
+        && SameNormal(a.normal, b.normal);
+}
+
+struct TrianglePrecompComparison {
+    SceneQueryBackendBenchmarkRow plain{};    // kernels recompute normals and edges
+    SceneQueryBackendBenchmarkRow precomp{};  // same tree + TrianglePrecomp; mismatches vs plain
+    uint32_t triangles = 0;
+    uint64_t precompBytes = 0;
+    uint32_t closestMismatches = 0;
+};
+
+TrianglePrecompComparison CompareTrianglePrecomp(uint32_t samplesPerSide, uint32_t queryCount)
+{
+    std::vector<Triangle> tris;
+    const HeightfieldPrim hf = BuildTestTerrain(samplesPerSide, tris);
+    const uint32_t triCount = static_cast<uint32_t>(tris.size());
+    std::vector<TrianglePrecomp> precomp;
+    BuildTrianglePrecomp(tris.data(), triCount, precomp);
+    const StaticBVH plain = BuildStaticBVH(nullptr, 0, nullptr, 0, tris.data(), triCount);
+    StaticBVH withPrecomp = plain;
+    SetStaticBVHTriPrecomp(withPrecomp, precomp.data());
+
+    TrianglePrecompComparison out{};
+    out.plain.backend = SceneQueryBackendId::BinaryBVH;
+    out.precomp.backend = SceneQueryBackendId::BinaryBVH;
+    out.triangles = triCount;
+    out.precompBytes = precomp.size() * sizeof(TrianglePrecomp);
+
+    const SweepConfig cfg{};
+    const float span = static_cast<float>(samplesPerSide - 1) * hf.cellSize;
+    auto makeQuery = [&](uint32_t i, bool& reject) {
+        const float fi = static_cast<float>(i);
+        const float x = hf.origin.x + 0.37f + std::fmod(fi * 2.93f, span - 0.8f);
+        const float z = hf.origin.z + 0.41f + std::fmod(fi * 4.37f, span - 0.8f);
+        const uint32_t sx = static_cast<uint32_t>((x - hf.origin.x) / hf.cellSize);
+        const uint32_t sz = static_cast<uint32_t>((z - hf.origin.z) / hf.cellSize);
+        const float ground0 = HeightfieldVertex(hf, sx, sz).y;
+        const Vec3 walk{std::cos(fi) * 2.0f, 0.0f, std::sin(fi) * 2.0f};
+        reject = (i % 3u) == 1u;
+        switch (i % 3u) {
+            case 0:  return MakeCapsuleSweep({x, 3.0f, z}, {0.0f, -4.0f, 0.0f});
+            case 1:  return MakeCapsuleSweep({x, ground0 + 0.8f, z}, walk);
+            default: return MakeCapsuleSweep({x, 1.6f, z}, walk * 3.0f + Vec3{0.0f, -0.5f, 0.0f});
+        }
+    };
+
+    // Rounds alternate plain and store passes and keep each row's fastest
+    // pass, so cache warm-up and clock noise do not favour either side.
+    // Metrics and mismatches come from round 0.
+    QueryScratch scratch{};
+    std::vector<Hit> plainHits(queryCount);
+    std::vector<OverlapRun> plainOverlaps(queryCount);
+    constexpr uint32_t kRounds = 7;
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        for (uint32_t pass = 0; pass < 2; ++pass) {
+            const StaticBVH& bvh = pass ? withPrecomp : plain;
+            SceneQueryBackendBenchmarkRow& row = pass ? out.precomp : out.plain;
+            if (round == 0)
+                ResetSceneQueryFrameMetrics(row.metrics);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < queryCount; ++i) {
+                bool reject = false;
+                const SweepCapsuleInput in = makeQuery(i, reject);
+                const Hit hit = SweepCapsuleClosestHit_Fast(bvh, in, cfg, scratch,
+                                                            SweepFilter{}, reject);
+                if (round == 0)
+                    AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                OverlapRun overlap{};
+                overlap.count = OverlapCapsuleContacts_Fast(
+                    bvh, in.segA0, in.segB0, in.radius + 0.1f,
+                    overlap.contacts, kMaxHarnessContacts, scratch);
+                if (round != 0)
+                    continue;
+                AccumulateQueryMetrics(row.metrics, scratch.metrics);
+                if (pass == 0) {
+                    plainHits[i] = hit;
+                    plainOverlaps[i] = overlap;
+                } else if (!SameTieTolerantHit(plainHits[i], hit) ||
+                           !SameContacts(plainOverlaps[i], overlap)) {
+                    ++row.mismatches;
+                }
+                row.queries += 2;
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const uint64_t ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            if (round == 0 || ns < row.elapsedNs)
+                row.elapsedNs = ns;
+        }
+    }
+
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        bool reject = false;
+        const SweepCapsuleInput in = makeQuery(i, reject);
+        const ClosestPointResult a = ClosestPointCapsule_Fast(
+            plain, in.segA0, in.segB0, in.radius, 2.0f, scratch);
+        const ClosestPointResult b = ClosestPointCapsule_Fast(
+            withPrecomp, in.segA0, in.segB0, in.radius, 2.0f, scratch);
+        if (!SameClosestPoint(a, b))
+            ++out.closestMismatches;
+    }
+    return out;
+}
+
+// The triangle store must not change any answer, and its cost is fixed per
+// triangle.
+void ExpectTrianglePrecompEquivalence()
+{
+    const TrianglePrecompComparison cmp = CompareTrianglePrecomp(65, 480);
+    assert(cmp.precomp.mismatches == 0 && cmp.closestMismatches == 0);
+    assert(cmp.precomp.metrics.narrowphaseCalls == cmp.plain.metrics.narrowphaseCalls);
+    assert(cmp.precompBytes == cmp.triangles * sizeof(TrianglePrecomp));
+    (void)cmp;
+
+    // The record describes translated copies too: a cap shifted off the
+    // plane gives the same face hit as rebuilding the normal.
+    const Triangle tri{{0.0f, 0.0f, 0.0f}, {0.0f, 0.2f, 2.0f}, {2.0f, 0.1f, 0.0f}};
+    const TrianglePrecomp pre = MakeTrianglePrecomp(tri);
+    const Vec3 shift{0.1f, 0.4f, -0.05f};
+    const Triangle cap{tri.p0 + shift, tri.p1 + shift, tri.p2 + shift};
+    float tA = 0.0f, tB = 0.0f, depthA = 0.0f, depthB = 0.0f;
+    Vec3 nA{}, nB{};
+    uint32_t fA = 0, fB = 0;
+    bool spA = false, spB = false;
+    const bool hitA = SweepSphereTri_TOI01({0.6f, 2.0f, 0.5f}, 0.3f, {0.0f, -3.0f, 0.0f}, cap,
+                                           true, tA, nA, fA, spA, depthA);
+    const bool hitB = SweepSphereTri_TOI01({0.6f, 2.0f, 0.5f}, 0.3f, {0.0f, -3.0f, 0.0f}, cap,
+                                           true, tB, nB, fB, spB, depthB, nullptr, false,
+                                           kNpEpsAlign, kTriEdgesAllActive, &pre);
+    assert(hitA && hitB && fA == 0 && fB == 0);
+    assert(Near(tA, tB, kHitTEps) && SameNormal(nA, nB));
+    (void)hitA;
+    (void)hitB;
+}
+
+// Sweeps over the ramp world (boxes + split ramps) and the test terrain, run
+// in primIdx order and again with leaf candidates ordered by entry time.
+struct LeafOrderComparison {
+    SceneQueryBackendBenchmarkRow primOrder{};   // narrowphase as each leaf is popped
+    SceneQueryBackendBenchmarkRow entryOrder{};  // orderLeafCandidates; mismatches vs primOrder
+    uint64_t deferred = 0;
+};
+
+LeafOrderComparison CompareLeafEntryOrder(uint32_t gridWidth, uint32_t gridDepth,
+                                          uint32_t queryCount)
+{
+    std::vector<AABB> boxes;
+    std::vector<Triangle> ramps;
+    BuildRampWorld(gridWidth, gridDepth, boxes, ramps);
+    BuildCtx splitCtx{};
+    splitCtx.spatialSplits = true;
+    const StaticBVH rampBvh = BuildStaticBVH(boxes.data(), static_cast<uint32_t>(boxes.size()),
+                                             nullptr, 0, ramps.data(),
+                                             static_cast<uint32_t>(ramps.size()), splitCtx);
+    std::vector<Triangle> terrainTris;
+    const HeightfieldPrim hf = BuildTestTerrain(gridWidth * 4u + 1u, terrainTris);
+    const StaticBVH terrainBvh = BuildStaticBVH(nullptr, 0, nullptr, 0, terrainTris.data(),
+                                                static_cast<uint32_t>(terrainTris.size()));
+    const float span = static_cast<float>(gridWidth * 4u) * hf.cellSize;
+    auto terrainQuery = [&](uint32_t i) {
+        const float fi = static_cast<float>(i);
+        const float x = hf.origin.x + 0.37f + std::fmod(fi * 3.11f, span - 0.8f);
+        const float z = hf.origin.z + 0.41f + std::fmod(fi * 4.79f, span - 0.8f);
+        const Vec3 walk{std::cos(fi) * 6.0f, -1.2f, std::sin(fi) * 6.0f};
+        return (i % 2u) ? MakeCapsuleSweep({x, 3.0f, z}, {0.0f, -4.0f, 0.0f})
+                        : MakeCapsuleSweep({x, 2.2f, z}, walk);
+    };
+
+    LeafOrderComparison out{};
+    out.primOrder.backend = SceneQueryBackendId::BinaryBVH;
+    out.entryOrder.backend = SceneQueryBackendId::BinaryBVH;
+    QueryScratch scratch{};
+    std::vector<Hit> primHits(static_cast<size_t>(queryCount) * 2u);
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        SweepConfig cfg{};
+        cfg.orderLeafCandidates = pass == 1;
+        SceneQueryBackendBenchmarkRow& row = pass ? out.entryOrder : out.primOrder;
+        ResetSceneQueryFrameMetrics(row.metrics);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < queryCount * 2u; ++i) {
+            const bool terrain = (i & 1u) != 0;
+            const SweepCapsuleInput in = terrain ? terrainQuery(i / 2u)
+                                                 : RampWorldQuery(i / 2u, gridWidth, gridDepth);
+            const Hit hit = SweepCapsuleClosestHit_Fast(terrain ? terrainBvh : rampBvh, in, cfg,
+                                                        scratch);
+            AccumulateQueryMetrics(row.metrics, scratch.metrics);
+            if (pass == 0)
+                primHits[i] = hit;
+            else if (!SameHit(primHits[i], hit))
+                ++row.mismatches;
+            ++row.queries;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        row.elapsedNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    out.deferred = out.entryOrder.metrics.deferredCandidates;
+    return out;
+}
+
+// Entry ordering must return the same hits with fewer narrowphase calls.
+void ExpectLeafEntryOrderEquivalence()
+{
+    const LeafOrderComparison cmp = CompareLeafEntryOrder(12, 12, 240);
+    assert(cmp.entryOrder.mismatches == 0);
+    assert(cmp.entryOrder.metrics.narrowphaseCalls < cmp.primOrder.metrics.narrowphaseCalls);
+    assert(cmp.primOrder.metrics.deferredCandidates == 0 && cmp.deferred > 0);
+    (void)cmp;
+
+    // One leaf, far triangle first in primIdx: the near one runs first and
+    // the far one is pruned without narrowphase.
+    const Triangle tris[2] = {
+        { {-2.0f, 0.0f, -2.0f}, {-2.0f, 0.0f, 2.0f}, {2.0f, 0.0f, -2.0f} },
+        { {-2.0f, 2.0f, -2.0f}, {-2.0f, 2.0f, 2.0f}, {2.0f, 2.0f, -2.0f} },
+    };
+    const StaticBVH bvh = BuildStaticBVH(nullptr, 0, nullptr, 0, tris, 2);
+    assert(bvh.nodes.size() == 1 && bvh.primIdx[0] == 0);
+    const SweepCapsuleInput fall = MakeCapsuleSweep({-1.0f, 5.0f, -1.0f}, {0.0f, -6.0f, 0.0f});
+    SweepConfig cfg{};
+    QueryScratch scratch{};
+    const Hit plain = SweepCapsuleClosestHit_Fast(bvh, fall, cfg, scratch);
+    const uint32_t plainCalls = scratch.metrics.narrowphaseCalls;
+    cfg.orderLeafCandidates = true;
+    const Hit ordered = SweepCapsuleClosestHit_Fast(bvh, fall, cfg, scratch);
+    assert(SameHit(plain, ordered) && ordered.index == 1);
+    assert(plainCalls == 2 && scratch.metrics.narrowphaseCalls == 1);
+    (void)plainCalls;
+}
+
+// ---- CollisionWorld-level checks ----------------------------------------
+
+// side x side box field at staggered heights, a ramp triangle per 7 cells,
+// a player-only blocker row, a floor plane and a trigger row. lift raises
+// every box, so two lifts give two worlds with different sweep results.
+std::vector<ColliderDesc> HarnessWorldColliders(uint32_t side, float lift)
+{
+    std::vector<ColliderDesc> out;
+    for (uint32_t z = 0; z < side; ++z) {
+        for (uint32_t x = 0; x < side; ++x) {
+            const float fx = static_cast<float>(x) * 2.0f;
+            const float fz = static_cast<float>(z) * 2.0f;
+            ColliderDesc d{};
+            if ((x * 3u + z) % 7u == 0) {
+                d.shape = ColliderShape::Tri;
+                d.triVerts = { {fx, lift, fz}, {fx + 1.5f, lift + 0.8f, fz},
+                               {fx + 1.5f, lift + 0.8f, fz + 1.5f} };
+                d.bounds = TriAABB(d.triVerts);
+            } else {
+                const float top = lift + 0.5f + 0.07f * static_cast<float>((x * 5u + z * 3u) % 9u);
+                d.bounds = Box(fx, lift - 0.5f, fz, fx + 1.5f, top, fz + 1.5f);
+            }
+            if (z == side / 2u)
+                d.mask = Q_Player;
+            d.userTag = z * side + x;
+            out.push_back(d);
+        }
+    }
+    ColliderDesc floor{};
+    floor.shape = ColliderShape::Plane;
+    floor.plane = MakeHalfSpace({0.0f, 1.0f, 0.0f}, -1.0f);
+    floor.bounds = PlaneFootprintBounds(floor.plane);
+    out.push_back(floor);
+    for (uint32_t x = 0; x < side; x += 3u) {
+        ColliderDesc trigger{};
+        trigger.kind = ColliderKind::Trigger;
+        trigger.mask = Q_Trigger;
+        const float fx = static_cast<float>(x) * 2.0f;
+        trigger.bounds = Box(fx, 1.5f, 0.0f, fx + 2.5f, 3.0f, 6.0f);
+        out.push_back(trigger);
+    }
+    return out;
+}
+
+// Falling and sideways capsule sweeps spread over the HarnessWorldColliders
+// field; odd queries also look at the player-only layer.
+SweepCapsuleInput HarnessWorldSweep(uint32_t i, uint32_t side)
+{
+    const float extent = static_cast<float>(side) * 2.0f;
+    const float x = 0.4f + static_cast<float>((i * 37u) % 97u) * extent / 97.0f;
+    const float z = 0.4f + static_cast<float>((i * 53u) % 89u) * extent / 89.0f;
+    if (i % 3u == 2u)
+        return MakeCapsuleSweep({x, 1.4f, z}, {std::cos(static_cast<float>(i)) * 4.0f, -0.2f,
+                                               std::sin(static_cast<float>(i)) * 4.0f});
+    return MakeCapsuleSweep({x, 3.0f, z}, {0.0f, -5.0f, 0.0f});
+}
+
+QueryMask HarnessWorldMask(uint32_t i)
+{
+    return (i & 1u) ? (Q_Solid | Q_Player) : Q_Solid;
+}
+
+// QueryTraversal::ShortStack must match FullStack through the whole world
+// path (BVH + planes + remap) and must leave the context's full stack
+// unallocated.
+void ExpectWorldShortStackTraversal()
+{
+    const uint32_t side = 24;
+    const std::vector<ColliderDesc> colliders = HarnessWorldColliders(side, 0.0f);
+    CollisionWorldLegacy full;
+    full.BuildStatic(colliders);
+    CollisionWorldLegacy bounded;
+    bounded.BuildStatic(colliders);
+    bounded.SetQueryTraversal(QueryTraversal::ShortStack);
+
+    SweepFilter ground{};
+    ground.active = true;
+    ground.refDir = {0.0f, 1.0f, 0.0f};
+    ground.minDot = 0.7f;
+
+    CollisionQueryContext fullCtx;
+    CollisionQueryContext boundedCtx;
+    const SweepConfig cfg{};
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < 96; ++i) {
+        const SweepCapsuleInput in = HarnessWorldSweep(i, side);
+        const QueryMask mask = HarnessWorldMask(i);
+        const SweepFilter filter = (i % 4u == 0) ? ground : SweepFilter{};
+        const Hit a = full.SweepCapsuleClosest(in, cfg, mask, filter, false, &fullCtx);
+        const Hit b = bounded.SweepCapsuleClosest(in, cfg, mask, filter, false, &boundedCtx);
+        assert(SameHit(a, b));
+        assert(boundedCtx.scratch.metrics.backend == QueryBackend::BinaryBVHShortStack);
+        hits += a.hit ? 1u : 0u;
+
+        OverlapRun oa{};
+        OverlapRun ob{};
+        const Vec3 segA = in.segA0 + in.delta * 0.6f;
+        const Vec3 segB = in.segB0 + in.delta * 0.6f;
+        oa.count = full.OverlapCapsuleContacts(segA, segB, 0.6f, mask, oa.contacts,
+                                               kMaxHarnessContacts, &fullCtx);
+        ob.count = bounded.OverlapCapsuleContacts(segA, segB, 0.6f, mask, ob.contacts,
+                                                  kMaxHarnessContacts, &boundedCtx);
+        assert(SameContacts(oa, ob));
+    }
+    assert(hits > 0);
+    assert(boundedCtx.scratch.stack.empty());
+    assert(fullCtx.scratch.stack.size() == QueryScratch::Capacity);
+    (void)hits;
+}
+
+// One-node budget: the Critical sweep always runs and exhausts it. Low slots
+// without a result defer and run one per BeginTick in FIFO order, served
+// results equal the direct world calls, results older than maxStaleTicks
+// or of another kind are not served, and SwapStatic drops every slot
+// result while keeping pending inputs.
+void ExpectQueryBudgetSlots()
+{
+    const uint32_t side = 12;
+    const std::vector<ColliderDesc> colliders = HarnessWorldColliders(side, 0.0f);
+    CollisionWorldLegacy world;
+    world.BuildStatic(colliders);
+
+    CollisionQueryBudget budget;
+    const uint32_t move = budget.RegisterSubsystem("move", QueryPriority::Critical);
+    const uint32_t probe = budget.RegisterSubsystem("probe", QueryPriority::Normal);
+    const uint32_t ai = budget.RegisterSubsystem("ai", QueryPriority::Low);
+
+    const SweepConfig cfg{};
+    const SweepCapsuleInput moveIn = HarnessWorldSweep(0, side);
+    const SweepCapsuleInput in = HarnessWorldSweep(3, side);
+    const Vec3 segA = in.segA0 + in.delta * 0.6f;
+    const Vec3 segB = in.segB0 + in.delta * 0.6f;
+    const Hit directHit = world.SweepCapsuleClosest(in, cfg);
+    OverlapRun directOverlap{};
+    directOverlap.count = world.OverlapCapsuleContacts(segA, segB, 0.6f, Q_Solid,
+                                                       directOverlap.contacts,
+                                                       kMaxHarnessContacts);
+    const ClosestPointResult directClosest =
+        world.ClosestPointCapsule(in.segA0, in.segB0, in.radius, 4.0f);
+    assert(directHit.hit && directOverlap.count > 0 && directClosest.hit);
+
+    using Status = BudgetedQueryStatus;
+    Hit hit{};
+    OverlapRun overlap{};
+    ClosestPointResult closest{};
+    auto sweep = [&](uint32_t subsystem, uint32_t slot) {
+        return budget.SweepCapsuleClosest(world, subsystem, slot, in, cfg, Q_Solid,
+                                          SweepFilter{}, false, hit);
+    };
+    auto overlapAt = [&](uint32_t slot) {
+        return budget.OverlapCapsuleContacts(world, ai, slot, segA, segB, 0.6f, Q_Solid,
+                                             overlap.contacts, kMaxHarnessContacts,
+                                             overlap.count);
+    };
+    auto closestAt = [&](uint32_t slot) {
+        return budget.ClosestPointCapsule(world, ai, slot, in.segA0, in.segB0, in.radius,
+                                          4.0f, Q_Solid, closest);
+    };
+    auto exhaust = [&] {
+        Hit moveHit{};
+        const Status status = budget.SweepCapsuleClosest(world, move, 0, moveIn, cfg, Q_Solid,
+                                                         SweepFilter{}, false, moveHit);
+        assert(status == Status::Ran);
+        assert(budget.IsExhausted(QueryPriority::Normal));
+        (void)status;
+    };
+
+    // Tick 1, unlimited until Configure: Low runs.
+    budget.BeginTick(world);
+    assert(sweep(ai, 0) == Status::Ran && SameHit(hit, directHit));
+
+    QueryBudgetDesc desc{};
+    desc.tickNodes = 1;
+    desc.lowPriorityShare = 0.5f;
+    desc.maxStaleTicks = 2;
+    budget.Configure(desc);
+
+    // Tick 2: slot 0 is served stale; the rest have no result and defer.
+    // Normal runs once without a result, then goes stale too.
+    budget.BeginTick(world);
+    exhaust();
+    assert(sweep(ai, 0) == Status::Stale && SameHit(hit, directHit));
+    assert(overlapAt(1) == Status::Deferred && overlap.count == 0);
+    assert(closestAt(2) == Status::Deferred && !closest.hit);
+    assert(sweep(ai, 3) == Status::Deferred && !hit.hit);
+    assert(overlapAt(1) == Status::Deferred);
+    assert(sweep(probe, 0) == Status::Ran && SameHit(hit, directHit));
+    assert(sweep(probe, 0) == Status::Stale && SameHit(hit, directHit));
+    assert(budget.GetPendingCount() == 3);
+    assert(budget.IsSlotPending(ai, 1) && budget.IsSlotPending(ai, 2) &&
+           budget.IsSlotPending(ai, 3));
+
+    // Ticks 3-5: one pending query fits each BeginTick, oldest first.
+    budget.BeginTick(world);
+    assert(budget.GetTickStats().counters.deferredRun == 1 && budget.GetTickStats().pending == 2);
+    assert(!budget.IsSlotPending(ai, 1) && budget.IsSlotPending(ai, 2));
+    OverlapRun slotOverlap{};
+    assert(budget.GetSlotResult(ai, 1, slotOverlap.contacts, kMaxHarnessContacts,
+                                slotOverlap.count) && SameContacts(slotOverlap, directOverlap));
+    assert(!budget.GetSlotResult(ai, 1, hit) && !budget.GetSlotResult(ai, 2, closest));
+    (void)slotOverlap;
+    exhaust();
+    assert(overlapAt(1) == Status::Stale && SameContacts(overlap, directOverlap));
+    assert(closestAt(2) == Status::Deferred);
+
+    budget.BeginTick(world);
+    ClosestPointResult slotClosest{};
+    assert(budget.GetSlotResult(ai, 2, slotClosest) && SameClosestPoint(slotClosest, directClosest));
+    (void)slotClosest;
+    exhaust();
+    assert(closestAt(2) == Status::Stale && SameClosestPoint(closest, directClosest));
+
+    budget.BeginTick(world);
+    assert(budget.GetPendingCount() == 0);
+    assert(budget.GetSlotResult(ai, 3, hit) && SameHit(hit, directHit));
+    exhaust();
+    // Slot 0 ran in tick 1, older than maxStaleTicks; slot 1 holds an overlap.
+    assert(sweep(ai, 0) == Status::Deferred);
+    assert(sweep(ai, 1) == Status::Deferred);
+    assert(budget.GetPendingCount() == 2);
+
+    // SwapStatic: results are dropped, pending inputs still run.
+    CollisionWorldLegacy built;
+    built.BuildStatic(colliders);
+    world.SwapStatic(built);
+    budget.BeginTick(world);
+    assert(budget.GetTickStats().counters.deferredRun == 1);
+    assert(!budget.GetSlotResult(ai, 3, hit) && !budget.GetSlotResult(probe, 0, hit));
+    assert(budget.GetSlotResult(ai, 0, hit) && SameHit(hit, directHit));
+    exhaust();
+    assert(sweep(ai, 3) == Status::Deferred);
+    assert(sweep(probe, 0) == Status::Ran && SameHit(hit, directHit));
+    assert(sweep(ai, 0) == Status::Stale && SameHit(hit, directHit));
+
+    const QueryBudgetCounters& low = budget.GetSubsystemCounters(ai);
+    assert(low.issued == low.ran - low.deferredRun + low.stale + low.deferred);
+    assert(low.deferredRun == 4 && low.stale == 4 && low.deferred == 8);
+    const QueryBudgetCounters& total = budget.GetTotalCounters();
+    assert(total.issued == total.ran - total.deferredRun + total.stale + total.deferred);
+
+    // A zero share is clamped above 0, so the queue still drains one per tick.
+    desc.lowPriorityShare = 0.0f;
+    budget.Configure(desc);
+    assert(budget.GetDesc().lowPriorityShare > 0.0f);
+    budget.BeginTick(world);
+    assert(budget.GetTickStats().counters.deferredRun == 1 && budget.GetPendingCount() == 1);
+    assert(budget.GetSlotResult(ai, 1, hit) && SameHit(hit, directHit));
+    (void)move;
+    (void)probe;
+    (void)low;
+    (void)total;
+}
+
+bool SameBits(float a, float b)
+{
+    uint32_t ua = 0;
+    uint32_t ub = 0;
+    std::memcpy(&ua, &a, sizeof(ua));
+    std::memcpy(&ub, &b, sizeof(ub));
+    return ua == ub;
+}
+
+bool SameBits(const Vec3& a, const Vec3& b)
+{
+    return SameBits(a.x, b.x) && SameBits(a.y, b.y) && SameBits(a.z, b.z);
+}
+
+bool SameHitBits(const Hit& a, const Hit& b)
+{
+    return a.hit == b.hit && SameBits(a.t, b.t) && a.type == b.type && a.index == b.index &&
+           SameBits(a.normal, b.normal) && a.featureId == b.featureId &&
+           a.startPenetrating == b.startPenetrating &&
+           SameBits(a.penetrationDepth, b.penetrationDepth);
+}
+
+bool SameContactBits(const OverlapContact& a, const OverlapContact& b)
+{
+    return SameBits(a.normal, b.normal) && SameBits(a.depth, b.depth) && a.type == b.type &&
+           a.index == b.index && a.featureId == b.featureId;
+}
+
+// Mixed sweep, ray and overlap jobs over three batches (one kicked early,
+// one ending in a partial chunk) must publish in submission order and equal
+// the direct world calls bit for bit, with 1 and 4 workers.
+void ExpectQueryJobsEquivalence()
+{
+    const uint32_t side = 16;
+    CollisionWorldLegacy world;
+    world.BuildStatic(HarnessWorldColliders(side, 0.0f));
+
+    SweepFilter ground{};
+    ground.active = true;
+    ground.refDir = {0.0f, 1.0f, 0.0f};
+    ground.minDot = 0.7f;
+    const SweepConfig cfg{};
+    SweepConfig rayCfg{};
+    rayCfg.skin = 0.0f;
+
+    const uint32_t kickAt = 100;
+    const uint32_t count = CollisionQueryJobs::kBatchSize + kickAt + 37;
+    const uint32_t workerCounts[] = {1u, 4u};
+    for (const uint32_t workers : workerCounts) {
+        CollisionQueryJobs jobs(&world);
+        jobs.SetWorkerCount(workers);
+        std::vector<QueryHandle> handles;
+        for (uint32_t i = 0; i < count; ++i) {
+            const SweepCapsuleInput in = HarnessWorldSweep(i, side);
+            const QueryMask mask = HarnessWorldMask(i);
+            switch (i % 3u) {
+            case 0:
+                handles.push_back(jobs.SubmitSweep(in, cfg, mask,
+                                                   (i % 4u == 0) ? ground : SweepFilter{},
+                                                   i % 5u == 0));
+                break;
+            case 1:
+                handles.push_back(jobs.SubmitRay(in.segA0, Normalize(in.delta),
+                                                 Length(in.delta), mask));
+                break;
+            default:
+                handles.push_back(jobs.SubmitOverlap(in.segA0 + in.delta * 0.6f,
+                                                     in.segB0 + in.delta * 0.6f, 0.6f, mask,
+                                                     (i % 4u == 2u) ? 3u : kQueryJobMaxContacts));
+                break;
+            }
+            if (i + 1 == kickAt)
+                jobs.Kick();
+        }
+        assert(!jobs.Poll(handles.back()));  // still in the open batch
+
+        // Waiting on a late job publishes every earlier one too.
+        const uint32_t probe = count - 20u;
+        jobs.Wait(handles[probe]);
+        for (uint32_t i = 0; i <= probe; ++i)
+            assert(jobs.Poll(handles[i]));
+        jobs.WaitAll();
+
+        uint32_t hits = 0;
+        uint32_t contacts = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            assert(jobs.Poll(handles[i]));
+            const QueryJobResult& r = jobs.Wait(handles[i]);
+            const SweepCapsuleInput in = HarnessWorldSweep(i, side);
+            const QueryMask mask = HarnessWorldMask(i);
+            switch (i % 3u) {
+            case 0: {
+                assert(r.kind == QueryJobKind::Sweep);
+                const Hit direct = world.SweepCapsuleClosest(
+                    in, cfg, mask, (i % 4u == 0) ? ground : SweepFilter{}, i % 5u == 0);
+                assert(SameHitBits(r.hit, direct));
+                hits += direct.hit ? 1u : 0u;
+                break;
+            }
+            case 1: {
+                assert(r.kind == QueryJobKind::Ray);
+                SweepCapsuleInput ray{};
+                ray.segA0 = in.segA0;
+                ray.segB0 = in.segA0;
+                ray.radius = 0.0f;
+                ray.delta = Normalize(in.delta) * Length(in.delta);
+                const Hit direct = world.SweepCapsuleClosest(ray, rayCfg, mask);
+                assert(SameHitBits(r.hit, direct));
+                hits += direct.hit ? 1u : 0u;
+                break;
+            }
+            default: {
+                assert(r.kind == QueryJobKind::Overlap);
+                OverlapContact direct[kQueryJobMaxContacts]{};
+                const uint32_t n = world.OverlapCapsuleContacts(
+                    in.segA0 + in.delta * 0.6f, in.segB0 + in.delta * 0.6f, 0.6f, mask, direct,
+                    (i % 4u == 2u) ? 3u : kQueryJobMaxContacts);
+                assert(r.contactCount == n);
+                for (uint32_t c = 0; c < n; ++c)
+                    assert(SameContactBits(r.contacts[c], direct[c]));
+                contacts += n;
+                break;
+            }
+            }
+        }
+        assert(hits > 0 && contacts > 0);
+
+        const QueryJobStats stats = jobs.GetStats();
+        assert(stats.completed == count && stats.batches == 3 && stats.workers == workers);
+
+        // Reset invalidates every handle.
+        const QueryHandle old = handles.front();
+        jobs.Reset();
+        assert(!jobs.Poll(old));
+        assert(!jobs.Wait(old).hit.hit && jobs.Wait(old).contactCount == 0);
+        (void)hits;
+        (void)contacts;
+        (void)stats;
+        (void)old;
+    }
+}
+
+// HarnessWorldColliders plus `rows` rows of raised boxes with one ramp each,
+// appended after the base list like WorldState's extras.
+std::vector<ColliderDesc> HarnessWorldGrown(uint32_t side, uint32_t rows)
+{
+    std::vector<ColliderDesc> out = HarnessWorldColliders(side, 0.0f);
+    for (uint32_t r = 0; r < rows; ++r) {
+        const float fz = static_cast<float>(r * 10u + 3u) + 0.3f;
+        for (uint32_t x = 0; x < side; x += 2u) {
+            const float fx = static_cast<float>(x) * 2.0f + 0.75f;
+            ColliderDesc d{};
+            d.bounds = Box(fx, 1.2f, fz, fx + 1.1f, 1.45f + 0.05f * static_cast<float>(r), fz + 2.2f);
+            out.push_back(d);
+        }
+        ColliderDesc ramp{};
+        ramp.shape = ColliderShape::Tri;
+        ramp.triVerts = { {1.1f, 1.3f, fz + 3.0f}, {9.3f, 2.1f, fz + 3.0f},
+                          {9.3f, 2.1f, fz + 4.6f} };
+        ramp.bounds = TriAABB(ramp.triVerts);
+        out.push_back(ramp);
+    }
+    return out;
+}
+
+// What a live world answers for a fixed probe set: sweeps, contact
+// overlaps, closest points and trigger ids.
+struct WorldAnswers {
+    std::vector<Hit> hits;
+    std::vector<OverlapRun> overlaps;
+    std::vector<ClosestPointResult> closest;
+    std::vector<std::vector<uint32_t>> triggers;
+};
+
+WorldAnswers AskWorld(const CollisionWorldLegacy& world, uint32_t side)
+{
+    WorldAnswers out;
+    const SweepConfig cfg{};
+    for (uint32_t i = 0; i < 72; ++i) {
+        const SweepCapsuleInput in = HarnessWorldSweep(i, side);
+        const QueryMask mask = HarnessWorldMask(i);
+        out.hits.push_back(world.SweepCapsuleClosest(in, cfg, mask));
+        OverlapRun overlap{};
+        const Vec3 segA = in.segA0 + in.delta * 0.4f;
+        const Vec3 segB = in.segB0 + in.delta * 0.4f;
+        overlap.count = world.OverlapCapsuleContacts(segA, segB, 0.6f, mask, overlap.contacts,
+                                                     (i % 4u == 1u) ? 3u : kMaxHarnessContacts);
+        out.overlaps.push_back(overlap);
+        out.closest.push_back(world.ClosestPointCapsule(in.segA0, in.segB0, in.radius, 3.0f, mask));
+        uint32_t ids[16];
+        const uint32_t n = world.OverlapCapsule(in.segA0, in.segB0, 1.5f, Q_Trigger, ids, 16);
+        out.triggers.emplace_back(ids, ids + n);
+    }
+    return out;
+}
+
+// The BVH prunes a node once its entry t reaches the best t, so a probe
+// that starts inside two colliders names whichever the traversal reaches
+// first; builds of different lists may disagree. Such a sweep counts as the
+// same when `world` (which answered a) also starts inside b's collider.
+bool SameAnswers(const CollisionWorldLegacy& world, const WorldAnswers& a,
+                 const WorldAnswers& b, uint32_t side)
+{
+    for (uint32_t i = 0; i < a.hits.size(); ++i) {
+        bool sameHit = SameHit(a.hits[i], b.hits[i]);
+        if (!sameHit && a.hits[i].hit && b.hits[i].hit &&
+            a.hits[i].startPenetrating && b.hits[i].startPenetrating &&
+            a.hits[i].t == 0.0f && b.hits[i].t == 0.0f) {
+            const Hit tie = world.SweepCapsuleAgainstCollider(b.hits[i].index,
+                                                              HarnessWorldSweep(i, side),
+                                                              SweepConfig{});
+            sameHit = tie.hit && tie.startPenetrating && tie.t == 0.0f;
+        }
+        if (!sameHit || !SameContacts(a.overlaps[i], b.overlaps[i]) ||
+            !SameClosestPoint(a.closest[i], b.closest[i]) || a.triggers[i] != b.triggers[i])
+            return false;
+    }
+    return true;
+}
+
+// Actor i's trigger pair events at probe i, for one cache across calls.
+std::vector<TriggerPairEvent> TriggerEvents(const CollisionWorldLegacy& world,
+                                            TriggerPairCache& cache, uint32_t side)
+{
+    std::vector<TriggerPairEvent> events;
+    for (uint32_t i = 0; i < 24; ++i) {
+        const SweepCapsuleInput in = HarnessWorldSweep(i, side);
+        world.UpdateTriggerPairs(cache, i, in.segA0, in.segB0, 1.5f, Q_Trigger, events);
+    }
+    return events;
+}
+
+// Background rebuild through the gap patch: the live world answers like a
+// full build of the newest request from the moment it is requested, through
+// each publish. Each publish bumps the epoch once, trigger pairs stay put
+// across it, and a request made while another is queued replaces it.
+void ExpectBackgroundRebuildGapPatch()
+{
+    const uint32_t side = 16;
+    const std::vector<ColliderDesc> base = HarnessWorldColliders(side, 0.0f);
+    const std::vector<ColliderDesc> grownA = HarnessWorldGrown(side, 1);
+    const std::vector<ColliderDesc> grownB = HarnessWorldGrown(side, 2);
+    const std::vector<ColliderDesc> grownC = HarnessWorldGrown(side, 3);
+    CollisionWorldLegacy fullC;
+    fullC.BuildStatic(grownC);
+    const WorldAnswers expected = AskWorld(fullC, side);
+
+    CollisionWorldLegacy live;
+    live.BuildStatic(base);
+    const WorldAnswers before = AskWorld(live, side);
+    assert(!SameAnswers(live, before, expected, side));  // the rows change some answers
+    TriggerPairCache pairs;
+    const std::vector<TriggerPairEvent> entered = TriggerEvents(live, pairs, side);
+    assert(!entered.empty());
+
+    CollisionWorldRebuilder rebuilder;
+    rebuilder.Request(grownA, live);
+    rebuilder.Request(grownB, live);
+    rebuilder.Request(grownC, live);
+    assert(rebuilder.IsBuilding() && rebuilder.HasQueued());
+    assert(rebuilder.GetStats().coalesced == 1);
+    assert(live.getColliderCount() == grownC.size());
+    assert(live.getGapColliderCount() == grownC.size() - base.size());
+    assert(SameAnswers(live, AskWorld(live, side), expected, side));
+
+    // Two publishes (A, then C); the epoch moves only when one happens.
+    for (uint32_t published = 0; published < 2;) {
+        const uint32_t epoch = live.GetStaticEpoch();
+        if (!rebuilder.PublishIfReady(live)) {
+            assert(live.GetStaticEpoch() == epoch);
+            std::this_thread::yield();
+            continue;
+        }
+        ++published;
+        assert(live.GetStaticEpoch() == epoch + 1);
+        assert(live.getStaticColliderCount() == (published == 1 ? grownA.size() : grownC.size()));
+        assert(live.getColliderCount() == grownC.size());
+        assert(SameAnswers(live, AskWorld(live, side), expected, side));
+
+        // Same triggers, same boxes: every pair stays.
+        const std::vector<TriggerPairEvent> again = TriggerEvents(live, pairs, side);
+        assert(again.size() == entered.size());
+        for (size_t e = 0; e < again.size(); ++e)
+            assert(again[e].trigger == entered[e].trigger &&
+                   again[e].kind == TriggerPairEventKind::Stay);
+    }
+    assert(live.getGapColliderCount() == 0 && !rebuilder.IsBuilding());
+    const CollisionRebuildStats& stats = rebuilder.GetStats();
+    assert(stats.requested == 3 && stats.built == 2 && stats.published == 2);
+
+    // Removing colliders is not an append: the patch clears and the old
+    // answers come back only with the publish.
+    rebuilder.Request(base, live);
+    assert(live.getGapColliderCount() == 0);
+    rebuilder.Flush(live);
+    assert(live.getColliderCount() == base.size());
+    assert(SameAnswers(live, AskWorld(live, side), before, side));
+    (void)stats;
+
+    // Cross-type tie at distance 0: a point on the floor plane and inside a
+    // patched stair box. The full build answers the box (Aabb before Plane),
+    // so the patch must too.
+    ColliderDesc floor{};
+    floor.shape = ColliderShape::Plane;
+    floor.plane = MakeHalfSpace({0.0f, 1.0f, 0.0f}, 0.0f);
+    floor.bounds = PlaneFootprintBounds(floor.plane);
+    ColliderDesc stair{};
+    stair.bounds = Box(0.0f, -0.5f, 0.0f, 1.0f, 0.25f, 1.0f);
+    const std::vector<ColliderDesc> floorOnly{floor};
+    const std::vector<ColliderDesc> withStair{floor, stair};
+    CollisionWorldLegacy fullStair;
+    fullStair.BuildStatic(withStair);
+    CollisionWorldLegacy patched;
+    patched.BuildStatic(floorOnly);
+    CollisionWorldRebuilder stairRebuilder;
+    stairRebuilder.Request(withStair, patched);
+    assert(patched.getGapColliderCount() == 1);
+    const Vec3 onFloor{0.5f, 0.0f, 0.5f};
+    const ClosestPointResult fullTie = fullStair.ClosestPointCapsule(onFloor, onFloor, 0.0f, 1.0f);
+    const ClosestPointResult gapTie = patched.ClosestPointCapsule(onFloor, onFloor, 0.0f, 1.0f);
+    assert(fullTie.hit && fullTie.distance == 0.0f && fullTie.type == PrimType::Aabb &&
+           fullTie.index == 1);
+    assert(gapTie.hit && gapTie.distance == 0.0f && gapTie.type == fullTie.type &&
+           gapTie.index == fullTie.index);
+    stairRebuilder.Flush(patched);
+    (void)fullTie;
+    (void)gapTie;
 }
 
 } // namespace
@@ -476,6 +3102,28 @@ void RunSceneQueryBackendSelfTest()
         return;
     s_ran = true;
     RunSmokeFixtures();
+    ExpectShortStackRestartEquivalence();
+    ExpectLocalSetEquivalence();
+    ExpectQueryMemoRefilterEquivalence();
+    ExpectDynamicCapsuleHashEquivalence();
+    ExpectClosestPointEquivalence();
+    ExpectKNearestEquivalence();
+    ExpectQueryMaskEquivalence();
+    ExpectFilterCullEquivalence();
+    ExpectUniformGridEquivalence();
+    ExpectTriggerPairCacheEquivalence();
+    ExpectFloorPlaneEquivalence();
+    ExpectFloorPlaneRimReturn();
+    ExpectHeightfieldEquivalence();
+    ExpectHeightfieldClosestPoint();
+    ExpectCookedMeshEdges();
+    ExpectTrianglePrecompEquivalence();
+    ExpectLeafEntryOrderEquivalence();
+    ExpectWorldShortStackTraversal();
+    ExpectQueryBudgetSlots();
+    ExpectQueryJobsEquivalence();
+    ExpectBackgroundRebuildGapPatch();
+    ExpectSpatialSplitEquivalence();
 #endif
 }
 
@@ -501,7 +3149,68 @@ SceneQueryBackendBenchmarkReport RunSceneQueryBackendBenchmark(
     report.bvh4Simd = RunBenchmarkBackend(SceneQueryBackendId::SimdBVH4,
                                           world, config, report.correctnessPassed,
                                           &oracleHits, nullptr);
+    report.shortStack = RunBenchmarkBackend(SceneQueryBackendId::ShortStackBVH,
+                                            world, config, report.correctnessPassed,
+                                            &oracleHits, nullptr);
+    report.uniformGrid = RunBenchmarkBackend(SceneQueryBackendId::UniformGrid,
+                                             world, config, report.correctnessPassed,
+                                             &oracleHits, nullptr);
     report.overlapTopologyRiskObserved = DetectOverlapTopologyRisk();
+
+    const FloorPlaneComparison floor = CompareFloorPlane(config.gridWidth, config.gridDepth,
+                                                         config.queryCount);
+    report.floorTris = floor.tris;
+    report.floorPlane = floor.plane;
+    if (floor.plane.mismatches)
+        report.correctnessPassed = false;
+
+    const HeightfieldComparison terrain = CompareHeightfield(config.gridWidth * 4u + 1u,
+                                                             config.queryCount);
+    report.terrainTris = terrain.tris;
+    report.terrainField = terrain.field;
+    report.terrainSamples = terrain.samples;
+    report.terrainTriangles = terrain.triangles;
+    report.terrainFieldBytes = terrain.fieldBytes;
+    report.terrainTriBytes = terrain.triBytes;
+    if (terrain.field.mismatches)
+        report.correctnessPassed = false;
+
+    const CookedMeshComparison cook = CompareCookedMesh();
+    report.cookInputVertices = cook.mesh.inputVertices;
+    report.cookVertices = static_cast<uint32_t>(cook.mesh.vertices.size());
+    report.cookActiveEdges = cook.mesh.activeEdges;
+    report.cookInactiveEdges = cook.mesh.inactiveEdges;
+    report.cookSkimSweeps = cook.skimSweeps;
+    report.cookRawGhostHits = cook.rawGhostHits;
+    report.cookGhostHits = cook.cookedGhostHits;
+    report.cookSweepMismatches = cook.sweepMismatches;
+    if (cook.edgeMismatches || cook.sweepMismatches)
+        report.correctnessPassed = false;
+
+    const TrianglePrecompComparison precomp = CompareTrianglePrecomp(config.gridWidth * 4u + 1u,
+                                                                     config.queryCount);
+    report.precompPlain = precomp.plain;
+    report.precompStore = precomp.precomp;
+    report.precompTriangles = precomp.triangles;
+    report.precompBytes = precomp.precompBytes;
+    if (precomp.precomp.mismatches || precomp.closestMismatches)
+        report.correctnessPassed = false;
+
+    const LeafOrderComparison leafOrder = CompareLeafEntryOrder(config.gridWidth, config.gridDepth,
+                                                                config.queryCount);
+    report.leafPrimOrder = leafOrder.primOrder;
+    report.leafEntryOrder = leafOrder.entryOrder;
+    if (leafOrder.entryOrder.mismatches)
+        report.correctnessPassed = false;
+
+    const SpatialSplitComparison ramps = CompareSpatialSplit(config.gridWidth, config.gridDepth,
+                                                             config.queryCount);
+    report.rampMedian = ramps.median;
+    report.rampSpatial = ramps.spatial;
+    report.rampPrims = ramps.prims;
+    report.rampSpatialRefs = ramps.spatialRefs;
+    if (ramps.median.mismatches || ramps.spatial.mismatches)
+        report.correctnessPassed = false;
     return report;
 }
 
@@ -513,63 +3222,113 @@ void FormatSceneQueryBackendBenchmarkReport(
     if (!out || outSize == 0)
         return;
 
-    const SceneQueryBackendBenchmarkRow& a = report.linear;
-    const SceneQueryBackendBenchmarkRow& b = report.binary;
-    const SceneQueryBackendBenchmarkRow& c = report.bvh4;
-    const SceneQueryBackendBenchmarkRow& d = report.bvh4Simd;
-    std::snprintf(
-        out, outSize,
+    size_t used = 0;
+    AppendReportLine(out, outSize, used,
         "SceneQuery backend benchmark\n"
-        "correctness=%s overlapTopologyRisk=%s grid=%ux%u queries=%u\n"
-        "%s: ns/query=%.1f nodeAabbTests=%llu nodePackets=%llu packetLanes=%llu primitiveAabbTests=%llu narrowphaseCalls=%llu maxStack=%u fallback=%u mismatches=%u\n"
-        "%s: ns/query=%.1f nodeAabbTests=%llu nodePackets=%llu packetLanes=%llu primitiveAabbTests=%llu narrowphaseCalls=%llu maxStack=%u fallback=%u mismatches=%u\n"
-        "%s: ns/query=%.1f nodeAabbTests=%llu nodePackets=%llu packetLanes=%llu primitiveAabbTests=%llu narrowphaseCalls=%llu maxStack=%u fallback=%u mismatches=%u\n"
-        "%s: ns/query=%.1f nodeAabbTests=%llu nodePackets=%llu packetLanes=%llu primitiveAabbTests=%llu narrowphaseCalls=%llu maxStack=%u fallback=%u mismatches=%u\n",
+        "correctness=%s overlapTopologyRisk=%s grid=%ux%u queries=%u\n",
         report.correctnessPassed ? "pass" : "fail",
         report.overlapTopologyRiskObserved ? "yes" : "no",
         report.config.gridWidth,
         report.config.gridDepth,
-        report.config.queryCount,
-        BackendName(a.backend),
-        a.NsPerQuery(),
-        static_cast<unsigned long long>(a.metrics.nodeAabbTests),
-        static_cast<unsigned long long>(a.metrics.nodeAabbPackets),
-        static_cast<unsigned long long>(a.metrics.nodeAabbPacketLanes),
-        static_cast<unsigned long long>(a.metrics.primitiveAabbTests),
-        static_cast<unsigned long long>(a.metrics.narrowphaseCalls),
-        a.metrics.maxStackDepth,
-        a.metrics.fallbackCount,
-        a.mismatches,
-        BackendName(b.backend),
-        b.NsPerQuery(),
-        static_cast<unsigned long long>(b.metrics.nodeAabbTests),
-        static_cast<unsigned long long>(b.metrics.nodeAabbPackets),
-        static_cast<unsigned long long>(b.metrics.nodeAabbPacketLanes),
-        static_cast<unsigned long long>(b.metrics.primitiveAabbTests),
-        static_cast<unsigned long long>(b.metrics.narrowphaseCalls),
-        b.metrics.maxStackDepth,
-        b.metrics.fallbackCount,
-        b.mismatches,
-        BackendName(c.backend),
-        c.NsPerQuery(),
-        static_cast<unsigned long long>(c.metrics.nodeAabbTests),
-        static_cast<unsigned long long>(c.metrics.nodeAabbPackets),
-        static_cast<unsigned long long>(c.metrics.nodeAabbPacketLanes),
-        static_cast<unsigned long long>(c.metrics.primitiveAabbTests),
-        static_cast<unsigned long long>(c.metrics.narrowphaseCalls),
-        c.metrics.maxStackDepth,
-        c.metrics.fallbackCount,
-        c.mismatches,
-        BackendName(d.backend),
-        d.NsPerQuery(),
-        static_cast<unsigned long long>(d.metrics.nodeAabbTests),
-        static_cast<unsigned long long>(d.metrics.nodeAabbPackets),
-        static_cast<unsigned long long>(d.metrics.nodeAabbPacketLanes),
-        static_cast<unsigned long long>(d.metrics.primitiveAabbTests),
-        static_cast<unsigned long long>(d.metrics.narrowphaseCalls),
-        d.metrics.maxStackDepth,
-        d.metrics.fallbackCount,
-        d.mismatches);
+        report.config.queryCount);
+
+    AppendBenchmarkRow(out, outSize, used, report.linear);
+    AppendBenchmarkRow(out, outSize, used, report.binary);
+    AppendBenchmarkRow(out, outSize, used, report.bvh4);
+    AppendBenchmarkRow(out, outSize, used, report.bvh4Simd);
+    AppendBenchmarkRow(out, outSize, used, report.shortStack);
+    AppendBenchmarkRow(out, outSize, used, report.uniformGrid);
+
+    const uint64_t triNodes = report.floorTris.metrics.nodesPopped;
+    const uint64_t planeNodes = report.floorPlane.metrics.nodesPopped;
+    AppendReportLine(out, outSize, used,
+        "floor (BinaryBVH sweeps+overlaps): 2 BVH tris -> bounded plane\n"
+        "  nodesPopped=%llu -> %llu (-%.1f%%) nodeAabbTests=%llu -> %llu narrowphaseCalls=%llu -> %llu ns/query=%.1f -> %.1f triTreeDiffs=%u mismatches=%u\n",
+        static_cast<unsigned long long>(triNodes),
+        static_cast<unsigned long long>(planeNodes),
+        triNodes ? 100.0 * static_cast<double>(triNodes - planeNodes) / static_cast<double>(triNodes) : 0.0,
+        static_cast<unsigned long long>(report.floorTris.metrics.nodeAabbTests),
+        static_cast<unsigned long long>(report.floorPlane.metrics.nodeAabbTests),
+        static_cast<unsigned long long>(report.floorTris.metrics.narrowphaseCalls),
+        static_cast<unsigned long long>(report.floorPlane.metrics.narrowphaseCalls),
+        report.floorTris.NsPerQuery(),
+        report.floorPlane.NsPerQuery(),
+        report.floorTris.mismatches,
+        report.floorPlane.mismatches);
+
+    AppendReportLine(out, outSize, used,
+        "terrain (sweeps+overlaps): %u tris in BinaryBVH -> heightfield %u samples\n"
+        "  bytes=%llu -> %llu (%.1f/tri -> %.2f/sample) nodesPopped=%llu -> %llu narrowphaseCalls=%llu -> %llu ns/query=%.1f -> %.1f mismatches=%u\n",
+        report.terrainTriangles,
+        report.terrainSamples,
+        static_cast<unsigned long long>(report.terrainTriBytes),
+        static_cast<unsigned long long>(report.terrainFieldBytes),
+        report.terrainTriangles ? static_cast<double>(report.terrainTriBytes) / report.terrainTriangles : 0.0,
+        report.terrainSamples ? static_cast<double>(report.terrainFieldBytes) / report.terrainSamples : 0.0,
+        static_cast<unsigned long long>(report.terrainTris.metrics.nodesPopped),
+        static_cast<unsigned long long>(report.terrainField.metrics.nodesPopped),
+        static_cast<unsigned long long>(report.terrainTris.metrics.narrowphaseCalls),
+        static_cast<unsigned long long>(report.terrainField.metrics.narrowphaseCalls),
+        report.terrainTris.NsPerQuery(),
+        report.terrainField.NsPerQuery(),
+        report.terrainField.mismatches);
+
+    AppendReportLine(out, outSize, used,
+        "cooked mesh: vertices %u -> %u welded, edges active=%u inactive=%u; skim sweeps=%u seam hits %u -> %u, other sweeps changed=%u\n",
+        report.cookInputVertices,
+        report.cookVertices,
+        report.cookActiveEdges,
+        report.cookInactiveEdges,
+        report.cookSkimSweeps,
+        report.cookRawGhostHits,
+        report.cookGhostHits,
+        report.cookSweepMismatches);
+
+    AppendReportLine(out, outSize, used,
+        "triangle store (terrain sweeps+overlaps, BinaryBVH): %u tris, +%llu bytes (%.0f/tri)\n"
+        "  narrowphaseCalls=%llu -> %llu ns/query=%.1f -> %.1f mismatches=%u\n",
+        report.precompTriangles,
+        static_cast<unsigned long long>(report.precompBytes),
+        report.precompTriangles ? static_cast<double>(report.precompBytes) / report.precompTriangles : 0.0,
+        static_cast<unsigned long long>(report.precompPlain.metrics.narrowphaseCalls),
+        static_cast<unsigned long long>(report.precompStore.metrics.narrowphaseCalls),
+        report.precompPlain.NsPerQuery(),
+        report.precompStore.NsPerQuery(),
+        report.precompStore.mismatches);
+
+    const uint64_t primCalls = report.leafPrimOrder.metrics.narrowphaseCalls;
+    const uint64_t entryCalls = report.leafEntryOrder.metrics.narrowphaseCalls;
+    AppendReportLine(out, outSize, used,
+        "leaf order (ramps+terrain sweeps, BinaryBVH): primIdx -> entry time, deferred=%llu\n"
+        "  narrowphaseCalls=%llu -> %llu (-%.1f%%) nodesPopped=%llu -> %llu ns/query=%.1f -> %.1f mismatches=%u\n",
+        static_cast<unsigned long long>(report.leafEntryOrder.metrics.deferredCandidates),
+        static_cast<unsigned long long>(primCalls),
+        static_cast<unsigned long long>(entryCalls),
+        primCalls ? 100.0 * static_cast<double>(primCalls - entryCalls) / static_cast<double>(primCalls) : 0.0,
+        static_cast<unsigned long long>(report.leafPrimOrder.metrics.nodesPopped),
+        static_cast<unsigned long long>(report.leafEntryOrder.metrics.nodesPopped),
+        report.leafPrimOrder.NsPerQuery(),
+        report.leafEntryOrder.NsPerQuery(),
+        report.leafEntryOrder.mismatches);
+
+    const uint64_t medianNodes = report.rampMedian.metrics.nodesPopped;
+    const uint64_t spatialNodes = report.rampSpatial.metrics.nodesPopped;
+    AppendReportLine(out, outSize, used,
+        "ramps (BinaryBVH sweeps+overlaps): median build -> spatial splits, refs=%u -> %u\n"
+        "  nodesPopped=%llu -> %llu (-%.1f%%) nodeAabbTests=%llu -> %llu narrowphaseCalls=%llu -> %llu ns/query=%.1f -> %.1f mismatches=%u/%u\n",
+        report.rampPrims,
+        report.rampSpatialRefs,
+        static_cast<unsigned long long>(medianNodes),
+        static_cast<unsigned long long>(spatialNodes),
+        medianNodes ? 100.0 * static_cast<double>(medianNodes - spatialNodes) / static_cast<double>(medianNodes) : 0.0,
+        static_cast<unsigned long long>(report.rampMedian.metrics.nodeAabbTests),
+        static_cast<unsigned long long>(report.rampSpatial.metrics.nodeAabbTests),
+        static_cast<unsigned long long>(report.rampMedian.metrics.narrowphaseCalls),
+        static_cast<unsigned long long>(report.rampSpatial.metrics.narrowphaseCalls),
+        report.rampMedian.NsPerQuery(),
+        report.rampSpatial.NsPerQuery(),
+        report.rampMedian.mismatches,
+        report.rampSpatial.mismatches);
 }
 
 }}} // namespace Engine::Collision::sq
@@ -20,7 +20,9 @@ enum class SceneQueryBackendId : uint8_t {
     LinearFallback = 0,
     BinaryBVH = 1,
     ScalarBVH4 = 2,
-    SimdBVH4 = 3
+    SimdBVH4 = 3,
+    ShortStackBVH = 4,
+    UniformGrid = 5
 };
 
 struct SceneQueryBackendBenchmarkConfig {
@@ -47,6 +49,34 @@ struct SceneQueryBackendBenchmarkReport {
     SceneQueryBackendBenchmarkRow binary{};
     SceneQueryBackendBenchmarkRow bvh4{};
     SceneQueryBackendBenchmarkRow bvh4Simd{};
+    SceneQueryBackendBenchmarkRow shortStack{};
+    SceneQueryBackendBenchmarkRow uniformGrid{};
+    SceneQueryBackendBenchmarkRow floorTris{};   // dense grid + 2 floor tris in the BVH
+    SceneQueryBackendBenchmarkRow floorPlane{};  // same grid, floor as a bounded plane
+    SceneQueryBackendBenchmarkRow terrainTris{};  // heightfield triangles in a BVH
+    SceneQueryBackendBenchmarkRow terrainField{}; // same terrain as a heightfield
+    uint32_t terrainSamples = 0;
+    uint32_t terrainTriangles = 0;
+    uint64_t terrainFieldBytes = 0;
+    uint64_t terrainTriBytes = 0;
+    uint32_t cookInputVertices = 0;     // cooked-mesh fixture: soup vertices
+    uint32_t cookVertices = 0;          // after welding
+    uint32_t cookActiveEdges = 0;
+    uint32_t cookInactiveEdges = 0;
+    uint32_t cookSkimSweeps = 0;
+    uint32_t cookRawGhostHits = 0;      // skim sweeps stopped by a seam, all edges active
+    uint32_t cookGhostHits = 0;         // same sweeps with cooked edge flags
+    uint32_t cookSweepMismatches = 0;
+    SceneQueryBackendBenchmarkRow precompPlain{};  // terrain tris, kernels recompute
+    SceneQueryBackendBenchmarkRow precompStore{};  // same tree with TrianglePrecomp
+    uint32_t precompTriangles = 0;
+    uint64_t precompBytes = 0;                     // TrianglePrecomp store size
+    SceneQueryBackendBenchmarkRow leafPrimOrder{};  // ramps + terrain, leaf prims in primIdx order
+    SceneQueryBackendBenchmarkRow leafEntryOrder{}; // same sweeps, orderLeafCandidates
+    SceneQueryBackendBenchmarkRow rampMedian{};  // grid + long ramp tris, median build
+    SceneQueryBackendBenchmarkRow rampSpatial{}; // same world, spatial-split build
+    uint32_t rampPrims = 0;
+    uint32_t rampSpatialRefs = 0;                // primIdx entries of the split tree
     bool correctnessPassed = true;
     bool overlapTopologyRiskObserved = false;
 };
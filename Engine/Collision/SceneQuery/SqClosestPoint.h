@@ -0,0 +1,634 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/16-closest-point-query.md
+// SSOT: docs/audits/scenequery/17-k-nearest-query.md
+//
+// TERMINOLOGY:
+//   ClosestPointResult - nearest solid to a capsule (or a point: segA == segB,
+//                        radius 0): signed gap, witness points, prim, feature
+//   lower bound        - squared gap between the segment's AABB and a node or
+//                        prim AABB; never more than the distance to anything
+//                        inside
+//
+// POLICY:
+//   - Best-first branch-and-bound. QueryScratch.stack is a binary min-heap
+//     keyed by the node lower bound (NodeTask.tEnter holds the squared
+//     distance). The first popped node that cannot beat the best ends the
+//     query, since every node left in the heap is at least as far.
+//   - Winner order is (distSq, type, index), so the answer does not depend on
+//     traversal order and matches the linear scan.
+//   - Bound prunes keep a relative slack of kClosestPointPruneSlack so float
+//     rounding between the AABB and primitive kernels cannot drop a tie.
+//   - Heap overflow falls back to the linear scan, like sweeps and overlaps.
+//   - k-nearest keeps its bounded max-heap in the caller's output array; a
+//     node is pruned once k hits are kept and it cannot beat the worst one.
+//
+// CONTRACT:
+//   - Standalone: includes SqBVH4.h (which pulls in SqQuery.h) and SqDistance.h.
+//   - distance = |segment - primitive| - radius. It is negative on overlap and
+//     equals -radius when the core segment touches the primitive.
+//   - normal and featureId follow the overlap kernel convention
+//     (primitive -> query); they come from OverlapCapsulePrim at the winner.
+//   - Primitives whose gap exceeds maxDistance are not reported.
+//   - KNearestPoint_* return at most k hits sorted by (distance, type, index).
+//     The PrimFilter runs per primitive before the distance kernel.
+//   - queryMask prunes whole subtrees whose mask union misses it; the mask
+//     test runs before any bound is computed.
+//
+// PROOF POINTS:
+//   - Harness: BinaryBVH and BVH4 match ClosestPointCapsule_LinearFallback on
+//     a mixed AABB/OBB/triangle world, with and without maxDistance.
+// =========================================================================
+
+#include "SqBVH4.h"
+#include "SqDistance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Engine { namespace Collision { namespace sq {
+
+struct KNearestHit {
+    float    distance = 0.0f;     // point to primitive; 0 inside
+    Vec3     point{};             // closest point on the primitive
+    PrimType type = PrimType::Aabb;
+    uint32_t index = 0;
+};
+
+struct ClosestPointResult {
+    bool     hit = false;
+    float    distance = 0.0f;     // segment distance minus radius (signed gap)
+    Vec3     pointOnSegment{};    // witness on the capsule core segment
+    Vec3     pointOnPrim{};       // witness on the primitive surface/interior
+    Vec3     normal{0, 1, 0};     // primitive -> query
+    PrimType type = PrimType::Aabb;
+    uint32_t index = 0;
+    uint32_t featureId = 0;
+};
+
+inline constexpr float kClosestPointPruneSlack = 1e-4f;
+
+namespace detail {
+
+struct ClosestPointBest {
+    bool     hit = false;
+    float    distSq = 0.0f;
+    float    boundSq = 0.0f;      // prune bound: best distSq, or the reach limit
+    PrimType type = PrimType::Aabb;
+    uint32_t index = 0;
+    Vec3     qSeg{};
+    Vec3     qPrim{};
+};
+
+// Squared gap between the segment's AABB and a box. Looser than
+// DistSegmentAABBSq but a few compares; used for node and prim culling.
+inline float ClosestPointBoundSq(const AABB& segBox, const AABB& box)
+{
+    const float dx = (std::max)((std::max)(box.minX - segBox.maxX, segBox.minX - box.maxX), 0.0f);
+    const float dy = (std::max)((std::max)(box.minY - segBox.maxY, segBox.minY - box.maxY), 0.0f);
+    const float dz = (std::max)((std::max)(box.minZ - segBox.maxZ, segBox.minZ - box.maxZ), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+inline bool ClosestPointCanBeat(float lowerBoundSq, float boundSq)
+{
+    return lowerBoundSq <= boundSq * (1.0f + kClosestPointPruneSlack) + 1e-8f;
+}
+
+inline bool ClosestPointCanBeat(float lowerBoundSq, const ClosestPointBest& best)
+{
+    return ClosestPointCanBeat(lowerBoundSq, best.boundSq);
+}
+
+inline bool ClosestPointBetter(float distSq, PrimType type, uint32_t index,
+                               const ClosestPointBest& best)
+{
+    if (!best.hit) return true;
+    if (distSq != best.distSq) return distSq < best.distSq;
+    if (type != best.type) return static_cast<uint8_t>(type) < static_cast<uint8_t>(best.type);
+    return index < best.index;
+}
+
+// Squared segment-to-primitive distance with witness points.
+inline float ClosestPointPrimSq(const StaticBVH& bvh,
+                                const Vec3& segA, const Vec3& segB,
+                                const PrimRef& pref,
+                                Vec3& qSeg, Vec3& qPrim)
+{
+    switch (pref.type) {
+        case PrimType::Aabb:
+            return DistSegmentAABBSq(segA, segB, bvh.aabbs[pref.index], &qSeg, &qPrim);
+        case PrimType::Obb: {
+            // Same local-AABB reduction as OverlapCapsuleObb.
+            const OBB& obb = bvh.obbs[pref.index];
+            const Vec3 dA = segA - obb.center;
+            const Vec3 dB = segB - obb.center;
+            const Vec3 localA = { Dot(dA, obb.axisX), Dot(dA, obb.axisY), Dot(dA, obb.axisZ) };
+            const Vec3 localB = { Dot(dB, obb.axisX), Dot(dB, obb.axisY), Dot(dB, obb.axisZ) };
+            const AABB localBox = { -obb.half.x, -obb.half.y, -obb.half.z,
+                                     obb.half.x,  obb.half.y,  obb.half.z };
+            Vec3 ls, lp;
+            const float d2 = DistSegmentAABBSq(localA, localB, localBox, &ls, &lp);
+            qSeg = obb.center + obb.axisX * ls.x + obb.axisY * ls.y + obb.axisZ * ls.z;
+            qPrim = obb.center + obb.axisX * lp.x + obb.axisY * lp.y + obb.axisZ * lp.z;
+            return d2;
+        }
+        case PrimType::Tri:
+            return DistSegmentTriangleSq(segA, segB, bvh.tris[pref.index], &qSeg, &qPrim, nullptr,
+                                         bvh.triPrecomp ? &bvh.triPrecomp[pref.index] : nullptr);
+        default:
+            return std::numeric_limits<float>::max();
+    }
+}
+
+inline void ConsiderClosestPointPrim(const StaticBVH& bvh,
+                                     const Vec3& segA, const Vec3& segB,
+                                     const AABB& segBox,
+                                     const PrimRef& pref,
+                                     ClosestPointBest& best,
+                                     float limitSq,
+                                     QueryMetrics* metrics,
+                                     uint32_t queryMask)
+{
+    if (!PassQueryMask(pref.mask, queryMask, metrics))
+        return;
+    if (metrics)
+        ++metrics->primitiveAabbTests;
+    if (!ClosestPointCanBeat(ClosestPointBoundSq(segBox, pref.bounds), best)) {
+        if (metrics)
+            ++metrics->primitiveAabbRejects;
+        return;
+    }
+
+    Vec3 qSeg, qPrim;
+    if (metrics)
+        ++metrics->narrowphaseCalls;
+    const float d2 = ClosestPointPrimSq(bvh, segA, segB, pref, qSeg, qPrim);
+    if (d2 > limitSq || !ClosestPointBetter(d2, pref.type, pref.index, best))
+        return;
+
+    if (metrics)
+        ++metrics->bestHitUpdates;
+    best.hit = true;
+    best.distSq = d2;
+    best.boundSq = d2;
+    best.type = pref.type;
+    best.index = pref.index;
+    best.qSeg = qSeg;
+    best.qPrim = qPrim;
+}
+
+inline ClosestPointBest MakeClosestPointBest(float radius, float maxDistance, float& limitSq)
+{
+    const float reach = radius + maxDistance;
+    limitSq = (reach >= 0.0f) ? reach * reach : -1.0f;
+    ClosestPointBest best{};
+    best.boundSq = limitSq;
+    return best;
+}
+
+inline ClosestPointResult FinishClosestPoint(const StaticBVH& bvh,
+                                             const Vec3& segA, const Vec3& segB,
+                                             float radius,
+                                             const ClosestPointBest& best,
+                                             QueryMetrics* metrics)
+{
+    ClosestPointResult out{};
+    if (metrics)
+        metrics->resultHit = best.hit;
+    if (!best.hit)
+        return out;
+
+    const float dist = std::sqrt(best.distSq);
+    out.hit = true;
+    out.distance = dist - radius;
+    out.pointOnSegment = best.qSeg;
+    out.pointOnPrim = best.qPrim;
+    out.type = best.type;
+    out.index = best.index;
+
+    // A capsule just past the witness distance overlaps the winner, so the
+    // overlap kernel yields its normal and feature (inside case included).
+    PrimRef pref{};
+    pref.type = best.type;
+    pref.index = best.index;
+    OverlapContact contact{};
+    if (OverlapCapsulePrim(bvh, segA, segB, dist + 1e-3f, pref, contact)) {
+        out.normal = contact.normal;
+        out.featureId = contact.featureId;
+    } else {
+        out.normal = NormalizeSafe(best.qSeg - best.qPrim, {0, 1, 0});
+    }
+    return out;
+}
+
+// Min-heap on (lower bound, node) so equal bounds pop in a fixed order.
+inline bool ClosestPointTaskAfter(const NodeTask& a, const NodeTask& b)
+{
+    if (a.tEnter != b.tEnter) return a.tEnter > b.tEnter;
+    return a.node > b.node;
+}
+
+inline void PushClosestPointTask(QueryScratch& scratch, uint32_t node, float lowerBoundSq)
+{
+    if (PushQueryTask(scratch, { node, lowerBoundSq, 0.0f }))
+        std::push_heap(scratch.stack.data(), scratch.stack.data() + scratch.sp,
+                       ClosestPointTaskAfter);
+}
+
+inline NodeTask PopClosestPointTask(QueryScratch& scratch)
+{
+    std::pop_heap(scratch.stack.data(), scratch.stack.data() + scratch.sp,
+                  ClosestPointTaskAfter);
+    ++scratch.metrics.nodesPopped;
+    return scratch.stack[--scratch.sp];
+}
+
+} // namespace detail
+
+inline ClosestPointResult ClosestPointCapsule_LinearFallback(
+    const StaticBVH& bvh,
+    const Vec3& segA, const Vec3& segB, float radius,
+    float maxDistance = std::numeric_limits<float>::max(),
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    if (metrics)
+        metrics->fallbackUsed = true;
+
+    float limitSq = 0.0f;
+    detail::ClosestPointBest best = detail::MakeClosestPointBest(radius, maxDistance, limitSq);
+    const AABB segBox = CapsuleAabbStatic(segA, segB, 0.0f);
+    if (!IsEmptyBVH(bvh) && limitSq >= 0.0f) {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(bvh.prims.size()); ++i)
+            detail::ConsiderClosestPointPrim(bvh, segA, segB, segBox, bvh.prims[i], best, limitSq, metrics,
+                                             queryMask);
+    }
+    return detail::FinishClosestPoint(bvh, segA, segB, radius, best, metrics);
+}
+
+inline ClosestPointResult ClosestPointCapsule_Fast(
+    const StaticBVH& bvh,
+    const Vec3& segA, const Vec3& segB, float radius,
+    float maxDistance,
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    ResetQueryScratch(scratch, QueryKind::ClosestPoint, QueryBackend::BinaryBVH);
+    float limitSq = 0.0f;
+    detail::ClosestPointBest best = detail::MakeClosestPointBest(radius, maxDistance, limitSq);
+    const AABB segBox = CapsuleAabbStatic(segA, segB, 0.0f);
+    if (IsEmptyBVH(bvh) || limitSq < 0.0f ||
+        !PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &scratch.metrics))
+        return detail::FinishClosestPoint(bvh, segA, segB, radius, best, &scratch.metrics);
+
+    ++scratch.metrics.nodeAabbTests;
+    const float rootBound = detail::ClosestPointBoundSq(segBox, bvh.nodes[bvh.root].bounds);
+    if (!detail::ClosestPointCanBeat(rootBound, best)) {
+        ++scratch.metrics.nodeAabbRejects;
+        return detail::FinishClosestPoint(bvh, segA, segB, radius, best, &scratch.metrics);
+    }
+    detail::PushClosestPointTask(scratch, bvh.root, rootBound);
+
+    while (scratch.sp) {
+        const NodeTask task = detail::PopClosestPointTask(scratch);
+        if (!detail::ClosestPointCanBeat(task.tEnter, best)) {
+            // Bound prunes reuse the sweep time-prune counter.
+            scratch.metrics.nodeTimePrunes += 1 + scratch.sp;
+            break;
+        }
+
+        const BVHNode& node = bvh.nodes[task.node];
+        if (node.primCount) {
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t k = 0; k < node.primCount; ++k) {
+                detail::ConsiderClosestPointPrim(
+                    bvh, segA, segB, segBox, bvh.prims[bvh.primIdx[node.primStart + k]],
+                    best, limitSq, &scratch.metrics, queryMask);
+            }
+            continue;
+        }
+
+        const uint32_t children[2] = { node.left, node.right };
+        for (uint32_t child : children) {
+            if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &scratch.metrics))
+                continue;
+            ++scratch.metrics.nodeAabbTests;
+            const float bound = detail::ClosestPointBoundSq(segBox, bvh.nodes[child].bounds);
+            if (!detail::ClosestPointCanBeat(bound, best)) {
+                ++scratch.metrics.nodeAabbRejects;
+                continue;
+            }
+            detail::PushClosestPointTask(scratch, child, bound);
+        }
+    }
+
+    if (scratch.overflowed)
+        return ClosestPointCapsule_LinearFallback(bvh, segA, segB, radius, maxDistance,
+                                                  &scratch.metrics, queryMask);
+    return detail::FinishClosestPoint(bvh, segA, segB, radius, best, &scratch.metrics);
+}
+
+// BVH4: internal slots enter the heap; leaf slots of a popped node are
+// scanned at once, nearest slot first.
+inline ClosestPointResult ClosestPointCapsule_BVH4(
+    const StaticBVH4& bvh,
+    const Vec3& segA, const Vec3& segB, float radius,
+    float maxDistance,
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    ResetQueryScratch(scratch, QueryKind::ClosestPoint, QueryBackend::BVH4);
+    const StaticBVH& view = bvh.sourceView;
+    float limitSq = 0.0f;
+    detail::ClosestPointBest best = detail::MakeClosestPointBest(radius, maxDistance, limitSq);
+    const AABB segBox = CapsuleAabbStatic(segA, segB, 0.0f);
+    if (IsEmptyBVH4(bvh) || limitSq < 0.0f)
+        return detail::FinishClosestPoint(view, segA, segB, radius, best, &scratch.metrics);
+
+    detail::PushClosestPointTask(scratch, bvh.root, 0.0f);
+
+    while (scratch.sp) {
+        const NodeTask task = detail::PopClosestPointTask(scratch);
+        if (!detail::ClosestPointCanBeat(task.tEnter, best)) {
+            scratch.metrics.nodeTimePrunes += 1 + scratch.sp;
+            break;
+        }
+
+        const BVH4Node& node = bvh.nodes[task.node];
+        uint32_t order[4];
+        float bounds[4];
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < node.childCount; ++i) {
+            const BVH4Slot& slot = node.slots[i];
+            if (!slot.active || !PassQueryMask(slot.mask, queryMask, &scratch.metrics))
+                continue;
+            ++scratch.metrics.nodeAabbTests;
+            const float bound = detail::ClosestPointBoundSq(segBox, slot.bounds);
+            if (!detail::ClosestPointCanBeat(bound, best)) {
+                ++scratch.metrics.nodeAabbRejects;
+                continue;
+            }
+            // Insertion by (bound, slot): at most four entries.
+            uint32_t pos = count++;
+            while (pos > 0 && bounds[pos - 1] > bound) {
+                bounds[pos] = bounds[pos - 1];
+                order[pos] = order[pos - 1];
+                --pos;
+            }
+            bounds[pos] = bound;
+            order[pos] = i;
+        }
+
+        for (uint32_t k = 0; k < count; ++k) {
+            const BVH4Slot& slot = node.slots[order[k]];
+            if (!slot.leaf) {
+                detail::PushClosestPointTask(scratch, slot.index, bounds[k]);
+                continue;
+            }
+            if (!detail::ClosestPointCanBeat(bounds[k], best)) {
+                ++scratch.metrics.nodeTimePrunes;
+                continue;
+            }
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t p = 0; p < slot.count; ++p) {
+                detail::ConsiderClosestPointPrim(
+                    view, segA, segB, segBox, view.prims[bvh.primIdx[slot.index + p]],
+                    best, limitSq, &scratch.metrics, queryMask);
+            }
+        }
+    }
+
+    if (scratch.overflowed)
+        return ClosestPointCapsule_LinearFallback(view, segA, segB, radius, maxDistance,
+                                                  &scratch.metrics, queryMask);
+    return detail::FinishClosestPoint(view, segA, segB, radius, best, &scratch.metrics);
+}
+
+// ---- k-nearest ------------------------------------------------------------
+// Caller's out[0..k) doubles as a bounded max-heap on (distance, type, index);
+// out[0] is the worst kept hit once it is full. Results are sorted ascending.
+
+struct KNearestAcceptAll {
+    bool operator()(const PrimRef&) const { return true; }
+};
+
+inline bool KNearestBefore(const KNearestHit& a, const KNearestHit& b)
+{
+    if (a.distance != b.distance) return a.distance < b.distance;
+    if (a.type != b.type) return static_cast<uint8_t>(a.type) < static_cast<uint8_t>(b.type);
+    return a.index < b.index;
+}
+
+inline bool InsertKNearestHit(KNearestHit* out, uint32_t k, uint32_t& count,
+                              const KNearestHit& hit)
+{
+    if (count < k) {
+        out[count++] = hit;
+        std::push_heap(out, out + count, KNearestBefore);
+        return true;
+    }
+    if (k == 0 || !KNearestBefore(hit, out[0]))
+        return false;
+    std::pop_heap(out, out + count, KNearestBefore);
+    out[count - 1] = hit;
+    std::push_heap(out, out + count, KNearestBefore);
+    return true;
+}
+
+namespace detail {
+
+inline float ClampAxis(float v, float lo, float hi)
+{
+    return (std::min)((std::max)(v, lo), hi);
+}
+
+inline float ClosestPointOnPrimSq(const StaticBVH& bvh, const Vec3& p,
+                                  const PrimRef& pref, Vec3& q)
+{
+    switch (pref.type) {
+        case PrimType::Aabb: {
+            const AABB& b = bvh.aabbs[pref.index];
+            q = { ClampAxis(p.x, b.minX, b.maxX),
+                  ClampAxis(p.y, b.minY, b.maxY),
+                  ClampAxis(p.z, b.minZ, b.maxZ) };
+            return LenSq(p - q);
+        }
+        case PrimType::Obb: {
+            const OBB& obb = bvh.obbs[pref.index];
+            const Vec3 d = p - obb.center;
+            const float lx = ClampAxis(Dot(d, obb.axisX), -obb.half.x, obb.half.x);
+            const float ly = ClampAxis(Dot(d, obb.axisY), -obb.half.y, obb.half.y);
+            const float lz = ClampAxis(Dot(d, obb.axisZ), -obb.half.z, obb.half.z);
+            q = obb.center + obb.axisX * lx + obb.axisY * ly + obb.axisZ * lz;
+            return LenSq(p - q);
+        }
+        case PrimType::Tri:
+            return DistPointTriangleSq(p, bvh.tris[pref.index], &q, nullptr,
+                                       bvh.triPrecomp ? &bvh.triPrecomp[pref.index] : nullptr);
+        default:
+            return std::numeric_limits<float>::max();
+    }
+}
+
+// Prune bound: the reach limit until k hits are kept, then the worst one.
+inline float KNearestBoundSq(const KNearestHit* out, uint32_t k, uint32_t count, float limitSq)
+{
+    return (count < k) ? limitSq : out[0].distance * out[0].distance;
+}
+
+template <typename PrimFilter>
+inline void ConsiderKNearestPrim(const StaticBVH& bvh, const Vec3& point,
+                                 const AABB& pointBox, const PrimRef& pref,
+                                 const PrimFilter& accept, float limitSq,
+                                 KNearestHit* out, uint32_t k, uint32_t& count,
+                                 QueryMetrics* metrics, uint32_t queryMask)
+{
+    if (!PassQueryMask(pref.mask, queryMask, metrics))
+        return;
+    if (metrics)
+        ++metrics->primitiveAabbTests;
+    if (!ClosestPointCanBeat(ClosestPointBoundSq(pointBox, pref.bounds),
+                             KNearestBoundSq(out, k, count, limitSq))) {
+        if (metrics)
+            ++metrics->primitiveAabbRejects;
+        return;
+    }
+    if (!accept(pref)) {
+        if (metrics)
+            ++metrics->filterRejects;
+        return;
+    }
+
+    KNearestHit hit{};
+    if (metrics)
+        ++metrics->narrowphaseCalls;
+    const float d2 = ClosestPointOnPrimSq(bvh, point, pref, hit.point);
+    if (d2 > limitSq)
+        return;
+    hit.distance = std::sqrt(d2);
+    hit.type = pref.type;
+    hit.index = pref.index;
+    if (InsertKNearestHit(out, k, count, hit) && metrics)
+        ++metrics->bestHitUpdates;
+}
+
+// Spatial-split repeat: the primitive is already in the result heap. One
+// evicted earlier cannot re-enter, as its key still loses to the heap top.
+inline bool KNearestHoldsPrim(const KNearestHit* out, uint32_t count, const PrimRef& pref)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        if (out[i].type == pref.type && out[i].index == pref.index)
+            return true;
+    }
+    return false;
+}
+
+inline uint32_t FinishKNearest(KNearestHit* out, uint32_t count, QueryMetrics* metrics)
+{
+    std::sort_heap(out, out + count, KNearestBefore);
+    if (metrics) {
+        metrics->resultHit = count > 0;
+        metrics->resultContactCount = count;
+    }
+    return count;
+}
+
+} // namespace detail
+
+template <typename PrimFilter = KNearestAcceptAll>
+inline uint32_t KNearestPoint_LinearFallback(
+    const StaticBVH& bvh, const Vec3& point, uint32_t k, float maxDistance,
+    KNearestHit* out, QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll,
+    const PrimFilter& accept = PrimFilter{})
+{
+    if (metrics)
+        metrics->fallbackUsed = true;
+    uint32_t count = 0;
+    if (k == 0 || maxDistance < 0.0f || IsEmptyBVH(bvh))
+        return detail::FinishKNearest(out, count, metrics);
+
+    const float limitSq = maxDistance * maxDistance;
+    const AABB pointBox = CapsuleAabbStatic(point, point, 0.0f);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(bvh.prims.size()); ++i) {
+        detail::ConsiderKNearestPrim(bvh, point, pointBox, bvh.prims[i], accept,
+                                     limitSq, out, k, count, metrics, queryMask);
+    }
+    return detail::FinishKNearest(out, count, metrics);
+}
+
+// Best-first: the node heap is QueryScratch.stack, the result heap is out.
+template <typename PrimFilter = KNearestAcceptAll>
+inline uint32_t KNearestPoint_Fast(
+    const StaticBVH& bvh, const Vec3& point, uint32_t k, float maxDistance,
+    KNearestHit* out, QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll,
+    const PrimFilter& accept = PrimFilter{})
+{
+    ResetQueryScratch(scratch, QueryKind::KNearest, QueryBackend::BinaryBVH);
+    uint32_t count = 0;
+    if (k == 0 || maxDistance < 0.0f || IsEmptyBVH(bvh))
+        return detail::FinishKNearest(out, count, &scratch.metrics);
+
+    const float limitSq = maxDistance * maxDistance;
+    const AABB pointBox = CapsuleAabbStatic(point, point, 0.0f);
+    ++scratch.metrics.nodeAabbTests;
+    if (!PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &scratch.metrics))
+        return detail::FinishKNearest(out, count, &scratch.metrics);
+    const float rootBound = detail::ClosestPointBoundSq(pointBox, bvh.nodes[bvh.root].bounds);
+    if (!detail::ClosestPointCanBeat(rootBound, limitSq)) {
+        ++scratch.metrics.nodeAabbRejects;
+        return detail::FinishKNearest(out, count, &scratch.metrics);
+    }
+    detail::PushClosestPointTask(scratch, bvh.root, rootBound);
+    const bool dupRefs = HasDuplicatePrimRefs(bvh);
+
+    while (scratch.sp) {
+        const NodeTask task = detail::PopClosestPointTask(scratch);
+        if (!detail::ClosestPointCanBeat(task.tEnter,
+                                         detail::KNearestBoundSq(out, k, count, limitSq))) {
+            scratch.metrics.nodeTimePrunes += 1 + scratch.sp;
+            break;
+        }
+
+        const BVHNode& node = bvh.nodes[task.node];
+        if (node.primCount) {
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t i = 0; i < node.primCount; ++i) {
+                const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + i]];
+                if (dupRefs && detail::KNearestHoldsPrim(out, count, pref)) {
+                    ++scratch.metrics.duplicateRefSkips;
+                    continue;
+                }
+                detail::ConsiderKNearestPrim(
+                    bvh, point, pointBox, pref,
+                    accept, limitSq, out, k, count, &scratch.metrics, queryMask);
+            }
+            continue;
+        }
+
+        const uint32_t children[2] = { node.left, node.right };
+        for (uint32_t child : children) {
+            if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &scratch.metrics))
+                continue;
+            ++scratch.metrics.nodeAabbTests;
+            const float bound = detail::ClosestPointBoundSq(pointBox, bvh.nodes[child].bounds);
+            if (!detail::ClosestPointCanBeat(bound,
+                                             detail::KNearestBoundSq(out, k, count, limitSq))) {
+                ++scratch.metrics.nodeAabbRejects;
+                continue;
+            }
+            detail::PushClosestPointTask(scratch, child, bound);
+        }
+    }
+
+    if (scratch.overflowed)
+        return KNearestPoint_LinearFallback(bvh, point, k, maxDistance, out,
+                                            &scratch.metrics, queryMask, accept);
+    return detail::FinishKNearest(out, count, &scratch.metrics);
+}
+
+}}} // namespace Engine::Collision::sq
@@ -33,13 +33,15 @@ namespace Engine { namespace Collision { namespace sq {
 
 // ---- Point to triangle distance squared (Ericson style) -----------------
 // Returns squared distance; optionally writes closest point on triangle.
+// pre (optional, TrianglePrecomp of t) supplies the edge vectors.
 inline float DistPointTriangleSq(const Vec3& p, const Triangle& t,
                                  Vec3* outQ = nullptr,
-                                 uint32_t* outFeatureId = nullptr)
+                                 uint32_t* outFeatureId = nullptr,
+                                 const TrianglePrecomp* pre = nullptr)
 {
     Vec3 a = t.p0, b = t.p1, c = t.p2;
-    Vec3 ab = b - a;
-    Vec3 ac = c - a;
+    Vec3 ab = pre ? pre->edge[0] : b - a;
+    Vec3 ac = pre ? pre->edge[2] * -1.0f : c - a;
     Vec3 ap = p - a;
 
     float d1 = Dot(ab, ap);
@@ -77,7 +79,7 @@ inline float DistPointTriangleSq(const Vec3& p, const Triangle& t,
     float va = d3*d6 - d5*d4;
     if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
         float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
-        Vec3 q = b + (c - b)*w;
+        Vec3 q = b + (pre ? pre->edge[1] : c - b)*w;
         if (outQ) *outQ = q;
         if (outFeatureId) *outFeatureId = 2;
         return LenSq(p - q);
@@ -154,14 +156,17 @@ inline float DistSegmentSegmentSq(const Vec3& p1, const Vec3& q1,
 // Checks segment-plane intersection first, then falls back to edge/endpoint tests.
 // Cyrus-Beck clipping produces a face candidate for segments parallel to (or hovering
 // over) the triangle face, ensuring featureId==0 when the closest point is on the face.
+// pre (optional, TrianglePrecomp of tri) supplies the unit normal, edges and
+// inward edge normals instead of recomputing them.
 inline float DistSegmentTriangleSq(const Vec3& s0, const Vec3& s1,
                                    const Triangle& tri,
                                    Vec3* outSegQ = nullptr,
                                    Vec3* outTriQ = nullptr,
-                                   uint32_t* outTriFeatureId = nullptr)
+                                   uint32_t* outTriFeatureId = nullptr,
+                                   const TrianglePrecomp* pre = nullptr)
 {
-    Vec3 n = Cross(tri.p1 - tri.p0, tri.p2 - tri.p0);
-    float n2 = LenSq(n);
+    Vec3 n = pre ? pre->normal : Cross(tri.p1 - tri.p0, tri.p2 - tri.p0);
+    float n2 = pre ? pre->normalLenSq : LenSq(n);
 
     // Segment-plane intersection inside triangle => distance 0
     if (n2 > kEpsSq) {
@@ -173,7 +178,7 @@ inline float DistSegmentTriangleSq(const Vec3& s0, const Vec3& s1,
                 float t = d0 / (d0 - d1);
                 if (t >= 0.0f && t <= 1.0f) {
                     Vec3 p = s0 + (s1 - s0)*t;
-                    if (PointInTri(p, tri, n)) {
+                    if (pre ? PointInTri(p, tri, *pre) : PointInTri(p, tri, n)) {
                         if (outSegQ) *outSegQ = p;
                         if (outTriQ) *outTriQ = p;
                         if (outTriFeatureId) *outTriFeatureId = 0;
@@ -195,7 +200,7 @@ inline float DistSegmentTriangleSq(const Vec3& s0, const Vec3& s1,
     float d2Face = (std::numeric_limits<float>::max)();
     Vec3  faceSeg{}, faceTri{};
     if (n2 > kEpsSq) {
-        Vec3  nU  = n * (1.0f / std::sqrt(n2));
+        Vec3  nU  = pre ? pre->normal : n * (1.0f / std::sqrt(n2));
         Vec3  d   = s1 - s0;
         float dn  = Dot(nU, d);
         float h0  = Dot(nU, s0 - tri.p0);
@@ -208,9 +213,14 @@ inline float DistSegmentTriangleSq(const Vec3& s0, const Vec3& s1,
         float tEnter = 0.0f, tExit = 1.0f;
         bool  valid  = true;
         for (int i = 0; i < 3; ++i) {
-            Vec3  mi  = Cross(nU, edges[i]);                         // outward or inward
-            float opp = Dot(mi, oppo[i] - orig[i]);                  // sign of opposite vtx
-            if (opp < 0.0f) mi = mi * (-1.0f);                       // orient inward
+            Vec3 mi;
+            if (pre) {
+                mi = pre->edgeNormal[i];                             // already inward
+            } else {
+                mi = Cross(nU, edges[i]);                            // outward or inward
+                float opp = Dot(mi, oppo[i] - orig[i]);              // sign of opposite vtx
+                if (opp < 0.0f) mi = mi * (-1.0f);                   // orient inward
+            }
             float dmi = Dot(mi, d);
             float hmi = Dot(mi, s0 - orig[i]);
             if (Abs(dmi) > kEpsSq) {
@@ -241,11 +251,11 @@ inline float DistSegmentTriangleSq(const Vec3& s0, const Vec3& s1,
     uint32_t bestFeat = 0;
     Vec3 q0, q1;
     uint32_t feat0, feat1;
-    float best = DistPointTriangleSq(s0, tri, &q0, &feat0);
+    float best = DistPointTriangleSq(s0, tri, &q0, &feat0, pre);
     Vec3 bestSeg = s0, bestTri = q0;
     bestFeat = feat0;
 
-    float d = DistPointTriangleSq(s1, tri, &q1, &feat1);
+    float d = DistPointTriangleSq(s1, tri, &q1, &feat1, pre);
     if (d < best - epsD2 || (d < best + epsD2 && feat1 < bestFeat))
     { best = d; bestSeg = s1; bestTri = q1; bestFeat = feat1; }
 
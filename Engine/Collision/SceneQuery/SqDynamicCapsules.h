@@ -0,0 +1,179 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/kcc/18-character-collision.md
+//
+// TERMINOLOGY:
+//   DynamicCapsule     - per-tick capsule snapshot (segment P-Q + radius)
+//   DynamicCapsuleHash - uniform 3D grid over capsule AABBs, stored as a
+//                        (cellKey, index) array sorted once per Build
+//
+// POLICY:
+//   - Rebuilt from scratch every tick; no incremental update, no BVH refit.
+//   - Build: O(n log n) sort over ~constant cells per capsule. Gather: binary
+//     search per touched cell. Both near-linear in capsule count.
+//   - Gather output is unique and ascending by capsule index, independent of
+//     cell iteration order. A capsule is offered only in the first cell of
+//     the query rectangle it occupies, so it is counted once even when the
+//     output is full.
+//
+// CONTRACT:
+//   - Standalone: includes SqBroadphase.h (CapsuleAabbStatic) and SqTypes.h.
+//   - Immutable between Build calls; concurrent Gather is safe.
+//   - Gather keeps the kept-count smallest indices when more overlap; the
+//     return value is the kept count, outTotal reports the full count.
+//
+// PROOF POINTS:
+//   - CctCrowd: state hash identical across worker counts with characters on.
+// =========================================================================
+
+#include "SqBroadphase.h"
+#include "SqTypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+struct DynamicCapsule {
+    Vec3  p{};          // bottom sphere center
+    Vec3  q{};          // top sphere center
+    float radius = 0.0f;
+};
+
+class DynamicCapsuleHash {
+public:
+    void Build(const DynamicCapsule* capsules, uint32_t count, float cellSize)
+    {
+        m_capsules.assign(capsules, capsules + count);
+        m_bounds.resize(count);
+        m_entries.clear();
+        m_cellSize = (cellSize > 0.0f) ? cellSize : 1.0f;
+        m_invCellSize = 1.0f / m_cellSize;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const AABB box = CapsuleAabbStatic(capsules[i].p, capsules[i].q, capsules[i].radius);
+            m_bounds[i] = box;
+            int32_t lo[3], hi[3];
+            CellRange(box, lo, hi);
+            for (int32_t z = lo[2]; z <= hi[2]; ++z)
+                for (int32_t y = lo[1]; y <= hi[1]; ++y)
+                    for (int32_t x = lo[0]; x <= hi[0]; ++x)
+                        m_entries.push_back({CellKey(x, y, z), i});
+        }
+
+        std::sort(m_entries.begin(), m_entries.end(),
+                  [](const Entry& a, const Entry& b) {
+                      return (a.key != b.key) ? a.key < b.key : a.index < b.index;
+                  });
+    }
+
+    void Clear()
+    {
+        m_capsules.clear();
+        m_bounds.clear();
+        m_entries.clear();
+    }
+
+    uint32_t Size() const { return static_cast<uint32_t>(m_capsules.size()); }
+    const DynamicCapsule& Get(uint32_t index) const { return m_capsules[index]; }
+
+    // Capsules whose AABB overlaps region, excluding excludeIndex.
+    uint32_t Gather(const AABB& region, uint32_t excludeIndex,
+                    uint32_t* out, uint32_t maxOut,
+                    uint32_t* outTotal = nullptr) const
+    {
+        uint32_t kept = 0;
+        uint32_t total = 0;
+        int32_t lo[3], hi[3];
+        CellRange(region, lo, hi);
+
+        for (int32_t z = lo[2]; z <= hi[2]; ++z) {
+            for (int32_t y = lo[1]; y <= hi[1]; ++y) {
+                for (int32_t x = lo[0]; x <= hi[0]; ++x) {
+                    const uint64_t key = CellKey(x, y, z);
+                    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                                               [](const Entry& e, uint64_t k) { return e.key < k; });
+                    for (; it != m_entries.end() && it->key == key; ++it) {
+                        const uint32_t idx = it->index;
+                        if (idx == excludeIndex || !AabbOverlap(m_bounds[idx], region))
+                            continue;
+                        // Count a capsule spanning several cells only in the
+                        // first cell of the rectangle it occupies.
+                        int32_t capLo[3], capHi[3];
+                        CellRange(m_bounds[idx], capLo, capHi);
+                        if (x != (std::max)(lo[0], capLo[0]) || y != (std::max)(lo[1], capLo[1]) ||
+                            z != (std::max)(lo[2], capLo[2]))
+                            continue;
+                        InsertSorted(idx, out, maxOut, kept, total);
+                    }
+                }
+            }
+        }
+
+        if (outTotal)
+            *outTotal = total;
+        return kept;
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    static constexpr int32_t kCellBias = 1 << 20;
+    static constexpr uint64_t kCellMask = (1ull << 21) - 1;
+
+    static uint64_t CellKey(int32_t x, int32_t y, int32_t z)
+    {
+        return ((static_cast<uint64_t>(x + kCellBias) & kCellMask) << 42) |
+               ((static_cast<uint64_t>(y + kCellBias) & kCellMask) << 21) |
+               (static_cast<uint64_t>(z + kCellBias) & kCellMask);
+    }
+
+    static bool AabbOverlap(const AABB& a, const AABB& b)
+    {
+        return a.minX <= b.maxX && a.maxX >= b.minX &&
+               a.minY <= b.maxY && a.maxY >= b.minY &&
+               a.minZ <= b.maxZ && a.maxZ >= b.minZ;
+    }
+
+    void CellRange(const AABB& box, int32_t lo[3], int32_t hi[3]) const
+    {
+        lo[0] = static_cast<int32_t>(std::floor(box.minX * m_invCellSize));
+        lo[1] = static_cast<int32_t>(std::floor(box.minY * m_invCellSize));
+        lo[2] = static_cast<int32_t>(std::floor(box.minZ * m_invCellSize));
+        hi[0] = static_cast<int32_t>(std::floor(box.maxX * m_invCellSize));
+        hi[1] = static_cast<int32_t>(std::floor(box.maxY * m_invCellSize));
+        hi[2] = static_cast<int32_t>(std::floor(box.maxZ * m_invCellSize));
+    }
+
+    // Keeps the maxOut smallest indices in ascending order. Gather offers
+    // each capsule once, so total is the full overlap count.
+    static void InsertSorted(uint32_t idx, uint32_t* out, uint32_t maxOut,
+                             uint32_t& kept, uint32_t& total)
+    {
+        uint32_t pos = 0;
+        while (pos < kept && out[pos] < idx)
+            ++pos;
+        ++total;
+        if (pos >= maxOut)
+            return;
+        const uint32_t last = (kept < maxOut) ? kept : maxOut - 1;
+        for (uint32_t i = last; i > pos; --i)
+            out[i] = out[i - 1];
+        out[pos] = idx;
+        if (kept < maxOut)
+            ++kept;
+    }
+
+    std::vector<DynamicCapsule> m_capsules;
+    std::vector<AABB> m_bounds;
+    std::vector<Entry> m_entries;
+    float m_cellSize = 1.0f;
+    float m_invCellSize = 1.0f;
+};
+
+}}} // namespace Engine::Collision::sq
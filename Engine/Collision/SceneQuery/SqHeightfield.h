@@ -0,0 +1,687 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/24-heightfield-collider.md
+//
+// TERMINOLOGY:
+//   HeightfieldPrim - terrain as a samplesX x samplesZ grid of uint16
+//                     heights. Sample (x, z) sits at origin + (x*cellSize,
+//                     heightScale*h, z*cellSize).
+//   cell            - the quad between four neighbouring samples. It holds
+//                     two triangles split along its (x, z)-(x+1, z+1)
+//                     diagonal, unless its hole bit is set.
+//   triangle id     - 2 * (cz * cellsX + cx) + k, k = 0 for the -x/+z half.
+//   mip pyramid     - per-block min/max heights. Level 0 blocks are
+//                     kHeightfieldMipBlock cells square; each level above
+//                     merges 2x2 blocks until one block is left. A block
+//                     whose cells are all holes stores min > max.
+//
+// POLICY:
+//   - Heightfields never enter a StaticBVH and never store triangles.
+//     Queries descend the pyramid over the query footprint, reject blocks
+//     by their min/max box, and build the triangles of the remaining cells
+//     on the stack.
+//   - Generated triangles go through the existing capsule-triangle kernels
+//     (SweepCapsuleTri_PhysXLike_TOI01, OverlapCapsuleTri) with the same
+//     window, time prune, filter and filter-cull rules as BVH triangles.
+//   - Inside one heightfield, hits tie-break by triangle id like separate
+//     Tri prims. The merged hit carries PrimType::Heightfield and the
+//     heightfield index; merge order follows SqPlane.h (BetterHit,
+//     InsertOverlapContactTopK + final OverlapContactBetter sort).
+//   - Overlap reports one contact per touching triangle, as a triangle mesh
+//     in the BVH would.
+//   - Closest point and k-nearest walk the cells under the query box grown
+//     by the reach (capped at the merged best), reject blocks and triangles
+//     by ClosestPointBoundSq and run DistSegmentTriangleSq /
+//     DistPointTriangleSq per triangle. They merge in (distance, type, index)
+//     order like planes; k-nearest reports one hit per heightfield.
+//
+// CONTRACT:
+//   - MakeHeightfield copies heights and holes and builds the pyramid.
+//     heightScale must be >= 0.
+//   - Hits and contacts carry PrimType::Heightfield and the index the caller
+//     passed. featureId is the triangle kernel's; the triangle id is not
+//     reported.
+//   - Memory: 2 bytes per sample, 1 bit per cell of holes, and 4 bytes per
+//     pyramid block (about 1/16 byte per cell).
+//
+// PROOF POINTS:
+//   - Harness: sweeps and overlaps match a linear scan over the same
+//     triangles as Tri prims, holes included, and the report compares
+//     memory and narrowphase work with that triangle mesh in a BVH.
+//   - Harness: ExpectHeightfieldClosestPoint matches closest point and
+//     k-nearest against the same linear scan, directly and through
+//     CollisionWorld.
+// =========================================================================
+
+#include "SqClosestPoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+inline constexpr uint32_t kHeightfieldMipBlock = 8;       // level-0 block side, in cells
+inline constexpr uint32_t kHeightfieldStackCapacity = 64;  // 3 per level + 1 is enough
+
+struct HeightfieldMipLevel {
+    uint32_t blocksX = 0;
+    uint32_t blocksZ = 0;
+    uint32_t blockCells = 0;         // cells per block side at this level
+    std::vector<uint16_t> minH;      // per block; minH > maxH: all holes
+    std::vector<uint16_t> maxH;
+};
+
+struct HeightfieldPrim {
+    Vec3     origin{};               // sample (0, 0) at height 0
+    uint32_t samplesX = 0;
+    uint32_t samplesZ = 0;
+    float    cellSize = 1.0f;
+    float    heightScale = 1.0f;     // world units per height step
+    std::vector<uint16_t> heights;   // samplesX * samplesZ, row z then x
+    std::vector<uint32_t> holeBits;  // one bit per cell, set = no triangles
+    std::vector<HeightfieldMipLevel> mips;  // [0] finest, back() one block
+    uint32_t mask = kPrimMaskAll;
+};
+
+inline uint32_t HeightfieldCellsX(const HeightfieldPrim& hf) { return hf.samplesX > 1 ? hf.samplesX - 1 : 0; }
+inline uint32_t HeightfieldCellsZ(const HeightfieldPrim& hf) { return hf.samplesZ > 1 ? hf.samplesZ - 1 : 0; }
+
+inline bool HeightfieldIsHole(const HeightfieldPrim& hf, uint32_t cx, uint32_t cz)
+{
+    const uint32_t cell = cz * HeightfieldCellsX(hf) + cx;
+    return (hf.holeBits[cell >> 5] >> (cell & 31u)) & 1u;
+}
+
+inline Vec3 HeightfieldVertex(const HeightfieldPrim& hf, uint32_t x, uint32_t z)
+{
+    return { hf.origin.x + static_cast<float>(x) * hf.cellSize,
+             hf.origin.y + hf.heightScale * static_cast<float>(hf.heights[z * hf.samplesX + x]),
+             hf.origin.z + static_cast<float>(z) * hf.cellSize };
+}
+
+// Both triangles of a cell, wound so the face normal points +y.
+inline void HeightfieldCellTriangles(const HeightfieldPrim& hf, uint32_t cx, uint32_t cz,
+                                     Triangle out[2])
+{
+    const Vec3 v00 = HeightfieldVertex(hf, cx, cz);
+    const Vec3 v10 = HeightfieldVertex(hf, cx + 1, cz);
+    const Vec3 v01 = HeightfieldVertex(hf, cx, cz + 1);
+    const Vec3 v11 = HeightfieldVertex(hf, cx + 1, cz + 1);
+    out[0] = { v00, v01, v11 };
+    out[1] = { v00, v11, v10 };
+}
+
+// holes: one byte per cell (nonzero = hole), or nullptr for none.
+inline HeightfieldPrim MakeHeightfield(const Vec3& origin, uint32_t samplesX, uint32_t samplesZ,
+                                       float cellSize, float heightScale,
+                                       const uint16_t* heights, const uint8_t* holes = nullptr)
+{
+    HeightfieldPrim hf{};
+    hf.origin = origin;
+    hf.samplesX = samplesX;
+    hf.samplesZ = samplesZ;
+    hf.cellSize = cellSize;
+    hf.heightScale = (std::max)(0.0f, heightScale);
+    hf.heights.assign(heights, heights + static_cast<size_t>(samplesX) * samplesZ);
+
+    const uint32_t cellsX = HeightfieldCellsX(hf);
+    const uint32_t cellsZ = HeightfieldCellsZ(hf);
+    hf.holeBits.assign((cellsX * cellsZ + 31u) / 32u, 0u);
+    if (holes) {
+        for (uint32_t c = 0; c < cellsX * cellsZ; ++c)
+            if (holes[c])
+                hf.holeBits[c >> 5] |= 1u << (c & 31u);
+    }
+    if (!cellsX || !cellsZ)
+        return hf;
+
+    // Level 0 from the cells' corner samples; holes contribute nothing.
+    HeightfieldMipLevel level{};
+    level.blockCells = kHeightfieldMipBlock;
+    level.blocksX = (cellsX + kHeightfieldMipBlock - 1) / kHeightfieldMipBlock;
+    level.blocksZ = (cellsZ + kHeightfieldMipBlock - 1) / kHeightfieldMipBlock;
+    level.minH.assign(level.blocksX * level.blocksZ, 0xFFFFu);
+    level.maxH.assign(level.blocksX * level.blocksZ, 0u);
+    for (uint32_t cz = 0; cz < cellsZ; ++cz) {
+        for (uint32_t cx = 0; cx < cellsX; ++cx) {
+            if (HeightfieldIsHole(hf, cx, cz))
+                continue;
+            const uint32_t b = (cz / kHeightfieldMipBlock) * level.blocksX + cx / kHeightfieldMipBlock;
+            for (uint32_t k = 0; k < 4; ++k) {
+                const uint16_t h = hf.heights[(cz + (k >> 1)) * samplesX + cx + (k & 1u)];
+                level.minH[b] = (std::min)(level.minH[b], h);
+                level.maxH[b] = (std::max)(level.maxH[b], h);
+            }
+        }
+    }
+    hf.mips.push_back(std::move(level));
+
+    while (hf.mips.back().blocksX > 1 || hf.mips.back().blocksZ > 1) {
+        const HeightfieldMipLevel& fine = hf.mips.back();
+        HeightfieldMipLevel coarse{};
+        coarse.blockCells = fine.blockCells * 2;
+        coarse.blocksX = (fine.blocksX + 1) / 2;
+        coarse.blocksZ = (fine.blocksZ + 1) / 2;
+        coarse.minH.assign(coarse.blocksX * coarse.blocksZ, 0xFFFFu);
+        coarse.maxH.assign(coarse.blocksX * coarse.blocksZ, 0u);
+        for (uint32_t bz = 0; bz < fine.blocksZ; ++bz) {
+            for (uint32_t bx = 0; bx < fine.blocksX; ++bx) {
+                const uint32_t f = bz * fine.blocksX + bx;
+                const uint32_t c = (bz / 2) * coarse.blocksX + bx / 2;
+                coarse.minH[c] = (std::min)(coarse.minH[c], fine.minH[f]);
+                coarse.maxH[c] = (std::max)(coarse.maxH[c], fine.maxH[f]);
+            }
+        }
+        hf.mips.push_back(std::move(coarse));
+    }
+    return hf;
+}
+
+// Bounds of every non-hole triangle (empty heightfields give an inverted box).
+inline AABB HeightfieldBounds(const HeightfieldPrim& hf)
+{
+    if (hf.mips.empty() || hf.mips.back().minH[0] > hf.mips.back().maxH[0])
+        return EmptyAABB();
+    return { hf.origin.x, hf.origin.y + hf.heightScale * static_cast<float>(hf.mips.back().minH[0]),
+             hf.origin.z,
+             hf.origin.x + static_cast<float>(HeightfieldCellsX(hf)) * hf.cellSize,
+             hf.origin.y + hf.heightScale * static_cast<float>(hf.mips.back().maxH[0]),
+             hf.origin.z + static_cast<float>(HeightfieldCellsZ(hf)) * hf.cellSize };
+}
+
+inline size_t HeightfieldMemoryBytes(const HeightfieldPrim& hf)
+{
+    size_t bytes = sizeof(HeightfieldPrim)
+        + hf.heights.size() * sizeof(uint16_t)
+        + hf.holeBits.size() * sizeof(uint32_t);
+    for (const HeightfieldMipLevel& level : hf.mips)
+        bytes += sizeof(HeightfieldMipLevel) + (level.minH.size() + level.maxH.size()) * sizeof(uint16_t);
+    return bytes;
+}
+
+namespace detail {
+
+struct HeightfieldCellRect {
+    uint32_t x0 = 0, z0 = 0, x1 = 0, z1 = 0;  // inclusive cell range
+};
+
+// Cells whose xz footprint touches b; false when b misses the heightfield.
+inline bool HeightfieldCellsUnder(const HeightfieldPrim& hf, const AABB& b,
+                                  HeightfieldCellRect& rect)
+{
+    const uint32_t cellsX = HeightfieldCellsX(hf);
+    const uint32_t cellsZ = HeightfieldCellsZ(hf);
+    if (hf.mips.empty() || hf.cellSize <= 0.0f)
+        return false;
+    const float inv = 1.0f / hf.cellSize;
+    // Closed cells: a box starting exactly on a sample line also touches
+    // the cell before it, hence ceil - 1 on the low side.
+    const float fx0 = std::ceil((b.minX - hf.origin.x) * inv) - 1.0f;
+    const float fx1 = std::floor((b.maxX - hf.origin.x) * inv);
+    const float fz0 = std::ceil((b.minZ - hf.origin.z) * inv) - 1.0f;
+    const float fz1 = std::floor((b.maxZ - hf.origin.z) * inv);
+    if (fx1 < 0.0f || fz1 < 0.0f || fx0 >= static_cast<float>(cellsX) ||
+        fz0 >= static_cast<float>(cellsZ))
+        return false;
+    rect.x0 = static_cast<uint32_t>((std::max)(0.0f, fx0));
+    rect.z0 = static_cast<uint32_t>((std::max)(0.0f, fz0));
+    rect.x1 = static_cast<uint32_t>((std::min)(fx1, static_cast<float>(cellsX - 1)));
+    rect.z1 = static_cast<uint32_t>((std::min)(fz1, static_cast<float>(cellsZ - 1)));
+    return true;
+}
+
+inline AABB HeightfieldBlockBounds(const HeightfieldPrim& hf, const HeightfieldMipLevel& level,
+                                   uint32_t bx, uint32_t bz)
+{
+    const uint32_t b = bz * level.blocksX + bx;
+    const float span = static_cast<float>(level.blockCells) * hf.cellSize;
+    const float x0 = hf.origin.x + static_cast<float>(bx) * span;
+    const float z0 = hf.origin.z + static_cast<float>(bz) * span;
+    return { x0, hf.origin.y + hf.heightScale * static_cast<float>(level.minH[b]), z0,
+             (std::min)(x0 + span, hf.origin.x + static_cast<float>(HeightfieldCellsX(hf)) * hf.cellSize),
+             hf.origin.y + hf.heightScale * static_cast<float>(level.maxH[b]),
+             (std::min)(z0 + span, hf.origin.z + static_cast<float>(HeightfieldCellsZ(hf)) * hf.cellSize) };
+}
+
+// Depth-first pyramid descent over rect. acceptBlock(bounds) gates a block;
+// visitCell(cx, cz) runs for each non-hole cell of accepted level-0 blocks.
+// Blocks and cells go in ascending (z, x) order, or descending on an axis
+// whose desc flag is set, so a sweep can walk from its start side first.
+template <typename AcceptBlock, typename VisitCell>
+inline void VisitHeightfieldCells(const HeightfieldPrim& hf, const HeightfieldCellRect& rect,
+                                  QueryMetrics* metrics,
+                                  AcceptBlock&& acceptBlock, VisitCell&& visitCell,
+                                  bool descX = false, bool descZ = false)
+{
+    struct BlockTask { uint32_t level, bx, bz; };
+    BlockTask stack[kHeightfieldStackCapacity];
+    uint32_t sp = 0;
+    stack[sp++] = { static_cast<uint32_t>(hf.mips.size() - 1), 0u, 0u };
+
+    while (sp) {
+        const BlockTask task = stack[--sp];
+        const HeightfieldMipLevel& level = hf.mips[task.level];
+        if (metrics)
+            ++metrics->nodesPopped;
+        const uint32_t b = task.bz * level.blocksX + task.bx;
+        if (level.minH[b] > level.maxH[b])
+            continue;
+        if (!acceptBlock(HeightfieldBlockBounds(hf, level, task.bx, task.bz)))
+            continue;
+
+        const uint32_t cx0 = (std::max)(rect.x0, task.bx * level.blockCells);
+        const uint32_t cz0 = (std::max)(rect.z0, task.bz * level.blockCells);
+        const uint32_t cx1 = (std::min)(rect.x1, (task.bx + 1) * level.blockCells - 1);
+        const uint32_t cz1 = (std::min)(rect.z1, (task.bz + 1) * level.blockCells - 1);
+        if (task.level == 0) {
+            if (metrics)
+                ++metrics->leafNodesVisited;
+            for (uint32_t iz = 0; iz <= cz1 - cz0; ++iz) {
+                const uint32_t cz = descZ ? cz1 - iz : cz0 + iz;
+                for (uint32_t ix = 0; ix <= cx1 - cx0; ++ix) {
+                    const uint32_t cx = descX ? cx1 - ix : cx0 + ix;
+                    if (!HeightfieldIsHole(hf, cx, cz))
+                        visitCell(cx, cz);
+                }
+            }
+            continue;
+        }
+
+        const uint32_t childCells = hf.mips[task.level - 1].blockCells;
+        const uint32_t bx0 = cx0 / childCells, bx1 = cx1 / childCells;
+        const uint32_t bz0 = cz0 / childCells, bz1 = cz1 / childCells;
+        // Pushed last-to-visit first so the stack pops in visit order.
+        for (uint32_t iz = 0; iz <= bz1 - bz0; ++iz) {
+            const uint32_t bz = descZ ? bz0 + iz : bz1 - iz;
+            for (uint32_t ix = 0; ix <= bx1 - bx0; ++ix) {
+                const uint32_t bx = descX ? bx0 + ix : bx1 - ix;
+                stack[sp++] = { task.level - 1, bx, bz };
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+// ---- Merge into BVH results ----------------------------------------------
+
+// Merges heightfield hits into best (heightfield j keeps index j).
+inline void SweepCapsuleClosestHit_Heightfields(
+    const HeightfieldPrim* heightfields, uint32_t heightfieldCount,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    Hit& best,
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    if (LenSq(in.delta) <= kEpsSq) {
+        if (metrics)
+            FinishSweepQueryMetrics(*metrics, best);
+        return;
+    }
+
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const AABB swept = UnionAABB(cap0, CapsuleAabbAtT(in, 1.0f, cfg.skin));
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
+    const SweepFilter* narrowFilter = filter.active ? &filter : nullptr;
+
+    for (uint32_t j = 0; j < heightfieldCount; ++j) {
+        const HeightfieldPrim& hf = heightfields[j];
+        if (!PassQueryMask(hf.mask, queryMask, metrics))
+            continue;
+        detail::HeightfieldCellRect rect{};
+        if (!detail::HeightfieldCellsUnder(hf, swept, rect))
+            continue;
+
+        // Local best in triangle-id space, bounded by the merged best.t.
+        Hit local{};
+        local.t = best.t;
+        auto acceptBlock = [&](const AABB& bounds) {
+            float tEnter = 0.0f;
+            float tExit = local.t;
+            if (metrics)
+                ++metrics->nodeAabbTests;
+            if (!AabbAabb_SweepInterval(cap0, in.delta, bounds, tEnter, tExit)) {
+                if (metrics)
+                    ++metrics->nodeAabbRejects;
+                return false;
+            }
+            if (tEnter >= local.t) {
+                if (metrics)
+                    ++metrics->nodeTimePrunes;
+                return false;
+            }
+            if (SweepFilterCulls(cull, bounds, tEnter, tExit)) {
+                if (metrics)
+                    ++metrics->filterCulls;
+                return false;
+            }
+            return true;
+        };
+        auto visitCell = [&](uint32_t cx, uint32_t cz) {
+            Triangle tris[2];
+            HeightfieldCellTriangles(hf, cx, cz, tris);
+            for (uint32_t k = 0; k < 2; ++k) {
+                const AABB triBounds = TriAABB(tris[k]);
+                float tEnter = 0.0f;
+                float tExit = local.t;
+                if (metrics)
+                    ++metrics->primitiveAabbTests;
+                if (!AabbAabb_SweepInterval(cap0, in.delta, triBounds, tEnter, tExit)) {
+                    if (metrics)
+                        ++metrics->primitiveAabbRejects;
+                    continue;
+                }
+                if (tEnter >= local.t) {
+                    if (metrics)
+                        ++metrics->primitiveTimePrunes;
+                    continue;
+                }
+                if (SweepFilterCulls(cull, triBounds, tEnter, tExit)) {
+                    if (metrics)
+                        ++metrics->filterCulls;
+                    continue;
+                }
+
+                float t; Vec3 n; uint32_t f;
+                bool startPenetrating = false;
+                float penetrationDepth = 0.0f;
+                if (metrics)
+                    ++metrics->narrowphaseCalls;
+                if (!SweepCapsuleTri_PhysXLike_TOI01(in, tris[k], cfg, t, n, f,
+                                                     startPenetrating, penetrationDepth,
+                                                     rejectInitialOverlap, narrowFilter))
+                    continue;
+                if (metrics)
+                    ++metrics->rawHits;
+                // Same post-narrowphase checks as ConsiderSweepCapsulePrimNarrow.
+                if (filter.active) {
+                    const bool applyFilter = !startPenetrating || filter.filterInitialOverlap;
+                    if (applyFilter && Dot(n, filter.refDir) < filter.minDot) {
+                        if (metrics)
+                            ++metrics->filterRejects;
+                        continue;
+                    }
+                }
+                if (t < tEnter || t > tExit) {
+                    if (metrics)
+                        ++metrics->primitiveTimePrunes;
+                    continue;
+                }
+                const uint32_t triId = 2u * (cz * HeightfieldCellsX(hf) + cx) + k;
+                if (!local.hit || BetterHit(t, PrimType::Tri, triId, f,
+                                            local.t, PrimType::Tri, local.index,
+                                            local.featureId, cfg.tieEpsT)) {
+                    local.hit = true;
+                    local.t = t;
+                    local.index = triId;
+                    local.normal = n;
+                    local.featureId = f;
+                    local.startPenetrating = startPenetrating;
+                    local.penetrationDepth = penetrationDepth;
+                }
+            }
+        };
+        // Start-side blocks first so local.t shrinks early and prunes the rest.
+        detail::VisitHeightfieldCells(hf, rect, metrics, acceptBlock, visitCell,
+                                      in.delta.x < 0.0f, in.delta.z < 0.0f);
+
+        if (!local.hit)
+            continue;
+        if (metrics)
+            ++metrics->acceptedHits;
+        if (!best.hit || BetterHit(local.t, PrimType::Heightfield, j, local.featureId,
+                                   best.t, best.type, best.index,
+                                   best.featureId, cfg.tieEpsT))
+        {
+            if (metrics)
+                ++metrics->bestHitUpdates;
+            best = local;
+            best.type = PrimType::Heightfield;
+            best.index = j;
+        }
+    }
+    if (metrics)
+        FinishSweepQueryMetrics(*metrics, best);
+}
+
+// Merges heightfield contacts into a sorted BVH contact list; returns the new count.
+inline uint32_t OverlapCapsuleContacts_Heightfields(
+    const HeightfieldPrim* heightfields, uint32_t heightfieldCount,
+    const Vec3& segA, const Vec3& segB, float radius,
+    OverlapContact* outContacts, uint32_t maxContacts,
+    uint32_t contactCount,
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
+    if (maxContacts == 0) return 0;
+
+    const AABB capBounds = CapsuleAabbStatic(segA, segB, radius);
+    bool merged = false;
+    for (uint32_t j = 0; j < heightfieldCount; ++j) {
+        const HeightfieldPrim& hf = heightfields[j];
+        if (!PassQueryMask(hf.mask, queryMask, metrics))
+            continue;
+        detail::HeightfieldCellRect rect{};
+        if (!detail::HeightfieldCellsUnder(hf, capBounds, rect))
+            continue;
+
+        auto acceptBlock = [&](const AABB& bounds) {
+            if (metrics)
+                ++metrics->nodeAabbTests;
+            if (TestAabbAabb(capBounds, bounds))
+                return true;
+            if (metrics)
+                ++metrics->nodeAabbRejects;
+            return false;
+        };
+        auto visitCell = [&](uint32_t cx, uint32_t cz) {
+            Triangle tris[2];
+            HeightfieldCellTriangles(hf, cx, cz, tris);
+            for (uint32_t k = 0; k < 2; ++k) {
+                if (metrics)
+                    ++metrics->primitiveAabbTests;
+                if (!TestAabbAabb(capBounds, TriAABB(tris[k]))) {
+                    if (metrics)
+                        ++metrics->primitiveAabbRejects;
+                    continue;
+                }
+                OverlapContact contact;
+                if (metrics)
+                    ++metrics->narrowphaseCalls;
+                if (!OverlapCapsuleTri(segA, segB, radius, tris[k], contact))
+                    continue;
+                if (metrics) {
+                    ++metrics->rawHits;
+                    ++metrics->acceptedHits;
+                }
+                contact.type = PrimType::Heightfield;
+                contact.index = j;
+                InsertOverlapContactTopK(outContacts, maxContacts, contactCount, contact, metrics);
+                merged = true;
+            }
+        };
+        detail::VisitHeightfieldCells(hf, rect, metrics, acceptBlock, visitCell);
+    }
+    if (merged)
+        std::sort(outContacts, outContacts + contactCount, OverlapContactBetter);
+    if (metrics)
+        FinishOverlapQueryMetrics(*metrics, contactCount);
+    return contactCount;
+}
+
+// Offers heightfield `index` to a closest-point result (ConsiderClosestPointPlane
+// order). Cells under the segment box grown by the reach are walked; blocks
+// and triangles whose box gap cannot beat the bound are skipped.
+inline void ConsiderClosestPointHeightfield(const HeightfieldPrim& hf, uint32_t index,
+                                            const Vec3& segA, const Vec3& segB,
+                                            float radius, float maxDistance,
+                                            ClosestPointResult& best,
+                                            QueryMetrics* metrics = nullptr,
+                                            uint32_t queryMask = kPrimMaskAll)
+{
+    if (!PassQueryMask(hf.mask, queryMask, metrics))
+        return;
+    float limitSq = 0.0f;
+    detail::ClosestPointBest local = detail::MakeClosestPointBest(radius, maxDistance, limitSq);
+    if (limitSq < 0.0f)
+        return;
+    // The merged best bounds the walk; the slack keeps cross-type ties.
+    if (best.hit)
+        local.boundSq = (std::min)(local.boundSq, (best.distance + radius) * (best.distance + radius));
+    const AABB segBox = CapsuleAabbStatic(segA, segB, 0.0f);
+    const float reach = std::sqrt(local.boundSq) * (1.0f + kClosestPointPruneSlack) + 1e-4f;
+    detail::HeightfieldCellRect rect{};
+    if (!detail::HeightfieldCellsUnder(hf, CapsuleAabbStatic(segA, segB, reach), rect))
+        return;
+
+    Triangle localTri{};
+    auto acceptBlock = [&](const AABB& bounds) {
+        if (metrics)
+            ++metrics->nodeAabbTests;
+        if (detail::ClosestPointCanBeat(detail::ClosestPointBoundSq(segBox, bounds), local))
+            return true;
+        if (metrics)
+            ++metrics->nodeAabbRejects;
+        return false;
+    };
+    auto visitCell = [&](uint32_t cx, uint32_t cz) {
+        Triangle tris[2];
+        HeightfieldCellTriangles(hf, cx, cz, tris);
+        for (uint32_t k = 0; k < 2; ++k) {
+            if (metrics)
+                ++metrics->primitiveAabbTests;
+            if (!detail::ClosestPointCanBeat(detail::ClosestPointBoundSq(segBox, TriAABB(tris[k])),
+                                             local)) {
+                if (metrics)
+                    ++metrics->primitiveAabbRejects;
+                continue;
+            }
+            Vec3 qSeg, qPrim;
+            if (metrics)
+                ++metrics->narrowphaseCalls;
+            const float d2 = DistSegmentTriangleSq(segA, segB, tris[k], &qSeg, &qPrim);
+            const uint32_t triId = 2u * (cz * HeightfieldCellsX(hf) + cx) + k;
+            // Blocks do not visit in triangle-id order, so ties compare ids.
+            if (d2 > limitSq || !detail::ClosestPointBetter(d2, PrimType::Tri, triId, local))
+                continue;
+            local.hit = true;
+            local.distSq = d2;
+            local.boundSq = d2;
+            local.type = PrimType::Tri;
+            local.index = triId;
+            local.qSeg = qSeg;
+            local.qPrim = qPrim;
+            localTri = tris[k];
+        }
+    };
+    detail::VisitHeightfieldCells(hf, rect, metrics, acceptBlock, visitCell);
+    if (!local.hit)
+        return;
+
+    const float dist = std::sqrt(local.distSq);
+    const float gap = dist - radius;
+    if (best.hit) {
+        if (gap != best.distance) {
+            if (gap > best.distance) return;
+        } else if (best.type != PrimType::Heightfield) {
+            if (static_cast<uint8_t>(best.type) < static_cast<uint8_t>(PrimType::Heightfield)) return;
+        } else if (best.index < index) {
+            return;
+        }
+    }
+    if (metrics) {
+        ++metrics->bestHitUpdates;
+        metrics->resultHit = true;
+    }
+    best.hit = true;
+    best.distance = gap;
+    best.pointOnSegment = local.qSeg;
+    best.pointOnPrim = local.qPrim;
+    best.type = PrimType::Heightfield;
+    best.index = index;
+    // Same normal rule as FinishClosestPoint, on the winning triangle.
+    OverlapContact contact{};
+    if (OverlapCapsuleTri(segA, segB, dist + 1e-3f, localTri, contact)) {
+        best.normal = contact.normal;
+        best.featureId = contact.featureId;
+    } else {
+        best.normal = NormalizeSafe(local.qSeg - local.qPrim, {0, 1, 0});
+        best.featureId = 0;
+    }
+}
+
+// Offers heightfield `index` to a k-nearest max-heap (InsertKNearestHit order)
+// as one hit at its nearest triangle (DistPointTriangleSq, as for BVH Tri prims).
+inline void ConsiderKNearestHeightfield(const HeightfieldPrim& hf, uint32_t index,
+                                        const Vec3& point, float maxDistance,
+                                        KNearestHit* out, uint32_t k, uint32_t& count,
+                                        QueryMetrics* metrics = nullptr,
+                                        uint32_t queryMask = kPrimMaskAll)
+{
+    if (k == 0 || maxDistance < 0.0f || !PassQueryMask(hf.mask, queryMask, metrics))
+        return;
+    const float limitSq = maxDistance * maxDistance;
+    // A heightfield that cannot beat the heap top is never inserted.
+    float boundSq = detail::KNearestBoundSq(out, k, count, limitSq);
+    const AABB pointBox = { point.x, point.y, point.z, point.x, point.y, point.z };
+    const float reach = std::sqrt(boundSq) * (1.0f + kClosestPointPruneSlack) + 1e-4f;
+    detail::HeightfieldCellRect rect{};
+    if (!detail::HeightfieldCellsUnder(hf, CapsuleAabbStatic(point, point, reach), rect))
+        return;
+
+    bool found = false;
+    float bestSq = 0.0f;
+    Vec3 bestPoint{};
+    auto acceptBlock = [&](const AABB& bounds) {
+        if (metrics)
+            ++metrics->nodeAabbTests;
+        if (detail::ClosestPointCanBeat(detail::ClosestPointBoundSq(pointBox, bounds), boundSq))
+            return true;
+        if (metrics)
+            ++metrics->nodeAabbRejects;
+        return false;
+    };
+    auto visitCell = [&](uint32_t cx, uint32_t cz) {
+        Triangle tris[2];
+        HeightfieldCellTriangles(hf, cx, cz, tris);
+        for (uint32_t t = 0; t < 2; ++t) {
+            if (metrics)
+                ++metrics->primitiveAabbTests;
+            if (!detail::ClosestPointCanBeat(detail::ClosestPointBoundSq(pointBox, TriAABB(tris[t])),
+                                             boundSq)) {
+                if (metrics)
+                    ++metrics->primitiveAabbRejects;
+                continue;
+            }
+            Vec3 q;
+            if (metrics)
+                ++metrics->narrowphaseCalls;
+            const float d2 = DistPointTriangleSq(point, tris[t], &q);
+            if (d2 > limitSq || (found && d2 >= bestSq))
+                continue;
+            found = true;
+            bestSq = d2;
+            boundSq = (std::min)(boundSq, d2);
+            bestPoint = q;
+        }
+    };
+    detail::VisitHeightfieldCells(hf, rect, metrics, acceptBlock, visitCell);
+    if (!found)
+        return;
+
+    KNearestHit hit{};
+    hit.distance = std::sqrt(bestSq);
+    hit.point = bestPoint;
+    hit.type = PrimType::Heightfield;
+    hit.index = index;
+    if (InsertKNearestHit(out, k, count, hit) && metrics)
+        ++metrics->bestHitUpdates;
+}
+
+}}} // namespace Engine::Collision::sq
@@ -0,0 +1,242 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/14-local-query-set.md
+//
+// TERMINOLOGY:
+//   LocalQuerySet - candidates whose bounds touch a caller-chosen region,
+//                   gathered once from the BVH into SoA bounds
+//   Region        - conservative bounds of every query the caller expects to
+//                   issue (e.g. one KCC tick)
+//   Contained     - query broadphase bounds lie inside the region
+//
+// POLICY:
+//   - One BVH traversal per gather; contained queries never touch the BVH.
+//   - Candidates are kept in ascending bvh.prims order, so a contained query
+//     visits exactly the primitives LinearFallback would accept, in the same
+//     order. Results are identical to the LinearFallback oracle.
+//   - Non-contained queries are the caller's problem: use the BVH path.
+//   - The set gathers every mask; queries skip candidates whose mask misses
+//     the query mask, so one gather serves every mask a tick uses.
+//
+// CONTRACT:
+//   - StaticBVH must outlive the set and stay immutable while it is used.
+//   - Gather inflates the region by kLocalSetGatherMargin so rounding in the
+//     sweep interval test cannot admit a primitive outside the set.
+//
+// PROOF POINTS:
+//   - Harness: contained sweeps/overlaps match LinearFallback on the dense grid.
+// =========================================================================
+
+#include "SqQuery.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+inline constexpr float kLocalSetGatherMargin = 1e-3f;
+
+struct LocalQuerySet {
+    AABB region{};
+    bool active = false;
+
+    // SoA candidate bounds, parallel to prim (indices into bvh.prims, ascending).
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+    std::vector<uint32_t> mask;
+    std::vector<uint32_t> prim;
+
+    uint32_t CandidateCount() const { return static_cast<uint32_t>(prim.size()); }
+};
+
+inline void ClearLocalQuerySet(LocalQuerySet& set)
+{
+    set.active = false;
+    set.minX.clear(); set.minY.clear(); set.minZ.clear();
+    set.maxX.clear(); set.maxY.clear(); set.maxZ.clear();
+    set.mask.clear();
+    set.prim.clear();
+}
+
+inline bool LocalQuerySetContains(const LocalQuerySet& set, const AABB& bounds)
+{
+    return set.active
+        && bounds.minX >= set.region.minX && bounds.maxX <= set.region.maxX
+        && bounds.minY >= set.region.minY && bounds.maxY <= set.region.maxY
+        && bounds.minZ >= set.region.minZ && bounds.maxZ <= set.region.maxZ;
+}
+
+// Broadphase bounds of a sweep over [0,1] (same skin as the BVH path).
+inline AABB SweptCapsuleBounds(const SweepCapsuleInput& in, const SweepConfig& cfg)
+{
+    return UnionAABB(CapsuleAabbAtT(in, 0.0f, cfg.skin),
+                     CapsuleAabbAtT(in, 1.0f, cfg.skin));
+}
+
+// ---- Gather ---------------------------------------------------------------
+
+inline void GatherLocalQuerySet(const StaticBVH& bvh, const AABB& region,
+                                LocalQuerySet& set, QueryScratch& scratch)
+{
+    ClearLocalQuerySet(set);
+    ResetQueryScratch(scratch, QueryKind::GatherLocalSet, QueryBackend::BinaryBVH);
+    set.region = region;
+    set.active = true;
+
+    if (IsEmptyBVH(bvh))
+        return;
+
+    const AABB gatherBounds = ExpandAabb(region, kLocalSetGatherMargin);
+
+    ++scratch.metrics.nodeAabbTests;
+    if (TestAabbAabb(gatherBounds, bvh.nodes[bvh.root].bounds))
+        PushQueryTask(scratch, { bvh.root, 0.0f, 0.0f });
+    else
+        ++scratch.metrics.nodeAabbRejects;
+
+    while (scratch.sp) {
+        const NodeTask task = scratch.stack[--scratch.sp];
+        ++scratch.metrics.nodesPopped;
+        const BVHNode& node = bvh.nodes[task.node];
+
+        if (node.primCount) {
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t k = 0; k < node.primCount; ++k) {
+                const uint32_t p = bvh.primIdx[node.primStart + k];
+                ++scratch.metrics.primitiveAabbTests;
+                if (TestAabbAabb(gatherBounds, bvh.prims[p].bounds))
+                    set.prim.push_back(p);
+                else
+                    ++scratch.metrics.primitiveAabbRejects;
+            }
+            continue;
+        }
+
+        PushStaticOverlapChildIfHit(bvh, gatherBounds, node.right, scratch);
+        PushStaticOverlapChildIfHit(bvh, gatherBounds, node.left, scratch);
+    }
+
+    if (scratch.overflowed) {
+        scratch.metrics.fallbackUsed = true;
+        set.prim.clear();
+        for (uint32_t p = 0; p < static_cast<uint32_t>(bvh.prims.size()); ++p) {
+            if (TestAabbAabb(gatherBounds, bvh.prims[p].bounds))
+                set.prim.push_back(p);
+        }
+    }
+
+    std::sort(set.prim.begin(), set.prim.end());
+    set.prim.erase(std::unique(set.prim.begin(), set.prim.end()), set.prim.end());  // spatial splits
+
+    const size_t n = set.prim.size();
+    set.minX.resize(n); set.minY.resize(n); set.minZ.resize(n);
+    set.maxX.resize(n); set.maxY.resize(n); set.maxZ.resize(n);
+    set.mask.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const AABB& b = bvh.prims[set.prim[i]].bounds;
+        set.minX[i] = b.minX; set.minY[i] = b.minY; set.minZ[i] = b.minZ;
+        set.maxX[i] = b.maxX; set.maxY[i] = b.maxY; set.maxZ[i] = b.maxZ;
+        set.mask[i] = bvh.prims[set.prim[i]].mask;
+    }
+    scratch.metrics.resultContactCount = static_cast<uint32_t>(n); // gathered candidates
+}
+
+// ---- Queries (caller guarantees containment) --------------------------------
+
+inline Hit SweepCapsuleClosestHit_LocalSet(
+    const StaticBVH& bvh,
+    const LocalQuerySet& set,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    QueryMetrics& metrics,
+    const SweepFilter& filter = SweepFilter{},
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    ResetQueryMetrics(metrics, QueryKind::SweepCapsuleClosest, QueryBackend::LocalSet);
+
+    Hit best{};
+    best.hit = false;
+    best.t = 1.0f;
+
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
+    const uint32_t n = set.CandidateCount();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!PassQueryMask(set.mask[i], queryMask, &metrics))
+            continue;
+        const AABB b{ set.minX[i], set.minY[i], set.minZ[i],
+                      set.maxX[i], set.maxY[i], set.maxZ[i] };
+        float tEnter = 0.0f;
+        float tExit = best.t;
+        ++metrics.primitiveAabbTests;
+        if (!AabbAabb_SweepInterval(cap0, in.delta, b, tEnter, tExit)) {
+            ++metrics.primitiveAabbRejects;
+            continue;
+        }
+        if (tEnter >= best.t) {
+            ++metrics.primitiveTimePrunes;
+            continue;
+        }
+        if (SweepFilterCulls(cull, b, tEnter, tExit)) {
+            ++metrics.filterCulls;
+            continue;
+        }
+        ConsiderSweepCapsulePrimNarrow(bvh, in, cfg, bvh.prims[set.prim[i]],
+                                       tEnter, tExit, filter,
+                                       rejectInitialOverlap, best, &metrics);
+    }
+
+    FinishSweepQueryMetrics(metrics, best);
+    return best;
+}
+
+inline uint32_t OverlapCapsuleContacts_LocalSet(
+    const StaticBVH& bvh,
+    const LocalQuerySet& set,
+    const Vec3& segA, const Vec3& segB, float radius,
+    OverlapContact* outContacts, uint32_t maxContacts,
+    QueryMetrics& metrics,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    ResetQueryMetrics(metrics, QueryKind::OverlapCapsuleContacts, QueryBackend::LocalSet);
+    if (maxContacts == 0) {
+        FinishOverlapQueryMetrics(metrics, 0);
+        return 0;
+    }
+    if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
+
+    const AABB capBounds = CapsuleAabbStatic(segA, segB, radius);
+    uint32_t contactCount = 0;
+    const uint32_t n = set.CandidateCount();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!PassQueryMask(set.mask[i], queryMask, &metrics))
+            continue;
+        ++metrics.primitiveAabbTests;
+        if (capBounds.maxX < set.minX[i] || capBounds.minX > set.maxX[i] ||
+            capBounds.maxY < set.minY[i] || capBounds.minY > set.maxY[i] ||
+            capBounds.maxZ < set.minZ[i] || capBounds.minZ > set.maxZ[i]) {
+            ++metrics.primitiveAabbRejects;
+            continue;
+        }
+
+        const PrimRef& pref = bvh.prims[set.prim[i]];
+        OverlapContact contact;
+        ++metrics.narrowphaseCalls;
+        if (!OverlapCapsulePrim(bvh, segA, segB, radius, pref, contact))
+            continue;
+
+        ++metrics.rawHits;
+        ++metrics.acceptedHits;
+        contact.type = pref.type;
+        contact.index = pref.index;
+        InsertOverlapContactTopK(outContacts, maxContacts, contactCount, contact, &metrics);
+    }
+
+    std::sort(outContacts, outContacts + contactCount, OverlapContactBetter);
+    FinishOverlapQueryMetrics(metrics, contactCount);
+    return contactCount;
+}
+
+}}} // namespace Engine::Collision::sq
@@ -0,0 +1,331 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/25-cooked-triangle-meshes.md
+//
+// TERMINOLOGY:
+//   cooking       - turning a triangle soup (raw buffers or OBJ text) into
+//                   welded, indexed triangles with edge adjacency and
+//                   active-edge flags, once, before the world is built.
+//   weld          - an input vertex within weldTolerance of an earlier
+//                   cooked vertex reuses it (the lowest id if several).
+//   adjacency     - per triangle edge k (vertex k -> (k+1)%3), the triangle
+//                   across it, or kNoMeshAdjacency on a boundary or an edge
+//                   shared by more than two triangles.
+//   active edge   - an edge whose cylinder and side quad the sweep kernel may
+//                   report (kTriEdge*Active, SqTypes.h).
+//
+// POLICY:
+//   - An edge is inactive when its two triangles are coplanar within
+//     flatEdgeCos, or when it is concave (the neighbour rises above this
+//     triangle's plane). Every contact on such an edge is also reached, at
+//     the same or an earlier t, through a neighbouring face.
+//   - Boundary, non-manifold and flipped-winding edges stay active.
+//   - Both triangles of a pair get the same decision, made once per pair.
+//   - Degenerate triangles (two welded corners equal, or zero area) are
+//     dropped; triSource maps each cooked triangle to its input triangle.
+//   - Deterministic: welding walks input order, adjacency sorts edges by
+//     (vertex pair, triangle, edge).
+//
+// CONTRACT:
+//   - Standalone: includes SqTypes.h + std headers. No file I/O; callers
+//     pass OBJ text or raw arrays.
+//   - CookTriangleMesh takes positions plus 3 indices per triangle, or
+//     indices == nullptr for a soup of 3 positions per triangle. It returns
+//     false on an out-of-range index.
+//   - ParseObjMesh reads "v" and "f" records (v, v/t, v//n, v/t/n, negative
+//     indices), fans polygons, ignores other records, and returns false on a
+//     malformed record.
+//
+// PROOF POINTS:
+//   - Harness: a welded floor of separate quads plus a step and a wall gets
+//     inactive flat and concave edges and active boundary and convex edges;
+//     skim sweeps across the floor seams lose their ghost edge hits and
+//     agree with the uncooked triangles on t and on every face hit.
+// =========================================================================
+
+#include "SqTypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+inline constexpr uint32_t kNoMeshAdjacency = 0xFFFFFFFFu;
+
+// Numerical guard: below this an exact weld still needs a finite cell size.
+inline constexpr float kMeshCookMinWeldCell = 1e-5f;
+
+struct MeshCookDesc {
+    float weldTolerance = 1e-4f;   // world units; 0 welds exact duplicates only
+    float flatEdgeCos   = 0.9995f; // normals this close count as coplanar (~1.8 deg)
+    float concaveEps    = 1e-5f;   // neighbour must rise this far to be concave
+};
+
+struct CookedMesh {
+    std::vector<Vec3>     vertices;
+    std::vector<uint32_t> indices;      // 3 per triangle
+    std::vector<uint32_t> adjacency;    // 3 per triangle, kNoMeshAdjacency if none
+    std::vector<uint8_t>  edgeFlags;    // 1 per triangle, kTriEdge*Active bits
+    std::vector<uint32_t> triSource;    // cooked triangle -> input triangle
+
+    uint32_t inputVertices = 0;
+    uint32_t inputTriangles = 0;
+    uint32_t droppedTriangles = 0;
+    uint32_t activeEdges = 0;           // triangle edges, so shared edges count twice
+    uint32_t inactiveEdges = 0;
+};
+
+inline uint32_t CookedTriangleCount(const CookedMesh& mesh)
+{
+    return static_cast<uint32_t>(mesh.indices.size() / 3);
+}
+
+inline Triangle CookedMeshTriangle(const CookedMesh& mesh, uint32_t tri)
+{
+    const uint32_t* v = &mesh.indices[tri * 3];
+    return { mesh.vertices[v[0]], mesh.vertices[v[1]], mesh.vertices[v[2]] };
+}
+
+namespace detail {
+
+inline int64_t MeshWeldCell(float x, float invCell)
+{
+    return static_cast<int64_t>(std::floor(x * invCell));
+}
+
+inline uint64_t MeshWeldKey(int64_t x, int64_t y, int64_t z)
+{
+    // 21 bits per axis; aliasing only costs extra distance checks.
+    const uint64_t m = (1ull << 21) - 1;
+    return (static_cast<uint64_t>(x) & m) | ((static_cast<uint64_t>(y) & m) << 21)
+         | ((static_cast<uint64_t>(z) & m) << 42);
+}
+
+struct MeshEdgeRef {
+    uint32_t lo, hi;    // welded vertex ids, lo < hi
+    uint32_t tri;
+    uint32_t edge;      // 0..2
+};
+
+inline bool MeshEdgeLess(const MeshEdgeRef& a, const MeshEdgeRef& b)
+{
+    if (a.lo != b.lo) return a.lo < b.lo;
+    if (a.hi != b.hi) return a.hi < b.hi;
+    if (a.tri != b.tri) return a.tri < b.tri;
+    return a.edge < b.edge;
+}
+
+// True when the edge (tri a, edge ea) | (tri b, edge eb) may produce contacts.
+inline bool MeshEdgeActive(const CookedMesh& mesh, uint32_t a, uint32_t ea,
+                           uint32_t b, uint32_t eb, const MeshCookDesc& desc)
+{
+    const uint32_t* va = &mesh.indices[a * 3];
+    const uint32_t* vb = &mesh.indices[b * 3];
+    // Consistent winding walks the shared edge in opposite directions.
+    if (va[ea] != vb[(eb + 1) % 3])
+        return true;
+
+    const Vec3 na = TriNormalUnit(CookedMeshTriangle(mesh, a));
+    const Vec3 nb = TriNormalUnit(CookedMeshTriangle(mesh, b));
+    if (Dot(na, nb) >= desc.flatEdgeCos)
+        return false;
+    const Vec3 opposite = mesh.vertices[vb[(eb + 2) % 3]];
+    return Dot(na, opposite - mesh.vertices[va[ea]]) <= desc.concaveEps;
+}
+
+} // namespace detail
+
+// Welds, drops degenerate triangles, links adjacency and sets edge flags.
+inline bool CookTriangleMesh(const Vec3* positions, uint32_t vertexCount,
+                             const uint32_t* indices, uint32_t triCount,
+                             const MeshCookDesc& desc, CookedMesh& out)
+{
+    out = CookedMesh{};
+    out.inputVertices = vertexCount;
+    out.inputTriangles = triCount;
+    if (!indices && vertexCount < triCount * 3)
+        return false;
+
+    // Weld in input order: each vertex joins the lowest cooked vertex within
+    // tolerance in its 3x3x3 cell neighbourhood.
+    const float cell = (std::max)(desc.weldTolerance, kMeshCookMinWeldCell);
+    const float invCell = 1.0f / cell;
+    const float tolSq = desc.weldTolerance * desc.weldTolerance;
+    std::unordered_map<uint64_t, uint32_t> cellHead;
+    std::vector<uint32_t> cellNext;
+    std::vector<uint32_t> weldOf(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const Vec3& p = positions[i];
+        const int64_t cx = detail::MeshWeldCell(p.x, invCell);
+        const int64_t cy = detail::MeshWeldCell(p.y, invCell);
+        const int64_t cz = detail::MeshWeldCell(p.z, invCell);
+        uint32_t found = kNoMeshAdjacency;
+        for (int64_t dz = -1; dz <= 1; ++dz)
+            for (int64_t dy = -1; dy <= 1; ++dy)
+                for (int64_t dx = -1; dx <= 1; ++dx) {
+                    const auto it = cellHead.find(detail::MeshWeldKey(cx + dx, cy + dy, cz + dz));
+                    for (uint32_t v = (it == cellHead.end()) ? kNoMeshAdjacency : it->second;
+                         v != kNoMeshAdjacency; v = cellNext[v]) {
+                        if (LenSq(out.vertices[v] - p) <= tolSq && (found == kNoMeshAdjacency || v < found))
+                            found = v;
+                    }
+                }
+        if (found == kNoMeshAdjacency) {
+            found = static_cast<uint32_t>(out.vertices.size());
+            out.vertices.push_back(p);
+            const uint64_t key = detail::MeshWeldKey(cx, cy, cz);
+            const auto it = cellHead.find(key);
+            cellNext.push_back(it == cellHead.end() ? kNoMeshAdjacency : it->second);
+            cellHead[key] = found;
+        }
+        weldOf[i] = found;
+    }
+
+    out.indices.reserve(static_cast<size_t>(triCount) * 3);
+    for (uint32_t t = 0; t < triCount; ++t) {
+        uint32_t v[3];
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t src = indices ? indices[t * 3 + k] : t * 3 + k;
+            if (src >= vertexCount) {
+                out = CookedMesh{};
+                return false;
+            }
+            v[k] = weldOf[src];
+        }
+        const Triangle tri{ out.vertices[v[0]], out.vertices[v[1]], out.vertices[v[2]] };
+        if (v[0] == v[1] || v[1] == v[2] || v[2] == v[0] ||
+            LenSq(Cross(tri.p1 - tri.p0, tri.p2 - tri.p0)) <= kEpsSq) {
+            ++out.droppedTriangles;
+            continue;
+        }
+        out.indices.insert(out.indices.end(), v, v + 3);
+        out.triSource.push_back(t);
+    }
+
+    // Adjacency: sort every triangle edge by its vertex pair; a pair listed
+    // exactly twice links its triangles.
+    const uint32_t cookedTris = CookedTriangleCount(out);
+    std::vector<detail::MeshEdgeRef> edges;
+    edges.reserve(static_cast<size_t>(cookedTris) * 3);
+    for (uint32_t t = 0; t < cookedTris; ++t)
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t a = out.indices[t * 3 + k];
+            const uint32_t b = out.indices[t * 3 + (k + 1) % 3];
+            edges.push_back({ (std::min)(a, b), (std::max)(a, b), t, k });
+        }
+    std::sort(edges.begin(), edges.end(), detail::MeshEdgeLess);
+
+    out.adjacency.assign(static_cast<size_t>(cookedTris) * 3, kNoMeshAdjacency);
+    out.edgeFlags.assign(cookedTris, kTriEdgesAllActive);
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].lo == edges[i].lo && edges[j].hi == edges[i].hi)
+            ++j;
+        if (j - i == 2) {
+            const detail::MeshEdgeRef& a = edges[i];
+            const detail::MeshEdgeRef& b = edges[i + 1];
+            out.adjacency[a.tri * 3 + a.edge] = b.tri;
+            out.adjacency[b.tri * 3 + b.edge] = a.tri;
+            if (!detail::MeshEdgeActive(out, a.tri, a.edge, b.tri, b.edge, desc)) {
+                out.edgeFlags[a.tri] &= static_cast<uint8_t>(~(1u << a.edge));
+                out.edgeFlags[b.tri] &= static_cast<uint8_t>(~(1u << b.edge));
+            }
+        }
+        i = j;
+    }
+    for (uint8_t flags : out.edgeFlags)
+        for (uint32_t k = 0; k < 3; ++k) {
+            if (flags & (1u << k)) ++out.activeEdges;
+            else                   ++out.inactiveEdges;
+        }
+    return true;
+}
+
+// Reads "v" and "f" records from OBJ text into positions and 3 indices per
+// triangle (polygons fanned from their first corner).
+inline bool ParseObjMesh(const char* text, size_t length,
+                         std::vector<Vec3>& positions, std::vector<uint32_t>& indices)
+{
+    positions.clear();
+    indices.clear();
+    std::string line;
+    std::vector<uint32_t> face;
+    size_t pos = 0;
+    while (pos < length) {
+        size_t end = pos;
+        while (end < length && text[end] != '\n')
+            ++end;
+        line.assign(text + pos, end - pos);
+        pos = end + 1;
+
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.resize(hash);
+        const char* s = line.c_str();
+        while (*s == ' ' || *s == '\t')
+            ++s;
+
+        if (s[0] == 'v' && (s[1] == ' ' || s[1] == '\t')) {
+            char* next = nullptr;
+            float xyz[3];
+            s += 2;
+            for (float& c : xyz) {
+                c = std::strtof(s, &next);
+                if (next == s)
+                    return false;
+                s = next;
+            }
+            positions.push_back({ xyz[0], xyz[1], xyz[2] });
+        } else if (s[0] == 'f' && (s[1] == ' ' || s[1] == '\t')) {
+            face.clear();
+            s += 2;
+            for (;;) {
+                while (*s == ' ' || *s == '\t' || *s == '\r')
+                    ++s;
+                if (!*s)
+                    break;
+                char* next = nullptr;
+                const long ref = std::strtol(s, &next, 10);
+                if (next == s || ref == 0)
+                    return false;
+                const long count = static_cast<long>(positions.size());
+                const long index = ref > 0 ? ref - 1 : count + ref;
+                if (index < 0 || index >= count)
+                    return false;
+                face.push_back(static_cast<uint32_t>(index));
+                s = next;
+                while (*s && *s != ' ' && *s != '\t' && *s != '\r')
+                    ++s;  // skip /t/n
+            }
+            if (face.size() < 3)
+                return false;
+            for (size_t k = 1; k + 1 < face.size(); ++k) {
+                indices.push_back(face[0]);
+                indices.push_back(face[k]);
+                indices.push_back(face[k + 1]);
+            }
+        }
+    }
+    return true;
+}
+
+inline bool CookObjMesh(const char* text, size_t length, const MeshCookDesc& desc,
+                        CookedMesh& out)
+{
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+    if (!ParseObjMesh(text, length, positions, indices)) {
+        out = CookedMesh{};
+        return false;
+    }
+    return CookTriangleMesh(positions.data(), static_cast<uint32_t>(positions.size()),
+                            indices.data(), static_cast<uint32_t>(indices.size() / 3),
+                            desc, out);
+}
+
+}}} // namespace Engine::Collision::sq
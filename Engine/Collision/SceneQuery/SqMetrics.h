@@ -15,14 +15,23 @@ namespace Engine { namespace Collision { namespace sq {
 enum class QueryKind : uint8_t {
     Unknown = 0,
     SweepCapsuleClosest,
-    OverlapCapsuleContacts
+    OverlapCapsuleContacts,
+    GatherLocalSet,
+    ClosestPoint,
+    KNearest,
+    OverlapAabb
 };
 
 enum class QueryBackend : uint8_t {
     BinaryBVH = 0,
     BVH4,
     BVH4Simd,
-    LinearFallback
+    LinearFallback,
+    BinaryBVHShortStack,
+    LocalSet,
+    Memo,
+    SinglePrim,
+    UniformGrid
 };
 
 struct QueryMetrics {
@@ -35,6 +44,7 @@ struct QueryMetrics {
     uint32_t nodeAabbPackets = 0;
     uint32_t nodeAabbPacketLanes = 0;
     uint32_t nodeTimePrunes = 0;
+    uint32_t maskRejects = 0;        // nodes/prims whose mask misses the query mask
     uint32_t leafNodesVisited = 0;
     uint32_t primitiveAabbTests = 0;
     uint32_t primitiveAabbRejects = 0;
@@ -43,15 +53,22 @@ struct QueryMetrics {
 
     uint32_t rawHits = 0;
     uint32_t filterRejects = 0;
+    uint32_t filterCulls = 0;        // nodes/prims culled before narrowphase by the filter
     uint32_t acceptedHits = 0;
     uint32_t bestHitUpdates = 0;
 
     uint32_t contactsGenerated = 0;
     uint32_t contactsEvicted = 0;
+    uint32_t duplicateRefSkips = 0;  // repeat spatial-split refs dropped before narrowphase
+    uint32_t deferredCandidates = 0; // leaf prims queued by entry time (orderLeafCandidates)
 
     uint32_t maxStackDepth = 0;
+    uint32_t stackEvictions = 0;     // short-stack entries dropped at capacity
+    uint32_t traversalRestarts = 0;  // parent-pointer backtracks after evictions
     bool overflowed = false;
     bool fallbackUsed = false;
+    bool localSetMiss = false;       // local set active but query left its region
+    bool memoRefilter = false;       // narrowphase rerun over memoized candidates
 
     bool resultHit = false;
     float resultT = 1.0f;
@@ -70,6 +87,14 @@ inline void ResetQueryMetrics(QueryMetrics& metrics,
 struct SceneQueryFrameMetrics {
     uint64_t sweepQueries = 0;
     uint64_t overlapQueries = 0;
+    uint64_t localSetGathers = 0;
+    uint64_t closestPointQueries = 0;
+    uint64_t kNearestQueries = 0;
+    uint64_t aabbOverlapQueries = 0;  // trigger BVH gathers
+    uint64_t localSetQueries = 0;    // sweeps/overlaps served from a local set
+    uint64_t localSetMisses = 0;     // queries that fell back to the full BVH
+    uint64_t memoHits = 0;           // exact repeats served from the query memo
+    uint64_t memoRefilters = 0;      // repeats re-filtered over memoized candidates
 
     uint64_t nodesPopped = 0;
     uint64_t nodeAabbTests = 0;
@@ -77,6 +102,7 @@ struct SceneQueryFrameMetrics {
     uint64_t nodeAabbPackets = 0;
     uint64_t nodeAabbPacketLanes = 0;
     uint64_t nodeTimePrunes = 0;
+    uint64_t maskRejects = 0;
     uint64_t leafNodesVisited = 0;
     uint64_t primitiveAabbTests = 0;
     uint64_t primitiveAabbRejects = 0;
@@ -85,13 +111,18 @@ struct SceneQueryFrameMetrics {
 
     uint64_t rawHits = 0;
     uint64_t filterRejects = 0;
+    uint64_t filterCulls = 0;
     uint64_t acceptedHits = 0;
     uint64_t bestHitUpdates = 0;
 
     uint64_t contactsGenerated = 0;
     uint64_t contactsEvicted = 0;
+    uint64_t duplicateRefSkips = 0;
+    uint64_t deferredCandidates = 0;
 
     uint32_t maxStackDepth = 0;
+    uint64_t stackEvictions = 0;
+    uint64_t traversalRestarts = 0;
     uint32_t overflowCount = 0;
     uint32_t fallbackCount = 0;
 
@@ -113,9 +144,27 @@ inline void AccumulateQueryMetrics(SceneQueryFrameMetrics& frame,
         case QueryKind::OverlapCapsuleContacts:
             ++frame.overlapQueries;
             break;
+        case QueryKind::GatherLocalSet:
+            ++frame.localSetGathers;
+            break;
+        case QueryKind::ClosestPoint:
+            ++frame.closestPointQueries;
+            break;
+        case QueryKind::KNearest:
+            ++frame.kNearestQueries;
+            break;
+        case QueryKind::OverlapAabb:
+            ++frame.aabbOverlapQueries;
+            break;
         default:
             break;
     }
+    if (query.backend == QueryBackend::LocalSet)
+        ++frame.localSetQueries;
+    if (query.localSetMiss)
+        ++frame.localSetMisses;
+    if (query.backend == QueryBackend::Memo)
+        ++(query.memoRefilter ? frame.memoRefilters : frame.memoHits);
 
     frame.nodesPopped += query.nodesPopped;
     frame.nodeAabbTests += query.nodeAabbTests;
@@ -123,6 +172,7 @@ inline void AccumulateQueryMetrics(SceneQueryFrameMetrics& frame,
     frame.nodeAabbPackets += query.nodeAabbPackets;
     frame.nodeAabbPacketLanes += query.nodeAabbPacketLanes;
     frame.nodeTimePrunes += query.nodeTimePrunes;
+    frame.maskRejects += query.maskRejects;
     frame.leafNodesVisited += query.leafNodesVisited;
     frame.primitiveAabbTests += query.primitiveAabbTests;
     frame.primitiveAabbRejects += query.primitiveAabbRejects;
@@ -131,14 +181,19 @@ inline void AccumulateQueryMetrics(SceneQueryFrameMetrics& frame,
 
     frame.rawHits += query.rawHits;
     frame.filterRejects += query.filterRejects;
+    frame.filterCulls += query.filterCulls;
     frame.acceptedHits += query.acceptedHits;
     frame.bestHitUpdates += query.bestHitUpdates;
 
     frame.contactsGenerated += query.contactsGenerated;
     frame.contactsEvicted += query.contactsEvicted;
+    frame.duplicateRefSkips += query.duplicateRefSkips;
+    frame.deferredCandidates += query.deferredCandidates;
 
     if (frame.maxStackDepth < query.maxStackDepth)
         frame.maxStackDepth = query.maxStackDepth;
+    frame.stackEvictions += query.stackEvictions;
+    frame.traversalRestarts += query.traversalRestarts;
     if (query.overflowed)
         ++frame.overflowCount;
     if (query.fallbackUsed)
@@ -147,4 +202,51 @@ inline void AccumulateQueryMetrics(SceneQueryFrameMetrics& frame,
     frame.lastQuery = query;
 }
 
+// Merges per-context frames (e.g. one per crowd worker). Counters add;
+// maxStackDepth takes the max; lastQuery keeps the destination's value.
+inline void AccumulateFrameMetrics(SceneQueryFrameMetrics& dst,
+                                   const SceneQueryFrameMetrics& src)
+{
+    dst.sweepQueries += src.sweepQueries;
+    dst.overlapQueries += src.overlapQueries;
+    dst.closestPointQueries += src.closestPointQueries;
+    dst.kNearestQueries += src.kNearestQueries;
+    dst.aabbOverlapQueries += src.aabbOverlapQueries;
+    dst.localSetGathers += src.localSetGathers;
+    dst.localSetQueries += src.localSetQueries;
+    dst.localSetMisses += src.localSetMisses;
+    dst.memoHits += src.memoHits;
+    dst.memoRefilters += src.memoRefilters;
+
+    dst.nodesPopped += src.nodesPopped;
+    dst.maskRejects += src.maskRejects;
+    dst.nodeAabbTests += src.nodeAabbTests;
+    dst.nodeAabbRejects += src.nodeAabbRejects;
+    dst.nodeAabbPackets += src.nodeAabbPackets;
+    dst.nodeAabbPacketLanes += src.nodeAabbPacketLanes;
+    dst.nodeTimePrunes += src.nodeTimePrunes;
+    dst.leafNodesVisited += src.leafNodesVisited;
+    dst.primitiveAabbTests += src.primitiveAabbTests;
+    dst.primitiveAabbRejects += src.primitiveAabbRejects;
+    dst.primitiveTimePrunes += src.primitiveTimePrunes;
+    dst.narrowphaseCalls += src.narrowphaseCalls;
+
+    dst.rawHits += src.rawHits;
+    dst.filterRejects += src.filterRejects;
+    dst.filterCulls += src.filterCulls;
+    dst.acceptedHits += src.acceptedHits;
+    dst.bestHitUpdates += src.bestHitUpdates;
+
+    dst.contactsGenerated += src.contactsGenerated;
+    dst.contactsEvicted += src.contactsEvicted;
+    dst.duplicateRefSkips += src.duplicateRefSkips;
+
+    if (dst.maxStackDepth < src.maxStackDepth)
+        dst.maxStackDepth = src.maxStackDepth;
+    dst.stackEvictions += src.stackEvictions;
+    dst.traversalRestarts += src.traversalRestarts;
+    dst.overflowCount += src.overflowCount;
+    dst.fallbackCount += src.fallbackCount;
+}
+
 }}} // namespace Engine::Collision::sq
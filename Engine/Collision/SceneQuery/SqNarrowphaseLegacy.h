@@ -24,6 +24,9 @@
 //     apply same extrusion+sweep per surface triangle.
 //   - Initial overlap: segment-triangle distance check at t=0.
 //   - Colinear shortcut: if capsule axis || motion, use front-sphere only.
+//   - Optional TrianglePrecomp: plane-side cull, then the stored normal,
+//     edges and edge normals replace per-candidate recomputation. The side
+//     quads depend on the capsule axis and are still built per query.
 //
 // PROOF POINTS:
 //   - [PR3.4] SweepSphereTri: face hit normal opposes motion direction
@@ -47,6 +50,7 @@ namespace Engine { namespace Collision { namespace sq {
 // ---- Epsilon constants for narrowphase ----------------------------------
 inline constexpr float kNpEpsAlign = 1e-6f;   // alignment tie-break tolerance
 inline constexpr float kNpColinearEps = 1e-4f; // capsule axis || motion threshold
+inline constexpr float kNpPlaneCullSlack = 1e-3f; // plane-side cull margin (plane distance rounding)
 
 // Feature priority class for tie-breaking:
 //   0=face, 1=edge, 2=vertex, 3=prism-side (lowest).
@@ -102,6 +106,10 @@ inline Vec3 InitialOverlapNormal(const Vec3& delta, const Vec3& fallback)
 //
 // Tie-break: smallest t; within tieEpsT: feature class -> alignment -> feature ID.
 // Feature class: face(0) < edge(1) < vertex(2) < prism-side(3).
+// edgeFlags (kTriEdge*Active): inactive edges skip their cylinder, and a
+// vertex skips its sphere when both of its edges are inactive.
+// pre (optional) is the TrianglePrecomp of tri or of a translated copy of it;
+// it replaces the normal and the point-in-triangle edge products.
 inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
                                  const Triangle& tri, bool twoSided,
                                  float& outT, Vec3& outN, uint32_t& outF,
@@ -109,7 +117,9 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
                                  float& outPenetrationDepth,
                                  const SweepFilter* filter = nullptr,
                                  bool rejectInitialOverlap = false,
-                                 float tieEpsT = kNpEpsAlign)
+                                 float tieEpsT = kNpEpsAlign,
+                                 uint8_t edgeFlags = kTriEdgesAllActive,
+                                 const TrianglePrecomp* pre = nullptr)
 {
     Vec3 p1 = c0 + delta;
 
@@ -122,10 +132,16 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
     float bestPenetrationDepth = 0.0f;
 
     // Degenerate triangle detection
-    Vec3 nd = Cross(tri.p1 - tri.p0, tri.p2 - tri.p0);
-    float nd2 = LenSq(nd);
-    bool degenerate = (nd2 <= kEpsSq);
-    Vec3 n = degenerate ? Vec3{0, 1, 0} : NormalizeSafe(nd, {0,1,0});
+    Vec3 n{0, 1, 0};
+    bool degenerate;
+    if (pre) {
+        degenerate = (pre->normalLenSq <= kEpsSq);
+        if (!degenerate) n = pre->normal;
+    } else {
+        Vec3 nd = Cross(tri.p1 - tri.p0, tri.p2 - tri.p0);
+        degenerate = (LenSq(nd) <= kEpsSq);
+        if (!degenerate) n = NormalizeSafe(nd, {0,1,0});
+    }
 
     Vec3 dirU = NormalizeSafe(delta, {0,1,0});
 
@@ -198,7 +214,7 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
     // Initial overlap: true sphere-triangle distance
     Vec3 q0;
     uint32_t initFeat = 0xFFFFFFFFu;
-    float initDistSq = DistPointTriangleSq(c0, tri, &q0, &initFeat);
+    float initDistSq = DistPointTriangleSq(c0, tri, &q0, &initFeat, pre);
     if (initDistSq <= r*r) {
         Vec3 n0 = InitialOverlapNormal(delta, c0 - q0);
         float depth = r - std::sqrt((std::max)(0.0f, initDistSq));
@@ -224,7 +240,7 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
                 float distT = Dot(n, ct - tri.p0);
                 Vec3 proj = ct - n*distT;
 
-                if (PointInTri(proj, tri, n)) {
+                if (pre ? PointInTri(proj, tri, *pre) : PointInTri(proj, tri, n)) {
                     Vec3 nFace = (distT >= 0.0f) ? n : (n * -1.0f);
                     consider(t, nFace, fId);
                 }
@@ -240,19 +256,22 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
     }
 
     // 2) Edge cylinders (features 1-3)
+    const bool e01 = (edgeFlags & kTriEdge01Active) != 0;
+    const bool e12 = (edgeFlags & kTriEdge12Active) != 0;
+    const bool e20 = (edgeFlags & kTriEdge20Active) != 0;
     float tEdge;
 
-    if (IntersectSegmentCylinder01(c0, p1, tri.p0, tri.p1, r, tEdge)) {
+    if (e01 && IntersectSegmentCylinder01(c0, p1, tri.p0, tri.p1, r, tEdge)) {
         Vec3 ct = c0 + delta*tEdge;
         Vec3 q = ClosestPointOnSegment(tri.p0, tri.p1, ct);
         consider(tEdge, ct - q, 1);
     }
-    if (IntersectSegmentCylinder01(c0, p1, tri.p1, tri.p2, r, tEdge)) {
+    if (e12 && IntersectSegmentCylinder01(c0, p1, tri.p1, tri.p2, r, tEdge)) {
         Vec3 ct = c0 + delta*tEdge;
         Vec3 q = ClosestPointOnSegment(tri.p1, tri.p2, ct);
         consider(tEdge, ct - q, 2);
     }
-    if (IntersectSegmentCylinder01(c0, p1, tri.p2, tri.p0, r, tEdge)) {
+    if (e20 && IntersectSegmentCylinder01(c0, p1, tri.p2, tri.p0, r, tEdge)) {
         Vec3 ct = c0 + delta*tEdge;
         Vec3 q = ClosestPointOnSegment(tri.p2, tri.p0, ct);
         consider(tEdge, ct - q, 3);
@@ -260,15 +279,15 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
 
     // 3) Vertex spheres (features 4-6)
     float tV;
-    if (IntersectSegmentSphere01(c0, p1, tri.p0, r, tV)) {
+    if ((e20 || e01) && IntersectSegmentSphere01(c0, p1, tri.p0, r, tV)) {
         Vec3 ct = c0 + delta*tV;
         consider(tV, ct - tri.p0, 4);
     }
-    if (IntersectSegmentSphere01(c0, p1, tri.p1, r, tV)) {
+    if ((e01 || e12) && IntersectSegmentSphere01(c0, p1, tri.p1, r, tV)) {
         Vec3 ct = c0 + delta*tV;
         consider(tV, ct - tri.p1, 5);
     }
-    if (IntersectSegmentSphere01(c0, p1, tri.p2, r, tV)) {
+    if ((e12 || e20) && IntersectSegmentSphere01(c0, p1, tri.p2, r, tV)) {
         Vec3 ct = c0 + delta*tV;
         consider(tV, ct - tri.p2, 6);
     }
@@ -294,8 +313,10 @@ inline bool  SweepSphereTri_TOI01(const Vec3& c0, float r, const Vec3& delta,
 // Build 7 extruded prism faces from triangle ± half-segment vector a.
 // Face 0: one end-cap (chosen based on normal direction).
 // Faces 1-6: three edge quads (two tris each).
+// pre (optional, TrianglePrecomp of src) supplies the cap-choice normal.
 inline uint32_t BuildExtrudedFaces7(const Triangle& src, const Vec3& a,
-                                     Triangle outFaces[7])
+                                     Triangle outFaces[7],
+                                     const TrianglePrecomp* pre = nullptr)
 {
     Vec3 p0  = src.p0 - a;
     Vec3 p1  = src.p1 - a;
@@ -304,7 +325,8 @@ inline uint32_t BuildExtrudedFaces7(const Triangle& src, const Vec3& a,
     Vec3 p1b = src.p1 + a;
     Vec3 p2b = src.p2 + a;
 
-    Vec3 nSrc = Cross(src.p1 - src.p0, src.p2 - src.p0);  // denormalized
+    Vec3 nSrc = pre ? pre->normal
+                    : Cross(src.p1 - src.p0, src.p2 - src.p0);  // denormalized
     uint32_t k = 0;
 
     // One cap
@@ -338,6 +360,19 @@ inline uint32_t BuildExtrudedFaces7(const Triangle& src, const Vec3& a,
 //   4. Extrude triangle by half-segment -> 7 prism faces
 //   5. Sweep sphere center against each prism face
 //   6. Return earliest hit with packed featureId
+//
+// edgeFlags (kTriEdge*Active) marks mesh edges that may produce contacts.
+// The cap skips inactive edges and their lone vertices; the side quad of an
+// inactive edge is skipped whole. Its vertical edges are still swept by the
+// neighbouring quad when that edge is active, and both caps are swept so the
+// face stays covered. The initial-overlap test keeps every feature, since
+// its normal opposes motion whatever the feature.
+//
+// pre (optional, TrianglePrecomp of srcTri) first culls the triangle when the
+// whole swept capsule stays beyond r on one side of its plane, then feeds the
+// initial-overlap distance, the sphere fallbacks and both caps, which are
+// translated copies of srcTri. The side quads depend on the capsule axis and
+// are built as before.
 inline bool SweepCapsuleTri_PhysXLike_TOI01(
     const SweepCapsuleInput& in,
     const Triangle& srcTri,
@@ -348,12 +383,27 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
     bool& outStartPenetrating,
     float& outPenetrationDepth,
     bool rejectInitialOverlap,
-    const SweepFilter* filter = nullptr)
+    const SweepFilter* filter = nullptr,
+    uint8_t edgeFlags = kTriEdgesAllActive,
+    const TrianglePrecomp* pre = nullptr)
 {
     const float r = in.radius + cfg.skin;
 
     if (LenSq(in.delta) <= kEpsSq) return false;
 
+    // Plane-side cull: the swept capsule is the hull of its four end points
+    // grown by r, so if all four stay beyond r on one side of the plane no
+    // feature of the triangle is reached.
+    if (pre && pre->normalLenSq > kEpsSq) {
+        const float dA = Dot(pre->normal, in.segA0) - pre->planeD;
+        const float dB = Dot(pre->normal, in.segB0) - pre->planeD;
+        const float dv = Dot(pre->normal, in.delta);
+        const float lo = (std::min)(dA, dB) + (std::min)(dv, 0.0f);
+        const float hi = (std::max)(dA, dB) + (std::max)(dv, 0.0f);
+        const float reach = r + kNpPlaneCullSlack;
+        if (lo > reach || hi < -reach) return false;
+    }
+
     Vec3 c0 = (in.segA0 + in.segB0) * 0.5f;
     Vec3 a  = (in.segA0 - in.segB0) * 0.5f;
     Vec3 dirU = NormalizeSafe(in.delta, {0,1,0});
@@ -434,7 +484,7 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
     };
 
     float initDistSq = DistSegmentTriangleSq(in.segA0, in.segB0, srcTri,
-                                             &qSeg, &qTri, &initFeat);
+                                             &qSeg, &qTri, &initFeat, pre);
     if (initDistSq <= r*r) {
         Vec3 n0 = InitialOverlapNormal(in.delta, qSeg - qTri);
         float depth = r - std::sqrt((std::max)(0.0f, initDistSq));
@@ -451,7 +501,7 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
         float penetrationDepth = 0.0f;
         if (SweepSphereTri_TOI01(c0, r, in.delta, srcTri, cfg.twoSidedTris,
                                  t, n, f, startPenetrating, penetrationDepth,
-                                 filter, rejectInitialOverlap, cfg.tieEpsT))
+                                 filter, rejectInitialOverlap, cfg.tieEpsT, edgeFlags, pre))
             consider(t, n, f, startPenetrating, penetrationDepth);
         if (!std::isfinite(bestT)) return false;
         outT = bestT;
@@ -475,7 +525,7 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
         float penetrationDepth = 0.0f;
         if (SweepSphereTri_TOI01(frontCenter, r, in.delta, srcTri, cfg.twoSidedTris,
                                  t, n, f, startPenetrating, penetrationDepth,
-                                 filter, rejectInitialOverlap, cfg.tieEpsT))
+                                 filter, rejectInitialOverlap, cfg.tieEpsT, edgeFlags, pre))
             consider(t, n, f, startPenetrating, penetrationDepth);
         // Robustness: if front-sphere shortcut misses, fall through to full prism sweep
         // instead of discarding this primitive.
@@ -491,9 +541,16 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
     }
 
     // Extrude triangle and sweep sphere center vs prism faces
+    // Edge owning each face: cap (face 0) none, then quads 1-2, 2-0, 0-1.
+    static constexpr uint8_t kFaceEdge[7] = {
+        0, kTriEdge12Active, kTriEdge12Active, kTriEdge20Active, kTriEdge20Active,
+        kTriEdge01Active, kTriEdge01Active
+    };
     Triangle faces[7];
-    uint32_t faceCount = BuildExtrudedFaces7(srcTri, a, faces);
+    uint32_t faceCount = BuildExtrudedFaces7(srcTri, a, faces, pre);
     for (uint32_t i = 0; i < faceCount; ++i) {
+        if (kFaceEdge[i] && !(edgeFlags & kFaceEdge[i]))
+            continue;
         float t;
         Vec3 n;
         uint32_t f;
@@ -501,12 +558,32 @@ inline bool SweepCapsuleTri_PhysXLike_TOI01(
         float penetrationDepth = 0.0f;
         if (!SweepSphereTri_TOI01(c0, r, in.delta, faces[i], true, t, n, f,
                                  startPenetrating, penetrationDepth,
-                                 filter, rejectInitialOverlap, cfg.tieEpsT))
+                                 filter, rejectInitialOverlap, cfg.tieEpsT,
+                                 i == 0 ? edgeFlags : kTriEdgesAllActive,
+                                 i == 0 ? pre : nullptr))
             continue;
         consider(t, n, (i << 8) | (f & 0xFFu),
                  startPenetrating, penetrationDepth);
     }
 
+    // Skipped quads no longer close the prism when the capsule axis lies in
+    // the triangle plane, and near-coplanar neighbours may pick opposite caps
+    // above. Sweep the other cap too; it reports as the cap (face 0).
+    if (edgeFlags != kTriEdgesAllActive) {
+        const Triangle otherCap = { srcTri.p0 * 2.0f - faces[0].p0,
+                                    srcTri.p1 * 2.0f - faces[0].p1,
+                                    srcTri.p2 * 2.0f - faces[0].p2 };
+        float t;
+        Vec3 n;
+        uint32_t f;
+        bool startPenetrating = false;
+        float penetrationDepth = 0.0f;
+        if (SweepSphereTri_TOI01(c0, r, in.delta, otherCap, true, t, n, f,
+                                 startPenetrating, penetrationDepth,
+                                 filter, rejectInitialOverlap, cfg.tieEpsT, edgeFlags, pre))
+            consider(t, n, f & 0xFFu, startPenetrating, penetrationDepth);
+    }
+
     if (!std::isfinite(bestT)) return false;
     outT = bestT;
     outN = bestN;
@@ -842,12 +919,22 @@ inline bool OverlapCapsuleObb(const Vec3& segA, const Vec3& segB, float radius,
 }
 
 // ---- Capsule vs Triangle overlap (segment-triangle distance) --------------
+// pre (optional, TrianglePrecomp of tri) culls by plane side like the sweep
+// and feeds the segment-triangle distance.
 inline bool OverlapCapsuleTri(const Vec3& segA, const Vec3& segB, float radius,
-                               const Triangle& tri, OverlapContact& out)
+                               const Triangle& tri, OverlapContact& out,
+                               const TrianglePrecomp* pre = nullptr)
 {
+    if (pre && pre->normalLenSq > kEpsSq) {
+        const float dA = Dot(pre->normal, segA) - pre->planeD;
+        const float dB = Dot(pre->normal, segB) - pre->planeD;
+        const float reach = radius + kNpPlaneCullSlack;
+        if ((dA > reach && dB > reach) || (dA < -reach && dB < -reach)) return false;
+    }
+
     Vec3 qSeg, qTri;
     uint32_t feat;
-    float dist2 = DistSegmentTriangleSq(segA, segB, tri, &qSeg, &qTri, &feat);
+    float dist2 = DistSegmentTriangleSq(segA, segB, tri, &qSeg, &qTri, &feat, pre);
 
     if (dist2 > radius * radius) return false;
 
@@ -862,7 +949,7 @@ inline bool OverlapCapsuleTri(const Vec3& segA, const Vec3& segB, float radius,
     } else {
         // Near-zero: closest-pair direction is unstable around coplanar contacts.
         // Use triangle normal oriented toward capsule center for stable support.
-        Vec3 n = TriNormalUnit(tri);
+        Vec3 n = pre ? pre->normal : TriNormalUnit(tri);
         Vec3 capCenter = (segA + segB) * 0.5f;
         Vec3 triCenter = (tri.p0 + tri.p1 + tri.p2) * (1.0f / 3.0f);
         if (Dot(n, capCenter - triCenter) < 0.0f) n = n * -1.0f;
@@ -873,4 +960,128 @@ inline bool OverlapCapsuleTri(const Vec3& segA, const Vec3& segB, float radius,
     return true;
 }
 
+// =========================================================================
+// Capsule vs Capsule (dynamic characters)
+// =========================================================================
+// Overlap: segment-segment distance against rA + rB. Normal points from B
+// toward A (push A out), like the static overlap kernels.
+//
+// Sweep: capsule A moves by delta, capsule B is fixed. A touches B when
+//   |(a + t*delta) - b| <= R  for some a in segA, b in segB, R = rA + rB,
+// i.e. the point t*delta enters M (+) ball(R), where M = {b - a} is the
+// parallelogram spanned by segB and -segA (a segment when they are parallel).
+// Earliest t = min over M's 4 vertex spheres, 4 edge cylinders and, when M
+// has area, the two face planes offset by +-R. Hit normal is the closest-pair
+// direction at the TOI pose.
+// Feature ids: 0=face, 1-4=edges, 5-8=vertices (informational only).
+
+inline bool OverlapCapsuleCapsule(const Vec3& aP, const Vec3& aQ, float radiusA,
+                                  const Vec3& bP, const Vec3& bQ, float radiusB,
+                                  OverlapContact& out)
+{
+    Vec3 qA, qB;
+    const float dist2 = DistSegmentSegmentSq(aP, aQ, bP, bQ, &qA, &qB);
+    const float R = radiusA + radiusB;
+    if (dist2 > R * R) return false;
+
+    constexpr float epsD2 = 1e-8f;
+    const float dist = std::sqrt(dist2);
+    out.depth = R - dist;
+    if (dist2 > epsD2) {
+        out.normal = (qA - qB) * (1.0f / dist);
+    } else {
+        // Crossing axes: separate along the axis-midpoint direction.
+        const Vec3 mid = (aP + aQ) * 0.5f - (bP + bQ) * 0.5f;
+        out.normal = NormalizeSafe(mid, {0, 1, 0});
+    }
+    out.featureId = 0;
+    return true;
+}
+
+inline bool SweepCapsuleCapsule_TOI01(
+    const SweepCapsuleInput& in,
+    const Vec3& otherP, const Vec3& otherQ, float otherRadius,
+    float& outT, Vec3& outN, uint32_t& outFeat,
+    bool& outStartPenetrating,
+    float& outPenetrationDepth,
+    bool rejectInitialOverlap = false,
+    const SweepFilter* filter = nullptr)
+{
+    const float R = in.radius + otherRadius;
+
+    OverlapContact start;
+    if (OverlapCapsuleCapsule(in.segA0, in.segB0, in.radius, otherP, otherQ, otherRadius, start)) {
+        const Vec3 n = InitialOverlapNormal(in.delta, start.normal);
+        if (!PassNarrowfilter(filter, rejectInitialOverlap, true, n))
+            return false;
+        outT = 0.0f;
+        outN = n;
+        outFeat = 0xFFFFFFFFu;
+        outStartPenetrating = true;
+        outPenetrationDepth = start.depth;
+        return true;
+    }
+    if (LenSq(in.delta) < kEpsSq) return false;
+
+    // Minkowski difference M = other - swept segment.
+    const Vec3 v[4] = {
+        otherP - in.segA0, otherQ - in.segA0,
+        otherQ - in.segB0, otherP - in.segB0
+    };
+    const Vec3 origin{0, 0, 0};
+    const Vec3 end = in.delta;
+
+    float bestT = 2.0f;
+    uint32_t bestF = 0;
+    auto consider = [&](float t, uint32_t feat) {
+        if (t < bestT) { bestT = t; bestF = feat; }
+    };
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        float t;
+        if (IntersectSegmentSphere01(origin, end, v[i], R, t)) consider(t, 5 + i);
+        if (IntersectSegmentCylinder01(origin, end, v[i], v[(i + 1) & 3], R, t)) consider(t, 1 + i);
+    }
+
+    const Vec3 e0 = v[1] - v[0];
+    const Vec3 e1 = v[3] - v[0];
+    const Vec3 faceN = Cross(e0, e1);
+    const float faceN2 = LenSq(faceN);
+    if (faceN2 > kEpsParallel) {
+        const Vec3 n = faceN * (1.0f / std::sqrt(faceN2));
+        const float dn = Dot(end, n);
+        if (Abs(dn) > kEpsParallel) {
+            const float e00 = Dot(e0, e0), e01 = Dot(e0, e1), e11 = Dot(e1, e1);
+            const float det = e00 * e11 - e01 * e01;
+            for (float side : {R, -R}) {
+                const float t = (Dot(v[0], n) + side) / dn;
+                if (t < 0.0f || t > 1.0f) continue;
+                const Vec3 rel = end * t - (v[0] + n * side);
+                const float r0 = Dot(rel, e0), r1 = Dot(rel, e1);
+                const float u = (r0 * e11 - r1 * e01) / det;
+                const float w = (r1 * e00 - r0 * e01) / det;
+                if (u >= 0.0f && u <= 1.0f && w >= 0.0f && w <= 1.0f)
+                    consider(t, 0);
+            }
+        }
+    }
+
+    if (bestT > 1.0f) return false;
+
+    const Vec3 moved = in.delta * bestT;
+    Vec3 qA, qB;
+    DistSegmentSegmentSq(in.segA0 + moved, in.segB0 + moved, otherP, otherQ, &qA, &qB);
+    const Vec3 fallback = NormalizeSafe(in.delta * -1.0f, {0, 1, 0});
+    const Vec3 n = NormalizeSafe(qA - qB, fallback);
+    if (!PassNarrowfilter(filter, rejectInitialOverlap, false, n))
+        return false;
+
+    outT = bestT;
+    outN = n;
+    outFeat = bestF;
+    outStartPenetrating = false;
+    outPenetrationDepth = 0.0f;
+    return true;
+}
+
 }}} // namespace Engine::Collision::sq
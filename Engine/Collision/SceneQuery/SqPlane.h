@@ -0,0 +1,463 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/21-plane-primitive.md
+//
+// TERMINOLOGY:
+//   PlanePrim  - half-space {x : Dot(normal, x) <= offset}, optionally bounded
+//                by a footprint rectangle (origin, axisU/axisV, halfU/halfV)
+//                on its surface. Infinite halves give an unbounded plane.
+//                A finite thickness makes it a slab: the solid ends at a
+//                bottom face that far below the surface.
+//   signed gap - Dot(normal, x) - offset; negative inside the solid
+//   support    - the capsule core point(s) with the smallest signed gap: one
+//                endpoint, or the whole segment when it lies parallel
+//   footprint  - a contact counts only when the support, moved onto the
+//                surface, touches the footprint rectangle
+//   near face  - the face a query answers against: the surface, or for a
+//                slab the bottom face when the segment lies nearer to it
+//
+// POLICY:
+//   - Planes never enter a StaticBVH. Their bounds span the map, so in the
+//     tree they sit near the root and overlap every leaf. They are tested
+//     after the BVH query in O(1) each and merged into its result.
+//   - Merge order is ascending plane index. Hits merge with BetterHit,
+//     contacts with InsertOverlapContactTopK and the final
+//     OverlapContactBetter sort, closest points and k-nearest with the
+//     (distance, type, index) order. The result does not depend on whether a
+//     plane was tested before or after the tree.
+//   - Sweep and overlap follow the kernel policy: r = radius + skin for
+//     sweeps, InitialOverlapNormal for startPenetrating hits,
+//     PassNarrowfilter inside the kernel, featureId 0 (face).
+//   - Face only. A bounded plane has no edge or vertex features, so a capsule
+//     past the footprint rim does not touch it.
+//   - A slab acts like a sheet: a capsule below it is pushed down and
+//     blocked by the bottom face, not lifted through the surface.
+//
+// CONTRACT:
+//   - Standalone: includes SqClosestPoint.h (which pulls in SqQuery.h).
+//   - normal, axisU and axisV are unit and mutually orthogonal; origin lies
+//     on the surface. MakeHalfSpace/MakeBoundedPlane establish this.
+//   - Plane hits and contacts carry PrimType::Plane and the plane index the
+//     caller passed; callers remap it like BVH prim indices.
+//   - A zero sweep delta returns no hit, like the triangle and box kernels.
+//
+// PROOF POINTS:
+//   - Harness: a bounded-plane floor matches the two-triangle floor it
+//     replaces for sweeps and overlaps inside the footprint, and reports the
+//     BVH node visits the plane removes.
+//   - Harness: a capsule that walks off a slab floor's rim and steers back
+//     under it keeps falling like on the triangle floor
+//     (ExpectFloorPlaneRimReturn).
+// =========================================================================
+
+#include "SqClosestPoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Engine { namespace Collision { namespace sq {
+
+// Numerical guard: endpoint gaps closer than this are a parallel support.
+inline constexpr float kPlaneSupportEps = 1e-6f;
+
+struct PlanePrim {
+    Vec3     normal{0, 1, 0};   // unit, points out of the solid
+    float    offset = 0.0f;     // Dot(normal, x) == offset on the surface
+    Vec3     origin{};          // footprint centre, on the surface
+    Vec3     axisU{1, 0, 0};    // unit, orthogonal to normal
+    Vec3     axisV{0, 0, 1};    // unit, orthogonal to normal and axisU
+    float    halfU = std::numeric_limits<float>::infinity();
+    float    halfV = std::numeric_limits<float>::infinity();
+    float    thickness = std::numeric_limits<float>::infinity();  // solid depth below the surface
+    uint32_t mask = kPrimMaskAll;
+};
+
+inline PlanePrim MakeHalfSpace(const Vec3& normal, float offset)
+{
+    PlanePrim plane{};
+    plane.normal = NormalizeSafe(normal, {0, 1, 0});
+    plane.offset = offset;
+    plane.origin = plane.normal * offset;
+    plane.axisU = NormalizeSafe(RejectFrom(Abs(plane.normal.x) < 0.9f ? Vec3{1, 0, 0}
+                                                                       : Vec3{0, 1, 0},
+                                           plane.normal), {1, 0, 0});
+    plane.axisV = Cross(plane.normal, plane.axisU);
+    return plane;
+}
+
+// Rectangle of half extents (halfU, halfV) centred on origin. axisU is
+// projected onto the surface; axisV completes the frame. A finite thickness
+// gives a slab.
+inline PlanePrim MakeBoundedPlane(const Vec3& normal, const Vec3& origin,
+                                  const Vec3& axisU, float halfU, float halfV,
+                                  float thickness = std::numeric_limits<float>::infinity())
+{
+    PlanePrim plane{};
+    plane.normal = NormalizeSafe(normal, {0, 1, 0});
+    plane.offset = Dot(plane.normal, origin);
+    plane.origin = origin;
+    plane.axisU = NormalizeSafe(RejectFrom(axisU, plane.normal), {1, 0, 0});
+    plane.axisV = Cross(plane.normal, plane.axisU);
+    plane.halfU = halfU;
+    plane.halfV = halfV;
+    plane.thickness = thickness;
+    return plane;
+}
+
+// Conservative bounds of the footprint (the surface rectangle). Infinite for
+// unbounded planes; informational only, planes never enter a BVH.
+inline AABB PlaneFootprintBounds(const PlanePrim& plane)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    if (!std::isfinite(plane.halfU) || !std::isfinite(plane.halfV))
+        return { -inf, -inf, -inf, inf, inf, inf };
+    const Vec3 eu = plane.axisU * plane.halfU;
+    const Vec3 ev = plane.axisV * plane.halfV;
+    const Vec3 e = { Abs(eu.x) + Abs(ev.x), Abs(eu.y) + Abs(ev.y), Abs(eu.z) + Abs(ev.z) };
+    return { plane.origin.x - e.x, plane.origin.y - e.y, plane.origin.z - e.z,
+             plane.origin.x + e.x, plane.origin.y + e.y, plane.origin.z + e.z };
+}
+
+inline float PlaneSignedGap(const PlanePrim& plane, const Vec3& p)
+{
+    return Dot(plane.normal, p) - plane.offset;
+}
+
+namespace detail {
+
+// Clips s0 + (s1 - s0) * t to |s| <= half, narrowing [t0, t1].
+inline bool ClipPlaneFootprintAxis(float s0, float s1, float half, float& t0, float& t1)
+{
+    const float ds = s1 - s0;
+    if (ds == 0.0f)
+        return Abs(s0) <= half;
+    float ta = (-half - s0) / ds;
+    float tb = (half - s0) / ds;
+    if (ta > tb) std::swap(ta, tb);
+    t0 = (std::max)(t0, ta);
+    t1 = (std::min)(t1, tb);
+    return t0 <= t1;
+}
+
+// Smallest signed gap of segment [a, b] and the support sub-segment that
+// attains it ([a, a], [b, b], or [a, b] when the segment is parallel).
+inline float PlaneSupport(const PlanePrim& plane, const Vec3& a, const Vec3& b,
+                          Vec3& supA, Vec3& supB)
+{
+    const float sa = PlaneSignedGap(plane, a);
+    const float sb = PlaneSignedGap(plane, b);
+    if (sa < sb - kPlaneSupportEps) {
+        supA = supB = a;
+        return sa;
+    }
+    if (sb < sa - kPlaneSupportEps) {
+        supA = supB = b;
+        return sb;
+    }
+    supA = a;
+    supB = b;
+    return (std::min)(sa, sb);
+}
+
+// The slab's bottom face as a plane facing down, same footprint.
+inline PlanePrim PlaneBottomFace(const PlanePrim& plane)
+{
+    PlanePrim bottom = plane;
+    bottom.normal = plane.normal * -1.0f;
+    bottom.offset = plane.thickness - plane.offset;
+    bottom.origin = plane.origin - plane.normal * plane.thickness;
+    return bottom;
+}
+
+// PlaneSupport against the near face, which is written to face. A segment
+// below a slab is nearer its bottom face; otherwise the surface answers.
+inline float PlaneNearFaceSupport(const PlanePrim& plane, const Vec3& a, const Vec3& b,
+                                  PlanePrim& face, Vec3& supA, Vec3& supB)
+{
+    face = plane;
+    const float s0 = PlaneSupport(plane, a, b, supA, supB);
+    if (!std::isfinite(plane.thickness))
+        return s0;
+    const PlanePrim bottom = PlaneBottomFace(plane);
+    Vec3 botA, botB;
+    const float b0 = PlaneSupport(bottom, a, b, botA, botB);
+    if (b0 <= s0)
+        return s0;
+    face = bottom;
+    supA = botA;
+    supB = botB;
+    return b0;
+}
+
+} // namespace detail
+
+// True when [a, b], moved along the normal onto the surface, touches the
+// footprint. tFirst receives the first touching parameter along [a, b].
+inline bool PlaneFootprintTouches(const PlanePrim& plane, const Vec3& a, const Vec3& b,
+                                  float* tFirst = nullptr)
+{
+    float t0 = 0.0f, t1 = 1.0f;
+    const Vec3 da = a - plane.origin;
+    const Vec3 db = b - plane.origin;
+    if (!detail::ClipPlaneFootprintAxis(Dot(da, plane.axisU), Dot(db, plane.axisU),
+                                        plane.halfU, t0, t1) ||
+        !detail::ClipPlaneFootprintAxis(Dot(da, plane.axisV), Dot(db, plane.axisV),
+                                        plane.halfV, t0, t1))
+        return false;
+    if (tFirst)
+        *tFirst = t0;
+    return true;
+}
+
+// ---- Kernels ------------------------------------------------------------
+
+// Capsule sweep against a plane. Same outputs and filter policy as
+// SweepCapsuleTri_PhysXLike_TOI01; closed form instead of a prism sweep.
+inline bool SweepCapsulePlane_TOI01(
+    const SweepCapsuleInput& in,
+    const PlanePrim& plane,
+    const SweepConfig& cfg,
+    float& outT,
+    Vec3& outN,
+    uint32_t& outFeat,
+    bool& outStartPenetrating,
+    float& outPenetrationDepth,
+    bool rejectInitialOverlap,
+    const SweepFilter* filter = nullptr)
+{
+    const float r = in.radius + cfg.skin;
+
+    if (LenSq(in.delta) <= kEpsSq) return false;
+
+    PlanePrim face;
+    Vec3 supA, supB;
+    const float s0 = detail::PlaneNearFaceSupport(plane, in.segA0, in.segB0, face, supA, supB);
+
+    if (s0 <= r) {
+        if (!PlaneFootprintTouches(plane, supA, supB))
+            return false;
+        const Vec3 n0 = InitialOverlapNormal(in.delta, face.normal);
+        if (!PassNarrowfilter(filter, rejectInitialOverlap, true, n0))
+            return false;
+        outT = 0.0f;
+        outN = n0;
+        outFeat = 0;
+        outStartPenetrating = true;
+        outPenetrationDepth = r - s0;
+        return true;
+    }
+
+    const float approach = -Dot(face.normal, in.delta);
+    if (approach <= 0.0f) return false;
+    const float t = (s0 - r) / approach;
+    if (t > 1.0f) return false;
+
+    const Vec3 move = in.delta * t;
+    if (!PlaneFootprintTouches(plane, supA + move, supB + move))
+        return false;
+    if (!PassNarrowfilter(filter, rejectInitialOverlap, false, face.normal))
+        return false;
+
+    outT = t;
+    outN = face.normal;
+    outFeat = 0;
+    outStartPenetrating = false;
+    outPenetrationDepth = 0.0f;
+    return true;
+}
+
+// Capsule overlap with a plane, pushed out of its near face. Depth grows
+// without bound below an infinitely thick plane.
+inline bool OverlapCapsulePlane(const Vec3& segA, const Vec3& segB, float radius,
+                                const PlanePrim& plane, OverlapContact& out)
+{
+    PlanePrim face;
+    Vec3 supA, supB;
+    const float s0 = detail::PlaneNearFaceSupport(plane, segA, segB, face, supA, supB);
+    if (s0 > radius || !PlaneFootprintTouches(plane, supA, supB))
+        return false;
+    out.normal = face.normal;
+    out.depth = radius - s0;
+    out.featureId = 0;
+    return true;
+}
+
+// Segment-to-plane distance (0 inside) with witness points, like
+// ClosestPointPrimSq. False when the support misses the footprint.
+inline bool ClosestPointSegmentPlane(const Vec3& segA, const Vec3& segB,
+                                     const PlanePrim& plane,
+                                     float& outDist, Vec3& qSeg, Vec3& qPrim)
+{
+    PlanePrim face;
+    Vec3 supA, supB;
+    const float s0 = detail::PlaneNearFaceSupport(plane, segA, segB, face, supA, supB);
+    float tFirst = 0.0f;
+    if (!PlaneFootprintTouches(plane, supA, supB, &tFirst))
+        return false;
+    qSeg = supA + (supB - supA) * tFirst;
+    const float s = (std::max)(0.0f, s0);
+    qPrim = qSeg - face.normal * s;
+    outDist = s;
+    return true;
+}
+
+// ---- Merge into BVH results ----------------------------------------------
+
+// Merges plane hits into best (BVH-local indices; plane j keeps index j).
+inline void SweepCapsuleClosestHit_Planes(
+    const PlanePrim* planes, uint32_t planeCount,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    Hit& best,
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    for (uint32_t j = 0; j < planeCount; ++j) {
+        if (!PassQueryMask(planes[j].mask, queryMask, metrics))
+            continue;
+        float t; Vec3 n; uint32_t f;
+        bool startPenetrating = false;
+        float penetrationDepth = 0.0f;
+        if (metrics)
+            ++metrics->narrowphaseCalls;
+        if (!SweepCapsulePlane_TOI01(in, planes[j], cfg, t, n, f,
+                                     startPenetrating, penetrationDepth,
+                                     rejectInitialOverlap,
+                                     filter.active ? &filter : nullptr))
+            continue;
+        if (metrics) {
+            ++metrics->rawHits;
+            ++metrics->acceptedHits;
+        }
+        if (!best.hit || BetterHit(t, PrimType::Plane, j, f,
+                                    best.t, best.type, best.index,
+                                    best.featureId, cfg.tieEpsT))
+        {
+            if (metrics)
+                ++metrics->bestHitUpdates;
+            best.hit = true;
+            best.t = t;
+            best.type = PrimType::Plane;
+            best.index = j;
+            best.normal = n;
+            best.featureId = f;
+            best.startPenetrating = startPenetrating;
+            best.penetrationDepth = penetrationDepth;
+        }
+    }
+    if (metrics)
+        FinishSweepQueryMetrics(*metrics, best);
+}
+
+// Merges plane contacts into a sorted BVH contact list; returns the new count.
+inline uint32_t OverlapCapsuleContacts_Planes(
+    const PlanePrim* planes, uint32_t planeCount,
+    const Vec3& segA, const Vec3& segB, float radius,
+    OverlapContact* outContacts, uint32_t maxContacts,
+    uint32_t contactCount,
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
+    if (maxContacts == 0) return 0;
+
+    bool merged = false;
+    for (uint32_t j = 0; j < planeCount; ++j) {
+        if (!PassQueryMask(planes[j].mask, queryMask, metrics))
+            continue;
+        OverlapContact contact;
+        if (metrics)
+            ++metrics->narrowphaseCalls;
+        if (!OverlapCapsulePlane(segA, segB, radius, planes[j], contact))
+            continue;
+        if (metrics) {
+            ++metrics->rawHits;
+            ++metrics->acceptedHits;
+        }
+        contact.type = PrimType::Plane;
+        contact.index = j;
+        InsertOverlapContactTopK(outContacts, maxContacts, contactCount, contact, metrics);
+        merged = true;
+    }
+    if (merged)
+        std::sort(outContacts, outContacts + contactCount, OverlapContactBetter);
+    if (metrics)
+        FinishOverlapQueryMetrics(*metrics, contactCount);
+    return contactCount;
+}
+
+// Merges plane `index` into a closest-point result (gap order, then type,
+// then index). best.index must still be in the caller's per-type space.
+inline void ConsiderClosestPointPlane(const PlanePrim& plane, uint32_t index,
+                                      const Vec3& segA, const Vec3& segB,
+                                      float radius, float maxDistance,
+                                      ClosestPointResult& best,
+                                      QueryMetrics* metrics = nullptr,
+                                      uint32_t queryMask = kPrimMaskAll)
+{
+    if (!PassQueryMask(plane.mask, queryMask, metrics))
+        return;
+    if (metrics)
+        ++metrics->narrowphaseCalls;
+    float dist;
+    Vec3 qSeg, qPrim;
+    if (!ClosestPointSegmentPlane(segA, segB, plane, dist, qSeg, qPrim))
+        return;
+    const float gap = dist - radius;
+    if (gap > maxDistance)
+        return;
+    if (best.hit) {
+        if (gap != best.distance) {
+            if (gap > best.distance) return;
+        } else if (best.type != PrimType::Plane) {
+            if (static_cast<uint8_t>(best.type) < static_cast<uint8_t>(PrimType::Plane)) return;
+        } else if (best.index < index) {
+            return;
+        }
+    }
+    if (metrics) {
+        ++metrics->bestHitUpdates;
+        metrics->resultHit = true;
+    }
+    best.hit = true;
+    best.distance = gap;
+    best.pointOnSegment = qSeg;
+    best.pointOnPrim = qPrim;
+    // Outside a slab and below its surface: the bottom face faces the query.
+    best.normal = (dist > 0.0f && PlaneSignedGap(plane, qSeg) < 0.0f) ? plane.normal * -1.0f
+                                                                      : plane.normal;
+    best.type = PrimType::Plane;
+    best.index = index;
+    best.featureId = 0;
+}
+
+// Offers plane `index` to a k-nearest max-heap (InsertKNearestHit order).
+inline void ConsiderKNearestPlane(const PlanePrim& plane, uint32_t index,
+                                  const Vec3& point, float maxDistance,
+                                  KNearestHit* out, uint32_t k, uint32_t& count,
+                                  QueryMetrics* metrics = nullptr,
+                                  uint32_t queryMask = kPrimMaskAll)
+{
+    if (!PassQueryMask(plane.mask, queryMask, metrics))
+        return;
+    if (metrics)
+        ++metrics->narrowphaseCalls;
+    if (!PlaneFootprintTouches(plane, point, point))
+        return;
+    PlanePrim face;
+    Vec3 sup, supB;
+    const float s = detail::PlaneNearFaceSupport(plane, point, point, face, sup, supB);
+    KNearestHit hit{};
+    hit.distance = (std::max)(0.0f, s);
+    hit.point = (s > 0.0f) ? point - face.normal * s : point;
+    hit.type = PrimType::Plane;
+    hit.index = index;
+    if (hit.distance <= maxDistance && InsertKNearestHit(out, k, count, hit) && metrics)
+        ++metrics->bestHitUpdates;
+}
+
+}}} // namespace Engine::Collision::sq
@@ -8,12 +8,21 @@
 //   BetterHit    - deterministic hit comparison (t -> type -> index -> feat)
 //
 // POLICY:
-//   - QueryScratch is caller-allocated on stack. No heap allocation during query.
+//   - QueryScratch is caller-owned. Its node stack is allocated once, by the
+//     first ResetQueryScratch; no heap allocation during query after that.
 //   - BVH traversal is deterministic and prefers nearer child windows first.
 //   - Hit selection uses BetterHit cascade for stable tie-breaking.
 //   - Overlap top-K retention uses OverlapContactBetter across all backends.
 //   - Early-out: prune nodes whose tEnter >= current best t.
 //   - Stack overflow falls back to a linear scan instead of losing candidates.
+//   - queryMask: subtrees whose node mask union misses it are skipped, and
+//     primitives whose mask misses it are never tested.
+//   - Active SweepFilter: node and primitive windows whose contact normals
+//     provably fail the filter are culled before narrowphase (filterCulls).
+//   - SweepConfig::orderLeafCandidates: leaf primitives that pass their AABB
+//     window wait in QueryScratch::candidates, sorted by tEnter. The nearest
+//     one runs narrowphase once no stacked node can enter earlier; it is
+//     pruned once tEnter >= best.t.
 //
 // CONTRACT:
 //   - Standalone: includes SqNarrowphase.h, SqBVH.h, SqBroadphase.h.
@@ -30,6 +39,8 @@
 //   - docs/agent-context/scenequery-refactor.md
 //   - docs/reference/physx/contracts/scenequery-pipeline.md
 //   - docs/reference/physx/contracts/mesh-sweeps-ordering.md
+//   - docs/audits/scenequery/20-sweep-filter-cull.md
+//   - docs/audits/scenequery/27-leaf-entry-ordering.md
 // =========================================================================
 
 #include "SqNarrowphaseLegacy.h"
@@ -38,6 +49,8 @@
 #include "SqPrimitiveTests.h"
 #include "SqMetrics.h"
 
+#include <vector>
+
 namespace Engine { namespace Collision { namespace sq {
 
 // ---- Traversal stack entry ----------------------------------------------
@@ -48,13 +61,27 @@ struct NodeTask {
     float    tExit;
 };
 
+// Leaf primitive whose AABB window passed, waiting for narrowphase
+// (SweepConfig::orderLeafCandidates).
+struct SweepLeafCandidate {
+    uint32_t prim;   // index into bvh.prims
+    float    tEnter;
+    float    tExit;
+};
+
 // ---- Caller-owned scratch memory ----------------------------------------
-// 512 entries for traversal tasks. Overflow falls back to a full scan.
+// 512 entries for traversal tasks. Overflow falls back to a full scan. The
+// stack is sized on first reset, so a scratch that only ever serves
+// short-stack queries (SqBVHShortStack.h) never holds the ~6 KB.
+// 64 deferred leaf candidates; a full queue runs its nearest entry early.
 
 struct QueryScratch {
     static constexpr uint32_t Capacity = 512;
+    static constexpr uint32_t CandidateCapacity = 64;
 
-    NodeTask stack[Capacity];
+    std::vector<NodeTask> stack;  // Capacity entries once reset
+    SweepLeafCandidate candidates[CandidateCapacity];  // descending tEnter
+    uint32_t candidateCount = 0;
     uint32_t sp = 0;
     uint32_t maxSp = 0;
     bool overflowed = false;
@@ -66,8 +93,11 @@ inline void ResetQueryScratch(QueryScratch& scratch,
                               QueryBackend backend = QueryBackend::BinaryBVH)
 {
     scratch.sp = 0;
+    scratch.candidateCount = 0;
     scratch.maxSp = 0;
     scratch.overflowed = false;
+    if (scratch.stack.size() != QueryScratch::Capacity)
+        scratch.stack.resize(QueryScratch::Capacity);
     ResetQueryMetrics(scratch.metrics, kind, backend);
 }
 
@@ -87,6 +117,16 @@ inline bool PushQueryTask(QueryScratch& scratch, const NodeTask& task)
     return true;
 }
 
+// Mask gate shared by every traversal; mask is a node union or a prim mask.
+inline bool PassQueryMask(uint32_t mask, uint32_t queryMask, QueryMetrics* metrics)
+{
+    if (mask & queryMask)
+        return true;
+    if (metrics)
+        ++metrics->maskRejects;
+    return false;
+}
+
 inline void FinishSweepQueryMetrics(QueryMetrics& metrics, const Hit& hit)
 {
     metrics.resultHit = hit.hit;
@@ -119,6 +159,115 @@ inline bool BetterHit(float tNew, PrimType typeNew, uint32_t idxNew, uint32_t fe
     return false;
 }
 
+// ---- Sweep filter cull ---------------------------------------------------
+// Every swept contact that is not an initial overlap has normal d/|d| with
+// d = c - q, |d| = radius + skin, c the capsule centre at the hit time and q
+// on the primitive extruded by the half segment (prism faces, edges,
+// vertices and the sphere shortcuts all follow this rule). For a window
+// [tEnter, tExit] over bounds b, d lies in the box D = C - (b + |a|), so b is
+// culled when no d in D can pass the filter. The test runs in a frame
+// (ref, u, v): alpha is the ref component, h the closest distance of D to
+// the ref axis. Bounds the capsule may touch at t=0 are never culled, since
+// initial-overlap normals follow InitialOverlapNormal instead.
+
+inline constexpr float kFilterCullSlack = 1e-3f;
+
+struct SweepFilterCull {
+    bool  active = false;
+    AABB  cap0{};          // t=0 capsule bounds + slack: initial-overlap guard
+    Vec3  c0{};
+    Vec3  delta{};
+    Vec3  halfSeg{};       // |a| per axis
+    Vec3  ref{};           // unit filter direction
+    Vec3  u{};
+    Vec3  v{};
+    float minDot = 0.0f;   // filter minDot over |refDir|, minus slack
+    float reach = 0.0f;    // radius + skin + slack
+};
+
+inline SweepFilterCull MakeSweepFilterCull(const SweepCapsuleInput& in,
+                                           const SweepConfig& cfg,
+                                           const SweepFilter& filter)
+{
+    SweepFilterCull cull{};
+    const float refLen = Len(filter.refDir);
+    if (!filter.active || refLen <= kFilterCullSlack || LenSq(in.delta) <= kEpsSq)
+        return cull;
+    cull.minDot = filter.minDot / refLen - kFilterCullSlack;
+    if (cull.minDot <= -1.0f)
+        return cull;
+
+    cull.active = true;
+    cull.cap0 = ExpandAabb(CapsuleAabbAtT(in, 0.0f, cfg.skin), kFilterCullSlack);
+    cull.c0 = (in.segA0 + in.segB0) * 0.5f;
+    cull.delta = in.delta;
+    const Vec3 a = (in.segA0 - in.segB0) * 0.5f;
+    cull.halfSeg = { Abs(a.x), Abs(a.y), Abs(a.z) };
+    cull.ref = filter.refDir * (1.0f / refLen);
+    const Vec3 ax = Abs(cull.ref.x) <= Abs(cull.ref.y) && Abs(cull.ref.x) <= Abs(cull.ref.z)
+        ? Vec3{1, 0, 0}
+        : (Abs(cull.ref.y) <= Abs(cull.ref.z) ? Vec3{0, 1, 0} : Vec3{0, 0, 1});
+    cull.u = NormalizeSafe(Cross(cull.ref, ax), {1, 0, 0});
+    cull.v = Cross(cull.ref, cull.u);
+    cull.reach = (in.radius + cfg.skin) * (1.0f + kFilterCullSlack) + kFilterCullSlack;
+    return cull;
+}
+
+// True when no contact inside bounds during [tEnter, tExit] can pass the filter.
+inline bool SweepFilterCulls(const SweepFilterCull& cull, const AABB& bounds,
+                             float tEnter, float tExit)
+{
+    if (!cull.active || TestAabbAabb(cull.cap0, bounds))
+        return false;
+
+    const Vec3 cA = cull.c0 + cull.delta * tEnter;
+    const Vec3 cB = cull.c0 + cull.delta * tExit;
+    const Vec3 dMin{
+        (std::min)(cA.x, cB.x) - bounds.maxX - cull.halfSeg.x - kFilterCullSlack,
+        (std::min)(cA.y, cB.y) - bounds.maxY - cull.halfSeg.y - kFilterCullSlack,
+        (std::min)(cA.z, cB.z) - bounds.maxZ - cull.halfSeg.z - kFilterCullSlack };
+    const Vec3 dMax{
+        (std::max)(cA.x, cB.x) - bounds.minX + cull.halfSeg.x + kFilterCullSlack,
+        (std::max)(cA.y, cB.y) - bounds.minY + cull.halfSeg.y + kFilterCullSlack,
+        (std::max)(cA.z, cB.z) - bounds.minZ + cull.halfSeg.z + kFilterCullSlack };
+    const Vec3 mid = (dMin + dMax) * 0.5f;
+    const Vec3 ext = (dMax - dMin) * 0.5f;
+
+    auto project = [&](const Vec3& w, float& lo, float& hi) {
+        const float c = Dot(mid, w);
+        const float e = Abs(w.x) * ext.x + Abs(w.y) * ext.y + Abs(w.z) * ext.z;
+        lo = c - e;
+        hi = c + e;
+    };
+    auto gapSq = [](float lo, float hi) {
+        const float g = lo > 0.0f ? lo : (hi < 0.0f ? -hi : 0.0f);
+        return g * g;
+    };
+
+    float aLo, aHi, uLo, uHi, vLo, vHi;
+    project(cull.ref, aLo, aHi);
+    project(cull.u, uLo, uHi);
+    project(cull.v, vLo, vHi);
+    const float hSq = gapSq(uLo, uHi) + gapSq(vLo, vHi);
+    const float reachSq = cull.reach * cull.reach;
+    if (hSq > reachSq)
+        return true;
+
+    // Lowest alpha the filter admits: alpha >= m|d| with |d| <= reach.
+    float alphaMin = aLo;
+    if (cull.minDot > 0.0f) {
+        const float m = (std::min)(cull.minDot, 0.9999f);
+        alphaMin = (std::max)(alphaMin, m * std::sqrt(hSq) / std::sqrt(1.0f - m * m));
+    } else {
+        alphaMin = (std::max)(alphaMin, cull.minDot * cull.reach);
+    }
+    if (alphaMin > aHi)
+        return true;
+
+    const float alpha = alphaMin > 0.0f ? alphaMin : (aHi < 0.0f ? aHi : 0.0f);
+    return alpha * alpha + hSq > reachSq;
+}
+
 // ---- Per-primitive narrowphase dispatch ----------------------------------
 
 inline bool SweepCapsulePrim_TOI01(
@@ -137,7 +286,9 @@ inline bool SweepCapsulePrim_TOI01(
             return SweepCapsuleTri_PhysXLike_TOI01(
                 in, bvh.tris[pref.index], cfg, outT, outN, outFeat,
                 outStartPenetrating, outPenetrationDepth,
-                rejectInitialOverlap, filter);
+                rejectInitialOverlap, filter,
+                bvh.triEdgeFlags ? bvh.triEdgeFlags[pref.index] : kTriEdgesAllActive,
+                bvh.triPrecomp ? &bvh.triPrecomp[pref.index] : nullptr);
 
         case PrimType::Aabb:
             return SweepCapsuleAabb_PhysXLike_TOI01(
@@ -156,11 +307,12 @@ inline bool SweepCapsulePrim_TOI01(
     }
 }
 
-inline void ConsiderSweepCapsulePrim(
+// Narrowphase + filter + BetterHit for a primitive whose AABB window
+// [tEnter, tExit] already passed (tEnter < best.t).
+inline void ConsiderSweepCapsulePrimNarrow(
     const StaticBVH& bvh,
     const SweepCapsuleInput& in,
     const SweepConfig& cfg,
-    const AABB& cap0,
     const PrimRef& pref,
     float tEnter,
     float tExit,
@@ -169,22 +321,6 @@ inline void ConsiderSweepCapsulePrim(
     Hit& best,
     QueryMetrics* metrics = nullptr)
 {
-    if (tExit > best.t) tExit = best.t;
-
-    if (metrics)
-        ++metrics->primitiveAabbTests;
-
-    if (!AabbAabb_SweepInterval(cap0, in.delta, pref.bounds, tEnter, tExit)) {
-        if (metrics)
-            ++metrics->primitiveAabbRejects;
-        return;
-    }
-    if (tEnter >= best.t) {
-        if (metrics)
-            ++metrics->primitiveTimePrunes;
-        return;
-    }
-
     float t; Vec3 n; uint32_t f;
     bool startPenetrating = false;
     float penetrationDepth = 0.0f;
@@ -235,13 +371,115 @@ inline void ConsiderSweepCapsulePrim(
     }
 }
 
+// AABB window, time prune and filter cull of one primitive. Narrows
+// [tEnter, tExit] and returns true when narrowphase should run.
+inline bool SweepCapsulePrimWindow(
+    const SweepCapsuleInput& in,
+    const AABB& cap0,
+    const PrimRef& pref,
+    float bestT,
+    float& tEnter,
+    float& tExit,
+    QueryMetrics* metrics = nullptr,
+    const SweepFilterCull* cull = nullptr)
+{
+    if (tExit > bestT) tExit = bestT;
+
+    if (metrics)
+        ++metrics->primitiveAabbTests;
+
+    if (!AabbAabb_SweepInterval(cap0, in.delta, pref.bounds, tEnter, tExit)) {
+        if (metrics)
+            ++metrics->primitiveAabbRejects;
+        return false;
+    }
+    if (tEnter >= bestT) {
+        if (metrics)
+            ++metrics->primitiveTimePrunes;
+        return false;
+    }
+    if (cull && SweepFilterCulls(*cull, pref.bounds, tEnter, tExit)) {
+        if (metrics)
+            ++metrics->filterCulls;
+        return false;
+    }
+    return true;
+}
+
+inline void ConsiderSweepCapsulePrim(
+    const StaticBVH& bvh,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const AABB& cap0,
+    const PrimRef& pref,
+    float tEnter,
+    float tExit,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    Hit& best,
+    QueryMetrics* metrics = nullptr,
+    const SweepFilterCull* cull = nullptr)
+{
+    if (!SweepCapsulePrimWindow(in, cap0, pref, best.t, tEnter, tExit, metrics, cull))
+        return;
+
+    ConsiderSweepCapsulePrimNarrow(bvh, in, cfg, pref, tEnter, tExit,
+                                   filter, rejectInitialOverlap, best, metrics);
+}
+
+// Runs the nearest deferred candidate: pruned once its entry reaches best.t,
+// otherwise narrowphase over its window clipped to best.t, as
+// ConsiderSweepCapsulePrim would have done when its leaf was popped.
+inline void RunNearestSweepLeafCandidate(
+    const StaticBVH& bvh,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    QueryScratch& scratch,
+    Hit& best)
+{
+    const SweepLeafCandidate c = scratch.candidates[--scratch.candidateCount];
+    if (c.tEnter >= best.t) {
+        ++scratch.metrics.primitiveTimePrunes;
+        return;
+    }
+    ConsiderSweepCapsulePrimNarrow(bvh, in, cfg, bvh.prims[c.prim], c.tEnter,
+                                   (std::min)(c.tExit, best.t), filter,
+                                   rejectInitialOverlap, best, &scratch.metrics);
+}
+
+// Queues a candidate by descending tEnter (nearest at the back). Equal
+// entries keep primIdx order. A full queue first runs its nearest entry.
+inline void PushSweepLeafCandidate(
+    const StaticBVH& bvh,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    QueryScratch& scratch,
+    Hit& best,
+    const SweepLeafCandidate& c)
+{
+    if (scratch.candidateCount == QueryScratch::CandidateCapacity)
+        RunNearestSweepLeafCandidate(bvh, in, cfg, filter, rejectInitialOverlap, scratch, best);
+    uint32_t k = scratch.candidateCount++;
+    while (k > 0 && scratch.candidates[k - 1].tEnter <= c.tEnter) {
+        scratch.candidates[k] = scratch.candidates[k - 1];
+        --k;
+    }
+    scratch.candidates[k] = c;
+    ++scratch.metrics.deferredCandidates;
+}
+
 inline Hit SweepCapsuleClosestHit_LinearFallback(
     const StaticBVH& bvh,
     const SweepCapsuleInput& in,
     const SweepConfig& cfg,
     const SweepFilter& filter,
     bool rejectInitialOverlap,
-    QueryMetrics* metrics = nullptr)
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
 {
     if (metrics)
         metrics->fallbackUsed = true;
@@ -256,6 +494,8 @@ inline Hit SweepCapsuleClosestHit_LinearFallback(
     const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
     for (uint32_t i = 0; i < static_cast<uint32_t>(bvh.prims.size()); ++i) {
         const PrimRef& pref = bvh.prims[i];
+        if (!PassQueryMask(pref.mask, queryMask, metrics))
+            continue;
         ConsiderSweepCapsulePrim(bvh, in, cfg, cap0, pref, 0.0f, best.t,
                                  filter, rejectInitialOverlap, best, metrics);
     }
@@ -271,8 +511,12 @@ inline bool MakeClosestSweepChildTask(
     const NodeTask& parent,
     float bestT,
     NodeTask& out,
-    QueryMetrics& metrics)
+    QueryMetrics& metrics,
+    uint32_t queryMask = kPrimMaskAll)
 {
+    if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &metrics))
+        return false;
+
     float cE = parent.tEnter;
     float cL = parent.tExit;
     if (cL > bestT)
@@ -314,8 +558,11 @@ inline void PushStaticOverlapChildIfHit(
     const StaticBVH& bvh,
     const AABB& capBounds,
     uint32_t child,
-    QueryScratch& scratch)
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
 {
+    if (!PassQueryMask(bvh.nodes[child].mask, queryMask, &scratch.metrics))
+        return;
     ++scratch.metrics.nodeAabbTests;
     if (TestAabbAabb(capBounds, bvh.nodes[child].bounds))
         PushQueryTask(scratch, { child, 0.0f, 0.0f });
@@ -333,7 +580,7 @@ inline void PushStaticOverlapChildIfHit(
 // Algorithm:
 //   1. Compute capsule AABB at t=0 expanded by skin (matches narrowphase radius+skin)
 //   2. Test root node time-window; push onto stack if valid
-//   3. DFS loop: pop node, prune by tEnter >= best.t
+//   3. DFS loop: pop node, prune by tEnter >= best.t and by the filter cull
 //      - Leaf: test each primitive (time-window + narrowphase + BetterHit)
 //      - Internal: push farther child first so nearer child is popped first
 //   4. Return best Hit
@@ -343,7 +590,8 @@ inline Hit SweepCapsuleClosestHit_Fast(
     const SweepConfig& cfg,
     QueryScratch& scratch,
     const SweepFilter& filter = SweepFilter{},
-    bool rejectInitialOverlap = false)
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
 {
     Hit best{};
     best.hit = false;
@@ -351,11 +599,12 @@ inline Hit SweepCapsuleClosestHit_Fast(
 
     ResetQueryScratch(scratch, QueryKind::SweepCapsuleClosest, QueryBackend::BinaryBVH);
 
-    if (IsEmptyBVH(bvh))
+    if (IsEmptyBVH(bvh) || !PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &scratch.metrics))
         return best;
 
     // Moving capsule AABB at t=0 expanded by skin (match narrowphase radius+skin)
     AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
 
     float rE = 0.0f;
     float rL = best.t;
@@ -367,7 +616,17 @@ inline Hit SweepCapsuleClosestHit_Fast(
 
     PushQueryTask(scratch, { bvh.root, rE, rL });
 
-    while (scratch.sp) {
+    while (scratch.sp || scratch.candidateCount) {
+        // Deferred candidates run once the next node cannot enter earlier.
+        if (scratch.candidateCount &&
+            (!scratch.sp ||
+             scratch.candidates[scratch.candidateCount - 1].tEnter <=
+                 scratch.stack[scratch.sp - 1].tEnter)) {
+            RunNearestSweepLeafCandidate(bvh, in, cfg, filter, rejectInitialOverlap,
+                                         scratch, best);
+            continue;
+        }
+
         NodeTask task = scratch.stack[--scratch.sp];
         ++scratch.metrics.nodesPopped;
 
@@ -382,16 +641,32 @@ inline Hit SweepCapsuleClosestHit_Fast(
         }
 
         const BVHNode& node = bvh.nodes[task.node];
+        if (SweepFilterCulls(cull, node.bounds, task.tEnter, task.tExit)) {
+            ++scratch.metrics.filterCulls;
+            continue;
+        }
 
         // Leaf node: test primitives
         if (node.primCount) {
             ++scratch.metrics.leafNodesVisited;
             for (uint32_t k = 0; k < node.primCount; ++k) {
-                const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + k]];
-                ConsiderSweepCapsulePrim(bvh, in, cfg, cap0, pref,
-                                         task.tEnter, task.tExit,
-                                         filter, rejectInitialOverlap, best,
-                                         &scratch.metrics);
+                const uint32_t prim = bvh.primIdx[node.primStart + k];
+                const PrimRef& pref = bvh.prims[prim];
+                if (!PassQueryMask(pref.mask, queryMask, &scratch.metrics))
+                    continue;
+                if (!cfg.orderLeafCandidates) {
+                    ConsiderSweepCapsulePrim(bvh, in, cfg, cap0, pref,
+                                             task.tEnter, task.tExit,
+                                             filter, rejectInitialOverlap, best,
+                                             &scratch.metrics, &cull);
+                    continue;
+                }
+                float tEnter = task.tEnter;
+                float tExit = task.tExit;
+                if (SweepCapsulePrimWindow(in, cap0, pref, best.t, tEnter, tExit,
+                                           &scratch.metrics, &cull))
+                    PushSweepLeafCandidate(bvh, in, cfg, filter, rejectInitialOverlap,
+                                           scratch, best, { prim, tEnter, tExit });
             }
             continue;
         }
@@ -401,16 +676,18 @@ inline Hit SweepCapsuleClosestHit_Fast(
         NodeTask leftTask{};
         NodeTask rightTask{};
         const bool leftHit = MakeClosestSweepChildTask(
-            bvh, cap0, in.delta, node.left, task, best.t, leftTask, scratch.metrics);
+            bvh, cap0, in.delta, node.left, task, best.t, leftTask, scratch.metrics,
+            queryMask);
         const bool rightHit = MakeClosestSweepChildTask(
-            bvh, cap0, in.delta, node.right, task, best.t, rightTask, scratch.metrics);
+            bvh, cap0, in.delta, node.right, task, best.t, rightTask, scratch.metrics,
+            queryMask);
         PushClosestSweepChildPair(scratch, leftTask, leftHit, rightTask, rightHit);
     }
 
     if (scratch.overflowed)
     {
         Hit fallback = SweepCapsuleClosestHit_LinearFallback(
-            bvh, in, cfg, filter, rejectInitialOverlap, &scratch.metrics);
+            bvh, in, cfg, filter, rejectInitialOverlap, &scratch.metrics, queryMask);
         FinishSweepQueryMetrics(scratch.metrics, fallback);
         return fallback;
     }
@@ -478,6 +755,20 @@ inline void InsertOverlapContactTopK(
     }
 }
 
+// Spatial-split trees list a triangle in several leaves. A repeat reference
+// computes the same contact: one already kept is skipped, and one evicted
+// earlier loses to the same kept set again.
+inline bool OverlapContactsHoldPrim(const OverlapContact* outContacts,
+                                    uint32_t contactCount,
+                                    const PrimRef& pref)
+{
+    for (uint32_t i = 0; i < contactCount; ++i) {
+        if (outContacts[i].type == pref.type && outContacts[i].index == pref.index)
+            return true;
+    }
+    return false;
+}
+
 // Per-primitive overlap dispatch
 inline bool OverlapCapsulePrim(
     const StaticBVH& bvh,
@@ -494,7 +785,8 @@ inline bool OverlapCapsulePrim(
                                     bvh.obbs[pref.index], out);
         case PrimType::Tri:
             return OverlapCapsuleTri(segA, segB, radius,
-                                    bvh.tris[pref.index], out);
+                                    bvh.tris[pref.index], out,
+                                    bvh.triPrecomp ? &bvh.triPrecomp[pref.index] : nullptr);
         default:
             return false;
     }
@@ -504,7 +796,8 @@ inline uint32_t OverlapCapsuleContacts_LinearFallback(
     const StaticBVH& bvh,
     const Vec3& segA, const Vec3& segB, float radius,
     OverlapContact* outContacts, uint32_t maxContacts,
-    QueryMetrics* metrics = nullptr)
+    QueryMetrics* metrics = nullptr,
+    uint32_t queryMask = kPrimMaskAll)
 {
     if (metrics)
         metrics->fallbackUsed = true;
@@ -518,6 +811,8 @@ inline uint32_t OverlapCapsuleContacts_LinearFallback(
 
     for (uint32_t i = 0; i < static_cast<uint32_t>(bvh.prims.size()); ++i) {
         const PrimRef& pref = bvh.prims[i];
+        if (!PassQueryMask(pref.mask, queryMask, metrics))
+            continue;
         if (metrics)
             ++metrics->primitiveAabbTests;
         if (!TestAabbAabb(capBounds, pref.bounds)) {
@@ -549,7 +844,8 @@ inline uint32_t OverlapCapsuleContacts_Fast(
     const StaticBVH& bvh,
     const Vec3& segA, const Vec3& segB, float radius,
     OverlapContact* outContacts, uint32_t maxContacts,
-    QueryScratch& scratch)
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
 {
     ResetQueryScratch(scratch, QueryKind::OverlapCapsuleContacts, QueryBackend::BinaryBVH);
     if (maxContacts == 0) {
@@ -559,9 +855,14 @@ inline uint32_t OverlapCapsuleContacts_Fast(
     if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
 
     if (IsEmptyBVH(bvh)) return 0;
+    if (!PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &scratch.metrics)) {
+        FinishOverlapQueryMetrics(scratch.metrics, 0);
+        return 0;
+    }
 
     AABB capBounds = CapsuleAabbStatic(segA, segB, radius);
     uint32_t contactCount = 0;
+    const bool dupRefs = HasDuplicatePrimRefs(bvh);
 
     ++scratch.metrics.nodeAabbTests;
     if (!TestAabbAabb(capBounds, bvh.nodes[bvh.root].bounds)) {
@@ -580,11 +881,17 @@ inline uint32_t OverlapCapsuleContacts_Fast(
             ++scratch.metrics.leafNodesVisited;
             for (uint32_t k = 0; k < node.primCount; ++k) {
                 const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + k]];
+                if (!PassQueryMask(pref.mask, queryMask, &scratch.metrics))
+                    continue;
                 ++scratch.metrics.primitiveAabbTests;
                 if (!TestAabbAabb(capBounds, pref.bounds)) {
                     ++scratch.metrics.primitiveAabbRejects;
                     continue;
                 }
+                if (dupRefs && OverlapContactsHoldPrim(outContacts, contactCount, pref)) {
+                    ++scratch.metrics.duplicateRefSkips;
+                    continue;
+                }
 
                 OverlapContact contact;
                 ++scratch.metrics.narrowphaseCalls;
@@ -601,14 +908,15 @@ inline uint32_t OverlapCapsuleContacts_Fast(
             continue;
         }
 
-        PushStaticOverlapChildIfHit(bvh, capBounds, node.right, scratch);
-        PushStaticOverlapChildIfHit(bvh, capBounds, node.left, scratch);
+        PushStaticOverlapChildIfHit(bvh, capBounds, node.right, scratch, queryMask);
+        PushStaticOverlapChildIfHit(bvh, capBounds, node.left, scratch, queryMask);
     }
 
     if (scratch.overflowed)
     {
         const uint32_t fallbackCount = OverlapCapsuleContacts_LinearFallback(
-            bvh, segA, segB, radius, outContacts, maxContacts, &scratch.metrics);
+            bvh, segA, segB, radius, outContacts, maxContacts, &scratch.metrics,
+            queryMask);
         FinishOverlapQueryMetrics(scratch.metrics, fallbackCount);
         return fallbackCount;
     }
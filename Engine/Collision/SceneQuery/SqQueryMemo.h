@@ -0,0 +1,378 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/15-intra-tick-query-memo.md
+//
+// TERMINOLOGY:
+//   SweepMemoKey   - exact geometric identity of a sweep (segment, radius,
+//                    delta, SweepConfig) plus the query mask; filter and
+//                    flags excluded
+//   Candidate list - primitives whose AABB window over [0,1] passes for a
+//                    key, unfiltered, ascending bvh.prims order
+//   Refilter       - rerunning narrowphase + filter over a cached candidate
+//                    list instead of traversing again
+//   Result hit     - exact (key, filter, rejectInitialOverlap) repeat
+//
+// POLICY:
+//   - Keys compare bitwise-equal floats. No tolerance: a near-duplicate is a
+//     different query.
+//   - Candidate runs visit primitives in ascending order with the same time
+//     window math as LinearFallback, so results match the oracle exactly.
+//   - Fixed slot counts, round-robin replacement; vectors keep capacity.
+//
+// CONTRACT:
+//   - Memo contents are valid only while the BVH is unchanged. Owners clear
+//     it at scope end and on rebuild.
+//
+// PROOF POINTS:
+//   - Harness: one candidate list rerun with every filter variant matches
+//     LinearFallback on the dense grid.
+// =========================================================================
+
+#include "SqQuery.h"
+#include "SqLocalSet.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+struct SweepMemoKey {
+    Vec3 segA0{};
+    Vec3 segB0{};
+    Vec3 delta{};
+    float radius = 0.0f;
+    SweepConfig cfg{};
+    uint32_t queryMask = kPrimMaskAll;
+};
+
+struct SweepCandidate {
+    uint32_t prim = 0;   // index into bvh.prims
+    float tEnter = 0.0f; // AABB window over [0,1]
+    float tExit = 1.0f;
+};
+
+inline bool SameVec3Bits(const Vec3& a, const Vec3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+inline SweepMemoKey MakeSweepMemoKey(const SweepCapsuleInput& in, const SweepConfig& cfg,
+                                     uint32_t queryMask = kPrimMaskAll)
+{
+    SweepMemoKey key;
+    key.segA0 = in.segA0;
+    key.segB0 = in.segB0;
+    key.delta = in.delta;
+    key.radius = in.radius;
+    key.cfg = cfg;
+    key.queryMask = queryMask;
+    return key;
+}
+
+inline bool SameSweepMemoKey(const SweepMemoKey& a, const SweepMemoKey& b)
+{
+    return SameVec3Bits(a.segA0, b.segA0)
+        && SameVec3Bits(a.segB0, b.segB0)
+        && SameVec3Bits(a.delta, b.delta)
+        && a.radius == b.radius
+        && a.queryMask == b.queryMask
+        && a.cfg.skin == b.cfg.skin
+        && a.cfg.tieEpsT == b.cfg.tieEpsT
+        && a.cfg.twoSidedTris == b.cfg.twoSidedTris;
+}
+
+// Inactive filters are interchangeable; active ones compare every field.
+inline bool SameSweepFilter(const SweepFilter& a, const SweepFilter& b)
+{
+    if (a.active != b.active)
+        return false;
+    if (!a.active)
+        return true;
+    return SameVec3Bits(a.refDir, b.refDir)
+        && a.minDot == b.minDot
+        && a.filterInitialOverlap == b.filterInitialOverlap;
+}
+
+// ---- Candidate collection ---------------------------------------------------
+
+inline void AppendSweepCandidateIfHit(const AABB& cap0,
+                                      const Vec3& delta, uint32_t prim,
+                                      const AABB& bounds,
+                                      std::vector<SweepCandidate>& out,
+                                      QueryMetrics& metrics)
+{
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    ++metrics.primitiveAabbTests;
+    if (!AabbAabb_SweepInterval(cap0, delta, bounds, tEnter, tExit)) {
+        ++metrics.primitiveAabbRejects;
+        return;
+    }
+    out.push_back({ prim, tEnter, tExit });
+}
+
+// BVH walk without best.t pruning: the list must serve any filter.
+inline void CollectSweepCandidates(const StaticBVH& bvh,
+                                   const SweepCapsuleInput& in,
+                                   const SweepConfig& cfg,
+                                   QueryScratch& scratch,
+                                   std::vector<SweepCandidate>& out,
+                                   uint32_t queryMask = kPrimMaskAll)
+{
+    out.clear();
+    ResetQueryScratch(scratch, QueryKind::SweepCapsuleClosest, QueryBackend::BinaryBVH);
+    if (IsEmptyBVH(bvh))
+        return;
+
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    QueryMetrics& metrics = scratch.metrics;
+
+    if (!PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &metrics))
+        return;
+    float rE = 0.0f;
+    float rL = 1.0f;
+    ++metrics.nodeAabbTests;
+    if (!AabbAabb_SweepInterval(cap0, in.delta, bvh.nodes[bvh.root].bounds, rE, rL)) {
+        ++metrics.nodeAabbRejects;
+        return;
+    }
+    PushQueryTask(scratch, { bvh.root, rE, rL });
+
+    while (scratch.sp) {
+        const NodeTask task = scratch.stack[--scratch.sp];
+        ++metrics.nodesPopped;
+        const BVHNode& node = bvh.nodes[task.node];
+
+        if (node.primCount) {
+            ++metrics.leafNodesVisited;
+            for (uint32_t k = 0; k < node.primCount; ++k) {
+                const uint32_t p = bvh.primIdx[node.primStart + k];
+                if (!PassQueryMask(bvh.prims[p].mask, queryMask, &metrics))
+                    continue;
+                AppendSweepCandidateIfHit(cap0, in.delta, p, bvh.prims[p].bounds,
+                                          out, metrics);
+            }
+            continue;
+        }
+
+        NodeTask leftTask{};
+        NodeTask rightTask{};
+        const bool leftHit = MakeClosestSweepChildTask(
+            bvh, cap0, in.delta, node.left, task, 1.0f, leftTask, metrics, queryMask);
+        const bool rightHit = MakeClosestSweepChildTask(
+            bvh, cap0, in.delta, node.right, task, 1.0f, rightTask, metrics, queryMask);
+        PushClosestSweepChildPair(scratch, leftTask, leftHit, rightTask, rightHit);
+    }
+
+    if (scratch.overflowed) {
+        metrics.fallbackUsed = true;
+        out.clear();
+        for (uint32_t p = 0; p < static_cast<uint32_t>(bvh.prims.size()); ++p) {
+            if (!PassQueryMask(bvh.prims[p].mask, queryMask, &metrics))
+                continue;
+            AppendSweepCandidateIfHit(cap0, in.delta, p, bvh.prims[p].bounds,
+                                      out, metrics);
+        }
+    }
+
+    std::sort(out.begin(), out.end(),
+              [](const SweepCandidate& a, const SweepCandidate& b) { return a.prim < b.prim; });
+    // Spatial-split repeats carry the same prim window; keep one.
+    out.erase(std::unique(out.begin(), out.end(),
+                          [](const SweepCandidate& a, const SweepCandidate& b) { return a.prim == b.prim; }),
+              out.end());
+}
+
+// Local-set variant; caller guarantees the sweep is contained in the set.
+inline void CollectSweepCandidates_LocalSet(const LocalQuerySet& set,
+                                            const SweepCapsuleInput& in,
+                                            const SweepConfig& cfg,
+                                            QueryMetrics& metrics,
+                                            std::vector<SweepCandidate>& out,
+                                            uint32_t queryMask = kPrimMaskAll)
+{
+    out.clear();
+    ResetQueryMetrics(metrics, QueryKind::SweepCapsuleClosest, QueryBackend::LocalSet);
+
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const uint32_t n = set.CandidateCount();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!PassQueryMask(set.mask[i], queryMask, &metrics))
+            continue;
+        const AABB b{ set.minX[i], set.minY[i], set.minZ[i],
+                      set.maxX[i], set.maxY[i], set.maxZ[i] };
+        AppendSweepCandidateIfHit(cap0, in.delta, set.prim[i], b, out, metrics);
+    }
+}
+
+// Narrowphase + filter over a candidate list. Candidates stay unfiltered;
+// the filter cull runs here, per call. Accumulates into metrics.
+inline Hit SweepCapsuleClosestHit_Candidates(
+    const StaticBVH& bvh,
+    const SweepCandidate* candidates, uint32_t count,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    const SweepFilter& filter,
+    bool rejectInitialOverlap,
+    QueryMetrics& metrics)
+{
+    Hit best{};
+    best.hit = false;
+    best.t = 1.0f;
+
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
+    for (uint32_t i = 0; i < count; ++i) {
+        const SweepCandidate& c = candidates[i];
+        if (c.tEnter >= best.t) {
+            ++metrics.primitiveTimePrunes;
+            continue;
+        }
+        const float tExit = (std::min)(c.tExit, best.t);
+        if (SweepFilterCulls(cull, bvh.prims[c.prim].bounds, c.tEnter, tExit)) {
+            ++metrics.filterCulls;
+            continue;
+        }
+        ConsiderSweepCapsulePrimNarrow(bvh, in, cfg, bvh.prims[c.prim],
+                                       c.tEnter, tExit, filter,
+                                       rejectInitialOverlap, best, &metrics);
+    }
+
+    FinishSweepQueryMetrics(metrics, best);
+    return best;
+}
+
+// ---- Memo tables ------------------------------------------------------------
+
+inline constexpr uint32_t kSweepMemoCandidateSlots = 8;
+inline constexpr uint32_t kSweepMemoResultSlots = 16;
+inline constexpr uint32_t kOverlapMemoSlots = 4;
+
+struct SweepMemoCandidateSlot {
+    SweepMemoKey key{};
+    std::vector<SweepCandidate> candidates;
+    bool valid = false;
+};
+
+struct SweepMemoResultSlot {
+    SweepMemoKey key{};
+    SweepFilter filter{};
+    bool rejectInitialOverlap = false;
+    Hit hit{};
+    bool valid = false;
+};
+
+struct OverlapMemoSlot {
+    Vec3 segA{};
+    Vec3 segB{};
+    float radius = 0.0f;
+    uint32_t maxContacts = 0;
+    uint32_t queryMask = kPrimMaskAll;
+    uint32_t count = 0;
+    OverlapContact contacts[kMaxOverlapContacts]{};
+    bool valid = false;
+};
+
+struct QueryMemo {
+    bool active = false;
+    SweepMemoCandidateSlot candidateSlots[kSweepMemoCandidateSlots];
+    SweepMemoResultSlot resultSlots[kSweepMemoResultSlots];
+    OverlapMemoSlot overlapSlots[kOverlapMemoSlots];
+    uint32_t nextCandidateSlot = 0;
+    uint32_t nextResultSlot = 0;
+    uint32_t nextOverlapSlot = 0;
+};
+
+inline void ClearQueryMemo(QueryMemo& memo)
+{
+    memo.active = false;
+    for (SweepMemoCandidateSlot& s : memo.candidateSlots) {
+        s.valid = false;
+        s.candidates.clear();
+    }
+    for (SweepMemoResultSlot& s : memo.resultSlots)
+        s.valid = false;
+    for (OverlapMemoSlot& s : memo.overlapSlots)
+        s.valid = false;
+    memo.nextCandidateSlot = 0;
+    memo.nextResultSlot = 0;
+    memo.nextOverlapSlot = 0;
+}
+
+inline const Hit* FindSweepMemoResult(const QueryMemo& memo, const SweepMemoKey& key,
+                                      const SweepFilter& filter, bool rejectInitialOverlap)
+{
+    for (const SweepMemoResultSlot& s : memo.resultSlots) {
+        if (s.valid && s.rejectInitialOverlap == rejectInitialOverlap &&
+            SameSweepFilter(s.filter, filter) && SameSweepMemoKey(s.key, key))
+            return &s.hit;
+    }
+    return nullptr;
+}
+
+inline void StoreSweepMemoResult(QueryMemo& memo, const SweepMemoKey& key,
+                                 const SweepFilter& filter, bool rejectInitialOverlap,
+                                 const Hit& hit)
+{
+    SweepMemoResultSlot& s = memo.resultSlots[memo.nextResultSlot];
+    memo.nextResultSlot = (memo.nextResultSlot + 1u) % kSweepMemoResultSlots;
+    s.key = key;
+    s.filter = filter;
+    s.rejectInitialOverlap = rejectInitialOverlap;
+    s.hit = hit;
+    s.valid = true;
+}
+
+inline SweepMemoCandidateSlot* FindSweepMemoCandidates(QueryMemo& memo, const SweepMemoKey& key)
+{
+    for (SweepMemoCandidateSlot& s : memo.candidateSlots) {
+        if (s.valid && SameSweepMemoKey(s.key, key))
+            return &s;
+    }
+    return nullptr;
+}
+
+// Claims the next round-robin slot; the caller fills candidates.
+inline SweepMemoCandidateSlot& ClaimSweepMemoCandidates(QueryMemo& memo, const SweepMemoKey& key)
+{
+    SweepMemoCandidateSlot& s = memo.candidateSlots[memo.nextCandidateSlot];
+    memo.nextCandidateSlot = (memo.nextCandidateSlot + 1u) % kSweepMemoCandidateSlots;
+    s.key = key;
+    s.candidates.clear();
+    s.valid = true;
+    return s;
+}
+
+inline const OverlapMemoSlot* FindOverlapMemo(const QueryMemo& memo,
+                                              const Vec3& segA, const Vec3& segB,
+                                              float radius, uint32_t maxContacts,
+                                              uint32_t queryMask = kPrimMaskAll)
+{
+    for (const OverlapMemoSlot& s : memo.overlapSlots) {
+        if (s.valid && s.radius == radius && s.maxContacts == maxContacts &&
+            s.queryMask == queryMask &&
+            SameVec3Bits(s.segA, segA) && SameVec3Bits(s.segB, segB))
+            return &s;
+    }
+    return nullptr;
+}
+
+inline void StoreOverlapMemo(QueryMemo& memo,
+                             const Vec3& segA, const Vec3& segB,
+                             float radius, uint32_t maxContacts,
+                             const OverlapContact* contacts, uint32_t count,
+                             uint32_t queryMask = kPrimMaskAll)
+{
+    OverlapMemoSlot& s = memo.overlapSlots[memo.nextOverlapSlot];
+    memo.nextOverlapSlot = (memo.nextOverlapSlot + 1u) % kOverlapMemoSlots;
+    s.segA = segA;
+    s.segB = segB;
+    s.radius = radius;
+    s.maxContacts = maxContacts;
+    s.queryMask = queryMask;
+    s.count = (std::min)(count, kMaxOverlapContacts);
+    std::copy(contacts, contacts + s.count, s.contacts);
+    s.valid = true;
+}
+
+}}} // namespace Engine::Collision::sq
@@ -0,0 +1,274 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/19-trigger-pair-cache.md
+//
+// TERMINOLOGY:
+//   Trigger BVH  - StaticBVH over trigger bounds, kept apart from the solid
+//                  tree so sweeps never walk trigger nodes
+//   Inside set   - trigger ids whose bounds touch an actor box, ascending
+//   Candidates   - trigger ids touching the actor's fat box (box + margin),
+//                  ascending, with their bounds
+//   Pair event   - Enter / Stay / Exit for one (actor, trigger) pair
+//
+// POLICY:
+//   - Overlap is AABB vs AABB (TestAabbAabb), the rule OverlapCapsule has
+//     always applied to triggers.
+//   - One sorted merge of the previous and new inside sets emits the events
+//     of an actor in ascending trigger id order.
+//   - Bitwise-equal box: the inside set is reused without tests. Box inside
+//     the fat box: only candidates are retested. Otherwise one BVH gather
+//     over a new fat box.
+//
+// CONTRACT:
+//   - Actor ids index TriggerPairCache::actors densely; the cache grows on
+//     demand. Candidates are dropped when the epoch or the query mask
+//     changes; the inside set is kept so the diff stays continuous.
+//   - The trigger BVH holds AABB primitives only (bvh.aabbs[index] are the
+//     trigger bounds).
+//   - idRemap maps trigger prim indices (PrimRef::index) to caller ids and
+//     must be ascending; events and sets carry the remapped ids.
+//
+// PROOF POINTS:
+//   - Harness: OverlapAabbPrims_Fast == LinearFallback; cache events equal a
+//     brute-force diff along a walk through a trigger grid.
+// =========================================================================
+
+#include "SqQuery.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+// ---- AABB overlap (prim ids) ------------------------------------------------
+
+inline void OverlapAabbPrims_LinearFallback(const StaticBVH& bvh, const AABB& box,
+                                            std::vector<uint32_t>& out,
+                                            QueryMetrics* metrics = nullptr,
+                                            uint32_t queryMask = kPrimMaskAll)
+{
+    if (metrics)
+        metrics->fallbackUsed = true;
+    out.clear();
+    for (const PrimRef& pref : bvh.prims) {
+        if (!PassQueryMask(pref.mask, queryMask, metrics))
+            continue;
+        if (metrics)
+            ++metrics->primitiveAabbTests;
+        if (!TestAabbAabb(box, pref.bounds)) {
+            if (metrics)
+                ++metrics->primitiveAabbRejects;
+            continue;
+        }
+        out.push_back(pref.index);
+    }
+    std::sort(out.begin(), out.end());
+    if (metrics)
+        metrics->resultContactCount = static_cast<uint32_t>(out.size());
+}
+
+// Writes every PrimRef::index whose bounds touch box, ascending.
+inline void OverlapAabbPrims_Fast(const StaticBVH& bvh, const AABB& box,
+                                  QueryScratch& scratch, std::vector<uint32_t>& out,
+                                  uint32_t queryMask = kPrimMaskAll)
+{
+    ResetQueryScratch(scratch, QueryKind::OverlapAabb, QueryBackend::BinaryBVH);
+    out.clear();
+    if (IsEmptyBVH(bvh) || !PassQueryMask(bvh.nodes[bvh.root].mask, queryMask, &scratch.metrics))
+        return;
+
+    ++scratch.metrics.nodeAabbTests;
+    if (!TestAabbAabb(box, bvh.nodes[bvh.root].bounds)) {
+        ++scratch.metrics.nodeAabbRejects;
+        return;
+    }
+    PushQueryTask(scratch, { bvh.root, 0.0f, 0.0f });
+
+    while (scratch.sp) {
+        const NodeTask task = scratch.stack[--scratch.sp];
+        ++scratch.metrics.nodesPopped;
+        const BVHNode& node = bvh.nodes[task.node];
+
+        if (node.primCount) {
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t k = 0; k < node.primCount; ++k) {
+                const PrimRef& pref = bvh.prims[bvh.primIdx[node.primStart + k]];
+                if (!PassQueryMask(pref.mask, queryMask, &scratch.metrics))
+                    continue;
+                ++scratch.metrics.primitiveAabbTests;
+                if (!TestAabbAabb(box, pref.bounds)) {
+                    ++scratch.metrics.primitiveAabbRejects;
+                    continue;
+                }
+                out.push_back(pref.index);
+            }
+            continue;
+        }
+
+        PushStaticOverlapChildIfHit(bvh, box, node.right, scratch, queryMask);
+        PushStaticOverlapChildIfHit(bvh, box, node.left, scratch, queryMask);
+    }
+
+    if (scratch.overflowed) {
+        OverlapAabbPrims_LinearFallback(bvh, box, out, &scratch.metrics, queryMask);
+        return;
+    }
+    std::sort(out.begin(), out.end());
+    scratch.metrics.resultContactCount = static_cast<uint32_t>(out.size());
+}
+
+// ---- Pair cache -------------------------------------------------------------
+
+inline constexpr float kTriggerPairDefaultMargin = 0.5f;
+
+enum class TriggerPairEventKind : uint8_t {
+    Enter = 0,
+    Stay,
+    Exit,
+};
+
+struct TriggerPairEvent {
+    uint32_t actor = 0;
+    uint32_t trigger = 0;  // remapped id
+    TriggerPairEventKind kind = TriggerPairEventKind::Enter;
+};
+
+struct TriggerActorSlot {
+    AABB box{};
+    AABB fatBox{};
+    uint32_t queryMask = 0;
+    uint32_t epoch = 0;
+    bool hasCandidates = false;
+    std::vector<uint32_t> candidates;      // remapped ids, ascending
+    std::vector<AABB> candidateBounds;     // parallel to candidates
+    std::vector<uint32_t> inside;          // remapped ids, ascending
+    std::vector<uint32_t> next;            // scratch for the new inside set
+};
+
+struct TriggerPairStats {
+    uint32_t updates = 0;
+    uint32_t reusedSets = 0;       // bitwise-equal box, no pair tests
+    uint32_t candidateRuns = 0;    // box inside fat box, candidates retested
+    uint32_t gathers = 0;          // BVH traversals over a new fat box
+    uint32_t pairTests = 0;        // candidate AABB tests
+    uint32_t enters = 0;
+    uint32_t stays = 0;
+    uint32_t exits = 0;
+};
+
+struct TriggerPairCache {
+    float margin = kTriggerPairDefaultMargin;
+    std::vector<TriggerActorSlot> actors;
+    std::vector<uint32_t> gatherScratch;
+    TriggerPairStats stats{};
+};
+
+inline void ClearTriggerPairCache(TriggerPairCache& cache)
+{
+    cache.actors.clear();
+    cache.stats = TriggerPairStats{};
+}
+
+inline bool SameAabbBits(const AABB& a, const AABB& b)
+{
+    return a.minX == b.minX && a.minY == b.minY && a.minZ == b.minZ
+        && a.maxX == b.maxX && a.maxY == b.maxY && a.maxZ == b.maxZ;
+}
+
+inline bool AabbContains(const AABB& outer, const AABB& inner)
+{
+    return inner.minX >= outer.minX && inner.minY >= outer.minY && inner.minZ >= outer.minZ
+        && inner.maxX <= outer.maxX && inner.maxY <= outer.maxY && inner.maxZ <= outer.maxZ;
+}
+
+// Sorted merge: ids only in prev exit, only in cur enter, in both stay.
+inline void DiffTriggerSets(uint32_t actor,
+                            const std::vector<uint32_t>& prev,
+                            const std::vector<uint32_t>& cur,
+                            std::vector<TriggerPairEvent>& events,
+                            TriggerPairStats& stats)
+{
+    size_t i = 0;
+    size_t j = 0;
+    while (i < prev.size() || j < cur.size()) {
+        if (j == cur.size() || (i < prev.size() && prev[i] < cur[j])) {
+            events.push_back({ actor, prev[i++], TriggerPairEventKind::Exit });
+            ++stats.exits;
+        } else if (i == prev.size() || cur[j] < prev[i]) {
+            events.push_back({ actor, cur[j++], TriggerPairEventKind::Enter });
+            ++stats.enters;
+        } else {
+            events.push_back({ actor, cur[j], TriggerPairEventKind::Stay });
+            ++stats.stays;
+            ++i;
+            ++j;
+        }
+    }
+}
+
+// New inside set for box, then events against the previous set.
+inline void UpdateTriggerActor(TriggerPairCache& cache,
+                               const StaticBVH& bvh,
+                               const uint32_t* idRemap,
+                               uint32_t epoch,
+                               uint32_t actor,
+                               const AABB& box,
+                               uint32_t queryMask,
+                               QueryScratch& scratch,
+                               std::vector<TriggerPairEvent>& events)
+{
+    if (actor >= cache.actors.size())
+        cache.actors.resize(actor + 1u);
+    TriggerActorSlot& slot = cache.actors[actor];
+    ++cache.stats.updates;
+
+    const bool warm = slot.hasCandidates && slot.epoch == epoch && slot.queryMask == queryMask;
+    if (warm && SameAabbBits(slot.box, box)) {
+        ++cache.stats.reusedSets;
+        DiffTriggerSets(actor, slot.inside, slot.inside, events, cache.stats);
+        return;
+    }
+
+    if (!warm || !AabbContains(slot.fatBox, box)) {
+        ++cache.stats.gathers;
+        slot.fatBox = ExpandAabb(box, cache.margin);
+        OverlapAabbPrims_Fast(bvh, slot.fatBox, scratch, cache.gatherScratch, queryMask);
+        slot.candidates.clear();
+        slot.candidateBounds.clear();
+        for (uint32_t index : cache.gatherScratch) {
+            slot.candidates.push_back(idRemap ? idRemap[index] : index);
+            slot.candidateBounds.push_back(bvh.aabbs[index]);
+        }
+        slot.epoch = epoch;
+        slot.queryMask = queryMask;
+        slot.hasCandidates = true;
+    } else {
+        ++cache.stats.candidateRuns;
+    }
+
+    slot.next.clear();
+    for (size_t i = 0; i < slot.candidates.size(); ++i) {
+        ++cache.stats.pairTests;
+        if (TestAabbAabb(box, slot.candidateBounds[i]))
+            slot.next.push_back(slot.candidates[i]);
+    }
+    slot.box = box;
+
+    DiffTriggerSets(actor, slot.inside, slot.next, events, cache.stats);
+    slot.inside.swap(slot.next);
+}
+
+// Exits every pair of actor and forgets its slot (despawn, teleport).
+inline void RemoveTriggerActor(TriggerPairCache& cache, uint32_t actor,
+                               std::vector<TriggerPairEvent>& events)
+{
+    if (actor >= cache.actors.size())
+        return;
+    TriggerActorSlot& slot = cache.actors[actor];
+    const std::vector<uint32_t> none;
+    DiffTriggerSets(actor, slot.inside, none, events, cache.stats);
+    slot = TriggerActorSlot{};
+}
+
+}}} // namespace Engine::Collision::sq
@@ -20,11 +20,14 @@
 // PROOF POINTS:
 //   - [PR3.1] static_assert(sizeof(AABB)==24)
 //   - [PR3.1] AABB layout matches Engine::AABB (verified at integration seam)
+//   - static_assert(sizeof(TrianglePrecomp)==92); kernels with and without it
+//     agree (SqBackendHarness.cpp, ExpectTrianglePrecompEquivalence)
 //
 // REFERENCES:
 //   - docs/agent-context/scenequery-refactor.md
 //   - docs/reference/physx/contracts/sweep-toi-hit-normal.md
 //   - docs/reference/physx/contracts/initial-overlap-mtd.md
+//   - docs/audits/scenequery/26-triangle-precompute-store.md
 // =========================================================================
 
 #include "SqMath.h"
@@ -73,6 +76,14 @@ inline AABB OBBWorldAABB(const OBB& o) {
 
 struct Triangle { Vec3 p0, p1, p2; };
 
+// Active-edge bits of one triangle (SqMeshCook.h). Edge k joins vertex k to
+// vertex (k+1)%3. Sweeps skip the features of inactive edges, and of vertices
+// whose two edges are both inactive. Loose triangles keep every edge active.
+inline constexpr uint8_t kTriEdge01Active   = 1u << 0;
+inline constexpr uint8_t kTriEdge12Active   = 1u << 1;
+inline constexpr uint8_t kTriEdge20Active   = 1u << 2;
+inline constexpr uint8_t kTriEdgesAllActive = kTriEdge01Active | kTriEdge12Active | kTriEdge20Active;
+
 inline AABB TriAABB(const Triangle& t) {
     return {
         (std::min)(t.p0.x, (std::min)(t.p1.x, t.p2.x)),
@@ -99,15 +110,69 @@ inline bool PointInTri(const Vec3& p, const Triangle& t, const Vec3& n) {
         && Dot(c2, n) >= -kEpsPointInTri;
 }
 
+// Per-triangle narrowphase data, built once beside the tris array and indexed
+// like it (BuildTrianglePrecomp). Edge k runs from vertex k to vertex
+// (k+1)%3; edgeNormal k = Cross(normal, edge k) lies in the plane and points
+// inward. Only planeD depends on position, so the record also describes a
+// translated copy of the triangle (a prism cap). normalLenSq is the squared
+// length of the unnormalized normal, for the same degenerate test as the
+// kernels use without a record.
+struct TrianglePrecomp {
+    Vec3  normal;         // TriNormalUnit; {0,1,0} when degenerate
+    float planeD;         // Dot(normal, p0)
+    Vec3  edge[3];
+    Vec3  edgeNormal[3];
+    float normalLenSq;
+};
+static_assert(sizeof(TrianglePrecomp) == 92, "TrianglePrecomp is 23 packed floats");
+
+inline TrianglePrecomp MakeTrianglePrecomp(const Triangle& t) {
+    TrianglePrecomp out{};
+    out.edge[0] = t.p1 - t.p0;
+    out.edge[1] = t.p2 - t.p1;
+    out.edge[2] = t.p0 - t.p2;
+    const Vec3 nd = Cross(out.edge[0], t.p2 - t.p0);
+    out.normalLenSq = LenSq(nd);
+    out.normal = NormalizeSafe(nd, {0, 1, 0});
+    out.planeD = Dot(out.normal, t.p0);
+    for (int k = 0; k < 3; ++k)
+        out.edgeNormal[k] = Cross(out.normal, out.edge[k]);
+    return out;
+}
+
+inline void BuildTrianglePrecomp(const Triangle* tris, uint32_t count,
+                                 std::vector<TrianglePrecomp>& out) {
+    out.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+        out[i] = MakeTrianglePrecomp(tris[i]);
+}
+
+// PointInTri from the record of t or of any translated copy of t: three dot
+// products instead of three edges, three cross products and three dots.
+inline bool PointInTri(const Vec3& p, const Triangle& t, const TrianglePrecomp& pre) {
+    return Dot(p - t.p0, pre.edgeNormal[0]) >= -kEpsPointInTri
+        && Dot(p - t.p1, pre.edgeNormal[1]) >= -kEpsPointInTri
+        && Dot(p - t.p2, pre.edgeNormal[2]) >= -kEpsPointInTri;
+}
+
 // ---- Primitive classification -------------------------------------------
 
-enum class PrimType : uint8_t { Aabb = 0, Obb = 1, Tri = 2 };
+// Plane and Heightfield are tested outside the tree (SqPlane.h,
+// SqHeightfield.h); Capsule is dynamic-only (SqDynamicCapsules.h). StaticBVH
+// stores none of them. Capsule is highest so static primitives win type
+// tie-breaks.
+enum class PrimType : uint8_t { Aabb = 0, Obb = 1, Tri = 2, Plane = 3, Heightfield = 4, Capsule = 5 };
+
+// Query-mask bits of a primitive. A query sees it when mask & queryMask != 0;
+// the default is visible to every query.
+inline constexpr uint32_t kPrimMaskAll = 0xFFFFFFFFu;
 
 struct PrimRef {
     PrimType type;
     uint32_t index;
     AABB     bounds;
     Vec3     centroid;
+    uint32_t mask = kPrimMaskAll;
 };
 
 // ---- Query I/O ----------------------------------------------------------
@@ -144,6 +209,7 @@ struct SweepConfig {
     float skin       = 1e-4f;   // contact offset
     float tieEpsT    = 1e-6f;   // tolerance for t tie-breaks
     bool  twoSidedTris = true;
+    bool  orderLeafCandidates = false;  // BinaryBVH sweep: defer leaf narrowphase, nearest entry first
 };
 
 // ---- Sweep filter (Bullet-equivalent callback predicate) ----------------
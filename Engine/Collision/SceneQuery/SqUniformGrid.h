@@ -0,0 +1,361 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/audits/scenequery/23-uniform-grid-backend.md
+//
+// TERMINOLOGY:
+//   UniformGridDesc - regular XZ cell layout: sizeX x sizeZ cells of
+//                     `spacing`, cell (ix, iz) starting at
+//                     (originX + ix*spacing, originZ + iz*spacing). Linear
+//                     cell index iz*sizeX + ix, like Scene::CellKey.
+//   occupant        - an Aabb prim binned to the cell holding its centroid.
+//                     It may reach past that cell by at most `overhang`.
+//   extras          - every other prim (Obb, Tri, boxes outside the grid or
+//                     wider than kUniformGridMaxOverhang). They keep a
+//                     StaticBVH of their own.
+//   slab            - one row of cells across the dominant XZ motion axis.
+//
+// POLICY:
+//   - Queries run the extras tree first (BinaryBVH path), then visit
+//     occupant cells. Every prim reaches the same ConsiderSweepCapsulePrim /
+//     OverlapCapsulePrim call and the same BetterHit / top-K merge, so the
+//     result equals BinaryBVH on the source tree.
+//   - Sweeps walk slabs in motion order. A slab whose entry time is at or
+//     past best.t ends the walk, since every later slab enters later still.
+//     Inside a slab the cell range comes from the padded footprint over the
+//     slab's time window.
+//   - Footprints are padded by overhang plus kUniformGridRasterSlack, so the
+//     raster is conservative. A cell's occupant union (cellBounds) is the
+//     node-level test, with the same mask and filter-cull gates as a leaf.
+//
+// CONTRACT:
+//   - Built from a finished StaticBVH after its masks are set. The grid
+//     copies the prim refs and borrows the same geometry pointers.
+//   - The desc is plain data so that SceneQuery does not include Scene
+//     types. Callers copy Scene::GridPrimitive's sizeX/sizeZ/spacing/origin.
+//   - Metrics report QueryBackend::UniformGrid. nodesPopped counts extras
+//     nodes plus non-empty cells visited.
+//
+// PROOF POINTS:
+//   - Harness: every sweep/overlap equivalence world also runs the grid
+//     backend (boxes, tris, OBBs, masks, filters). The benchmark report has
+//     a uniformGrid row next to BinaryBVH on the dense column world.
+// =========================================================================
+
+#include "SqQuery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Engine { namespace Collision { namespace sq {
+
+// Occupant reach past its own cell, as a fraction of spacing. Wider boxes go
+// to the extras tree.
+inline constexpr float kUniformGridMaxOverhang = 0.25f;
+// Footprint padding on top of overhang; covers the slab-time division.
+inline constexpr float kUniformGridRasterSlack = 1e-4f;
+
+struct UniformGridDesc {
+    uint32_t sizeX = 0;
+    uint32_t sizeZ = 0;
+    float    spacing = 2.0f;
+    float    originX = 0.0f;
+    float    originZ = 0.0f;
+};
+
+struct UniformGrid {
+    UniformGridDesc       desc{};
+    StaticBVH             sourceView{};  // prim refs + borrowed geometry
+    std::vector<uint32_t> cellStart;     // CSR offsets, cell count + 1
+    std::vector<uint32_t> cellPrims;     // sourceView prim ids, ascending per cell
+    std::vector<AABB>     cellBounds;    // union of the cell's occupants
+    std::vector<uint32_t> cellMask;      // union of the cell's occupant masks
+    float                 overhang = 0.0f;
+    StaticBVH             extras{};      // non-occupant prims, original type/index
+};
+
+namespace detail {
+
+// Cell coordinate of v, clamped to [-1, size] before the integer cast.
+inline int32_t UniformGridCoord(float v, float origin, float spacing, uint32_t size)
+{
+    float c = std::floor((v - origin) / spacing);
+    c = (std::max)(-1.0f, (std::min)(c, static_cast<float>(size)));
+    return static_cast<int32_t>(c);
+}
+
+// Cell range [first, last] touched by [lo, hi]; false when it misses the grid.
+inline bool UniformGridRange(float lo, float hi, float origin, float spacing, uint32_t size,
+                             int32_t& first, int32_t& last)
+{
+    first = (std::max)(0, UniformGridCoord(lo, origin, spacing, size));
+    last = (std::min)(static_cast<int32_t>(size) - 1, UniformGridCoord(hi, origin, spacing, size));
+    return first <= last;
+}
+
+// Window of t in [0, 1] where [lo, hi] + d*t overlaps [a, b].
+inline bool UniformGridSlabWindow(float lo, float hi, float d, float a, float b,
+                                  float& t0, float& t1)
+{
+    t0 = 0.0f;
+    t1 = 1.0f;
+    if (Abs(d) < kEpsParallel)
+        return lo <= b && hi >= a;
+    const float ta = (a - hi) / d;
+    const float tb = (b - lo) / d;
+    t0 = (std::max)(t0, (std::min)(ta, tb));
+    t1 = (std::min)(t1, (std::max)(ta, tb));
+    return t0 <= t1;
+}
+
+inline uint32_t UniformGridCell(const UniformGridDesc& desc, int32_t major, int32_t minor, bool majorIsX)
+{
+    const uint32_t ix = static_cast<uint32_t>(majorIsX ? major : minor);
+    const uint32_t iz = static_cast<uint32_t>(majorIsX ? minor : major);
+    return iz * desc.sizeX + ix;
+}
+
+} // namespace detail
+
+inline UniformGrid BuildUniformGrid(const StaticBVH& source, const UniformGridDesc& desc,
+                                    const BuildCtx& extrasCtx = {})
+{
+    UniformGrid grid{};
+    grid.desc = desc;
+    grid.sourceView.prims = source.prims;
+    grid.sourceView.aabbs = source.aabbs;  grid.sourceView.aabbCount = source.aabbCount;
+    grid.sourceView.obbs  = source.obbs;   grid.sourceView.obbCount  = source.obbCount;
+    grid.sourceView.tris  = source.tris;   grid.sourceView.triCount  = source.triCount;
+    grid.sourceView.triEdgeFlags = source.triEdgeFlags;
+    grid.sourceView.triPrecomp = source.triPrecomp;
+
+    const uint32_t cellCount = (desc.spacing > 0.0f) ? desc.sizeX * desc.sizeZ : 0u;
+    const float maxReach = kUniformGridMaxOverhang * desc.spacing;
+    const uint32_t primCount = static_cast<uint32_t>(source.prims.size());
+
+    std::vector<uint32_t> cellOf(primCount, kInvalidBVHNode);
+    std::vector<uint32_t> extraIds;
+    grid.cellStart.assign(cellCount + 1, 0u);
+
+    for (uint32_t p = 0; p < primCount; ++p) {
+        const PrimRef& pref = source.prims[p];
+        if (pref.type == PrimType::Aabb && cellCount) {
+            const int32_t ix = detail::UniformGridCoord(pref.centroid.x, desc.originX, desc.spacing, desc.sizeX);
+            const int32_t iz = detail::UniformGridCoord(pref.centroid.z, desc.originZ, desc.spacing, desc.sizeZ);
+            if (ix >= 0 && iz >= 0 && ix < static_cast<int32_t>(desc.sizeX) && iz < static_cast<int32_t>(desc.sizeZ)) {
+                const float x0 = desc.originX + static_cast<float>(ix) * desc.spacing;
+                const float z0 = desc.originZ + static_cast<float>(iz) * desc.spacing;
+                const float reach = (std::max)({ 0.0f,
+                    x0 - pref.bounds.minX, pref.bounds.maxX - (x0 + desc.spacing),
+                    z0 - pref.bounds.minZ, pref.bounds.maxZ - (z0 + desc.spacing) });
+                if (reach <= maxReach) {
+                    cellOf[p] = static_cast<uint32_t>(iz) * desc.sizeX + static_cast<uint32_t>(ix);
+                    ++grid.cellStart[cellOf[p] + 1];
+                    grid.overhang = (std::max)(grid.overhang, reach);
+                    continue;
+                }
+            }
+        }
+        extraIds.push_back(p);
+    }
+
+    for (uint32_t c = 0; c < cellCount; ++c)
+        grid.cellStart[c + 1] += grid.cellStart[c];
+
+    grid.cellPrims.resize(primCount - extraIds.size());
+    grid.cellBounds.assign(cellCount, EmptyAABB());
+    grid.cellMask.assign(cellCount, 0u);
+    std::vector<uint32_t> fill(grid.cellStart.begin(), grid.cellStart.begin() + cellCount);
+    for (uint32_t p = 0; p < primCount; ++p) {
+        const uint32_t c = cellOf[p];
+        if (c == kInvalidBVHNode)
+            continue;
+        grid.cellPrims[fill[c]++] = p;
+        grid.cellBounds[c] = UnionAABB(grid.cellBounds[c], source.prims[p].bounds);
+        grid.cellMask[c] |= source.prims[p].mask;
+    }
+
+    grid.extras = BuildStaticBVHSubset(source, extraIds, extrasCtx);
+    return grid;
+}
+
+// Sweep: extras tree, then occupant cells in slab order (see POLICY).
+inline Hit SweepCapsuleClosestHit_UniformGrid(
+    const UniformGrid& grid,
+    const SweepCapsuleInput& in,
+    const SweepConfig& cfg,
+    QueryScratch& scratch,
+    const SweepFilter& filter = SweepFilter{},
+    bool rejectInitialOverlap = false,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    Hit best = SweepCapsuleClosestHit_Fast(grid.extras, in, cfg, scratch, filter,
+                                           rejectInitialOverlap, queryMask);
+    scratch.metrics.backend = QueryBackend::UniformGrid;
+    if (grid.cellPrims.empty()) {
+        FinishSweepQueryMetrics(scratch.metrics, best);
+        return best;
+    }
+
+    const UniformGridDesc& desc = grid.desc;
+    const AABB cap0 = CapsuleAabbAtT(in, 0.0f, cfg.skin);
+    const SweepFilterCull cull = MakeSweepFilterCull(in, cfg, filter);
+    const float pad = grid.overhang + kUniformGridRasterSlack;
+
+    const bool majorIsX = Abs(in.delta.x) >= Abs(in.delta.z);
+    const float loM = (majorIsX ? cap0.minX : cap0.minZ) - pad;
+    const float hiM = (majorIsX ? cap0.maxX : cap0.maxZ) + pad;
+    const float loN = (majorIsX ? cap0.minZ : cap0.minX) - pad;
+    const float hiN = (majorIsX ? cap0.maxZ : cap0.maxX) + pad;
+    const float dM = majorIsX ? in.delta.x : in.delta.z;
+    const float dN = majorIsX ? in.delta.z : in.delta.x;
+    const float originM = majorIsX ? desc.originX : desc.originZ;
+    const float originN = majorIsX ? desc.originZ : desc.originX;
+    const uint32_t sizeM = majorIsX ? desc.sizeX : desc.sizeZ;
+    const uint32_t sizeN = majorIsX ? desc.sizeZ : desc.sizeX;
+
+    int32_t firstM = 0;
+    int32_t lastM = 0;
+    if (!detail::UniformGridRange((std::min)(loM, loM + dM), (std::max)(hiM, hiM + dM),
+                                  originM, desc.spacing, sizeM, firstM, lastM)) {
+        FinishSweepQueryMetrics(scratch.metrics, best);
+        return best;
+    }
+
+    const int32_t stepM = (dM >= 0.0f) ? 1 : -1;
+    const int32_t endM = (dM >= 0.0f) ? lastM + 1 : firstM - 1;
+    for (int32_t i = (dM >= 0.0f) ? firstM : lastM; i != endM; i += stepM) {
+        const float a = originM + static_cast<float>(i) * desc.spacing;
+        float s0 = 0.0f;
+        float s1 = 1.0f;
+        if (!detail::UniformGridSlabWindow(loM, hiM, dM, a, a + desc.spacing, s0, s1))
+            continue;
+        if (s0 >= best.t)
+            break;
+        s1 = (std::min)(s1, best.t);
+
+        const float nA = dN * s0;
+        const float nB = dN * s1;
+        int32_t firstN = 0;
+        int32_t lastN = 0;
+        if (!detail::UniformGridRange(loN + (std::min)(nA, nB), hiN + (std::max)(nA, nB),
+                                      originN, desc.spacing, sizeN, firstN, lastN))
+            continue;
+
+        const int32_t stepN = (dN >= 0.0f) ? 1 : -1;
+        const int32_t endN = (dN >= 0.0f) ? lastN + 1 : firstN - 1;
+        for (int32_t j = (dN >= 0.0f) ? firstN : lastN; j != endN; j += stepN) {
+            const uint32_t c = detail::UniformGridCell(desc, i, j, majorIsX);
+            if (grid.cellStart[c] == grid.cellStart[c + 1])
+                continue;
+            ++scratch.metrics.nodesPopped;
+            if (!PassQueryMask(grid.cellMask[c], queryMask, &scratch.metrics))
+                continue;
+
+            float tEnter = 0.0f;
+            float tExit = best.t;
+            ++scratch.metrics.nodeAabbTests;
+            if (!AabbAabb_SweepInterval(cap0, in.delta, grid.cellBounds[c], tEnter, tExit)) {
+                ++scratch.metrics.nodeAabbRejects;
+                continue;
+            }
+            if (tEnter >= best.t) {
+                ++scratch.metrics.nodeTimePrunes;
+                continue;
+            }
+            if (SweepFilterCulls(cull, grid.cellBounds[c], tEnter, tExit)) {
+                ++scratch.metrics.filterCulls;
+                continue;
+            }
+
+            ++scratch.metrics.leafNodesVisited;
+            for (uint32_t k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+                const PrimRef& pref = grid.sourceView.prims[grid.cellPrims[k]];
+                if (!PassQueryMask(pref.mask, queryMask, &scratch.metrics))
+                    continue;
+                ConsiderSweepCapsulePrim(grid.sourceView, in, cfg, cap0, pref,
+                                         tEnter, tExit, filter, rejectInitialOverlap, best,
+                                         &scratch.metrics, &cull);
+            }
+        }
+    }
+
+    FinishSweepQueryMetrics(scratch.metrics, best);
+    return best;
+}
+
+// Overlap: extras tree, then the occupant cells under the padded capsule bounds.
+inline uint32_t OverlapCapsuleContacts_UniformGrid(
+    const UniformGrid& grid,
+    const Vec3& segA, const Vec3& segB, float radius,
+    OverlapContact* outContacts, uint32_t maxContacts,
+    QueryScratch& scratch,
+    uint32_t queryMask = kPrimMaskAll)
+{
+    uint32_t contactCount = OverlapCapsuleContacts_Fast(grid.extras, segA, segB, radius,
+                                                        outContacts, maxContacts, scratch,
+                                                        queryMask);
+    scratch.metrics.backend = QueryBackend::UniformGrid;
+    if (maxContacts == 0 || grid.cellPrims.empty()) {
+        FinishOverlapQueryMetrics(scratch.metrics, contactCount);
+        return contactCount;
+    }
+    if (maxContacts > kMaxOverlapContacts) maxContacts = kMaxOverlapContacts;
+
+    const UniformGridDesc& desc = grid.desc;
+    const AABB capBounds = CapsuleAabbStatic(segA, segB, radius);
+    const float pad = grid.overhang + kUniformGridRasterSlack;
+
+    int32_t firstX = 0, lastX = 0, firstZ = 0, lastZ = 0;
+    if (detail::UniformGridRange(capBounds.minX - pad, capBounds.maxX + pad,
+                                 desc.originX, desc.spacing, desc.sizeX, firstX, lastX) &&
+        detail::UniformGridRange(capBounds.minZ - pad, capBounds.maxZ + pad,
+                                 desc.originZ, desc.spacing, desc.sizeZ, firstZ, lastZ)) {
+        for (int32_t iz = firstZ; iz <= lastZ; ++iz) {
+            for (int32_t ix = firstX; ix <= lastX; ++ix) {
+                const uint32_t c = detail::UniformGridCell(desc, ix, iz, true);
+                if (grid.cellStart[c] == grid.cellStart[c + 1])
+                    continue;
+                ++scratch.metrics.nodesPopped;
+                if (!PassQueryMask(grid.cellMask[c], queryMask, &scratch.metrics))
+                    continue;
+                ++scratch.metrics.nodeAabbTests;
+                if (!TestAabbAabb(capBounds, grid.cellBounds[c])) {
+                    ++scratch.metrics.nodeAabbRejects;
+                    continue;
+                }
+
+                ++scratch.metrics.leafNodesVisited;
+                for (uint32_t k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+                    const PrimRef& pref = grid.sourceView.prims[grid.cellPrims[k]];
+                    if (!PassQueryMask(pref.mask, queryMask, &scratch.metrics))
+                        continue;
+                    ++scratch.metrics.primitiveAabbTests;
+                    if (!TestAabbAabb(capBounds, pref.bounds)) {
+                        ++scratch.metrics.primitiveAabbRejects;
+                        continue;
+                    }
+
+                    OverlapContact contact;
+                    ++scratch.metrics.narrowphaseCalls;
+                    if (!OverlapCapsulePrim(grid.sourceView, segA, segB, radius, pref, contact))
+                        continue;
+
+                    ++scratch.metrics.rawHits;
+                    ++scratch.metrics.acceptedHits;
+                    contact.type = pref.type;
+                    contact.index = pref.index;
+                    InsertOverlapContactTopK(outContacts, maxContacts, contactCount, contact,
+                                             &scratch.metrics);
+                }
+            }
+        }
+    }
+
+    std::sort(outContacts, outContacts + contactCount, OverlapContactBetter);
+    FinishOverlapQueryMetrics(scratch.metrics, contactCount);
+    return contactCount;
+}
+
+}}} // namespace Engine::Collision::sq
@@ -0,0 +1,192 @@
+#pragma once
+// =========================================================================
+// SSOT: docs/contracts/math/vec3-contract.md
+// REF: PhysX-style Vec4V/BoolV lanes; ISPC-style SoA "varying" float.
+//
+// POLICY:
+//   - Internal math backend only, like Vec3V. Callers gather scalar storage
+//     into lanes, run masked math, and scatter back.
+//   - One lane = one independent element (e.g. one character). Vec3Lanes is
+//     SoA: x/y/z each hold kLaneWidth elements.
+//   - Lane ops are IEEE single-precision per element, so results are
+//     bit-identical to the same scalar expression evaluated in the same order.
+//   - kLaneWidth is 4 (SSE). No AVX route; EL_MATH_ENABLE_SIMD stays a
+//     compile-time SSE/scalar switch.
+// =========================================================================
+
+#include "MathCommon.h"
+#include "Vec3.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if EL_MATH_ENABLE_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Engine { namespace Math { namespace simd {
+
+static constexpr uint32_t kLaneWidth = 4;
+
+#if EL_MATH_ENABLE_SIMD
+
+struct FloatLanes { __m128 v; };
+struct MaskLanes { __m128 v; };
+
+EL_FORCE_INLINE FloatLanes SplatLanes(float value) {
+    return {_mm_set1_ps(value)};
+}
+
+EL_FORCE_INLINE FloatLanes LoadLanes(const float* values) {
+    return {_mm_loadu_ps(values)};
+}
+
+EL_FORCE_INLINE void StoreLanes(const FloatLanes& value, float* out) {
+    _mm_storeu_ps(out, value.v);
+}
+
+// Mask storage is one float per lane holding all-ones (set) or zero bits.
+EL_FORCE_INLINE MaskLanes LoadMaskLanes(const float* bits) {
+    return {_mm_loadu_ps(bits)};
+}
+
+EL_FORCE_INLINE uint32_t MaskBits(const MaskLanes& mask) {
+    return static_cast<uint32_t>(_mm_movemask_ps(mask.v));
+}
+
+EL_FORCE_INLINE FloatLanes Add(const FloatLanes& a, const FloatLanes& b) { return {_mm_add_ps(a.v, b.v)}; }
+EL_FORCE_INLINE FloatLanes Sub(const FloatLanes& a, const FloatLanes& b) { return {_mm_sub_ps(a.v, b.v)}; }
+EL_FORCE_INLINE FloatLanes Mul(const FloatLanes& a, const FloatLanes& b) { return {_mm_mul_ps(a.v, b.v)}; }
+EL_FORCE_INLINE FloatLanes Min(const FloatLanes& a, const FloatLanes& b) { return {_mm_min_ps(a.v, b.v)}; }
+EL_FORCE_INLINE FloatLanes Max(const FloatLanes& a, const FloatLanes& b) { return {_mm_max_ps(a.v, b.v)}; }
+EL_FORCE_INLINE FloatLanes Sqrt(const FloatLanes& a) { return {_mm_sqrt_ps(a.v)}; }
+EL_FORCE_INLINE FloatLanes Neg(const FloatLanes& a) { return {_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))}; }
+
+EL_FORCE_INLINE MaskLanes CmpGt(const FloatLanes& a, const FloatLanes& b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+EL_FORCE_INLINE MaskLanes CmpLt(const FloatLanes& a, const FloatLanes& b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+
+EL_FORCE_INLINE MaskLanes And(const MaskLanes& a, const MaskLanes& b) { return {_mm_and_ps(a.v, b.v)}; }
+EL_FORCE_INLINE MaskLanes Or(const MaskLanes& a, const MaskLanes& b) { return {_mm_or_ps(a.v, b.v)}; }
+// a & ~b
+EL_FORCE_INLINE MaskLanes AndNot(const MaskLanes& a, const MaskLanes& b) { return {_mm_andnot_ps(b.v, a.v)}; }
+
+// mask ? a : b, per lane.
+EL_FORCE_INLINE FloatLanes Select(const MaskLanes& mask, const FloatLanes& a, const FloatLanes& b) {
+    return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+}
+
+#else
+
+struct FloatLanes { float v[kLaneWidth]; };
+struct MaskLanes { bool v[kLaneWidth]; };
+
+#define EL_LANE_LOOP for (uint32_t i = 0; i < kLaneWidth; ++i)
+
+EL_FORCE_INLINE FloatLanes SplatLanes(float value) {
+    FloatLanes out; EL_LANE_LOOP out.v[i] = value; return out;
+}
+
+EL_FORCE_INLINE FloatLanes LoadLanes(const float* values) {
+    FloatLanes out; EL_LANE_LOOP out.v[i] = values[i]; return out;
+}
+
+EL_FORCE_INLINE void StoreLanes(const FloatLanes& value, float* out) {
+    EL_LANE_LOOP out[i] = value.v[i];
+}
+
+EL_FORCE_INLINE MaskLanes LoadMaskLanes(const float* bits) {
+    MaskLanes out;
+    EL_LANE_LOOP {
+        uint32_t raw;
+        std::memcpy(&raw, &bits[i], sizeof(raw));
+        out.v[i] = raw != 0;
+    }
+    return out;
+}
+
+EL_FORCE_INLINE uint32_t MaskBits(const MaskLanes& mask) {
+    uint32_t bits = 0; EL_LANE_LOOP bits |= (mask.v[i] ? 1u : 0u) << i; return bits;
+}
+
+EL_FORCE_INLINE FloatLanes Add(const FloatLanes& a, const FloatLanes& b) { FloatLanes o; EL_LANE_LOOP o.v[i] = a.v[i] + b.v[i]; return o; }
+EL_FORCE_INLINE FloatLanes Sub(const FloatLanes& a, const FloatLanes& b) { FloatLanes o; EL_LANE_LOOP o.v[i] = a.v[i] - b.v[i]; return o; }
+EL_FORCE_INLINE FloatLanes Mul(const FloatLanes& a, const FloatLanes& b) { FloatLanes o; EL_LANE_LOOP o.v[i] = a.v[i] * b.v[i]; return o; }
+EL_FORCE_INLINE FloatLanes Min(const FloatLanes& a, const FloatLanes& b) { FloatLanes o; EL_LANE_LOOP o.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return o; }
+EL_FORCE_INLINE FloatLanes Max(const FloatLanes& a, const FloatLanes& b) { FloatLanes o; EL_LANE_LOOP o.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return o; }
+EL_FORCE_INLINE FloatLanes Sqrt(const FloatLanes& a) { FloatLanes o; EL_LANE_LOOP o.v[i] = std::sqrt(a.v[i]); return o; }
+EL_FORCE_INLINE FloatLanes Neg(const FloatLanes& a) { FloatLanes o; EL_LANE_LOOP o.v[i] = -a.v[i]; return o; }
+
+EL_FORCE_INLINE MaskLanes CmpGt(const FloatLanes& a, const FloatLanes& b) { MaskLanes o; EL_LANE_LOOP o.v[i] = a.v[i] > b.v[i]; return o; }
+EL_FORCE_INLINE MaskLanes CmpLt(const FloatLanes& a, const FloatLanes& b) { MaskLanes o; EL_LANE_LOOP o.v[i] = a.v[i] < b.v[i]; return o; }
+
+EL_FORCE_INLINE MaskLanes And(const MaskLanes& a, const MaskLanes& b) { MaskLanes o; EL_LANE_LOOP o.v[i] = a.v[i] && b.v[i]; return o; }
+EL_FORCE_INLINE MaskLanes Or(const MaskLanes& a, const MaskLanes& b) { MaskLanes o; EL_LANE_LOOP o.v[i] = a.v[i] || b.v[i]; return o; }
+EL_FORCE_INLINE MaskLanes AndNot(const MaskLanes& a, const MaskLanes& b) { MaskLanes o; EL_LANE_LOOP o.v[i] = a.v[i] && !b.v[i]; return o; }
+
+EL_FORCE_INLINE FloatLanes Select(const MaskLanes& mask, const FloatLanes& a, const FloatLanes& b) {
+    FloatLanes o; EL_LANE_LOOP o.v[i] = mask.v[i] ? a.v[i] : b.v[i]; return o;
+}
+
+#undef EL_LANE_LOOP
+
+#endif
+
+// ---- SoA Vec3 lanes (shared by both routes) --------------------------------
+
+struct Vec3Lanes { FloatLanes x, y, z; };
+
+EL_FORCE_INLINE Vec3Lanes SplatLanes3(const Vec3& value) {
+    return {SplatLanes(value.x), SplatLanes(value.y), SplatLanes(value.z)};
+}
+
+// SoA storage for kLaneWidth Vec3 values; loads without a gather.
+struct Vec3LaneStore {
+    float x[kLaneWidth];
+    float y[kLaneWidth];
+    float z[kLaneWidth];
+
+    void Set(uint32_t lane, const Vec3& value) {
+        x[lane] = value.x;
+        y[lane] = value.y;
+        z[lane] = value.z;
+    }
+    Vec3 Get(uint32_t lane) const { return {x[lane], y[lane], z[lane]}; }
+};
+
+EL_FORCE_INLINE Vec3Lanes LoadLanes3(const Vec3LaneStore& values) {
+    return {LoadLanes(values.x), LoadLanes(values.y), LoadLanes(values.z)};
+}
+
+EL_FORCE_INLINE void StoreLanes3(const Vec3Lanes& value, Vec3LaneStore& out) {
+    StoreLanes(value.x, out.x);
+    StoreLanes(value.y, out.y);
+    StoreLanes(value.z, out.z);
+}
+
+EL_FORCE_INLINE Vec3Lanes Add(const Vec3Lanes& a, const Vec3Lanes& b) {
+    return {Add(a.x, b.x), Add(a.y, b.y), Add(a.z, b.z)};
+}
+
+EL_FORCE_INLINE Vec3Lanes Sub(const Vec3Lanes& a, const Vec3Lanes& b) {
+    return {Sub(a.x, b.x), Sub(a.y, b.y), Sub(a.z, b.z)};
+}
+
+EL_FORCE_INLINE Vec3Lanes Scale(const Vec3Lanes& a, const FloatLanes& s) {
+    return {Mul(a.x, s), Mul(a.y, s), Mul(a.z, s)};
+}
+
+EL_FORCE_INLINE Vec3Lanes Select(const MaskLanes& mask, const Vec3Lanes& a, const Vec3Lanes& b) {
+    return {Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z)};
+}
+
+// Same association as scalar Dot: (x*x' + y*y') + z*z'.
+EL_FORCE_INLINE FloatLanes Dot3(const Vec3Lanes& a, const Vec3Lanes& b) {
+    return Add(Add(Mul(a.x, b.x), Mul(a.y, b.y)), Mul(a.z, b.z));
+}
+
+EL_FORCE_INLINE FloatLanes Length3(const Vec3Lanes& a) {
+    return Sqrt(Dot3(a, a));
+}
+
+}}} // namespace Engine::Math::simd
@@ -1,8 +1,10 @@
 #include "Vec3SimdSelfTest.h"
 
+#include "LaneSimd.h"
 #include "Vec3Simd.h"
 
 #include <cassert>
+#include <cstring>
 
 namespace Engine { namespace Math {
 
@@ -22,6 +24,57 @@ Vec3 Store(const simd::Vec3V& value) {
     return simd::StoreU(value);
 }
 
+// Lane ops are IEEE per element: parity is exact, not epsilon.
+void ExpectLanesExact(const simd::FloatLanes& lanes, const float* expected) {
+    float actual[simd::kLaneWidth];
+    simd::StoreLanes(lanes, actual);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i)
+        assert(actual[i] == expected[i]);
+}
+
+void RunLaneSimdParity() {
+    const float a[simd::kLaneWidth] = {1.5f, -2.0f, 0.0f, 9.25f};
+    const float b[simd::kLaneWidth] = {-4.0f, 3.0f, 0.5f, 9.25f};
+    const bool flags[simd::kLaneWidth] = {true, false, true, false};
+    float maskBits[simd::kLaneWidth];
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) {
+        const uint32_t raw = flags[i] ? 0xFFFFFFFFu : 0u;
+        std::memcpy(&maskBits[i], &raw, sizeof(raw));
+    }
+    const simd::FloatLanes al = simd::LoadLanes(a);
+    const simd::FloatLanes bl = simd::LoadLanes(b);
+    const simd::MaskLanes mask = simd::LoadMaskLanes(maskBits);
+
+    float expected[simd::kLaneWidth];
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = a[i] + b[i];
+    ExpectLanesExact(simd::Add(al, bl), expected);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = a[i] * b[i];
+    ExpectLanesExact(simd::Mul(al, bl), expected);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = (a[i] > b[i]) ? b[i] : a[i];
+    ExpectLanesExact(simd::Min(al, bl), expected);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = (a[i] < b[i]) ? b[i] : a[i];
+    ExpectLanesExact(simd::Max(al, bl), expected);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = flags[i] ? a[i] : b[i];
+    ExpectLanesExact(simd::Select(mask, al, bl), expected);
+    assert(simd::MaskBits(mask) == 0x5u);
+    assert(simd::MaskBits(simd::CmpGt(al, bl)) == 0x1u);
+
+    const Vec3 va[simd::kLaneWidth] = {{1, 2, 3}, {-0.5f, 4, 0}, {0, 0, 0}, {3, -4, 12}};
+    simd::Vec3LaneStore store{};
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i)
+        store.Set(i, va[i]);
+    const simd::Vec3Lanes vl = simd::LoadLanes3(store);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) expected[i] = Length(va[i]);
+    ExpectLanesExact(simd::Length3(vl), expected);
+
+    simd::Vec3LaneStore roundTrip{};
+    simd::StoreLanes3(vl, roundTrip);
+    for (uint32_t i = 0; i < simd::kLaneWidth; ++i) {
+        const Vec3 v = roundTrip.Get(i);
+        assert(v.x == va[i].x && v.y == va[i].y && v.z == va[i].z);
+    }
+}
+
 } // namespace
 
 void RunVec3SimdSelfTest() {
@@ -57,6 +110,8 @@ void RunVec3SimdSelfTest() {
 
     const Vec3 zero = Zero3();
     ExpectVecNear(Store(simd::Add(simd::LoadU(zero), simd::Splat3(1.0f))), One3());
+
+    RunLaneSimdParity();
 #endif
 }
 
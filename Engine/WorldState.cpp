@@ -241,6 +241,9 @@ namespace Engine
         // Reset collision stats for this tick
         m_collisionStats = CollisionStats{};
 
+        // Tick boundary: publish a finished background rebuild before any query.
+        m_collisionRebuild.PublishIfReady(m_collisionWorld);
+
         // 1. Apply yaw rotation [LOOK-UNIFIED] pre-computed delta from Action layer
         m_view.yaw += input.yawDelta;
 
@@ -683,6 +686,7 @@ namespace Engine
             m_pawn.posX = rs.posFeet.x; m_pawn.posY = rs.posFeet.y; m_pawn.posZ = rs.posFeet.z;
             m_pawn.velX = rs.vel.x;     m_pawn.velY = rs.vel.y;     m_pawn.velZ = rs.vel.z;
             m_pawn.onGround = rs.onGround;
+            DispatchTriggerEvents();  // exits from the respawn reset
             return;  // respawned — skip trigger overlap this tick
         }
 
@@ -696,19 +700,28 @@ namespace Engine
         Collision::sq::Vec3 segA = {cs.posFeet.x, cs.posFeet.y + r,         cs.posFeet.z};
         Collision::sq::Vec3 segB = {cs.posFeet.x, cs.posFeet.y + r + 2*hh,  cs.posFeet.z};
 
-        uint32_t hitIds[8];
-        uint32_t hitCount = m_collisionWorld.OverlapCapsule(
-            segA, segB, r, Collision::Q_Trigger, hitIds, 8);
+        // Pair cache diffs this tick's inside set against the last one; the
+        // pawn is actor 0. Events are ascending by collider index.
+        m_triggerEvents.clear();
+        m_collisionWorld.UpdateTriggerPairs(
+            m_triggerPairs, 0, segA, segB, r, Collision::Q_Trigger, m_triggerEvents);
+        DispatchTriggerEvents();
+    }
 
-        // hitIds already ascending (m_triggerIds is ascending, scan preserves order)
-        for (uint32_t i = 0; i < hitCount; ++i)
+    void WorldState::DispatchTriggerEvents()
+    {
+        for (const auto& ev : m_triggerEvents)
         {
-            const auto& desc = m_collisionWorld.getColliderDesc(hitIds[i]);
+            if (ev.kind == Collision::sq::TriggerPairEventKind::Stay)
+                continue;
+            const auto& desc = m_collisionWorld.getColliderDesc(ev.trigger);
 
 #if defined(_DEBUG)
             {
                 char buf[128];
-                sprintf_s(buf, "[TRIGGER_HIT] idx=%u tag=%u\n", hitIds[i], desc.userTag);
+                sprintf_s(buf, "[TRIGGER_%s] idx=%u tag=%u\n",
+                    ev.kind == Collision::sq::TriggerPairEventKind::Enter ? "ENTER" : "EXIT",
+                    ev.trigger, desc.userTag);
                 OutputDebugStringA(buf);
             }
 #endif
@@ -727,6 +740,11 @@ namespace Engine
         m_pawn.onGround = false;
         m_collisionStats = CollisionStats{};
 
+        // Teleport: exit every trigger the pawn was inside and forget its
+        // pair slot, so the next TriggerPass re-enters from the spawn point.
+        m_triggerEvents.clear();
+        Collision::sq::RemoveTriggerActor(m_triggerPairs, 0, m_triggerEvents);
+
         // Sync KCC primary state on respawn
         if (m_cct)
         {
@@ -769,15 +787,40 @@ namespace Engine
         OutputDebugStringA("[Collision] Built spatial hash: 10000 cubes in 100x100 grid\n");
     }
 
-    // Phase A: Build CollisionWorld from cube AABBs + floor triangles.
-    // Cubes are Solid AABB. Floor is 2 Solid Tri covering the floor plane.
+    // Floor: Solid bounded plane (normal +Y) over the floor bounds, a slab
+    // floorThickness deep. The pawn still falls off the rim toward KillZ; the
+    // plane has no edge features, and steering back under the slab meets its
+    // bottom face instead of lifting the pawn through the surface.
+    Collision::ColliderDesc WorldState::MakeFloorColliderDesc() const
+    {
+        namespace coll = Collision;
+
+        const float fx0 = m_config.floorMinX, fx1 = m_config.floorMaxX;
+        const float fz0 = m_config.floorMinZ, fz1 = m_config.floorMaxZ;
+        const float fy  = m_config.floorY;
+
+        coll::ColliderDesc floor;
+        floor.shape   = coll::ColliderShape::Plane;
+        floor.kind    = coll::ColliderKind::Solid;
+        floor.mask    = coll::Q_Solid;
+        floor.userTag = 0xFFFFFFFE;
+        floor.plane   = coll::sq::MakeBoundedPlane(
+            {0.0f, 1.0f, 0.0f}, {(fx0 + fx1) * 0.5f, fy, (fz0 + fz1) * 0.5f},
+            {1.0f, 0.0f, 0.0f}, (fx1 - fx0) * 0.5f, (fz1 - fz0) * 0.5f,
+            m_config.floorThickness);
+        floor.bounds  = coll::sq::PlaneFootprintBounds(floor.plane);
+        return floor;
+    }
+
+    // Phase A: Build CollisionWorld from cube AABBs + the floor plane.
+    // Cubes are Solid AABB. Floor is one Solid bounded plane.
     void WorldState::BuildCollisionWorld()
     {
         namespace coll = Collision;
 
         const uint32_t cubeCount = GRID_SIZE * GRID_SIZE;
         std::vector<coll::ColliderDesc> descs;
-        descs.reserve(cubeCount + 2);  // cubes + 2 floor tris
+        descs.reserve(cubeCount + 1);  // cubes + floor plane
 
         // Cubes
         for (uint32_t i = 0; i < cubeCount; ++i) {
@@ -794,44 +837,36 @@ namespace Engine
             descs.push_back(d);
         }
 
-        // Floor: two triangles at Y=floorY covering floor bounds.
-        // Winding: CCW from above → normal = (0,1,0).
-        {
-            const float fx0 = m_config.floorMinX, fx1 = m_config.floorMaxX;
-            const float fz0 = m_config.floorMinZ, fz1 = m_config.floorMaxZ;
-            const float fy  = m_config.floorY;
-
-            coll::ColliderDesc floorA;
-            floorA.shape    = coll::ColliderShape::Tri;
-            floorA.kind     = coll::ColliderKind::Solid;
-            floorA.mask     = coll::Q_Solid;
-            floorA.userTag  = 0xFFFFFFFE;
-            floorA.triVerts = {{fx0,fy,fz0}, {fx1,fy,fz1}, {fx1,fy,fz0}};
-            floorA.bounds   = Collision::sq::TriAABB(floorA.triVerts);
-            descs.push_back(floorA);
-
-            coll::ColliderDesc floorB;
-            floorB.shape    = coll::ColliderShape::Tri;
-            floorB.kind     = coll::ColliderKind::Solid;
-            floorB.mask     = coll::Q_Solid;
-            floorB.userTag  = 0xFFFFFFFE;
-            floorB.triVerts = {{fx0,fy,fz0}, {fx0,fy,fz1}, {fx1,fy,fz1}};
-            floorB.bounds   = Collision::sq::TriAABB(floorB.triVerts);
-            descs.push_back(floorB);
-        }
+        // Floor: one bounded plane at Y=floorY covering floor bounds.
+        // Tested outside the BVH, so it no longer overlaps every leaf.
+        descs.push_back(MakeFloorColliderDesc());
 
-        m_collisionWorld.BuildStatic(descs);
+        SubmitCollisionColliders(std::move(descs));
+    }
+
+    // First build runs inline: nothing queries the world yet and the KCC
+    // needs it at once. Later builds run on the rebuild worker; colliders
+    // they append are gap-patched into the live world until TickFixed
+    // publishes the build.
+    void WorldState::SubmitCollisionColliders(std::vector<Collision::ColliderDesc> descs)
+    {
+        if (m_collisionWorld.GetStaticEpoch() == 0 && !m_collisionRebuild.IsBuilding())
+            m_collisionWorld.BuildStatic(descs);
+        else
+            m_collisionRebuild.Request(std::move(descs), m_collisionWorld);
     }
 
-    // Rebuild CollisionWorld with cubes + floor tris + all current extras as Solid AABBs.
+    // Rebuild CollisionWorld with cubes + floor plane + all current extras as Solid AABBs.
     // Called after BuildStepUpGridTest() to ensure stairs are in the BVH.
+    // The build runs on a worker; the new extras are gap-patched into the
+    // current world until TickFixed publishes the new one.
     void WorldState::RebuildCollisionWorldWithExtras()
     {
         namespace coll = Collision;
 
         const uint32_t cubeCount = GRID_SIZE * GRID_SIZE;
         std::vector<coll::ColliderDesc> descs;
-        descs.reserve(cubeCount + 2 + m_extras.size());
+        descs.reserve(cubeCount + 1 + m_extras.size());
 
         // Cubes
         for (uint32_t i = 0; i < cubeCount; ++i) {
@@ -848,30 +883,8 @@ namespace Engine
             descs.push_back(d);
         }
 
-        // Floor triangles
-        {
-            const float fx0 = m_config.floorMinX, fx1 = m_config.floorMaxX;
-            const float fz0 = m_config.floorMinZ, fz1 = m_config.floorMaxZ;
-            const float fy  = m_config.floorY;
-
-            coll::ColliderDesc floorA;
-            floorA.shape    = coll::ColliderShape::Tri;
-            floorA.kind     = coll::ColliderKind::Solid;
-            floorA.mask     = coll::Q_Solid;
-            floorA.userTag  = 0xFFFFFFFE;
-            floorA.triVerts = {{fx0,fy,fz0}, {fx1,fy,fz1}, {fx1,fy,fz0}};
-            floorA.bounds   = Collision::sq::TriAABB(floorA.triVerts);
-            descs.push_back(floorA);
-
-            coll::ColliderDesc floorB;
-            floorB.shape    = coll::ColliderShape::Tri;
-            floorB.kind     = coll::ColliderKind::Solid;
-            floorB.mask     = coll::Q_Solid;
-            floorB.userTag  = 0xFFFFFFFE;
-            floorB.triVerts = {{fx0,fy,fz0}, {fx0,fy,fz1}, {fx1,fy,fz1}};
-            floorB.bounds   = Collision::sq::TriAABB(floorB.triVerts);
-            descs.push_back(floorB);
-        }
+        // Floor plane
+        descs.push_back(MakeFloorColliderDesc());
 
         // Extras (stairs, etc.) as Solid AABBs
         for (size_t i = 0; i < m_extras.size(); ++i) {
@@ -885,12 +898,12 @@ namespace Engine
             descs.push_back(d);
         }
 
-        m_collisionWorld.BuildStatic(descs);
-
         char buf[128];
-        sprintf_s(buf, "[COLLWORLD_REBUILD] total=%u extras=%zu\n",
+        sprintf_s(buf, "[COLLWORLD_REBUILD] total=%u extras=%zu async\n",
             static_cast<uint32_t>(descs.size()), m_extras.size());
         OutputDebugStringA(buf);
+
+        SubmitCollisionColliders(std::move(descs));
     }
 
     int WorldState::WorldToCellX(float x) const
@@ -984,7 +997,8 @@ namespace Engine
         sprintf_s(buf, "[STEP_GRID] Total extras=%zu\n", m_extras.size());
         OutputDebugStringA(buf);
 
-        // Rebuild BVH to include extras (stairs)
+        // Rebuild BVH to include extras (stairs). The gap patch makes them
+        // solid for the first tick; the full build publishes a few ticks later.
         RebuildCollisionWorldWithExtras();
     }
 
@@ -9,6 +9,7 @@
 #include "WorldTypes.h"
 #include "Math/Transform.h"
 #include "Collision/CollisionWorld.h"
+#include "Collision/CollisionWorldRebuild.h"
 #include "Collision/KinematicCharacterController.h"
 #include "../Renderer/DX12/KccTraceTypes.h"
 
@@ -118,6 +119,7 @@ namespace Engine
 
         // Private helpers
         void TriggerPass();  // Post-move trigger overlap (future: teleport, checkpoint, etc.)
+        void DispatchTriggerEvents();  // Enter/exit events in m_triggerEvents
 
         // Part 2: Spatial hash helpers (kept for SceneView adapter)
         void BuildSpatialGrid();
@@ -130,6 +132,13 @@ namespace Engine
         Collision::CollisionWorld m_collisionWorld;
         void BuildCollisionWorld();
         void RebuildCollisionWorldWithExtras();  // cubes + floor + extras
+        void SubmitCollisionColliders(std::vector<Collision::ColliderDesc> descs);
+        Collision::ColliderDesc MakeFloorColliderDesc() const;  // bounded floor plane
+        Collision::CollisionWorldRebuilder m_collisionRebuild;  // background BuildStatic, published in TickFixed
+
+        // Trigger enter/stay/exit state across ticks (pawn = actor 0)
+        Collision::sq::TriggerPairCache m_triggerPairs;
+        std::vector<Collision::sq::TriggerPairEvent> m_triggerEvents;
 
         // KCC (sole movement authority)
         std::unique_ptr<Collision::KinematicCharacterController> m_cct;
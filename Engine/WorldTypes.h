@@ -279,6 +279,7 @@ namespace Engine
         float floorMinZ = -200.0f;
         float floorMaxZ = 200.0f;
         float floorY = 0.0f;
+        float floorThickness = 1.0f;  // slab depth below floorY; a pawn under it falls on
 
         // KillZ (respawn trigger)
         float killZ = -50.0f;